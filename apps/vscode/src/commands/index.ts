@@ -21,6 +21,11 @@ export {
 	handleOpenTableFromTree,
 	setGraphCommandsContext,
 } from "./graph-commands.js";
+export {
+	handleClearLogOverlay,
+	handleOverlayLogOnActiveTable,
+	setLogOverlayCommandsContext,
+} from "./log-overlay-commands.js";
 export { openRomFlow } from "./rom-commands.js";
 export {
 	openTableFlow,
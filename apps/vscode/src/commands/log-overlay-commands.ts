@@ -0,0 +1,197 @@
+import {
+	type BinnedGrid,
+	createTableBinner,
+	type TableDefinition,
+} from "@ecu-explorer/core";
+import type { TableLogOverlay } from "@ecu-explorer/ui";
+import * as vscode from "vscode";
+import { type LogCsvColumns, parseLogCsvColumns } from "../csv/log-columns.js";
+import type { RomEditorProvider } from "../rom/editor-provider.js";
+import type { TableSessionLogOverlayMessage } from "../table-session-protocol.js";
+
+type LogOverlayEditorProvider = Pick<
+	RomEditorProvider,
+	"getPanelForDocument" | "getTableDocument"
+>;
+
+/**
+ * Get references to extension state
+ */
+let getStateRefs:
+	| (() => {
+			activePanel: vscode.WebviewPanel | null;
+			activeTableDef: TableDefinition | null;
+			activeRomBytes: Uint8Array | null;
+			editorProvider: LogOverlayEditorProvider | null;
+	  })
+	| null = null;
+
+/**
+ * Set the state reference getter for log overlay commands
+ */
+export function setLogOverlayCommandsContext(
+	stateRefGetter: typeof getStateRefs extends null
+		? never
+		: typeof getStateRefs,
+): void {
+	getStateRefs = stateRefGetter;
+}
+
+/**
+ * Helper to get state refs
+ */
+function getState() {
+	if (!getStateRefs) {
+		throw new Error("Log overlay commands context not initialized");
+	}
+	return getStateRefs();
+}
+
+/**
+ * Resolve the table editor the overlay applies to
+ */
+function resolveActiveTable() {
+	const state = getState();
+	let panel = state.activePanel;
+	let tableDef = state.activeTableDef;
+	let romBytes = state.activeRomBytes;
+
+	const activeTab = vscode.window.tabGroups.activeTabGroup.activeTab;
+	if (activeTab?.input instanceof vscode.TabInputCustom) {
+		const tableDoc = state.editorProvider?.getTableDocument(
+			activeTab.input.uri,
+		);
+		if (tableDoc) {
+			tableDef = tableDoc.tableDef;
+			romBytes = tableDoc.romDocument.romBytes;
+			panel =
+				state.editorProvider?.getPanelForDocument(tableDoc.romDocument) ??
+				panel;
+		}
+	}
+
+	return panel && tableDef && romBytes ? { panel, tableDef, romBytes } : null;
+}
+
+async function pickChannel(
+	log: LogCsvColumns,
+	placeHolder: string,
+): Promise<{ label: string; column: Float64Array } | undefined> {
+	const picked = await vscode.window.showQuickPick(
+		log.headers.map((header, index) => ({ label: header, index })),
+		{ placeHolder },
+	);
+	const column = picked ? log.columns[picked.index] : undefined;
+	return picked && column ? { label: picked.label, column } : undefined;
+}
+
+/**
+ * Convert binned statistics to the plain arrays posted to the webview
+ */
+export function toTableLogOverlay(
+	grid: BinnedGrid,
+	label: string,
+): TableLogOverlay {
+	const orNull = (values: Float64Array) =>
+		Array.from(values, (v) => (Number.isNaN(v) ? null : v));
+	return {
+		label,
+		rows: grid.rows,
+		cols: grid.cols,
+		count: Array.from(grid.count),
+		mean: orNull(grid.mean),
+		min: orNull(grid.min),
+		max: orNull(grid.max),
+		stddev: orNull(grid.stddev),
+	};
+}
+
+/**
+ * Handle the overlay log command
+ *
+ * Prompts for a log file and the channels matching the active table's axes,
+ * bins the chosen value channel onto the table and shows the per-cell mean
+ * over the grid.
+ */
+export async function handleOverlayLogOnActiveTable(): Promise<void> {
+	const active = resolveActiveTable();
+	if (!active) {
+		vscode.window.showErrorMessage("No active table editor");
+		return;
+	}
+	const { panel, tableDef, romBytes } = active;
+	if (tableDef.kind === "table3d") {
+		vscode.window.showErrorMessage(
+			"Log overlays are only supported for 1D and 2D tables.",
+		);
+		return;
+	}
+
+	const uris = await vscode.window.showOpenDialog({
+		canSelectFiles: true,
+		canSelectFolders: false,
+		canSelectMany: false,
+		filters: { "Log CSV": ["csv"] },
+		openLabel: "Overlay Log",
+	});
+	const logUri = uris?.[0];
+	if (!logUri) return;
+
+	try {
+		const binner = createTableBinner(tableDef, romBytes);
+		const log = parseLogCsvColumns(await vscode.workspace.fs.readFile(logUri));
+		if (log.rowCount === 0) {
+			vscode.window.showWarningMessage("The selected log has no data rows.");
+			return;
+		}
+
+		const x = await pickChannel(
+			log,
+			`Log channel for the X axis (${tableDef.x?.name ?? "X"})`,
+		);
+		if (!x) return;
+		let y: Float64Array | undefined;
+		if (tableDef.kind === "table2d") {
+			y = (
+				await pickChannel(
+					log,
+					`Log channel for the Y axis (${tableDef.y?.name ?? "Y"})`,
+				)
+			)?.column;
+			if (!y) return;
+		}
+		const value = await pickChannel(log, "Log channel to average per cell");
+		if (!value) return;
+
+		const binned = binner.addColumns({
+			x: x.column,
+			value: value.column,
+			...(y ? { y } : {}),
+		});
+		const message: TableSessionLogOverlayMessage = {
+			type: "logOverlay",
+			overlay: toTableLogOverlay(binner.result(), value.label),
+		};
+		await panel.webview.postMessage(message);
+		vscode.window.showInformationMessage(
+			`Binned ${binned} of ${log.rowCount} samples of ${value.label} onto ${tableDef.name}.`,
+		);
+	} catch (error) {
+		vscode.window.showErrorMessage(
+			`Failed to overlay log: ${error instanceof Error ? error.message : String(error)}`,
+		);
+	}
+}
+
+/**
+ * Handle the clear log overlay command
+ */
+export async function handleClearLogOverlay(): Promise<void> {
+	const active = resolveActiveTable();
+	if (!active) return;
+	const message: TableSessionLogOverlayMessage = {
+		type: "logOverlay",
+		overlay: null,
+	};
+	await active.panel.webview.postMessage(message);
+}
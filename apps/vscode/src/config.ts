@@ -1,3 +1,4 @@
+import type { ResampleMode } from "@ecu-explorer/core";
 import * as vscode from "vscode";
 
 /** Known definition provider identifiers */
@@ -25,6 +26,12 @@ export interface EcuExplorerConfig {
 	logging: {
 		/** Which PID columns to include in CSV logs. "all" or array of PID names. Default: "all" */
 		columns: string[] | "all";
+		/** Row spacing for time-aligned logs in ms; 0 writes each sample as it arrives. Default: 0 */
+		sampleIntervalMs: number;
+		/** How channels are resampled onto the row timebase. Default: "hold" */
+		interpolation: ResampleMode;
+		/** Reporting latency per column name in ms, subtracted before alignment. Default: {} */
+		latencyMs: Record<string, number>;
 	};
 }
 
@@ -47,6 +54,9 @@ export function readConfig(): EcuExplorerConfig {
 		logsFolder: config.get<string>("logsFolder", "logs"),
 		logging: {
 			columns: config.get<string[] | "all">("logging.columns", "all"),
+			sampleIntervalMs: config.get<number>("logging.sampleIntervalMs", 0),
+			interpolation: config.get<ResampleMode>("logging.interpolation", "hold"),
+			latencyMs: config.get<Record<string, number>>("logging.latencyMs", {}),
 		},
 	};
 }
@@ -29,7 +29,6 @@ export async function exportActiveTableCsvFlow(
 	}
 
 	const snapshot = snapshotTable(activeTableDef, activeRom.bytes);
-	const csv = snapshotToCsv(snapshot);
 	const defaultUri = vscode.Uri.file(
 		new URL(
 			`./${sanitizeFilename(snapshot.name)}.csv`,
@@ -42,7 +41,7 @@ export async function exportActiveTableCsvFlow(
 		saveLabel: "Export CSV",
 	});
 	if (!uri) return;
-	await vscode.workspace.fs.writeFile(uri, new TextEncoder().encode(csv));
+	await vscode.workspace.fs.writeFile(uri, encodeSnapshotCsv(snapshot));
 	vscode.window.showInformationMessage(`Exported ${snapshot.name} to CSV.`);
 }
 
@@ -67,14 +66,54 @@ export function sanitizeFilename(input: string): string {
  * @returns CSV formatted string
  */
 export function snapshotToCsv(snapshot: TableSnapshot): string {
+	return Array.from(csvLines(snapshot)).join("\n");
+}
+
+/**
+ * Encode a table snapshot as UTF-8 CSV
+ *
+ * Lines are encoded one at a time into a buffer that grows as needed, so the
+ * CSV text is never built up as one string before encoding.
+ *
+ * @param snapshot - Table snapshot to convert
+ * @returns Same content as {@link snapshotToCsv}, UTF-8 encoded
+ */
+export function encodeSnapshotCsv(snapshot: TableSnapshot): Uint8Array {
+	const encoder = new TextEncoder();
+	const cells =
+		snapshot.kind === "table1d"
+			? snapshot.rows * 2
+			: (snapshot.rows + 1) * (snapshot.cols + 1);
+	let buffer = new Uint8Array(Math.max(64, cells * 8));
+	let length = 0;
+	let first = true;
+	for (const line of csvLines(snapshot)) {
+		const text = first ? line : `\n${line}`;
+		first = false;
+		// UTF-8 needs at most 3 bytes per UTF-16 code unit
+		if (buffer.length - length < text.length * 3) {
+			const grown = new Uint8Array(
+				Math.max(buffer.length * 2, length + text.length * 3),
+			);
+			grown.set(buffer.subarray(0, length));
+			buffer = grown;
+		}
+		length += encoder.encodeInto(text, buffer.subarray(length)).written;
+	}
+	return buffer.subarray(0, length);
+}
+
+/**
+ * Yield the lines of a snapshot's CSV representation
+ */
+function* csvLines(snapshot: TableSnapshot): Generator<string> {
 	if (snapshot.kind === "table1d") {
-		const header = ["x", "value"];
-		const lines = [header.join(",")];
+		yield "x,value";
 		for (let i = 0; i < snapshot.z.length; i++) {
 			const x = snapshot.x ? snapshot.x[i] : i;
-			lines.push(`${x},${snapshot.z[i]}`);
+			yield `${x},${snapshot.z[i]}`;
 		}
-		return lines.join("\n");
+		return;
 	}
 
 	const header = [""].concat(
@@ -82,11 +121,10 @@ export function snapshotToCsv(snapshot: TableSnapshot): string {
 			String,
 		),
 	);
-	const lines = [header.join(",")];
+	yield header.join(",");
 	for (let r = 0; r < snapshot.rows; r++) {
 		const y = snapshot.y ? snapshot.y[r] : r;
 		const row = snapshot.z[r] ?? [];
-		lines.push([String(y)].concat(row.map(String)).join(","));
+		yield [String(y)].concat(row.map(String)).join(",");
 	}
-	return lines.join("\n");
 }
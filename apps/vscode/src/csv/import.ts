@@ -11,11 +11,18 @@ import type { EditTransaction } from "@ecu-explorer/ui";
 import * as vscode from "vscode";
 import type { TableEditSession } from "../history/table-edit-session.js";
 import type { RomDocument } from "../rom/document.js";
-import { csvToSnapshot, parseCsv, type TableSnapshot } from "./parser.js";
+import { transferableBuffer } from "../workers/operations.js";
+import type { RomTaskRunner } from "../workers/task-runner.js";
+import { sanitizeFilename } from "./export.js";
+import {
+	type CsvTableData,
+	csvTableShape,
+	type TableSnapshot,
+} from "./parser.js";
 import {
 	generateImportPreview,
 	showImportPreviewDialog,
-	validateDimensions,
+	validateCsvTable,
 } from "./validation.js";
 
 /**
@@ -44,6 +51,7 @@ function getRomDocumentForPanel(
  * @param activePanel - Active webview panel
  * @param tableSession - Table edit session for this table
  * @param panelToDocument - Map of panels to documents
+ * @param taskRunner - Runs CSV parsing off the extension host thread
  */
 export async function importTableFromCsvFlow(
 	_ctx: vscode.ExtensionContext,
@@ -53,6 +61,7 @@ export async function importTableFromCsvFlow(
 	activePanel: vscode.WebviewPanel | null,
 	tableSession: TableEditSession | null,
 	panelToDocument: Map<vscode.WebviewPanel, RomDocument>,
+	taskRunner: RomTaskRunner,
 ) {
 	if (!activeRom || !activeTableName || !activeTableDef || !activePanel) {
 		vscode.window.showWarningMessage("Open a table first.");
@@ -73,17 +82,18 @@ export async function importTableFromCsvFlow(
 	if (!selectedUri) return;
 
 	try {
-		// Read CSV file
+		// Read CSV file; parsing checks its shape against the table as it goes
 		const csvContent = await vscode.workspace.fs.readFile(selectedUri);
-		const csvData = parseCsv(new TextDecoder().decode(csvContent));
-
-		if (csvData.length === 0) {
+		if (csvContent.length === 0) {
 			vscode.window.showErrorMessage("CSV file is empty.");
 			return;
 		}
 
-		// Parse CSV based on table type
-		const result = csvToSnapshot(csvData, activeTableDef);
+		const result = await taskRunner.run(
+			"parseCsvTable",
+			{ content: csvContent, shape: csvTableShape(activeTableDef) },
+			{ transfer: transferableBuffer(csvContent) },
+		);
 
 		if (!result.success) {
 			vscode.window.showErrorMessage(`CSV import failed: ${result.error}`);
@@ -93,20 +103,9 @@ export async function importTableFromCsvFlow(
 		// Get current snapshot for comparison
 		const currentSnapshot = snapshotTable(activeTableDef, activeRom.bytes);
 
-		// Validate dimensions match
-		if (!validateDimensions(result.snapshot, currentSnapshot)) {
-			vscode.window.showErrorMessage(
-				`CSV dimensions don't match table. Expected ${currentSnapshot.rows} rows` +
-					(currentSnapshot.kind === "table2d"
-						? ` x ${currentSnapshot.cols} columns`
-						: ""),
-			);
-			return;
-		}
-
 		// Generate import preview with validation
 		const preview = generateImportPreview(
-			result.snapshot,
+			result.data,
 			currentSnapshot,
 			activeTableDef,
 		);
@@ -118,8 +117,8 @@ export async function importTableFromCsvFlow(
 		}
 
 		// Apply changes to ROM
-		await applySnapshotToRom(
-			result.snapshot,
+		await applyCsvTableToRom(
+			result.data,
 			activeTableDef,
 			activeRom,
 			activePanel,
@@ -137,6 +136,194 @@ export async function importTableFromCsvFlow(
 	}
 }
 
+/**
+ * Handle CSV folder import flow
+ *
+ * Prompts the user for a folder and imports every CSV file whose name
+ * matches a table of the active ROM, as written by the CSV export
+ * (`<table name>.csv`). All files are parsed and validated before anything is
+ * written, and the changes are recorded as a single undo/redo operation.
+ *
+ * @param activeRom - Current active ROM instance
+ * @param activeTableDef - Definition of the active table
+ * @param activePanel - Active webview panel
+ * @param tableSession - Table edit session that records the import
+ * @param panelToDocument - Map of panels to documents
+ * @param taskRunner - Parses the CSV files off the extension host thread
+ */
+export async function importTablesFromCsvFolderFlow(
+	activeRom: RomInstance | null,
+	activeTableDef: TableDefinition | null,
+	activePanel: vscode.WebviewPanel | null,
+	tableSession: TableEditSession | null,
+	panelToDocument: Map<vscode.WebviewPanel, RomDocument>,
+	taskRunner: RomTaskRunner,
+) {
+	if (!activeRom || !activeTableDef || !activePanel) {
+		vscode.window.showWarningMessage("Open a table first.");
+		return;
+	}
+
+	const uri = await vscode.window.showOpenDialog({
+		canSelectFiles: false,
+		canSelectFolders: true,
+		canSelectMany: false,
+		openLabel: "Import CSV Folder",
+	});
+	const folder = uri?.[0];
+	if (!folder) return;
+
+	try {
+		const tablesByFile = new Map<string, TableDefinition>();
+		for (const table of activeRom.definition.tables) {
+			const fileName = `${sanitizeFilename(table.name)}.csv`.toLowerCase();
+			if (!tablesByFile.has(fileName)) {
+				tablesByFile.set(fileName, table);
+			}
+		}
+
+		const files: { fileName: string; def: TableDefinition }[] = [];
+		let unmatched = 0;
+		for (const [fileName, type] of await vscode.workspace.fs.readDirectory(
+			folder,
+		)) {
+			if (
+				type !== vscode.FileType.File ||
+				!fileName.toLowerCase().endsWith(".csv")
+			) {
+				continue;
+			}
+			const def = tablesByFile.get(fileName.toLowerCase());
+			if (def) {
+				files.push({ fileName, def });
+			} else {
+				unmatched++;
+			}
+		}
+
+		// Parse every file concurrently; the task runner spreads them over its
+		// workers
+		const parsed = await vscode.window.withProgress(
+			{
+				location: vscode.ProgressLocation.Notification,
+				title: `Reading ${files.length} CSV file(s)`,
+				cancellable: true,
+			},
+			(_progress, token) =>
+				Promise.all(
+					files.map(async ({ fileName, def }) => {
+						const content = await vscode.workspace.fs.readFile(
+							vscode.Uri.joinPath(folder, fileName),
+						);
+						const result = await taskRunner.run(
+							"parseCsvTable",
+							{ content, shape: csvTableShape(def) },
+							{ transfer: transferableBuffer(content), token },
+						);
+						return { fileName, def, result };
+					}),
+				),
+		);
+
+		const imports: { def: TableDefinition; data: CsvTableData }[] = [];
+		const failures: string[] = [];
+		let errorCount = 0;
+		for (const { fileName, def, result } of parsed) {
+			if (!result.success) {
+				failures.push(`${fileName}: ${result.error}`);
+				continue;
+			}
+			errorCount += validateCsvTable(result.data, def, 0).invalidCount;
+			imports.push({ def, data: result.data });
+		}
+
+		if (imports.length === 0) {
+			vscode.window.showErrorMessage(
+				failures.length > 0
+					? `CSV import failed: ${failures[0]}`
+					: "No CSV files in the folder match a table of this ROM.",
+			);
+			return;
+		}
+
+		let message = `Import ${imports.length} table(s) from CSV?\n\n`;
+		if (failures.length > 0) {
+			message += `⚠️ ${failures.length} file(s) could not be imported\n`;
+			for (const failure of failures.slice(0, 3)) {
+				message += `  • ${failure}\n`;
+			}
+			if (failures.length > 3) {
+				message += `  ... and ${failures.length - 3} more\n`;
+			}
+			message += "\n";
+		}
+		if (unmatched > 0) {
+			message += `ℹ️ ${unmatched} file(s) don't match a table and will be skipped\n`;
+		}
+		if (errorCount > 0) {
+			message += `⚠️ ${errorCount} validation error(s)\n`;
+		}
+		const action = errorCount > 0 ? "Import Anyway" : "Import";
+		const choice =
+			errorCount > 0 || failures.length > 0
+				? await vscode.window.showErrorMessage(
+						message,
+						{ modal: true },
+						"Cancel",
+						action,
+					)
+				: await vscode.window.showInformationMessage(
+						message,
+						{ modal: true },
+						"Cancel",
+						action,
+					);
+		if (choice !== action) {
+			return;
+		}
+
+		if (!tableSession) {
+			throw new Error("Table edit session not initialized");
+		}
+
+		// Write every table, then record and report the whole import at once
+		const document = getRomDocumentForPanel(activePanel, panelToDocument);
+		const edits: EditTransaction["edits"][number][] = [];
+		let start = Number.POSITIVE_INFINITY;
+		let end = 0;
+		for (const { def, data } of imports) {
+			const range = writeCsvTable(data, def, activeRom.bytes, edits, document);
+			start = Math.min(start, range.offset);
+			end = Math.max(end, range.offset + range.length);
+		}
+
+		if (edits.length > 0) {
+			tableSession.recordTransaction({
+				label: `Import CSV folder (${imports.length} tables)`,
+				timestamp: Date.now(),
+				edits,
+			});
+			document?.updateBytes(activeRom.bytes, start, end - start);
+		}
+
+		await activePanel.webview.postMessage({
+			type: "snapshot",
+			snapshot: snapshotTable(activeTableDef, activeRom.bytes),
+		});
+
+		vscode.window.showInformationMessage(
+			`Imported ${imports.length} table(s) from CSV.`,
+		);
+	} catch (error) {
+		if (error instanceof vscode.CancellationError) {
+			return;
+		}
+		vscode.window.showErrorMessage(
+			`Failed to import CSV folder: ${error instanceof Error ? error.message : String(error)}`,
+		);
+	}
+}
+
 /**
  * Apply imported snapshot data to ROM
  *
@@ -157,70 +344,56 @@ export async function applySnapshotToRom(
 	panel: vscode.WebviewPanel,
 	tableSession: TableEditSession | null,
 	panelToDocument: Map<vscode.WebviewPanel, RomDocument>,
+): Promise<void> {
+	const cols = snapshot.kind === "table2d" ? snapshot.cols : 1;
+	const data: CsvTableData = {
+		kind: snapshot.kind,
+		name: snapshot.name,
+		rows: snapshot.rows,
+		cols,
+		z:
+			snapshot.kind === "table1d"
+				? Float64Array.from(snapshot.z)
+				: Float64Array.from(snapshot.z.flatMap((row) => row.slice(0, cols))),
+	};
+	await applyCsvTableToRom(
+		data,
+		def,
+		rom,
+		panel,
+		tableSession,
+		panelToDocument,
+	);
+}
+
+/**
+ * Apply parsed CSV data to ROM
+ *
+ * Converts the values back to raw bytes and writes them to ROM, creating a
+ * batch undo/redo operation for all changes.
+ *
+ * @param data - Parsed CSV data
+ * @param def - Table definition
+ * @param rom - ROM instance to update
+ * @param panel - Webview panel for sending updates
+ * @param tableSession - Table edit session
+ * @param panelToDocument - Map of panels to documents
+ */
+export async function applyCsvTableToRom(
+	data: CsvTableData,
+	def: TableDefinition,
+	rom: RomInstance,
+	panel: vscode.WebviewPanel,
+	tableSession: TableEditSession | null,
+	panelToDocument: Map<vscode.WebviewPanel, RomDocument>,
 ): Promise<void> {
 	if (!tableSession) {
 		throw new Error("Table edit session not initialized");
 	}
 
+	const document = getRomDocumentForPanel(panel, panelToDocument);
 	const edits: EditTransaction["edits"][number][] = [];
-
-	if (snapshot.kind === "table1d") {
-		const t = def as Table1DDefinition;
-		const width = sizeOf(t.z.dtype);
-		const stride = t.z.rowStrideBytes ?? width;
-
-		for (let row = 0; row < snapshot.z.length; row++) {
-			const address = (t.z.address ?? 0) + row * stride;
-			const oldValue = rom.bytes.slice(address, address + width);
-
-			// Convert scaled value back to raw value
-			const scaledValue = snapshot.z[row];
-			if (scaledValue === undefined) continue;
-			const rawValue = (scaledValue - (t.z.offset ?? 0)) / (t.z.scale ?? 1);
-			const newValue = encodeScalar(rawValue, t.z.dtype, t.z.endianness);
-
-			edits.push({
-				address,
-				before: oldValue,
-				after: newValue,
-				label: `Import CSV row ${row}`,
-				metadata: { row, col: 0 },
-			});
-
-			rom.bytes.set(newValue, address);
-		}
-	} else if (snapshot.kind === "table2d") {
-		const t = def as Table2DDefinition;
-		const width = sizeOf(t.z.dtype);
-		const colStride = t.z.colStrideBytes ?? width;
-		const rowStride = t.z.rowStrideBytes ?? t.cols * colStride;
-
-		for (let row = 0; row < snapshot.rows; row++) {
-			const zRow = snapshot.z[row];
-			if (!zRow) continue;
-
-			for (let col = 0; col < zRow.length; col++) {
-				const address = (t.z.address ?? 0) + row * rowStride + col * colStride;
-				const oldValue = rom.bytes.slice(address, address + width);
-
-				// Convert scaled value back to raw value
-				const scaledValue = zRow[col];
-				if (scaledValue === undefined) continue;
-				const rawValue = (scaledValue - (t.z.offset ?? 0)) / (t.z.scale ?? 1);
-				const newValue = encodeScalar(rawValue, t.z.dtype, t.z.endianness);
-
-				edits.push({
-					address,
-					before: oldValue,
-					after: newValue,
-					label: `Import CSV cell (${row}, ${col})`,
-					metadata: { row, col },
-				});
-
-				rom.bytes.set(newValue, address);
-			}
-		}
-	}
+	const range = writeCsvTable(data, def, rom.bytes, edits, document);
 
 	if (edits.length > 0) {
 		const transaction: EditTransaction = {
@@ -232,21 +405,9 @@ export async function applySnapshotToRom(
 	}
 
 	// Mark the RomDocument as dirty
-	const document = getRomDocumentForPanel(panel, panelToDocument);
 	if (document) {
 		// For batch operations, we use the table's address and total length
-		const width = sizeOf(def.z.dtype);
-		let length = 0;
-		if (def.kind === "table1d") {
-			const t = def as Table1DDefinition;
-			length = t.rows * (t.z.rowStrideBytes ?? width);
-		} else {
-			const t = def as Table2DDefinition;
-			const colStride = t.z.colStrideBytes ?? width;
-			const rowStride = t.z.rowStrideBytes ?? t.cols * colStride;
-			length = t.rows * rowStride;
-		}
-		document.updateBytes(rom.bytes, def.z.address, length);
+		document.updateBytes(rom.bytes, range.offset, range.length);
 	}
 
 	// Send updated snapshot to webview
@@ -256,3 +417,62 @@ export async function applySnapshotToRom(
 		snapshot: newSnapshot,
 	});
 }
+
+/**
+ * Encode parsed CSV values into a table's cells
+ *
+ * Writes the raw bytes into `bytes` and appends one edit per cell to `edits`.
+ * The table's range is announced to `document` before any byte changes.
+ *
+ * @returns Byte range covered by the table's values
+ */
+function writeCsvTable(
+	data: CsvTableData,
+	def: TableDefinition,
+	bytes: Uint8Array,
+	edits: EditTransaction["edits"][number][],
+	document: RomDocument | undefined,
+): { offset: number; length: number } {
+	const t = def as Table1DDefinition | Table2DDefinition;
+	const width = sizeOf(t.z.dtype);
+	const scale = t.z.scale ?? 1;
+	const offset = t.z.offset ?? 0;
+	const base = t.z.address ?? 0;
+	let colStride = 0;
+	let rowStride: number;
+	if (def.kind === "table1d") {
+		rowStride = t.z.rowStrideBytes ?? width;
+	} else {
+		colStride = t.z.colStrideBytes ?? width;
+		rowStride = t.z.rowStrideBytes ?? (t as Table2DDefinition).cols * colStride;
+	}
+	const range = { offset: base, length: t.rows * rowStride };
+	document?.prepareEdit(range.offset, range.length);
+
+	for (let row = 0; row < data.rows; row++) {
+		for (let col = 0; col < data.cols; col++) {
+			const address = base + row * rowStride + col * colStride;
+			const oldValue = bytes.slice(address, address + width);
+
+			// Convert scaled value back to raw value
+			const scaledValue = data.z[row * data.cols + col] as number;
+			const rawValue = (scaledValue - offset) / scale;
+			const newValue = encodeScalar(rawValue, t.z.dtype, t.z.endianness);
+
+			edits.push({
+				address,
+				before: oldValue,
+				after: newValue,
+				label:
+					data.kind === "table1d"
+						? `Import CSV row ${row}`
+						: `Import CSV cell (${row}, ${col})`,
+				metadata: { row, col },
+			});
+
+			bytes.set(newValue, address);
+		}
+	}
+
+	return range;
+}
@@ -2,36 +2,56 @@
  * CSV utilities module
  *
  * Provides functions for:
- * - Parsing CSV files into table snapshots
+ * - Parsing CSV files into table snapshots or typed arrays
+ * - Parsing live-data log CSVs into columns
  * - Exporting table data to CSV format
- * - Importing CSV data into tables with validation
+ * - Importing CSV data into tables (or a folder of CSVs into a ROM) with
+ *   validation
  * - Validating imported data with error/warning reporting
  */
 
 // Export functions
 export {
+	encodeSnapshotCsv,
 	exportActiveTableCsvFlow,
 	sanitizeFilename,
 	snapshotToCsv,
 } from "./export.js";
 // Import functions
-export { applySnapshotToRom, importTableFromCsvFlow } from "./import.js";
+export {
+	applyCsvTableToRom,
+	applySnapshotToRom,
+	importTableFromCsvFlow,
+	importTablesFromCsvFolderFlow,
+} from "./import.js";
+// Log parsing
+export { type LogCsvColumns, parseLogCsvColumns } from "./log-columns.js";
 // Parser functions
 export {
+	type CsvTableData,
 	csvToSnapshot,
 	parseCsv,
 	parseCsv1D,
 	parseCsv2D,
+	parseCsvTable,
 	type TableSnapshot,
 } from "./parser.js";
+// Tokenizer
+export {
+	type CsvNumberSink,
+	CsvNumberTokenizer,
+	tokenizeCsvBytes,
+} from "./tokenizer.js";
 
 // Validation functions and types
 export {
 	generateImportPreview,
+	getCsvPreviewValues,
 	getPreviewValues,
 	type ImportPreview,
 	showImportPreviewDialog,
 	type ValidationError,
 	type ValidationWarning,
+	validateCsvTable,
 	validateDimensions,
 } from "./validation.js";
@@ -0,0 +1,96 @@
+import {
+	type CsvNumberSink,
+	CsvNumberTokenizer,
+	tokenizeCsvBytes,
+} from "./tokenizer.js";
+
+/**
+ * A live-data log held as one typed array per column
+ */
+export interface LogCsvColumns {
+	/** Column names from the header row */
+	headers: string[];
+	rowCount: number;
+	/** Values per column, parallel to `headers`; NaN where a cell is empty */
+	columns: Float64Array[];
+}
+
+const INITIAL_CAPACITY = 1024;
+
+/**
+ * Collects data rows of a log into growable columns
+ */
+class LogColumnsSink implements CsvNumberSink {
+	readonly headers: string[] = [];
+	private columns: Float64Array[] = [];
+	private capacity = INITIAL_CAPACITY;
+	private dataRows = 0;
+	private skipRow = -1;
+
+	field(row: number, col: number, value: number, text?: string): void {
+		if (row === 0) {
+			this.headers.push(text ?? String(value));
+			return;
+		}
+		// The logging manager writes a units row ("Unit,rpm,...") after the header
+		if (row === 1 && col === 0 && text?.toLowerCase() === "unit") {
+			this.skipRow = 1;
+		}
+		if (row === this.skipRow) return;
+		const column = this.columns[col];
+		if (column) column[this.dataRows] = value;
+	}
+
+	endRow(row: number): void {
+		if (row === 0) {
+			this.columns = this.headers.map(() =>
+				new Float64Array(this.capacity).fill(Number.NaN),
+			);
+			return;
+		}
+		if (row === this.skipRow) return;
+		this.dataRows++;
+		if (this.dataRows === this.capacity) this.grow();
+	}
+
+	finish(): LogCsvColumns {
+		return {
+			headers: this.headers,
+			rowCount: this.dataRows,
+			columns: this.columns.map((column) => column.slice(0, this.dataRows)),
+		};
+	}
+
+	private grow(): void {
+		this.capacity *= 2;
+		this.columns = this.columns.map((column) => {
+			const next = new Float64Array(this.capacity).fill(Number.NaN);
+			next.set(column);
+			return next;
+		});
+	}
+}
+
+/**
+ * Parse a live-data log CSV into columns
+ *
+ * Expects the layout written by the logging manager: a header row, an
+ * optional units row starting with `Unit`, then numeric rows. Fields beyond
+ * the header are ignored and short rows leave NaN in the missing columns.
+ *
+ * @param content - CSV file bytes (UTF-8) or text
+ * @returns Headers and columns of the log
+ */
+export function parseLogCsvColumns(
+	content: Uint8Array | string,
+): LogCsvColumns {
+	const sink = new LogColumnsSink();
+	if (typeof content === "string") {
+		const tokenizer = new CsvNumberTokenizer(sink);
+		tokenizer.push(content);
+		tokenizer.end();
+	} else {
+		tokenizeCsvBytes(content, sink);
+	}
+	return sink.finish();
+}
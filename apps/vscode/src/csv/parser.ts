@@ -3,6 +3,11 @@ import type {
 	Table2DDefinition,
 	TableDefinition,
 } from "@ecu-explorer/core";
+import {
+	type CsvNumberSink,
+	CsvNumberTokenizer,
+	tokenizeCsvBytes,
+} from "./tokenizer.js";
 
 /**
  * Table snapshot type - represents the current data in a table
@@ -210,3 +215,241 @@ export function parseCsv2D(
 		snapshot,
 	};
 }
+
+/**
+ * Table data parsed from CSV into typed arrays
+ *
+ * `z` holds `rows * cols` values in row-major order (`cols` is 1 for 1D
+ * tables).
+ */
+export interface CsvTableData {
+	kind: "table1d" | "table2d";
+	name: string;
+	rows: number;
+	cols: number;
+	x?: Float64Array;
+	y?: Float64Array;
+	z: Float64Array;
+}
+
+/**
+ * Dimensions of the table a CSV is parsed into
+ *
+ * Plain data, so it can be sent to a worker thread along with the CSV.
+ */
+export interface CsvTableShape {
+	kind: TableDefinition["kind"];
+	name: string;
+	rows: number;
+	cols?: number;
+}
+
+/**
+ * Get the parts of a table definition that {@link parseCsvTable} needs
+ */
+export function csvTableShape(def: TableDefinition): CsvTableShape {
+	return {
+		kind: def.kind,
+		name: def.name,
+		rows: def.rows,
+		...(def.kind === "table2d"
+			? { cols: (def as Table2DDefinition).cols }
+			: {}),
+	};
+}
+
+/**
+ * Parse CSV straight into typed arrays sized from the table definition
+ *
+ * The CSV is tokenized in a single pass and its shape is checked as rows
+ * arrive, so a file with the wrong dimensions fails at the first offending
+ * row instead of after the whole file has been split into strings. Accepts
+ * the same layouts as {@link csvToSnapshot}.
+ *
+ * @param content - CSV file bytes (UTF-8) or text
+ * @param def - Definition (or shape) of the table the CSV is imported into
+ * @returns Result with table data or error
+ */
+export function parseCsvTable(
+	content: Uint8Array | string,
+	def: CsvTableShape,
+):
+	| { success: true; data: CsvTableData }
+	| { success: false; error: string } {
+	if (def.kind !== "table1d" && def.kind !== "table2d") {
+		return {
+			success: false,
+			error: "3D tables are not yet supported for CSV import",
+		};
+	}
+	const sink =
+		def.kind === "table1d"
+			? new Table1DCsvSink(def)
+			: new Table2DCsvSink({ ...def, cols: def.cols ?? 0 });
+	try {
+		if (typeof content === "string") {
+			const tokenizer = new CsvNumberTokenizer(sink);
+			tokenizer.push(content);
+			tokenizer.end();
+		} else {
+			tokenizeCsvBytes(content, sink);
+		}
+		return { success: true, data: sink.finish() };
+	} catch (error) {
+		return {
+			success: false,
+			error: error instanceof Error ? error.message : String(error),
+		};
+	}
+}
+
+/**
+ * Collects `x,value` rows after a header into a 1D table
+ */
+class Table1DCsvSink implements CsvNumberSink {
+	private readonly x: Float64Array;
+	private readonly z: Float64Array;
+	private dataRows = 0;
+
+	constructor(private readonly def: CsvTableShape) {
+		this.x = new Float64Array(def.rows);
+		this.z = new Float64Array(def.rows);
+	}
+
+	field(row: number, col: number, value: number, text?: string): void {
+		if (row === 0 || col > 1) {
+			return;
+		}
+		const index = row - 1;
+		if (index >= this.def.rows) {
+			throw new Error(
+				`CSV dimensions don't match table. Expected ${this.def.rows} rows`,
+			);
+		}
+		if (Number.isNaN(value)) {
+			throw new Error(`Invalid numeric value in row ${row}: ${text ?? ""}`);
+		}
+		(col === 0 ? this.x : this.z)[index] = value;
+	}
+
+	endRow(row: number, fieldCount: number): void {
+		if (row === 0) {
+			return;
+		}
+		if (fieldCount < 2) {
+			throw new Error(
+				`Invalid row format: expected 2 columns, got ${fieldCount}`,
+			);
+		}
+		this.dataRows++;
+	}
+
+	finish(): CsvTableData {
+		if (this.dataRows === 0) {
+			throw new Error("No data rows found in CSV");
+		}
+		if (this.dataRows !== this.def.rows) {
+			throw new Error(
+				`CSV dimensions don't match table. Expected ${this.def.rows} rows`,
+			);
+		}
+		return {
+			kind: "table1d",
+			name: this.def.name,
+			rows: this.def.rows,
+			cols: 1,
+			x: this.x,
+			z: this.z,
+		};
+	}
+}
+
+/**
+ * Collects a header of x values and rows of `y,z...` into a 2D table
+ */
+class Table2DCsvSink implements CsvNumberSink {
+	private readonly x: Float64Array;
+	private readonly y: Float64Array;
+	private readonly z: Float64Array;
+	private xCount = 0;
+	private yComplete = true;
+	private dataRows = 0;
+
+	constructor(private readonly def: CsvTableShape & { cols: number }) {
+		this.x = new Float64Array(def.cols);
+		this.y = new Float64Array(def.rows);
+		this.z = new Float64Array(def.rows * def.cols);
+	}
+
+	field(row: number, col: number, value: number, text?: string): void {
+		const { rows, cols } = this.def;
+		if (row === 0) {
+			// Non-numeric column labels are skipped
+			if (col > 0 && !Number.isNaN(value) && this.xCount < cols) {
+				this.x[this.xCount++] = value;
+			}
+			return;
+		}
+		const index = row - 1;
+		if (index >= rows) {
+			throw new Error(
+				`CSV dimensions don't match table. Expected ${rows} rows x ${cols} columns`,
+			);
+		}
+		if (col === 0) {
+			if (Number.isNaN(value)) {
+				this.yComplete = false;
+			} else {
+				this.y[index] = value;
+			}
+			return;
+		}
+		if (col > cols) {
+			throw new Error(
+				`CSV dimensions don't match table. Row ${row} has more than ${cols} columns`,
+			);
+		}
+		if (Number.isNaN(value)) {
+			throw new Error(
+				`Invalid numeric value at row ${row}, col ${col}: ${text ?? ""}`,
+			);
+		}
+		this.z[index * cols + col - 1] = value;
+	}
+
+	endRow(row: number, fieldCount: number): void {
+		if (row === 0) {
+			return;
+		}
+		if (fieldCount < 2) {
+			throw new Error(`Invalid row ${row}: expected at least 2 columns`);
+		}
+		if (fieldCount - 1 !== this.def.cols) {
+			throw new Error(
+				`CSV dimensions don't match table. Row ${row} has ${fieldCount - 1} of ${this.def.cols} columns`,
+			);
+		}
+		this.dataRows++;
+	}
+
+	finish(): CsvTableData {
+		const { rows, cols } = this.def;
+		if (this.dataRows === 0) {
+			throw new Error("CSV must have at least header and one data row");
+		}
+		if (this.dataRows !== rows) {
+			throw new Error(
+				`CSV dimensions don't match table. Expected ${rows} rows x ${cols} columns`,
+			);
+		}
+		return {
+			kind: "table2d",
+			name: this.def.name,
+			rows,
+			cols,
+			...(this.xCount === cols ? { x: this.x } : {}),
+			...(this.yComplete ? { y: this.y } : {}),
+			z: this.z,
+		};
+	}
+}
@@ -0,0 +1,207 @@
+/**
+ * Streaming CSV tokenizer for numeric tables
+ *
+ * Scans CSV text once, chunk by chunk, and hands each field to a sink as a
+ * number. Plain decimal fields are parsed straight from the character
+ * codes, so no per-line or per-cell strings are allocated; anything else
+ * falls back to `Number.parseFloat` on the trimmed field.
+ */
+
+/** Characters decoded per chunk by {@link tokenizeCsvBytes} */
+const DECODE_CHUNK_SIZE = 64 * 1024;
+
+const COMMA = 0x2c;
+const CR = 0x0d;
+const SPACE = 0x20;
+const TAB = 0x09;
+const PLUS = 0x2b;
+const MINUS = 0x2d;
+const DOT = 0x2e;
+const ZERO = 0x30;
+const NINE = 0x39;
+
+// Exact powers of ten; dividing an exact integer by one of these is a
+// single correctly rounded operation, which matches parseFloat
+const POWERS_OF_TEN = Array.from({ length: 23 }, (_, i) => 10 ** i);
+
+/**
+ * Receives the fields of a CSV file
+ */
+export interface CsvNumberSink {
+	/**
+	 * Called for each field of a non-blank line
+	 *
+	 * @param row - Index of the line among non-blank lines (header is 0)
+	 * @param col - Index of the field within the line
+	 * @param value - Parsed value, or NaN if the field is not numeric
+	 * @param text - The trimmed field, only provided when `value` is NaN
+	 */
+	field(row: number, col: number, value: number, text?: string): void;
+	/**
+	 * Called after the last field of a non-blank line
+	 *
+	 * @param row - Index of the line among non-blank lines
+	 * @param fieldCount - Number of fields on the line
+	 */
+	endRow(row: number, fieldCount: number): void;
+}
+
+/**
+ * Incremental CSV tokenizer
+ *
+ * Feed text with {@link push} as it arrives and call {@link end} once. Only
+ * the unterminated tail of the previous chunk is carried over. Blank lines
+ * are skipped and fields are split on commas (quoted fields are not
+ * supported, as with {@link parseCsv}).
+ *
+ * Errors thrown by the sink propagate out of `push`/`end`, which lets a sink
+ * stop at the first malformed line.
+ */
+export class CsvNumberTokenizer {
+	private pending = "";
+	private row = 0;
+
+	constructor(private readonly sink: CsvNumberSink) {}
+
+	push(chunk: string): void {
+		const text = this.pending.length > 0 ? this.pending + chunk : chunk;
+		let lineStart = 0;
+		for (;;) {
+			const newline = text.indexOf("\n", lineStart);
+			if (newline === -1) {
+				break;
+			}
+			this.line(text, lineStart, newline);
+			lineStart = newline + 1;
+		}
+		this.pending = text.slice(lineStart);
+	}
+
+	end(): void {
+		if (this.pending.length > 0) {
+			this.line(this.pending, 0, this.pending.length);
+			this.pending = "";
+		}
+	}
+
+	private line(text: string, start: number, end: number): void {
+		if (end > start && text.charCodeAt(end - 1) === CR) {
+			end--;
+		}
+		let blank = true;
+		for (let i = start; i < end; i++) {
+			if (!isSpace(text.charCodeAt(i))) {
+				blank = false;
+				break;
+			}
+		}
+		if (blank) {
+			return;
+		}
+
+		let col = 0;
+		let fieldStart = start;
+		for (let i = start; i <= end; i++) {
+			if (i < end && text.charCodeAt(i) !== COMMA) {
+				continue;
+			}
+			let from = fieldStart;
+			let to = i;
+			while (from < to && isSpace(text.charCodeAt(from))) from++;
+			while (to > from && isSpace(text.charCodeAt(to - 1))) to--;
+
+			let value = parseDecimal(text, from, to);
+			let fieldText: string | undefined;
+			if (Number.isNaN(value)) {
+				fieldText = text.slice(from, to);
+				value = Number.parseFloat(fieldText);
+			}
+			this.sink.field(
+				this.row,
+				col,
+				value,
+				Number.isNaN(value) ? fieldText : undefined,
+			);
+			col++;
+			fieldStart = i + 1;
+		}
+		this.sink.endRow(this.row, col);
+		this.row++;
+	}
+}
+
+/**
+ * Decode and tokenize CSV bytes in chunks, so the whole file never has to
+ * exist as one string
+ */
+export function tokenizeCsvBytes(
+	bytes: Uint8Array,
+	sink: CsvNumberSink,
+): void {
+	const decoder = new TextDecoder();
+	const tokenizer = new CsvNumberTokenizer(sink);
+	for (let offset = 0; offset < bytes.length; offset += DECODE_CHUNK_SIZE) {
+		tokenizer.push(
+			decoder.decode(bytes.subarray(offset, offset + DECODE_CHUNK_SIZE), {
+				stream: true,
+			}),
+		);
+	}
+	tokenizer.push(decoder.decode());
+	tokenizer.end();
+}
+
+function isSpace(code: number): boolean {
+	return code === SPACE || code === TAB;
+}
+
+/**
+ * Parse `[+-]digits[.digits]` from `text[start, end)`
+ *
+ * @returns The value, or NaN if the field has any other form or more
+ *   significant digits than can be converted exactly (the caller then
+ *   falls back to parseFloat)
+ */
+function parseDecimal(text: string, start: number, end: number): number {
+	let i = start;
+	let negative = false;
+	const sign = text.charCodeAt(i);
+	if (sign === MINUS || sign === PLUS) {
+		negative = sign === MINUS;
+		i++;
+	}
+
+	let mantissa = 0;
+	let significantDigits = 0;
+	let exponent = 0;
+	let sawDigit = false;
+	let sawDot = false;
+	for (; i < end; i++) {
+		const code = text.charCodeAt(i);
+		if (code >= ZERO && code <= NINE) {
+			sawDigit = true;
+			if (mantissa > 0 || code !== ZERO) {
+				if (++significantDigits > 15) {
+					return Number.NaN;
+				}
+			}
+			mantissa = mantissa * 10 + (code - ZERO);
+			if (sawDot) {
+				exponent--;
+			}
+		} else if (code === DOT && !sawDot) {
+			sawDot = true;
+		} else {
+			return Number.NaN;
+		}
+	}
+	if (!sawDigit || -exponent >= POWERS_OF_TEN.length) {
+		return Number.NaN;
+	}
+
+	const value =
+		exponent === 0
+			? mantissa
+			: mantissa / (POWERS_OF_TEN[-exponent] as number);
+	return negative ? -value : value;
+}
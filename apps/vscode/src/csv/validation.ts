@@ -1,11 +1,15 @@
 import type {
+	BulkValidationResult,
 	Table1DDefinition,
 	Table2DDefinition,
 	TableDefinition,
 } from "@ecu-explorer/core";
-import { validateValue } from "@ecu-explorer/core";
+import { validateValuesBulk } from "@ecu-explorer/core";
 import * as vscode from "vscode";
-import type { TableSnapshot } from "./parser.js";
+import type { CsvTableData, TableSnapshot } from "./parser.js";
+
+/** Number of invalid values an import preview reports in detail */
+export const MAX_PREVIEW_ERRORS = 100;
 
 /**
  * Import preview data for user confirmation
@@ -15,6 +19,9 @@ export interface ImportPreview {
 	dimensions: { rows: number; cols?: number };
 	beforeValues: number[][] | number[];
 	afterValues: number[][] | number[];
+	/** Total number of invalid values */
+	errorCount: number;
+	/** Details for the first {@link MAX_PREVIEW_ERRORS} invalid values */
 	errors: ValidationError[];
 	warnings: ValidationWarning[];
 	scaleOffsetMismatch?: {
@@ -80,79 +87,34 @@ export function validateDimensions(
  * Generate import preview with validation
  */
 export function generateImportPreview(
-	imported: TableSnapshot,
+	imported: CsvTableData,
 	current: TableSnapshot,
 	def: TableDefinition,
 ): ImportPreview {
-	const errors: ValidationError[] = [];
 	const warnings: ValidationWarning[] = [];
 
-	// Validate all imported values
-	if (imported.kind === "table1d") {
-		const t = def as Table1DDefinition;
-		for (let i = 0; i < imported.z.length; i++) {
-			const value = imported.z[i];
-			if (value === undefined) continue;
-
-			const context = {
-				dtype: t.z.dtype,
-				min: undefined,
-				max: undefined,
-				scale: t.z.scale,
-				offset: t.z.offset,
+	const { cols } = imported;
+	const validation = validateCsvTable(imported, def);
+	const errors = validation.failures.map(
+		({ index, value, result }): ValidationError => {
+			const errorItem: ValidationError = {
+				row: Math.floor(index / cols),
+				value,
+				error: result.error || "Invalid value",
 			};
-
-			const result = validateValue(value, context);
-			if (!result.valid) {
-				const errorItem: ValidationError = {
-					row: i,
-					value,
-					error: result.error || "Invalid value",
-				};
-				if (result.suggestion) {
-					errorItem.suggestion = result.suggestion;
-				}
-				errors.push(errorItem);
+			if (imported.kind === "table2d") {
+				errorItem.col = index % cols;
 			}
-		}
-	} else if (imported.kind === "table2d") {
-		const t = def as Table2DDefinition;
-		for (let row = 0; row < imported.z.length; row++) {
-			const zRow = imported.z[row];
-			if (!zRow) continue;
-
-			for (let col = 0; col < zRow.length; col++) {
-				const value = zRow[col];
-				if (value === undefined) continue;
-
-				const context = {
-					dtype: t.z.dtype,
-					min: undefined,
-					max: undefined,
-					scale: t.z.scale,
-					offset: t.z.offset,
-				};
-
-				const result = validateValue(value, context);
-				if (!result.valid) {
-					const errorItem: ValidationError = {
-						row,
-						col,
-						value,
-						error: result.error || "Invalid value",
-					};
-					if (result.suggestion) {
-						errorItem.suggestion = result.suggestion;
-					}
-					errors.push(errorItem);
-				}
+			if (result.suggestion) {
+				errorItem.suggestion = result.suggestion;
 			}
-		}
-	}
+			return errorItem;
+		},
+	);
 
 	// Get first 5 rows for preview
 	const beforeValues = getPreviewValues(current, 5);
-	const afterValues = getPreviewValues(imported, 5);
+	const afterValues = getCsvPreviewValues(imported, 5);
 
 	const dimensions: { rows: number; cols?: number } = {
 		rows: imported.rows,
@@ -166,11 +128,38 @@ export function generateImportPreview(
 		dimensions,
 		beforeValues,
 		afterValues,
+		errorCount: validation.invalidCount,
 		errors,
 		warnings,
 	};
 }
 
+/**
+ * Validate all imported values in one pass over the row-major values
+ *
+ * @param data - Parsed CSV data
+ * @param def - Table definition the data is imported into
+ * @param maxFailures - Number of invalid values to report in detail
+ */
+export function validateCsvTable(
+	data: CsvTableData,
+	def: TableDefinition,
+	maxFailures = MAX_PREVIEW_ERRORS,
+): BulkValidationResult {
+	const z = (def as Table1DDefinition | Table2DDefinition).z;
+	return validateValuesBulk(
+		data.z,
+		{
+			dtype: z.dtype,
+			min: undefined,
+			max: undefined,
+			scale: z.scale,
+			offset: z.offset,
+		},
+		{ maxFailures },
+	);
+}
+
 /**
  * Get preview values (first N rows)
  */
@@ -185,13 +174,29 @@ export function getPreviewValues(
 	}
 }
 
+/**
+ * Get preview values (first N rows) of parsed CSV data
+ */
+export function getCsvPreviewValues(
+	data: CsvTableData,
+	maxRows: number,
+): number[][] | number[] {
+	const rows = Math.min(maxRows, data.rows);
+	if (data.kind === "table1d") {
+		return Array.from(data.z.subarray(0, rows));
+	}
+	return Array.from({ length: rows }, (_, row) =>
+		Array.from(data.z.subarray(row * data.cols, (row + 1) * data.cols)),
+	);
+}
+
 /**
  * Show import preview dialog
  */
 export async function showImportPreviewDialog(
 	preview: ImportPreview,
 ): Promise<boolean> {
-	const errorCount = preview.errors.length;
+	const errorCount = preview.errorCount;
 	const warningCount = preview.warnings.length;
 
 	let message = `Import ${preview.tableName}?\n\n`;
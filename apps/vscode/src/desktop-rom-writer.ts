@@ -0,0 +1,62 @@
+import * as fs from "node:fs/promises";
+import type { RomRangeWriter } from "./rom/save-manager.js";
+
+/**
+ * Range writer that patches ROM files with positional writes, so saving an
+ * edited ROM only rewrites the pages that changed
+ *
+ * Files are identified by inode, size and nanosecond mtime; a file that was
+ * replaced or touched since it was stamped is never patched.
+ */
+export function createDesktopRomRangeWriter(): RomRangeWriter {
+	return {
+		async stamp(romPath) {
+			try {
+				return formatStamp(await fs.stat(romPath, { bigint: true }));
+			} catch {
+				return null;
+			}
+		},
+
+		async writeRanges(romPath, stamp, byteLength, ranges) {
+			let handle: fs.FileHandle;
+			try {
+				handle = await fs.open(romPath, "r+");
+			} catch {
+				return null;
+			}
+			try {
+				const stats = await handle.stat({ bigint: true });
+				if (
+					stats.size !== BigInt(byteLength) ||
+					formatStamp(stats) !== stamp
+				) {
+					return null;
+				}
+				for (const { offset, bytes } of ranges) {
+					let written = 0;
+					while (written < bytes.length) {
+						const result = await handle.write(
+							bytes,
+							written,
+							bytes.length - written,
+							offset + written,
+						);
+						written += result.bytesWritten;
+					}
+				}
+				return formatStamp(await handle.stat({ bigint: true }));
+			} finally {
+				await handle.close();
+			}
+		},
+	};
+}
+
+function formatStamp(stats: {
+	ino: bigint;
+	size: bigint;
+	mtimeNs: bigint;
+}): string {
+	return `${stats.ino}:${stats.size}:${stats.mtimeNs}`;
+}
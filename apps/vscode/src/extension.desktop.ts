@@ -1,18 +1,26 @@
 import { createNodeSerialRuntime } from "@ecu-explorer/hardware-runtime-node";
 import type * as vscode from "vscode";
+import { createDesktopRomRangeWriter } from "./desktop-rom-writer.js";
 import {
 	activate as activateShared,
 	deactivate as deactivateShared,
 } from "./extension.js";
 import { registerMcpProvider } from "./mcp-provider.js";
 import { createOpenPortDesktopRuntime } from "./openport2-desktop-runtime.js";
+import { RomWorkerPool } from "./workers/pool.js";
 
 export async function activate(ctx: vscode.ExtensionContext) {
 	const serialRuntime = await createNodeSerialRuntime();
+	const romWorkerPool = new RomWorkerPool(
+		ctx.asAbsolutePath("dist/rom-worker.cjs"),
+	);
+	ctx.subscriptions.push(romWorkerPool);
 	await activateShared(ctx, {
 		hardwareLocality: "extension-host",
 		openPortRuntime: await createOpenPortDesktopRuntime(serialRuntime),
 		widebandSerialRuntime: serialRuntime,
+		romRangeWriter: createDesktopRomRangeWriter(),
+		romTaskRunner: romWorkerPool,
 	});
 	registerMcpProvider(ctx);
 }
@@ -2,10 +2,14 @@ import {
 	type DefinitionProvider,
 	decodeScalarBytes,
 	type RomInstance,
+	type RomSnapshot,
 	snapshotTable,
 	type TableDefinition,
 } from "@ecu-explorer/core";
-import { EcuFlashProvider } from "@ecu-explorer/definitions-ecuflash";
+import {
+	EcuFlashProvider,
+	RomIdIndex,
+} from "@ecu-explorer/definitions-ecuflash";
 import type { EcuEvent, RomProgress } from "@ecu-explorer/device";
 import type {
 	HardwareLocality,
@@ -26,20 +30,26 @@ import {
 	reconnectPreferredWideband,
 } from "./auto-reconnect.js";
 import {
+	handleClearLogOverlay,
 	handleMathOpAdd,
 	handleMathOpClamp,
 	handleMathOpFormula,
 	handleMathOpMultiply,
 	handleMathOpSmooth,
+	handleOverlayLogOnActiveTable,
 	handlePasteSpecialFormula,
 	handleRedo,
 	handleUndo,
 	setEditCommandsContext,
 	setGraphCommandsContext,
+	setLogOverlayCommandsContext,
 } from "./commands/index.js";
 import { readConfig } from "./config.js";
 import { exportActiveTableCsvFlow } from "./csv/export.js";
-import { importTableFromCsvFlow } from "./csv/import.js";
+import {
+	importTableFromCsvFlow,
+	importTablesFromCsvFolderFlow,
+} from "./csv/import.js";
 import { DeviceManagerImpl } from "./device-manager.js";
 import { DeviceStatusBarManager } from "./device-status-bar.js";
 import { GraphPanelManager } from "./graph-panel-manager.js";
@@ -58,12 +68,14 @@ import { selectHardwareCandidateFromSource } from "./hardware-source.js";
 import type { TableEditSession } from "./history/table-edit-session.js";
 import { LiveDataPanelManager } from "./live-data-panel-manager.js";
 import { LoggingManager, openLogsFolder } from "./logging-manager.js";
+import { ChecksumStatusBar } from "./rom/checksum-status-bar.js";
 import { resolveRomDefinition } from "./rom/definition-resolver.js";
 import type { RomDocument } from "./rom/document.js";
 import {
 	RomEditorProvider,
 	TableEditorDelegate,
 } from "./rom/editor-provider.js";
+import type { RomRangeWriter } from "./rom/save-manager.js";
 import { RomSymbolProvider } from "./rom/symbol-provider.js";
 import { TableFileSystemProvider } from "./table-fs-provider.js";
 import { createTableUri, parseTableUri } from "./table-fs-uri.js";
@@ -76,12 +88,18 @@ import {
 	promptForWidebandMode,
 	WidebandSerialHardwareSource,
 } from "./wideband-serial-source.js";
+import {
+	InlineRomTaskRunner,
+	type RomTaskRunner,
+} from "./workers/task-runner.js";
 import { WorkspaceState } from "./workspace-state.js";
 
 type ActivationOptions = {
 	openPortRuntime?: ConstructorParameters<typeof OpenPort2Transport>[0];
 	hardwareLocality?: HardwareLocality;
 	widebandSerialRuntime?: SerialRuntime;
+	romRangeWriter?: RomRangeWriter;
+	romTaskRunner?: RomTaskRunner;
 };
 
 class ProviderRegistry {
@@ -114,20 +132,7 @@ let widebandManager: WidebandManager | null = null;
 let editorProvider: RomEditorProvider | null = null; // Will be set during activation
 let workspaceState: WorkspaceState | null = null; // Workspace state manager
 let activeWidebandMode: "afr" | "lambda" | undefined;
-
-function bytesEqual(a: Uint8Array, b: Uint8Array): boolean {
-	if (a.length !== b.length) {
-		return false;
-	}
-
-	for (let i = 0; i < a.length; i++) {
-		if (a[i] !== b[i]) {
-			return false;
-		}
-	}
-
-	return true;
-}
+let romIdIndex: RomIdIndex | null = null; // Definition headers, kept across provider re-creation
 
 function getActiveRomPathForCacheClear(): string | null {
 	if (activeRom) {
@@ -368,7 +373,11 @@ function reinitializeProviders(): void {
 
 	// Only instantiate if enabled
 	if (enabledProviders.includes("ecuflash")) {
-		registry.register(new EcuFlashProvider(allEcuflashPaths));
+		registry.register(
+			new EcuFlashProvider(allEcuflashPaths, {
+				...(romIdIndex ? { romIdIndex } : {}),
+			}),
+		);
 	}
 }
 
@@ -383,9 +392,25 @@ export async function activate(
 	ctx: vscode.ExtensionContext,
 	options?: ActivationOptions,
 ) {
+	// Persist definition headers next to the extension's global state so
+	// scanning the metadata directory is incremental across sessions
+	romIdIndex = new RomIdIndex(
+		ctx.globalStorageUri.scheme === "file"
+			? {
+					path: vscode.Uri.joinPath(
+						ctx.globalStorageUri,
+						"ecuflash-romid-index.json",
+					).fsPath,
+				}
+			: {},
+	);
+
 	// Initialize providers based on current settings
 	reinitializeProviders();
 
+	// Heavy ROM operations run on worker threads where the host provides them
+	const romTaskRunner = options?.romTaskRunner ?? new InlineRomTaskRunner();
+
 	// Initialize GraphPanelManager
 	graphPanelManager = new GraphPanelManager(
 		ctx,
@@ -495,6 +520,7 @@ export async function activate(
 				activePanel,
 				activeTableSession,
 				panelToDocument,
+				romTaskRunner,
 			);
 		},
 		openTableInCustomEditor,
@@ -537,6 +563,13 @@ export async function activate(
 		editorProvider,
 	}));
 
+	setLogOverlayCommandsContext(() => ({
+		activePanel,
+		activeTableDef,
+		activeRomBytes: activeRom?.bytes ?? null,
+		editorProvider,
+	}));
+
 	workspaceState = new WorkspaceState(ctx.workspaceState);
 
 	// Initialize DeviceManager and register transport/protocol
@@ -981,6 +1014,17 @@ export async function activate(
 				activePanel,
 				activeTableSession,
 				panelToDocument,
+				romTaskRunner,
+			),
+		),
+		vscode.commands.registerCommand("rom.importTablesCsvFolder", () =>
+			importTablesFromCsvFolderFlow(
+				activeRom,
+				activeTableDef,
+				activePanel,
+				activeTableSession,
+				panelToDocument,
+				romTaskRunner,
 			),
 		),
 		vscode.commands.registerCommand("rom.saveRom", async () => {
@@ -1348,6 +1392,14 @@ export async function activate(
 			"ecuExplorer.open3DGraphForActiveTable",
 			() => handleOpenGraph(),
 		),
+		// Log overlay commands
+		vscode.commands.registerCommand(
+			"ecuExplorer.overlayLogOnActiveTable",
+			() => handleOverlayLogOnActiveTable(),
+		),
+		vscode.commands.registerCommand("ecuExplorer.clearLogOverlay", () =>
+			handleClearLogOverlay(),
+		),
 		vscode.commands.registerCommand(
 			"ecuExplorer.open2DGraph",
 			async (treeItem?: RomTreeItem) => {
@@ -1369,10 +1421,11 @@ export async function activate(
 	// Set of URI strings currently being saved by the extension.
 	// Used to suppress spurious file watcher callbacks for self-initiated saves.
 	const savingRomUris = new Set<string>();
-	// Tracks the exact bytes written by the most recent self-save for each ROM.
+	// Tracks the version written by the most recent self-save for each ROM.
 	// The next watcher event carrying these bytes is ignored even if it arrives
 	// after the coarse save-in-progress suppression window has expired.
-	const pendingSavedRomBytes = new Map<string, Uint8Array>();
+	// Snapshots share pages with the live document instead of copying it.
+	const pendingSavedRomBytes = new Map<string, RomSnapshot>();
 
 	// Register CustomEditorProvider for native dirty marker support
 	const newEditorProvider = new RomEditorProvider(
@@ -1385,7 +1438,7 @@ export async function activate(
 		(savedDocument) => {
 			pendingSavedRomBytes.set(
 				savedDocument.uri.toString(),
-				new Uint8Array(savedDocument.romBytes),
+				savedDocument.pages.savedSnapshot(),
 			);
 
 			// Mark the current history position as the clean baseline for all
@@ -1417,6 +1470,8 @@ export async function activate(
 				await panel.webview.postMessage(result.message);
 			}
 		},
+		options?.romRangeWriter,
+		romTaskRunner,
 	);
 	editorProvider = newEditorProvider;
 	// Create a separate delegate for table editor registration.
@@ -1427,6 +1482,7 @@ export async function activate(
 	// RomEditorProvider._onDidChangeTableDocument, keeping the two event streams separate.
 	const tableEditorDelegate = new TableEditorDelegate(newEditorProvider);
 	ctx.subscriptions.push(
+		new ChecksumStatusBar(newEditorProvider),
 		vscode.window.registerCustomEditorProvider(
 			"romViewer.editor",
 			newEditorProvider,
@@ -1497,7 +1553,7 @@ export async function activate(
 					await vscode.workspace.fs.readFile(uri),
 				);
 				const pendingSavedBytes = pendingSavedRomBytes.get(uriStr);
-				if (pendingSavedBytes && bytesEqual(newBytes, pendingSavedBytes)) {
+				if (pendingSavedBytes?.equals(newBytes)) {
 					pendingSavedRomBytes.delete(uriStr);
 					return;
 				}
@@ -1945,4 +2001,9 @@ export function deactivate() {
 		workspaceState.flush();
 		workspaceState = null;
 	}
+
+	if (romIdIndex) {
+		romIdIndex.dispose();
+		romIdIndex = null;
+	}
 }
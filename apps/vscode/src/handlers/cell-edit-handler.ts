@@ -167,10 +167,11 @@ export function handleCellEdit(
 	);
 
 	// Apply change to ROM
+	const document = state.getRomDocumentForPanel(panel);
+	document?.prepareEdit(address, newValue.length);
 	state.activeRom.bytes.set(newValue, address);
 
 	// Mark the RomDocument as dirty (enables native ● marker)
-	const document = state.getRomDocumentForPanel(panel);
 	console.log(
 		`[DEBUG] handleCellEdit: Got document=${!!document}, isDirty=${
 			document?.isDirty
@@ -469,10 +469,11 @@ export async function handleTableOpen(
 				);
 
 				// Apply change to ROM
+				const document = getRomDocumentForPanel(panel);
+				document?.prepareEdit(address, newValue.length);
 				activeRom.bytes.set(newValue, address);
 
 				// Mark the RomDocument as dirty
-				const document = getRomDocumentForPanel(panel);
 				console.log(
 					`[DEBUG] cellEdit: Got document=${!!document}, isDirty=${
 						document?.isDirty
@@ -633,6 +634,7 @@ export async function handleTableOpen(
 					let minAddress = Number.MAX_SAFE_INTEGER;
 					let maxAddress = 0;
 
+					const docRef = getRomDocumentForPanel(panel);
 					const edits: EditTransaction["edits"][number][] = [];
 					for (const edit of mathMsg.edits) {
 						const newValue = new Uint8Array(edit.after);
@@ -647,6 +649,7 @@ export async function handleTableOpen(
 							after: newValue,
 							label: `Math op: ${mathMsg.operation}`,
 						});
+						docRef?.prepareEdit(edit.address, newValue.length);
 						activeRom.bytes.set(newValue, edit.address);
 						minAddress = Math.min(minAddress, edit.address);
 						maxAddress = Math.max(maxAddress, edit.address + newValue.length);
@@ -661,7 +664,6 @@ export async function handleTableOpen(
 						tableSession.recordTransaction(transaction);
 					}
 
-					const docRef = getRomDocumentForPanel(panel);
 					if (docRef) {
 						docRef.updateBytes(
 							activeRom.bytes,
@@ -24,6 +24,7 @@ export class VsCodeHistoryExecutor<
 		options: ExecuteHistoryOptions = {},
 	): HistoryExecutionResult {
 		for (const edit of transaction.edits) {
+			this.document?.prepareEdit(edit.address, edit.after.length);
 			this.romBytes.set(edit.after, edit.address);
 		}
 
@@ -35,6 +36,7 @@ export class VsCodeHistoryExecutor<
 		options: ExecuteHistoryOptions = {},
 	): HistoryExecutionResult {
 		for (const edit of [...transaction.edits].reverse()) {
+			this.document?.prepareEdit(edit.address, edit.before.length);
 			this.romBytes.set(edit.before, edit.address);
 		}
 
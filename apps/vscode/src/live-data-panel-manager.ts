@@ -105,7 +105,7 @@ export class LiveDataPanelManager {
 			},
 			(health: LiveDataHealth) => {
 				console.log(
-					`[Live Data Health] status=${health.status} sps=${health.samplesPerSecond} dropped=${health.droppedFrames} latency=${health.latencyMs}ms`,
+					`[Live Data Health] status=${health.status} sps=${health.samplesPerSecond} dropped=${health.droppedFrames} latency=${health.latencyMs}ms rate=${health.achievedHz ?? "?"}/${health.requestedHz ?? "?"}Hz`,
 				);
 				if (health.status === "stalled" || health.status === "degraded") {
 					vscode.window.showWarningMessage(
@@ -1,3 +1,4 @@
+import { SampleFusion } from "@ecu-explorer/core";
 import type { LiveDataFrame, PidDescriptor } from "@ecu-explorer/device";
 import * as vscode from "vscode";
 import { readConfig } from "./config.js";
@@ -30,6 +31,11 @@ function isLoggingStartOptions(
  *
  * The CSV uses a wide format: one column per PID, named by PID name.
  * All data is accumulated in-memory and written atomically on stopLog().
+ *
+ * By default each sample is written on its own row as it arrives. When
+ * `logging.sampleIntervalMs` is set, samples are buffered per column and
+ * resampled onto a steady timebase instead (see {@link SampleFusion}), so
+ * every row holds time-aligned values from the ECU and the wideband.
  */
 export class LoggingManager implements vscode.Disposable {
 	private state: LoggingState = "idle";
@@ -37,14 +43,19 @@ export class LoggingManager implements vscode.Disposable {
 	private recordingUri: vscode.Uri | undefined;
 	private sessionStartMs = 0;
 	private columns: string[] | "all" = "all";
-	/** pid -> log column key */
-	private pidColumnKeys: Map<number, string> = new Map();
-	/** channel key -> log column key */
-	private channelColumnKeys: Map<string, string> = new Map();
+	/** pid -> CSV column index */
+	private pidColumns: Map<number, number> = new Map();
+	/** channel key -> CSV column index */
+	private channelColumns: Map<string, number> = new Map();
 	/** Ordered list of all log column keys for CSV positions */
 	private columnOrder: string[] = [];
 	private columnNames: Map<string, string> = new Map();
 	private columnUnits: Map<string, string> = new Map();
+	/** Time-aligned row buffer; null when samples are written as they arrive */
+	private fusion: SampleFusion | null = null;
+	/** How far behind the current time fused rows are emitted */
+	private fusionDelayMs = 0;
+	private fusionTimer: ReturnType<typeof setInterval> | undefined;
 
 	private _onDidChangeState = new vscode.EventEmitter<LoggingState>();
 	readonly onDidChangeState: vscode.Event<LoggingState> =
@@ -124,21 +135,21 @@ export class LoggingManager implements vscode.Disposable {
 		}
 
 		// Build column maps and order
-		this.pidColumnKeys.clear();
-		this.channelColumnKeys.clear();
+		this.pidColumns.clear();
+		this.channelColumns.clear();
 		this.columnNames.clear();
 		this.columnUnits.clear();
 		this.columnOrder = [];
 		for (const pid of filteredPids) {
 			const columnKey = `pid:${pid.pid}`;
-			this.pidColumnKeys.set(pid.pid, columnKey);
+			this.pidColumns.set(pid.pid, this.columnOrder.length);
 			this.columnNames.set(columnKey, pid.name);
 			this.columnUnits.set(columnKey, pid.unit);
 			this.columnOrder.push(columnKey);
 		}
 		for (const channel of channels) {
 			const columnKey = `channel:${channel.key}`;
-			this.channelColumnKeys.set(channel.key, columnKey);
+			this.channelColumns.set(channel.key, this.columnOrder.length);
 			this.columnNames.set(columnKey, channel.name);
 			this.columnUnits.set(columnKey, channel.unit);
 			this.columnOrder.push(columnKey);
@@ -159,6 +170,25 @@ export class LoggingManager implements vscode.Disposable {
 		this.csvBuffer = `${headerRow}\n${unitsRow}\n`;
 		this.sessionStartMs = Date.now();
 
+		const intervalMs = cfg.logging.sampleIntervalMs;
+		if (intervalMs > 0) {
+			const { interpolation, latencyMs } = cfg.logging;
+			const latencies = this.columnOrder.map((columnKey) => {
+				const name = this.columnNames.get(columnKey) ?? columnKey;
+				return latencyMs[name] ?? 0;
+			});
+			this.fusion = new SampleFusion(
+				latencies.map((latency) => ({
+					latencyMs: latency,
+					mode: interpolation,
+				})),
+				{ periodMs: intervalMs, originMs: this.sessionStartMs },
+			);
+			// Wait for the slowest column to report past a row before writing it
+			this.fusionDelayMs = Math.max(0, ...latencies) + intervalMs;
+			this.startFusionTimer();
+		}
+
 		this.state = "recording";
 		this._onDidChangeState.fire(this.state);
 
@@ -185,6 +215,8 @@ export class LoggingManager implements vscode.Disposable {
 			return;
 		}
 		this.state = "paused";
+		this.drainFusion(Date.now());
+		this.stopFusionTimer();
 		this._onDidChangeState.fire(this.state);
 
 		vscode.commands.executeCommand(
@@ -209,6 +241,11 @@ export class LoggingManager implements vscode.Disposable {
 			return;
 		}
 		this.state = "recording";
+		if (this.fusion) {
+			// Rows inside the pause are left out, as they are without alignment
+			this.fusion.seek(Date.now());
+			this.startFusionTimer();
+		}
 		this._onDidChangeState.fire(this.state);
 
 		vscode.commands.executeCommand(
@@ -235,6 +272,12 @@ export class LoggingManager implements vscode.Disposable {
 
 		const savedUri = this.recordingUri;
 
+		if (this.state === "recording") {
+			this.drainFusion(Date.now());
+		}
+		this.stopFusionTimer();
+		this.fusion = null;
+
 		this.state = "idle";
 		this._onDidChangeState.fire(this.state);
 
@@ -281,8 +324,8 @@ export class LoggingManager implements vscode.Disposable {
 		// Clear state
 		this.csvBuffer = "";
 		this.recordingUri = undefined;
-		this.pidColumnKeys.clear();
-		this.channelColumnKeys.clear();
+		this.pidColumns.clear();
+		this.channelColumns.clear();
 		this.columnNames.clear();
 		this.columnUnits.clear();
 		this.columnOrder = [];
@@ -303,12 +346,12 @@ export class LoggingManager implements vscode.Disposable {
 			return;
 		}
 
-		const columnKey = this.pidColumnKeys.get(frame.pid);
-		if (columnKey == null) {
+		const column = this.pidColumns.get(frame.pid);
+		if (column == null) {
 			return;
 		}
 
-		this.appendValue(frame.timestamp, columnKey, frame.value);
+		this.appendValue(frame.timestamp, column, frame.value);
 	}
 
 	onChannelSample(channelKey: string, timestamp: number, value: number): void {
@@ -316,12 +359,12 @@ export class LoggingManager implements vscode.Disposable {
 			return;
 		}
 
-		const columnKey = this.channelColumnKeys.get(channelKey);
-		if (columnKey == null) {
+		const column = this.channelColumns.get(channelKey);
+		if (column == null) {
 			return;
 		}
 
-		this.appendValue(timestamp, columnKey, value);
+		this.appendValue(timestamp, column, value);
 	}
 
 	/**
@@ -332,19 +375,47 @@ export class LoggingManager implements vscode.Disposable {
 	}
 
 	dispose(): void {
+		this.stopFusionTimer();
 		this._onDidChangeState.dispose();
 	}
 
-	private appendValue(
-		timestamp: number,
-		columnKey: string,
-		value: number,
-	): void {
+	private appendValue(timestamp: number, column: number, value: number): void {
+		if (this.fusion) {
+			this.fusion.push(column, timestamp, value);
+			return;
+		}
+
 		const relativeTs = timestamp - this.sessionStartMs;
-		const values = this.columnOrder.map((currentKey) =>
-			currentKey === columnKey ? String(value) : "",
-		);
-		this.csvBuffer += `${relativeTs},${values.join(",")}\n`;
+		const before = ",".repeat(column);
+		const after = ",".repeat(this.columnOrder.length - column - 1);
+		this.csvBuffer += `${relativeTs},${before}${value}${after}\n`;
+	}
+
+	private startFusionTimer(): void {
+		const fusion = this.fusion;
+		if (!fusion || this.fusionTimer !== undefined) {
+			return;
+		}
+		this.fusionTimer = setInterval(() => {
+			this.drainFusion(Date.now() - this.fusionDelayMs);
+		}, fusion.periodMs);
+	}
+
+	private stopFusionTimer(): void {
+		if (this.fusionTimer !== undefined) {
+			clearInterval(this.fusionTimer);
+			this.fusionTimer = undefined;
+		}
+	}
+
+	private drainFusion(untilMs: number): void {
+		this.fusion?.drain(untilMs, (timeMs, values) => {
+			let row = String(timeMs - this.sessionStartMs);
+			for (const value of values) {
+				row += Number.isNaN(value) ? "," : `,${value}`;
+			}
+			this.csvBuffer += `${row}\n`;
+		});
 	}
 }
 
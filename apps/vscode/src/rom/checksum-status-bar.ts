@@ -0,0 +1,124 @@
+import * as vscode from "vscode";
+import type { RomDocument } from "./document.js";
+import type { RomEditorProvider } from "./editor-provider.js";
+
+// Algorithms without incremental support recompute the full checksum on
+// read, so coalesce bursts of edits into one refresh
+const REFRESH_DELAY_MS = 100;
+
+/**
+ * Shows the checksum state of the ROM behind the active editor tab.
+ *
+ * The document's {@link RomDocument.checksum} is updated as edits land, so
+ * the item reflects the current bytes: valid, pending (edited, and will be
+ * written on save) or mismatched (the file on disk carries a wrong
+ * checksum). Hidden when the active tab is not a ROM or table editor, or
+ * the ROM's definition has no checksum.
+ */
+export class ChecksumStatusBar implements vscode.Disposable {
+	private readonly item: vscode.StatusBarItem;
+	private readonly disposables: vscode.Disposable[] = [];
+	private documentListeners: vscode.Disposable[] = [];
+	private document: RomDocument | undefined;
+	private refreshTimer: ReturnType<typeof setTimeout> | null = null;
+
+	constructor(private readonly editorProvider: RomEditorProvider) {
+		this.item = vscode.window.createStatusBarItem(
+			vscode.StatusBarAlignment.Right,
+			100,
+		);
+		this.item.name = "ROM Checksum";
+
+		this.disposables.push(
+			vscode.window.tabGroups.onDidChangeTabs(() => this.bindActiveDocument()),
+			vscode.window.tabGroups.onDidChangeTabGroups(() =>
+				this.bindActiveDocument(),
+			),
+			// The tab can become active before its document is registered
+			editorProvider.onDidOpenRomDocument(() => this.bindActiveDocument()),
+		);
+		this.bindActiveDocument();
+	}
+
+	private bindActiveDocument(): void {
+		const document = this.resolveActiveDocument();
+		if (document !== this.document) {
+			for (const listener of this.documentListeners) {
+				listener.dispose();
+			}
+			this.document = document;
+			this.documentListeners = document
+				? [
+						document.onDidChange(() => this.scheduleRefresh()),
+						document.onDidUpdateBytes(() => this.scheduleRefresh()),
+						document.onDidDispose(() => this.bindActiveDocument()),
+					]
+				: [];
+		}
+		this.refresh();
+	}
+
+	private resolveActiveDocument(): RomDocument | undefined {
+		const input = vscode.window.tabGroups.activeTabGroup.activeTab?.input;
+		if (!(input instanceof vscode.TabInputCustom)) {
+			return undefined;
+		}
+		return (
+			this.editorProvider.getDocument(input.uri) ??
+			this.editorProvider.getTableDocument(input.uri)?.romDocument
+		);
+	}
+
+	private scheduleRefresh(): void {
+		this.refreshTimer ??= setTimeout(() => {
+			this.refreshTimer = null;
+			this.refresh();
+		}, REFRESH_DELAY_MS);
+	}
+
+	private refresh(): void {
+		const document = this.document;
+		const checksum = document?.checksum;
+		if (!document || !checksum) {
+			this.item.hide();
+			return;
+		}
+
+		let expected: number;
+		let stored: number;
+		try {
+			expected = checksum.expected;
+			stored = checksum.stored;
+		} catch (error) {
+			this.item.text = "$(error) Checksum";
+			this.item.tooltip = `Checksum could not be computed: ${error instanceof Error ? error.message : String(error)}`;
+			this.item.show();
+			return;
+		}
+
+		const algorithm = document.definition?.checksum?.algorithm ?? "checksum";
+		const hex = (value: number) =>
+			`0x${value.toString(16).toUpperCase().padStart(8, "0")}`;
+		if (stored === expected) {
+			this.item.text = "$(pass) Checksum";
+			this.item.tooltip = `Checksum valid (${algorithm}: ${hex(stored)})`;
+		} else if (document.isDirty) {
+			this.item.text = "$(sync) Checksum";
+			this.item.tooltip = `Checksum will be updated on save (${algorithm}: ${hex(stored)} → ${hex(expected)})`;
+		} else {
+			this.item.text = "$(warning) Checksum";
+			this.item.tooltip = `Checksum mismatch (${algorithm}): stored ${hex(stored)}, expected ${hex(expected)}. Saving the ROM writes the correct value.`;
+		}
+		this.item.show();
+	}
+
+	dispose(): void {
+		if (this.refreshTimer != null) {
+			clearTimeout(this.refreshTimer);
+		}
+		for (const d of [...this.disposables, ...this.documentListeners]) {
+			d.dispose();
+		}
+		this.item.dispose();
+	}
+}
@@ -1,4 +1,8 @@
-import type { ROMDefinition } from "@ecu-explorer/core";
+import {
+	IncrementalChecksum,
+	PagedRom,
+	type ROMDefinition,
+} from "@ecu-explorer/core";
 import * as vscode from "vscode";
 
 /**
@@ -33,6 +37,8 @@ export class RomDocument implements vscode.CustomDocument {
 	private readonly _uri: vscode.Uri;
 	private _romBytes: Uint8Array;
 	private _definition: ROMDefinition | undefined;
+	private _checksum: IncrementalChecksum | null;
+	private readonly _pages: PagedRom;
 	private _isDirty = false;
 
 	private readonly _onDidChange = new vscode.EventEmitter<void>();
@@ -53,6 +59,8 @@ export class RomDocument implements vscode.CustomDocument {
 		this._uri = uri;
 		this._romBytes = romBytes;
 		this._definition = definition;
+		this._pages = new PagedRom(romBytes);
+		this._checksum = createChecksumState(this._pages, definition);
 	}
 
 	get uri(): vscode.Uri {
@@ -67,6 +75,22 @@ export class RomDocument implements vscode.CustomDocument {
 		return this._definition;
 	}
 
+	/**
+	 * Live checksum state, kept current as bytes change. `null` when the
+	 * definition has no checksum (or its checksum does not fit this ROM).
+	 */
+	get checksum(): IncrementalChecksum | null {
+		return this._checksum;
+	}
+
+	/**
+	 * Paged view of the ROM: which pages differ from the saved file, and
+	 * copy-on-write snapshots that share unchanged pages
+	 */
+	get pages(): PagedRom {
+		return this._pages;
+	}
+
 	get isDirty(): boolean {
 		return this._isDirty;
 	}
@@ -90,6 +114,17 @@ export class RomDocument implements vscode.CustomDocument {
 		this._onDidChange.fire();
 	}
 
+	/**
+	 * Announce an in-place write to `romBytes[offset, offset + length)`
+	 *
+	 * Call before changing the bytes, then report the change with
+	 * {@link updateBytes}. The pages being written are copied here so saves,
+	 * snapshots and the checksum still see what they held before.
+	 */
+	prepareEdit(offset: number, length: number): void {
+		this._pages.prepare(offset, length);
+	}
+
 	/**
 	 * Update ROM bytes, optionally marking the document as dirty
 	 * @param newBytes - New ROM bytes
@@ -105,6 +140,19 @@ export class RomDocument implements vscode.CustomDocument {
 		length?: number,
 		markDirty = true,
 	): void {
+		// Fold the edit into the checksum and pages before listeners read them
+		if (newBytes !== this._romBytes) {
+			this._pages.reset(newBytes);
+			this._checksum?.reset();
+			if (!markDirty) {
+				// Replacement bytes that are not dirty came from disk
+				this._pages.markSaved();
+			}
+		} else {
+			// The checksum reads the replaced bytes from the prepared pages
+			this._checksum?.update(offset, length);
+			this._pages.commit(offset, length);
+		}
 		this._romBytes = newBytes;
 		if (markDirty) {
 			this.makeDirty();
@@ -123,6 +171,7 @@ export class RomDocument implements vscode.CustomDocument {
 	 */
 	setDefinition(definition: ROMDefinition): void {
 		this._definition = definition;
+		this._checksum = createChecksumState(this._pages, definition);
 	}
 
 	/**
@@ -136,3 +185,21 @@ export class RomDocument implements vscode.CustomDocument {
 		this._onDidDispose.dispose();
 	}
 }
+
+function createChecksumState(
+	pages: PagedRom,
+	definition: ROMDefinition | undefined,
+): IncrementalChecksum | null {
+	if (!definition?.checksum) {
+		return null;
+	}
+	try {
+		return new IncrementalChecksum(pages, definition.checksum);
+	} catch (error) {
+		console.warn(
+			`[WARN] RomDocument: Checksum tracking disabled for ${definition.name}:`,
+			error,
+		);
+		return null;
+	}
+}
@@ -10,10 +10,11 @@ import {
 import { TableDocument } from "../table-document.js";
 import { isTableUri, parseTableUri } from "../table-fs-uri.js";
 import type { RomExplorerTreeProvider } from "../tree/rom-tree-provider.js";
+import type { RomTaskRunner } from "../workers/task-runner.js";
 import { WorkspaceState } from "../workspace-state.js";
 import { resolveRomDefinition } from "./definition-resolver.js";
 import { RomDocument } from "./document.js";
-import { RomSaveManager } from "./save-manager.js";
+import { type RomRangeWriter, RomSaveManager } from "./save-manager.js";
 
 async function parseDefinitionByUri(
 	providerRegistry: { list(): DefinitionProvider[] },
@@ -47,7 +48,7 @@ type TableDocumentEditAction = "undo" | "redo";
 export class RomEditorProvider
 	implements vscode.CustomEditorProvider<RomDocument | TableDocument>
 {
-	private readonly saveManager = new RomSaveManager();
+	private readonly saveManager: RomSaveManager;
 
 	/**
 	 * Emitter for ROM document changes (used by romViewer.editor registration).
@@ -119,7 +120,12 @@ export class RomEditorProvider
 			document: TableDocument,
 			action: TableDocumentEditAction,
 		) => Promise<void> | void,
+		/** Positional writer so saves only rewrite changed pages (desktop) */
+		romRangeWriter?: RomRangeWriter,
+		/** Runs post-save checksum validation off the extension host thread */
+		romTaskRunner?: RomTaskRunner,
 	) {
+		this.saveManager = new RomSaveManager(romRangeWriter, romTaskRunner);
 		this.stateManager = new WorkspaceState(context.workspaceState);
 		this.contextTracker = new OpenContextTracker();
 	}
@@ -281,7 +287,8 @@ export class RomEditorProvider
 			return existing;
 		}
 
-		// Read ROM file
+		// Read ROM file, stamping it first so saves can tell if it changed
+		const stamp = await this.saveManager.stampFile(uri.fsPath);
 		const romBytes = new Uint8Array(await vscode.workspace.fs.readFile(uri));
 
 		// Resolve the ROM definition (checks saved state, auto-matches, or prompts user)
@@ -294,6 +301,7 @@ export class RomEditorProvider
 
 		// Create document (definition may be undefined if user cancelled)
 		const document = new RomDocument(uri, romBytes, definition);
+		this.saveManager.trackFile(uri.fsPath, document.pages, stamp);
 
 		// Store document
 		this.documents.set(uri.toString(), document);
@@ -587,7 +595,12 @@ export class RomEditorProvider
 				const result = await this.saveManager.save({
 					romPath,
 					romData: document.romBytes,
+					pages: document.pages,
+					editor: document,
 					...(checksumDef ? { checksumDef } : {}),
+					...(document.checksum
+						? { checksumValue: document.checksum.expected }
+						: {}),
 					...(this.savingRomUris
 						? { savingUris: this.savingRomUris, uriStr }
 						: {}),
@@ -662,8 +675,13 @@ export class RomEditorProvider
 
 				const result = await this.saveManager.save({
 					romPath: destination.fsPath,
-					romData: new Uint8Array(document.romBytes),
+					romData: document.romBytes,
+					pages: document.pages,
+					editor: document,
 					...(checksumDef ? { checksumDef } : {}),
+					...(document.checksum
+						? { checksumValue: document.checksum.expected }
+						: {}),
 				});
 
 				if (result.ok) {
@@ -703,11 +721,13 @@ export class RomEditorProvider
 		}
 
 		// Reload ROM from disk
+		const stamp = await this.saveManager.stampFile(document.uri.fsPath);
 		const romBytes = new Uint8Array(
 			await vscode.workspace.fs.readFile(document.uri),
 		);
 		// Pass markDirty=false: reverting from disk should never dirty the document
 		document.updateBytes(romBytes, undefined, undefined, false);
+		this.saveManager.trackFile(document.uri.fsPath, document.pages, stamp);
 		document.makeClean();
 
 		// Clear all dirty tables for this ROM
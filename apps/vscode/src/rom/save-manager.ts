@@ -1,10 +1,16 @@
 import {
 	type ChecksumDefinition,
+	type ChecksumValidation,
+	type PagedRom,
+	type RomSnapshot,
+	readChecksum,
 	recomputeChecksum,
 	validateChecksum,
 	writeChecksum,
 } from "@ecu-explorer/core";
 import * as vscode from "vscode";
+import { transferableBuffer } from "../workers/operations.js";
+import type { RomTaskRunner } from "../workers/task-runner.js";
 
 /**
  * Result of a ROM save operation
@@ -13,6 +19,70 @@ export type SaveResult =
 	| { ok: true; checksumValid?: boolean }
 	| { ok: false; error: string };
 
+/**
+ * Bytes to write at an offset within a ROM file
+ */
+export interface RomRangeWrite {
+	offset: number;
+	bytes: Uint8Array;
+}
+
+/**
+ * Patches byte ranges of an existing ROM file in place (positional writes)
+ *
+ * Only available where the extension host has direct file access (desktop).
+ */
+export interface RomRangeWriter {
+	/**
+	 * Identify the version of a ROM file currently on disk
+	 *
+	 * @returns An opaque stamp that changes whenever the file does, or null
+	 *   if the file cannot be stat'ed
+	 */
+	stamp(romPath: string): Promise<string | null>;
+
+	/**
+	 * @param romPath - ROM file path
+	 * @param stamp - Stamp of the file version the ranges are diffed against
+	 * @param byteLength - Expected size of the file
+	 * @param ranges - Ranges to write
+	 * @returns Stamp of the patched file, or null if the file cannot be
+	 *   patched in place (missing, changed since `stamp`, or its size differs
+	 *   from `byteLength`); the caller then writes the whole ROM
+	 */
+	writeRanges(
+		romPath: string,
+		stamp: string,
+		byteLength: number,
+		ranges: readonly RomRangeWrite[],
+	): Promise<string | null>;
+}
+
+/**
+ * Owner of the bytes being saved, such as the `RomDocument` they belong to,
+ * through which in-place writes are announced to its listeners
+ */
+export interface RomBytesEditor {
+	/** Called before `romData[offset, offset + length)` is changed */
+	prepareEdit(offset: number, length: number): void;
+	/** Called once the range holds its new bytes */
+	updateBytes(
+		newBytes: Uint8Array,
+		offset?: number,
+		length?: number,
+		markDirty?: boolean,
+	): void;
+}
+
+/**
+ * File on disk that holds a paged ROM's saved contents
+ */
+interface SavedFile {
+	romPath: string;
+	/** {@link RomRangeWriter.stamp} of the file when it last matched */
+	stamp: string;
+}
+
 /**
  * Options for ROM save operations
  */
@@ -23,6 +93,24 @@ export interface SaveOptions {
 	romData: Uint8Array;
 	/** Checksum definition (optional - if provided, checksums will be recomputed) */
 	checksumDef?: ChecksumDefinition;
+	/**
+	 * Checksum already computed for `romData` (e.g. `RomDocument.checksum`).
+	 * When provided it is written as-is instead of recomputing over the ROM.
+	 */
+	checksumValue?: number;
+	/**
+	 * Paged state of `romData` (e.g. `RomDocument.pages`). When provided, only
+	 * pages changed since the last save are written (if the manager has a
+	 * range writer and `romPath` is unchanged since it was tracked or last
+	 * saved), and the written version is marked saved on success.
+	 */
+	pages?: PagedRom;
+	/**
+	 * Owner of `romData` (e.g. the `RomDocument` being saved). When provided,
+	 * the checksum is written through it so byte-update listeners see the
+	 * changed range; it is then responsible for committing `pages`.
+	 */
+	editor?: RomBytesEditor;
 	/**
 	 * Optional set of URI strings currently being saved by the extension.
 	 * When provided, the ROM file's URI string will be added to this set before
@@ -41,6 +129,43 @@ export interface SaveOptions {
  * Manages ROM save operations with checksum validation
  */
 export class RomSaveManager {
+	/** Files last read into or saved from each paged ROM */
+	private readonly savedFiles = new WeakMap<PagedRom, SavedFile>();
+
+	/**
+	 * @param rangeWriter - Positional writer used to save only dirty pages;
+	 *   without one, every save rewrites the whole file
+	 * @param taskRunner - Runs the post-save checksum validation (a full pass
+	 *   over the saved file) off the calling thread
+	 */
+	constructor(
+		private readonly rangeWriter?: RomRangeWriter,
+		private readonly taskRunner?: RomTaskRunner,
+	) {}
+
+	/**
+	 * Stamp a ROM file before reading it for {@link trackFile}
+	 *
+	 * @returns null without a range writer or when the file cannot be stat'ed
+	 */
+	async stampFile(romPath: string): Promise<string | null> {
+		return (await this.rangeWriter?.stamp(romPath)) ?? null;
+	}
+
+	/**
+	 * Record that `pages` were read from `romPath` as of `stamp`, so the next
+	 * save may patch just their dirty pages into it
+	 *
+	 * @param stamp - From {@link stampFile}, taken before the file was read
+	 */
+	trackFile(romPath: string, pages: PagedRom, stamp: string | null): void {
+		if (stamp === null) {
+			this.savedFiles.delete(pages);
+		} else {
+			this.savedFiles.set(pages, { romPath, stamp });
+		}
+	}
+
 	/**
 	 * Save ROM data with checksum recomputation
 	 *
@@ -62,7 +187,22 @@ export class RomSaveManager {
 	 * ```
 	 */
 	async save(options: SaveOptions): Promise<SaveResult> {
-		const { romPath, romData, checksumDef } = options;
+		const { romPath, romData, checksumDef, pages, editor } = options;
+
+		// Change romData in place, announcing the range to the editor (or at
+		// least the paged state) so nothing keeps serving the old bytes
+		const writeInPlace = (offset: number, size: number, write: () => void) => {
+			if (editor) {
+				editor.prepareEdit(offset, size);
+				write();
+				// Not an edit of its own: the document is clean once saved
+				editor.updateBytes(romData, offset, size, false);
+			} else {
+				pages?.prepare(offset, size);
+				write();
+				pages?.commit(offset, size);
+			}
+		};
 
 		try {
 			// Validate inputs
@@ -73,17 +213,20 @@ export class RomSaveManager {
 				return { ok: false, error: "ROM data is empty" };
 			}
 
-			// Recompute checksums if definition provided
-			let finalData = romData;
+			// Write the checksum (recomputing it unless the caller already has it)
+			// straight into romData. The bytes it replaces are kept so a failed
+			// save can put them back and leave the in-memory document untouched.
+			let replacedChecksumBytes: Uint8Array | undefined;
 			if (checksumDef) {
 				try {
-					// Recompute checksum value
-					const checksumValue = recomputeChecksum(romData, checksumDef);
-					// Write checksum to a copy first so a failed save does not mutate the
-					// in-memory document. On success we copy the persisted bytes back into
-					// the caller's buffer to keep all live references in sync with disk.
-					finalData = new Uint8Array(romData);
-					writeChecksum(finalData, checksumValue, checksumDef);
+					const checksumValue =
+						options.checksumValue ?? recomputeChecksum(romData, checksumDef);
+					const { offset, size } = checksumDef.storage;
+					const previous = romData.slice(offset, offset + size);
+					writeInPlace(offset, size, () => {
+						writeChecksum(romData, checksumValue, checksumDef);
+					});
+					replacedChecksumBytes = previous;
 				} catch (error) {
 					return {
 						ok: false,
@@ -98,13 +241,21 @@ export class RomSaveManager {
 				savingUris.add(uriStr);
 			}
 
-			// Write directly to file
+			// Write directly to file. With paged state, the snapshot pins the
+			// pages being written while later edits land in new ones.
+			const snapshot = pages?.snapshot();
 			let writeError: unknown;
 			try {
-				await vscode.workspace.fs.writeFile(
-					vscode.Uri.file(romPath),
-					finalData,
-				);
+				const patched =
+					pages && snapshot
+						? await this.writeDirtyPages(romPath, pages, snapshot)
+						: false;
+				if (!patched) {
+					await vscode.workspace.fs.writeFile(vscode.Uri.file(romPath), romData);
+					if (pages) {
+						this.trackFile(romPath, pages, await this.stampFile(romPath));
+					}
+				}
 			} catch (error) {
 				console.error(
 					"[ERROR] RomSaveManager.save: Failed to write file:",
@@ -128,15 +279,21 @@ export class RomSaveManager {
 				}
 			}
 			if (writeError !== undefined) {
+				if (checksumDef && replacedChecksumBytes) {
+					const { offset, size } = checksumDef.storage;
+					const replaced = replacedChecksumBytes;
+					writeInPlace(offset, size, () => {
+						romData.set(replaced, offset);
+					});
+				}
 				return {
 					ok: false,
 					error: `Failed to save ROM: ${writeError instanceof Error ? writeError.message : String(writeError)}`,
 				};
 			}
 
-			// Keep the in-memory ROM bytes aligned with what was persisted.
-			if (finalData !== romData) {
-				romData.set(finalData);
+			if (pages && snapshot) {
+				pages.markSaved(snapshot);
 			}
 
 			// Validate checksums after save if definition provided
@@ -146,7 +303,22 @@ export class RomSaveManager {
 					const savedData = new Uint8Array(
 						await vscode.workspace.fs.readFile(vscode.Uri.file(romPath)),
 					);
-					const validation = validateChecksum(savedData, checksumDef);
+					let validation: ChecksumValidation;
+					if (options.checksumValue !== undefined) {
+						// A precomputed checksum only needs to have reached the disk
+						const actual = readChecksum(savedData, checksumDef);
+						validation = {
+							valid: actual === options.checksumValue,
+							expected: options.checksumValue,
+							actual,
+							algorithm: checksumDef.algorithm,
+						};
+					} else {
+						validation = await this.validateSavedChecksum(
+							savedData,
+							checksumDef,
+						);
+					}
 					if (!validation.valid) {
 						return {
 							ok: false,
@@ -173,4 +345,57 @@ export class RomSaveManager {
 			};
 		}
 	}
+
+	/**
+	 * Validate the checksum of freshly read file contents
+	 *
+	 * `savedData` is owned by the caller's read, so it is handed to the task
+	 * runner without a copy. Custom checksum functions cannot leave this
+	 * thread and are validated here.
+	 */
+	private async validateSavedChecksum(
+		savedData: Uint8Array,
+		checksumDef: ChecksumDefinition,
+	): Promise<ChecksumValidation> {
+		if (!this.taskRunner || checksumDef.customFunction) {
+			return validateChecksum(savedData, checksumDef);
+		}
+		return this.taskRunner.run(
+			"validateChecksum",
+			{ bytes: savedData, checksum: checksumDef },
+			{ transfer: transferableBuffer(savedData) },
+		);
+	}
+
+	/**
+	 * Write only the pages of `snapshot` that differ from the last save
+	 *
+	 * @returns `false` when there is no range writer, `romPath` is not the
+	 *   file the pages were last read from or saved to, or it changed since
+	 */
+	private async writeDirtyPages(
+		romPath: string,
+		pages: PagedRom,
+		snapshot: RomSnapshot,
+	): Promise<boolean> {
+		const savedFile = this.savedFiles.get(pages);
+		if (!this.rangeWriter || savedFile?.romPath !== romPath) {
+			return false;
+		}
+		const ranges = pages.dirtyRanges().map(({ offset, length }) => ({
+			offset,
+			bytes: snapshot.read(offset, length),
+		}));
+		const stamp = await this.rangeWriter.writeRanges(
+			romPath,
+			savedFile.stamp,
+			snapshot.byteLength,
+			ranges,
+		);
+		if (stamp === null) {
+			return false;
+		}
+		savedFile.stamp = stamp;
+		return true;
+	}
 }
@@ -1,4 +1,4 @@
-import type { TableDefinition } from "@ecu-explorer/core";
+import { getTableSearchIndex, type TableDefinition } from "@ecu-explorer/core";
 import * as vscode from "vscode";
 import { createTableUri } from "../table-fs-uri.js";
 import type { RomExplorerTreeProvider } from "../tree/rom-tree-provider.js";
@@ -48,13 +48,15 @@ export class RomSymbolProvider implements vscode.WorkspaceSymbolProvider {
 			const romUri = vscode.Uri.parse(romUriString);
 			const romFileName = romUri.path.split("/").pop() || romUri.path;
 
-			// Create symbols for each table
-			for (const table of document.definition.tables) {
-				// Filter by query if provided (case-insensitive, relaxed matching)
-				if (query && !this.matchesQuery(table, query)) {
-					continue;
-				}
+			// Filter by query if provided (case-insensitive substring of name or
+			// category). The index is built once per definition and narrows the
+			// scan to tables sharing the query's trigrams.
+			const tables = query
+				? getTableSearchIndex(document.definition.tables).filter(query)
+				: document.definition.tables;
 
+			// Create symbols for each table
+			for (const table of tables) {
 				// Create table URI
 				const tableUri = createTableUri(romUri.fsPath, table.id, table.name);
 
@@ -76,25 +78,6 @@ export class RomSymbolProvider implements vscode.WorkspaceSymbolProvider {
 		return symbols;
 	}
 
-	/**
-	 * Match table against query string
-	 *
-	 * Uses relaxed matching: case-insensitive, checks if query characters
-	 * appear in order in the table name or category
-	 *
-	 * @param table - Table definition to match
-	 * @param query - Search query
-	 * @returns True if table matches query
-	 */
-	private matchesQuery(table: TableDefinition, query: string): boolean {
-		const lowerQuery = query.toLowerCase();
-		const lowerName = table.name.toLowerCase();
-		const lowerCategory = (table.category || "").toLowerCase();
-
-		// Check if query appears in name or category
-		return lowerName.includes(lowerQuery) || lowerCategory.includes(lowerQuery);
-	}
-
 	/**
 	 * Get appropriate symbol kind for table type
 	 *
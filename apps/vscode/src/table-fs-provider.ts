@@ -13,6 +13,10 @@
  *
  * Each table write updates the ROM file on disk immediately, and the provider
  * handles concurrent writes to the same ROM file.
+ *
+ * Table contents are materialized on first read and cached per ROM document
+ * and table ID. An edit only invalidates the tables whose bytes it touches,
+ * and `stat` is answered from the cache without reading the ROM file.
  */
 
 import type {
@@ -188,13 +192,41 @@ interface TableMetadata {
 }
 
 /**
- * Cache entry for table metadata
+ * Byte range a table reads from the ROM
  */
-interface TableCacheEntry {
-	romPath: string;
-	tableId: string;
+interface ByteRange {
+	offset: number;
+	length: number;
+}
+
+/**
+ * Cached state of one table, valid until an edit touches its bytes
+ */
+interface MaterializedTable {
 	definition: TableDefinition;
-	lastRead: number;
+	/** Byte ranges of the table's values and dynamic axes */
+	ranges: ByteRange[];
+	/** Encoded JSON; generated on the first read after a change */
+	content?: Uint8Array;
+	/** When the table's bytes last changed (ms since epoch, monotonic) */
+	mtime: number;
+	/** Table URIs that have been read or written, for change events */
+	uris: Set<string>;
+}
+
+/**
+ * Table cache for one ROM document
+ */
+interface RomTableCache {
+	definition: ROMDefinition;
+	/** Table definitions by ID */
+	definitions: Map<string, TableDefinition>;
+	/** Tables materialized so far, by ID */
+	tables: Map<string, MaterializedTable>;
+	/** ROM buffer the cached tables were read from */
+	bytes: Uint8Array;
+	ctime: number;
+	subscription: vscode.Disposable;
 }
 
 /**
@@ -213,8 +245,8 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 	// Cache of ROM documents by ROM path
 	private readonly romDocuments = new Map<string, RomDocument>();
 
-	// Cache of table metadata by URI
-	private readonly tableCache = new Map<string, TableCacheEntry>();
+	// Materialized tables by ROM path
+	private readonly tableCaches = new Map<string, RomTableCache>();
 
 	constructor(
 		private readonly providerRegistry: { list(): DefinitionProvider[] },
@@ -251,40 +283,17 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 	 * Extracts table data from ROM and encodes as JSON
 	 */
 	async readFile(uri: vscode.Uri): Promise<Uint8Array> {
-		const parsed = parseTableUri(uri);
-		if (!parsed) {
-			throw vscode.FileSystemError.FileNotFound(uri);
-		}
-
-		const { romPath, tableId } = parsed;
-
-		// Get or load ROM document
-		const romDoc = await this.getRomDocument(romPath);
-		if (!romDoc || !romDoc.definition) {
-			throw vscode.FileSystemError.FileNotFound(uri);
-		}
+		const { romDoc, table } = await this.resolveTable(uri);
 
-		// Find table definition
-		const tableDef = romDoc.definition.tables.find((t) => t.id === tableId);
-		if (!tableDef) {
-			throw vscode.FileSystemError.FileNotFound(uri);
+		// Extract and encode the table only if an edit invalidated it
+		if (!table.content) {
+			const tableData = this.extractTableData(romDoc, table);
+			table.content = new TextEncoder().encode(
+				JSON.stringify(tableData, null, 2),
+			);
 		}
 
-		// Extract table data
-		const tableData = this.extractTableData(romDoc, tableDef);
-
-		// Encode as JSON
-		const json = JSON.stringify(tableData, null, 2);
-
-		// Cache metadata
-		this.tableCache.set(uri.toString(), {
-			romPath,
-			tableId,
-			definition: tableDef,
-			lastRead: Date.now(),
-		});
-
-		return new TextEncoder().encode(json);
+		return table.content;
 	}
 
 	/**
@@ -297,24 +306,8 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 		content: Uint8Array,
 		_options: { create: boolean; overwrite: boolean },
 	): Promise<void> {
-		const parsed = parseTableUri(uri);
-		if (!parsed) {
-			throw vscode.FileSystemError.FileNotFound(uri);
-		}
-
-		const { romPath, tableId } = parsed;
-
-		// Get ROM document
-		const romDoc = await this.getRomDocument(romPath);
-		if (!romDoc || !romDoc.definition) {
-			throw vscode.FileSystemError.FileNotFound(uri);
-		}
-
-		// Find table definition
-		const tableDef = romDoc.definition.tables.find((t) => t.id === tableId);
-		if (!tableDef) {
-			throw vscode.FileSystemError.FileNotFound(uri);
-		}
+		const { romDoc, table, romPath, tableId } = await this.resolveTable(uri);
+		const tableDef = table.definition;
 
 		// Decode JSON
 		const json = new TextDecoder().decode(content);
@@ -329,28 +322,20 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 		this.validateTableData(tableData, tableDef);
 
 		// Update ROM bytes
+		const length = this.getTableDataLength(tableDef);
+		romDoc.prepareEdit(tableDef.z.address, length);
 		this.updateRomBytes(romDoc, tableDef, tableData);
 
-		// Mark ROM as dirty and fire update event
-		romDoc.updateBytes(
-			romDoc.romBytes,
-			tableDef.z.address,
-			this.getTableDataLength(tableDef),
-		);
+		// Mark ROM as dirty and fire update event. The cache's update listener
+		// invalidates this table (and any sharing its bytes) and notifies
+		// other editors of the change.
+		romDoc.updateBytes(romDoc.romBytes, tableDef.z.address, length);
 
 		// Mark this specific table as dirty
 		this.stateManager.markTableDirty(romPath, tableId);
 
 		// Notify tree provider to refresh
 		this.treeProvider?.refresh();
-
-		// Notify other editors of the change
-		this._emitter.fire([
-			{
-				type: vscode.FileChangeType.Changed,
-				uri,
-			},
-		]);
 	}
 
 	/**
@@ -362,6 +347,21 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 			throw vscode.FileSystemError.FileNotFound(uri);
 		}
 
+		// Answer from the cache once the ROM is loaded
+		const cache = this.tableCaches.get(parsed.romPath);
+		if (cache) {
+			const table = this.getMaterializedTable(cache, parsed.tableId);
+			if (!table) {
+				throw vscode.FileSystemError.FileNotFound(uri);
+			}
+			return {
+				type: vscode.FileType.File,
+				ctime: cache.ctime,
+				mtime: table.mtime,
+				size: table.content?.length ?? 0,
+			};
+		}
+
 		// Check if ROM file exists
 		const romUri = vscode.Uri.file(parsed.romPath);
 		try {
@@ -411,6 +411,146 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 		throw vscode.FileSystemError.NoPermissions("Cannot rename virtual file");
 	}
 
+	/**
+	 * Resolve a table URI to its ROM document and cached table
+	 *
+	 * @throws FileSystemError.FileNotFound if the URI, ROM or table is invalid
+	 */
+	private async resolveTable(uri: vscode.Uri): Promise<{
+		romDoc: RomDocument;
+		table: MaterializedTable;
+		romPath: string;
+		tableId: string;
+	}> {
+		const parsed = parseTableUri(uri);
+		if (!parsed) {
+			throw vscode.FileSystemError.FileNotFound(uri);
+		}
+
+		const { romPath, tableId } = parsed;
+
+		// Get or load ROM document
+		const romDoc = await this.getRomDocument(romPath);
+		if (!romDoc || !romDoc.definition) {
+			throw vscode.FileSystemError.FileNotFound(uri);
+		}
+
+		const cache = this.getTableCache(romPath, romDoc, romDoc.definition);
+		const table = this.getMaterializedTable(cache, tableId);
+		if (!table) {
+			throw vscode.FileSystemError.FileNotFound(uri);
+		}
+		table.uris.add(uri.toString());
+
+		return { romDoc, table, romPath, tableId };
+	}
+
+	/**
+	 * Get the table cache of a ROM document, creating it on first use
+	 *
+	 * The cache follows the document's byte updates: an update with a known
+	 * range invalidates only the tables that read from it, while a replaced
+	 * buffer or an update of unknown extent invalidates every table.
+	 */
+	private getTableCache(
+		romPath: string,
+		romDoc: RomDocument,
+		definition: ROMDefinition,
+	): RomTableCache {
+		const existing = this.tableCaches.get(romPath);
+		if (existing && existing.definition === definition) {
+			return existing;
+		}
+		existing?.subscription.dispose();
+
+		const cache: RomTableCache = {
+			definition,
+			definitions: new Map(definition.tables.map((t) => [t.id, t])),
+			tables: new Map(),
+			bytes: romDoc.romBytes,
+			ctime: Date.now(),
+			subscription: romDoc.onDidUpdateBytes((event) => {
+				const wholeRom =
+					event.bytes !== cache.bytes ||
+					event.offset === undefined ||
+					event.length === undefined;
+				cache.bytes = event.bytes;
+
+				const changed: vscode.FileChangeEvent[] = [];
+				for (const table of cache.tables.values()) {
+					if (
+						wholeRom ||
+						overlaps(table.ranges, event.offset ?? 0, event.length ?? 0)
+					) {
+						delete table.content;
+						table.mtime = Math.max(Date.now(), table.mtime + 1);
+						for (const uri of table.uris) {
+							changed.push({
+								type: vscode.FileChangeType.Changed,
+								uri: vscode.Uri.parse(uri),
+							});
+						}
+					}
+				}
+				if (changed.length > 0) {
+					this._emitter.fire(changed);
+				}
+			}),
+		};
+		this.tableCaches.set(romPath, cache);
+		return cache;
+	}
+
+	/**
+	 * Get the cached state of a table, creating it without reading any bytes
+	 */
+	private getMaterializedTable(
+		cache: RomTableCache,
+		tableId: string,
+	): MaterializedTable | undefined {
+		let table = cache.tables.get(tableId);
+		if (!table) {
+			const definition = cache.definitions.get(tableId);
+			if (!definition) {
+				return undefined;
+			}
+			table = {
+				definition,
+				ranges: this.getTableRanges(definition),
+				mtime: cache.ctime,
+				uris: new Set(),
+			};
+			cache.tables.set(tableId, table);
+		}
+		return table;
+	}
+
+	/**
+	 * Get the byte ranges a table reads: its values and dynamic axes
+	 */
+	private getTableRanges(tableDef: TableDefinition): ByteRange[] {
+		const ranges: ByteRange[] = [
+			{
+				offset: tableDef.z.address,
+				length: this.getTableDataLength(tableDef),
+			},
+		];
+		const axes = [tableDef.x];
+		if (tableDef.kind !== "table1d") {
+			axes.push((tableDef as Table2DDefinition).y);
+		}
+		for (const axis of axes) {
+			if (axis && axis.kind !== "static") {
+				const dyn = axis as DynamicArrayDefinition;
+				ranges.push({
+					offset: dyn.address,
+					length: dyn.length * sizeOf(dyn.dtype),
+				});
+			}
+		}
+		return ranges;
+	}
+
 	/**
 	 * Get or load a ROM document
 	 */
@@ -472,6 +612,8 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 			// Clean up when document is disposed
 			romDoc.onDidDispose(() => {
 				this.romDocuments.delete(romPath);
+				this.tableCaches.get(romPath)?.subscription.dispose();
+				this.tableCaches.delete(romPath);
 			});
 
 			return romDoc;
@@ -486,9 +628,10 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 	 */
 	private extractTableData(
 		romDoc: RomDocument,
-		tableDef: TableDefinition,
+		table: MaterializedTable,
 	): TableData {
 		const rom = romDoc.romBytes;
+		const tableDef = table.definition;
 
 		// Read axis data
 		const xAxis = this.readAxis(tableDef.x, rom);
@@ -548,7 +691,7 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 			tableKind: tableDef.kind,
 			address: tableDef.z.address,
 			dimensions,
-			lastModified: Date.now(),
+			lastModified: table.mtime,
 		};
 
 		if (romDoc.definition?.uri) {
@@ -731,6 +874,23 @@ export class TableFileSystemProvider implements vscode.FileSystemProvider {
 	dispose(): void {
 		this._emitter.dispose();
 		this.romDocuments.clear();
-		this.tableCache.clear();
+		for (const cache of this.tableCaches.values()) {
+			cache.subscription.dispose();
+		}
+		this.tableCaches.clear();
 	}
 }
+
+/**
+ * Whether `[offset, offset + length)` overlaps any of `ranges`
+ */
+function overlaps(
+	ranges: readonly ByteRange[],
+	offset: number,
+	length: number,
+): boolean {
+	return ranges.some(
+		(range) =>
+			offset < range.offset + range.length && range.offset < offset + length,
+	);
+}
@@ -1,5 +1,9 @@
 import type { TableDefinition } from "@ecu-explorer/core";
-import type { TableSnapshot, ThemeColors } from "@ecu-explorer/ui";
+import type {
+	TableLogOverlay,
+	TableSnapshot,
+	ThemeColors,
+} from "@ecu-explorer/ui";
 
 export type TableSessionSelection = {
 	row: number;
@@ -42,8 +46,15 @@ export type TableSessionSelectCellsMessage = {
 	selection: TableSessionSelectionPayload;
 };
 
+export type TableSessionLogOverlayMessage = {
+	type: "logOverlay";
+	/** Binned log statistics to show over the cells, or null to clear them */
+	overlay: TableLogOverlay | null;
+};
+
 export type TableSessionHostMessage =
 	| TableSessionInitMessage
 	| TableSessionUpdateMessage
 	| TableSessionThemeMessage
-	| TableSessionSelectCellsMessage;
+	| TableSessionSelectCellsMessage
+	| TableSessionLogOverlayMessage;
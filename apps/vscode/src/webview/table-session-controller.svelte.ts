@@ -1,5 +1,9 @@
 import type { TableDefinition } from "@ecu-explorer/core";
-import type { TableSnapshot, ThemeColors } from "@ecu-explorer/ui";
+import type {
+	TableLogOverlay,
+	TableSnapshot,
+	ThemeColors,
+} from "@ecu-explorer/ui";
 import type {
 	TableSessionHostMessage,
 	TableSessionInitMessage,
@@ -27,6 +31,7 @@ export interface TableSessionViewModel {
 	snapshot: TableSnapshot | null;
 	hasData: boolean;
 	definition: TableDefinition | null;
+	logOverlay: TableLogOverlay | null;
 }
 
 export class TableSessionController {
@@ -38,6 +43,7 @@ export class TableSessionController {
 	private snapshotState: TableSnapshot | null = null;
 	private definitionState: TableDefinition | null = null;
 	private romState: Uint8Array | null = null;
+	private logOverlayState: TableLogOverlay | null = null;
 
 	constructor(private readonly host: TableWebviewApi) {}
 
@@ -73,6 +79,10 @@ export class TableSessionController {
 		return this.romState;
 	}
 
+	get logOverlay(): TableLogOverlay | null {
+		return this.logOverlayState;
+	}
+
 	get hasData(): boolean {
 		return this.snapshot !== null;
 	}
@@ -88,6 +98,7 @@ export class TableSessionController {
 			hasData: snapshot !== null,
 			...(this.themeColors ? { themeColors: this.themeColors } : {}),
 			definition: this.definition,
+			logOverlay: this.logOverlay,
 		};
 	}
 
@@ -105,6 +116,9 @@ export class TableSessionController {
 			case "selectCells":
 				// no-op here: selection messages are consumed by the view layer
 				break;
+			case "logOverlay":
+				this.logOverlayState = message.overlay;
+				break;
 		}
 	}
 
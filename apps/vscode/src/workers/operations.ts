@@ -0,0 +1,85 @@
+/**
+ * ROM worker operation handlers
+ *
+ * Runs inside the worker thread, and on the calling thread where workers are
+ * not available (web). Must not import `vscode`.
+ */
+
+import { validateChecksum } from "@ecu-explorer/core";
+import { parseCsvTable } from "../csv/parser.js";
+import type {
+	RomWorkerOperation,
+	RomWorkerOperations,
+	RomWorkerParams,
+	RomWorkerResult,
+} from "./protocol.js";
+
+const handlers: {
+	[K in RomWorkerOperation]: (
+		params: RomWorkerOperations[K]["params"],
+	) => RomWorkerOperations[K]["result"];
+} = {
+	validateChecksum: ({ bytes, checksum }) => validateChecksum(bytes, checksum),
+	parseCsvTable: ({ content, shape }) => parseCsvTable(content, shape),
+};
+
+/**
+ * Run a ROM worker operation on the current thread
+ *
+ * @throws Error if the operation is unknown, or whatever the operation throws
+ */
+export function runRomWorkerOperation<K extends RomWorkerOperation>(
+	op: K,
+	params: RomWorkerParams<K>,
+): RomWorkerResult<K> {
+	const handler = handlers[op] as
+		| ((params: RomWorkerParams<K>) => RomWorkerResult<K>)
+		| undefined;
+	if (!handler) {
+		throw new Error(`Unknown ROM worker operation: ${String(op)}`);
+	}
+	return handler(params);
+}
+
+/**
+ * Collect the buffers of typed arrays in a result so they can be transferred
+ * instead of copied
+ *
+ * Only buffers wholly owned by one view are transferred; plain objects and
+ * arrays are searched a few levels deep.
+ */
+export function transferablesOf(value: unknown, depth = 3): ArrayBuffer[] {
+	const buffers = new Set<ArrayBuffer>();
+	const visit = (item: unknown, level: number) => {
+		if (ArrayBuffer.isView(item)) {
+			for (const buffer of transferableBuffer(item)) {
+				buffers.add(buffer);
+			}
+		} else if (level > 0 && item !== null && typeof item === "object") {
+			for (const child of Object.values(item)) {
+				visit(child, level - 1);
+			}
+		}
+	};
+	visit(value, depth);
+	return Array.from(buffers);
+}
+
+/**
+ * The buffer behind `view`, if transferring it detaches nothing but `view`
+ *
+ * Views into shared or pooled buffers (e.g. small Node `Buffer`s) return an
+ * empty list and are copied instead.
+ */
+export function transferableBuffer(view: ArrayBufferView): ArrayBuffer[] {
+	const { buffer } = view;
+	if (
+		buffer instanceof ArrayBuffer &&
+		view.byteOffset === 0 &&
+		view.byteLength === buffer.byteLength &&
+		buffer.byteLength > 0
+	) {
+		return [buffer];
+	}
+	return [];
+}
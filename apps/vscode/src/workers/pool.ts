@@ -0,0 +1,191 @@
+import { availableParallelism } from "node:os";
+import { Worker } from "node:worker_threads";
+import * as vscode from "vscode";
+import type {
+	RomWorkerOperation,
+	RomWorkerParams,
+	RomWorkerRequest,
+	RomWorkerResponse,
+	RomWorkerResult,
+} from "./protocol.js";
+import type { RomTaskOptions, RomTaskRunner } from "./task-runner.js";
+
+interface PoolTask {
+	request: RomWorkerRequest;
+	transfer: ArrayBuffer[];
+	resolve(result: unknown): void;
+	reject(error: unknown): void;
+	cancellation?: vscode.Disposable;
+}
+
+/**
+ * Default pool size: leave one core for the extension host, cap at 4
+ */
+function defaultPoolSize(): number {
+	return Math.max(1, Math.min(4, availableParallelism() - 1));
+}
+
+/**
+ * Pool of worker threads running ROM operations (desktop)
+ *
+ * Workers are started on demand, up to `size`, and kept for later tasks.
+ * Tasks beyond that wait in a FIFO queue. Cancelling a queued task drops it;
+ * cancelling a running one terminates its worker, since synchronous work
+ * cannot be interrupted otherwise, and a replacement is started when needed.
+ */
+export class RomWorkerPool implements RomTaskRunner, vscode.Disposable {
+	private readonly workers = new Set<Worker>();
+	private readonly idle: Worker[] = [];
+	private readonly running = new Map<Worker, PoolTask>();
+	private readonly queue: PoolTask[] = [];
+	private nextId = 1;
+	private disposed = false;
+
+	/**
+	 * @param workerPath - Path of the bundled worker entry point
+	 * @param size - Maximum number of worker threads
+	 */
+	constructor(
+		private readonly workerPath: string | URL,
+		readonly size = defaultPoolSize(),
+	) {}
+
+	run<K extends RomWorkerOperation>(
+		op: K,
+		params: RomWorkerParams<K>,
+		options: RomTaskOptions = {},
+	): Promise<RomWorkerResult<K>> {
+		if (this.disposed) {
+			return Promise.reject(new Error("ROM worker pool has been disposed"));
+		}
+		const { token, transfer = [] } = options;
+		if (token?.isCancellationRequested) {
+			return Promise.reject(new vscode.CancellationError());
+		}
+		return new Promise((resolve, reject) => {
+			const task: PoolTask = {
+				request: { id: this.nextId++, op, params },
+				transfer,
+				resolve: resolve as (result: unknown) => void,
+				reject,
+			};
+			if (token) {
+				task.cancellation = token.onCancellationRequested(() =>
+					this.cancel(task),
+				);
+			}
+			this.queue.push(task);
+			this.drain();
+		});
+	}
+
+	dispose(): void {
+		this.disposed = true;
+		const error = new Error("ROM worker pool has been disposed");
+		for (const task of [...this.queue, ...this.running.values()]) {
+			settle(task, () => task.reject(error));
+		}
+		this.queue.length = 0;
+		this.running.clear();
+		this.idle.length = 0;
+		for (const worker of this.workers) {
+			void worker.terminate();
+		}
+		this.workers.clear();
+	}
+
+	private drain(): void {
+		while (this.queue.length > 0) {
+			const worker =
+				this.idle.pop() ??
+				(this.workers.size < this.size ? this.spawn() : undefined);
+			if (!worker) {
+				return;
+			}
+			const task = this.queue.shift() as PoolTask;
+			this.running.set(worker, task);
+			try {
+				worker.postMessage(task.request, task.transfer);
+			} catch (error) {
+				// e.g. parameters that cannot be cloned
+				this.running.delete(worker);
+				this.idle.push(worker);
+				settle(task, () => task.reject(error));
+			}
+		}
+	}
+
+	private spawn(): Worker {
+		const worker = new Worker(this.workerPath);
+		worker.on("message", (response: RomWorkerResponse) =>
+			this.finish(worker, response),
+		);
+		worker.on("error", (error) => this.remove(worker, error));
+		worker.on("exit", (code) =>
+			this.remove(worker, new Error(`ROM worker exited with code ${code}`)),
+		);
+		this.workers.add(worker);
+		return worker;
+	}
+
+	private finish(worker: Worker, response: RomWorkerResponse): void {
+		const task = this.running.get(worker);
+		this.running.delete(worker);
+		this.idle.push(worker);
+		if (task && task.request.id === response.id) {
+			settle(task, () => {
+				if (response.ok) {
+					task.resolve(response.result);
+				} else {
+					task.reject(new Error(response.error));
+				}
+			});
+		}
+		this.drain();
+	}
+
+	/**
+	 * Forget a worker that crashed, exited or was terminated, failing its task
+	 */
+	private remove(worker: Worker, error: unknown): void {
+		if (!this.workers.delete(worker)) {
+			return;
+		}
+		const index = this.idle.indexOf(worker);
+		if (index !== -1) {
+			this.idle.splice(index, 1);
+		}
+		const task = this.running.get(worker);
+		this.running.delete(worker);
+		if (task) {
+			settle(task, () => task.reject(error));
+		}
+		if (!this.disposed) {
+			this.drain();
+		}
+	}
+
+	private cancel(task: PoolTask): void {
+		const queued = this.queue.indexOf(task);
+		if (queued !== -1) {
+			this.queue.splice(queued, 1);
+		} else {
+			for (const [worker, runningTask] of this.running) {
+				if (runningTask === task) {
+					this.running.delete(worker);
+					this.workers.delete(worker);
+					void worker.terminate();
+					break;
+				}
+			}
+		}
+		settle(task, () => task.reject(new vscode.CancellationError()));
+		this.drain();
+	}
+}
+
+function settle(task: PoolTask, complete: () => void): void {
+	task.cancellation?.dispose();
+	delete task.cancellation;
+	complete();
+}
@@ -0,0 +1,63 @@
+/**
+ * Typed request/response protocol for the ROM worker
+ *
+ * Each operation declares its parameters and result. Both must survive
+ * structured cloning: plain data and typed arrays, no functions.
+ */
+
+import type {
+	ChecksumDefinition,
+	ChecksumValidation,
+} from "@ecu-explorer/core";
+import type { CsvTableShape, parseCsvTable } from "../csv/parser.js";
+
+/**
+ * Checksum definition that can be sent to a worker
+ *
+ * Definitions with a custom checksum function have to be handled on the
+ * calling thread.
+ */
+export type PortableChecksumDefinition = Omit<
+	ChecksumDefinition,
+	"customFunction"
+>;
+
+/**
+ * Operations the ROM worker can run
+ */
+export interface RomWorkerOperations {
+	/** Compare a ROM's stored checksum against its contents */
+	validateChecksum: {
+		params: { bytes: Uint8Array; checksum: PortableChecksumDefinition };
+		result: ChecksumValidation;
+	};
+	/** Parse a CSV file into typed arrays for a table */
+	parseCsvTable: {
+		params: { content: Uint8Array; shape: CsvTableShape };
+		result: ReturnType<typeof parseCsvTable>;
+	};
+}
+
+export type RomWorkerOperation = keyof RomWorkerOperations;
+
+export type RomWorkerParams<K extends RomWorkerOperation> =
+	RomWorkerOperations[K]["params"];
+
+export type RomWorkerResult<K extends RomWorkerOperation> =
+	RomWorkerOperations[K]["result"];
+
+/**
+ * Message posted to a worker
+ */
+export interface RomWorkerRequest {
+	id: number;
+	op: RomWorkerOperation;
+	params: unknown;
+}
+
+/**
+ * Message posted back by a worker
+ */
+export type RomWorkerResponse =
+	| { id: number; ok: true; result: unknown }
+	| { id: number; ok: false; error: string };
@@ -0,0 +1,29 @@
+/**
+ * ROM worker thread entry point (desktop)
+ *
+ * Bundled as `dist/rom-worker.cjs` and started by {@link RomWorkerPool}.
+ */
+
+import { parentPort } from "node:worker_threads";
+import { runRomWorkerOperation, transferablesOf } from "./operations.js";
+import type { RomWorkerRequest, RomWorkerResponse } from "./protocol.js";
+
+parentPort?.on("message", (request: RomWorkerRequest) => {
+	let response: RomWorkerResponse;
+	let transfer: ArrayBuffer[] = [];
+	try {
+		const result = runRomWorkerOperation(
+			request.op,
+			request.params as never,
+		);
+		response = { id: request.id, ok: true, result };
+		transfer = transferablesOf(result);
+	} catch (error) {
+		response = {
+			id: request.id,
+			ok: false,
+			error: error instanceof Error ? error.message : String(error),
+		};
+	}
+	parentPort?.postMessage(response, transfer);
+});
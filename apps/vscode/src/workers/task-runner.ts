@@ -0,0 +1,50 @@
+import * as vscode from "vscode";
+import { runRomWorkerOperation } from "./operations.js";
+import type {
+	RomWorkerOperation,
+	RomWorkerParams,
+	RomWorkerResult,
+} from "./protocol.js";
+
+/**
+ * Options for a ROM task
+ */
+export interface RomTaskOptions {
+	/**
+	 * Buffers to move to the worker instead of copying. They are detached
+	 * (unusable by the caller) once the task is submitted.
+	 */
+	transfer?: ArrayBuffer[];
+	/** Cancels the task; the promise then rejects with `CancellationError` */
+	token?: vscode.CancellationToken;
+}
+
+/**
+ * Runs heavy ROM operations, off the extension host thread where possible
+ */
+export interface RomTaskRunner {
+	run<K extends RomWorkerOperation>(
+		op: K,
+		params: RomWorkerParams<K>,
+		options?: RomTaskOptions,
+	): Promise<RomWorkerResult<K>>;
+}
+
+/**
+ * Runs operations on the calling thread
+ *
+ * Used where worker threads are unavailable (web extension host). Transfer
+ * lists are ignored and cancellation is only checked before starting.
+ */
+export class InlineRomTaskRunner implements RomTaskRunner {
+	async run<K extends RomWorkerOperation>(
+		op: K,
+		params: RomWorkerParams<K>,
+		options: RomTaskOptions = {},
+	): Promise<RomWorkerResult<K>> {
+		if (options.token?.isCancellationRequested) {
+			throw new vscode.CancellationError();
+		}
+		return runRomWorkerOperation(op, params);
+	}
+}
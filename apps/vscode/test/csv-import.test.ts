@@ -0,0 +1,126 @@
+import type { TableDefinition } from "@ecu-explorer/core";
+import { describe, expect, it } from "vitest";
+import { encodeSnapshotCsv, snapshotToCsv } from "../src/csv/export.js";
+import {
+	csvToSnapshot,
+	parseCsv,
+	parseCsvTable,
+	type TableSnapshot,
+} from "../src/csv/parser.js";
+import {
+	type CsvNumberSink,
+	CsvNumberTokenizer,
+} from "../src/csv/tokenizer.js";
+
+const table1d = {
+	id: "boost",
+	name: "Boost Target",
+	kind: "table1d",
+	rows: 3,
+	z: { id: "boost-z", name: "z", address: 0x100, dtype: "u8" },
+} as TableDefinition;
+
+const table2d = {
+	id: "fuel",
+	name: "Fuel Map",
+	kind: "table2d",
+	rows: 2,
+	cols: 3,
+	z: { id: "fuel-z", name: "z", address: 0x200, dtype: "u8" },
+} as TableDefinition;
+
+describe("parseCsvTable", () => {
+	it("parses a 1D table into typed arrays", () => {
+		const result = parseCsvTable("x,value\n0,1.5\n1,-2\r\n\n2,3e2\n", table1d);
+		expect(result.success).toBe(true);
+		if (!result.success) return;
+		expect(Array.from(result.data.x ?? [])).toEqual([0, 1, 2]);
+		expect(Array.from(result.data.z)).toEqual([1.5, -2, 300]);
+	});
+
+	it("parses a 2D table row-major", () => {
+		const csv = ",1000,2000,3000\n10, 1,2,3\n20,4,5,6.25";
+		const result = parseCsvTable(new TextEncoder().encode(csv), table2d);
+		expect(result.success).toBe(true);
+		if (!result.success) return;
+		expect(Array.from(result.data.x ?? [])).toEqual([1000, 2000, 3000]);
+		expect(Array.from(result.data.y ?? [])).toEqual([10, 20]);
+		expect(Array.from(result.data.z)).toEqual([1, 2, 3, 4, 5, 6.25]);
+	});
+
+	it("matches the string parser's values", () => {
+		const csv = [
+			",0.1,0.2,0.30000000000000004",
+			"0.7,1.1,2.2e-3,-0.0",
+			"+8,9.5,007,12345.678901234",
+		].join("\n");
+		const result = parseCsvTable(csv, table2d);
+		const legacy = csvToSnapshot(parseCsv(csv), table2d);
+		expect(result.success && legacy.success).toBe(true);
+		if (!result.success || !legacy.success) return;
+		const snapshot = legacy.snapshot as Extract<
+			TableSnapshot,
+			{ kind: "table2d" }
+		>;
+		expect(Array.from(result.data.z)).toEqual(snapshot.z.flat());
+		expect(Array.from(result.data.x ?? [])).toEqual(snapshot.x);
+	});
+
+	it("rejects rows with the wrong number of columns", () => {
+		const result = parseCsvTable(",1,2,3\n0,1,2\n1,4,5,6", table2d);
+		expect(result).toEqual({
+			success: false,
+			error: "CSV dimensions don't match table. Row 1 has 2 of 3 columns",
+		});
+	});
+
+	it("stops at the first row past the table", () => {
+		const result = parseCsvTable("x,value\n0,1\n1,2\n2,3\n3,4\n4,x", table1d);
+		expect(result).toEqual({
+			success: false,
+			error: "CSV dimensions don't match table. Expected 3 rows",
+		});
+	});
+
+	it("reports non-numeric values", () => {
+		const result = parseCsvTable("x,value\n0,1\n1,abc\n2,3", table1d);
+		expect(result).toEqual({
+			success: false,
+			error: "Invalid numeric value in row 2: abc",
+		});
+	});
+});
+
+describe("CsvNumberTokenizer", () => {
+	it("handles lines split across chunks", () => {
+		const rows: number[][] = [];
+		const sink: CsvNumberSink = {
+			field(row, _col, value) {
+				(rows[row] ??= []).push(value);
+			},
+			endRow() {},
+		};
+		const tokenizer = new CsvNumberTokenizer(sink);
+		for (const chunk of ["1.2", "5,3", "\r", "\n4,", "-0.5\n", "6"]) {
+			tokenizer.push(chunk);
+		}
+		tokenizer.end();
+		expect(rows).toEqual([[1.25, 3], [4, -0.5], [6]]);
+	});
+});
+
+describe("encodeSnapshotCsv", () => {
+	it("encodes the same CSV as snapshotToCsv", () => {
+		const snapshot: TableSnapshot = {
+			kind: "table2d",
+			name: "Fuel Map",
+			rows: 40,
+			cols: 3,
+			x: [1000, 2000, 3000],
+			z: Array.from({ length: 40 }, (_, row) => [row / 3, row, -row]),
+		};
+		expect(new TextDecoder().decode(encodeSnapshotCsv(snapshot))).toBe(
+			snapshotToCsv(snapshot),
+		);
+	});
+});
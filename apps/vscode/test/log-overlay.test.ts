@@ -0,0 +1,53 @@
+import { LogBinner } from "@ecu-explorer/core";
+import { describe, expect, it } from "vitest";
+import { toTableLogOverlay } from "../src/commands/log-overlay-commands.js";
+import { parseLogCsvColumns } from "../src/csv/log-columns.js";
+
+describe("parseLogCsvColumns", () => {
+	it("reads logging manager output into columns, skipping the units row", () => {
+		const log = parseLogCsvColumns(
+			new TextEncoder().encode(
+				[
+					"Timestamp (ms),Engine RPM,AFR",
+					"Unit,rpm,afr",
+					"0,2100,14.7",
+					"50,2900,",
+					"100,3100,11.5",
+				].join("\n"),
+			),
+		);
+
+		expect(log.headers).toEqual(["Timestamp (ms)", "Engine RPM", "AFR"]);
+		expect(log.rowCount).toBe(3);
+		expect(Array.from(log.columns[1] ?? [])).toEqual([2100, 2900, 3100]);
+		expect(Array.from(log.columns[2] ?? [])).toEqual([14.7, Number.NaN, 11.5]);
+	});
+
+	it("grows columns for long logs without a units row", () => {
+		const lines = ["t,value"];
+		for (let i = 0; i < 3000; i++) lines.push(`${i},${i * 2}`);
+		const log = parseLogCsvColumns(lines.join("\n"));
+
+		expect(log.rowCount).toBe(3000);
+		expect(log.columns[1]?.[2999]).toBe(5998);
+	});
+});
+
+describe("toTableLogOverlay", () => {
+	it("converts binned statistics to plain arrays with null for empty cells", () => {
+		const binner = new LogBinner({ xAxis: [1000, 2000] });
+		binner.add(1100, 0, 12);
+		binner.add(900, 0, 14);
+
+		expect(toTableLogOverlay(binner.result(), "AFR")).toEqual({
+			label: "AFR",
+			rows: 1,
+			cols: 2,
+			count: [2, 0],
+			mean: [13, null],
+			min: [12, null],
+			max: [14, null],
+			stddev: [1, null],
+		});
+	});
+});
@@ -6,7 +6,7 @@
  */
 
 import * as path from "node:path";
-import { beforeEach, describe, expect, it, vi } from "vitest";
+import { afterEach, beforeEach, describe, expect, it, vi } from "vitest";
 import * as vscode from "vscode";
 import { LoggingManager, openLogsFolder } from "../src/logging-manager.js";
 import {
@@ -494,6 +494,92 @@ describe("LoggingManager", () => {
 			expect(fields[3]).toBe(""); // Throttle Position empty
 		});
 	});
+
+	describe("time-aligned rows", () => {
+		beforeEach(() => {
+			vi.useFakeTimers();
+			vi.setSystemTime(10_000);
+			vi.mocked(vscode.workspace.getConfiguration).mockReturnValue(
+				createLoggingConfiguration("logs", "all", {
+					"logging.sampleIntervalMs": 100,
+					"logging.interpolation": "hold",
+					"logging.latencyMs": { "Wideband AFR": 50 },
+				}),
+			);
+		});
+
+		afterEach(() => {
+			vi.useRealTimers();
+		});
+
+		it("should write one row per interval with every column filled", async () => {
+			const [rpm] = createSamplePids();
+			await manager.startLog({
+				pids: [rpm],
+				channels: [
+					{ key: "wideband-primary", name: "Wideband AFR", unit: "AFR" },
+				],
+			});
+
+			manager.onFrame({
+				timestamp: 10_000,
+				pid: rpm.pid,
+				value: 850,
+				unit: rpm.unit,
+			});
+			// Reported 50 ms late, so it lines up with the first row
+			manager.onChannelSample("wideband-primary", 10_050, 14.7);
+			manager.onFrame({
+				timestamp: 10_150,
+				pid: rpm.pid,
+				value: 900,
+				unit: rpm.unit,
+			});
+			vi.advanceTimersByTime(400);
+			await manager.stopLog();
+
+			const writeCall = vi.mocked(vscode.workspace.fs.writeFile).mock.calls[0];
+			const content = new TextDecoder().decode(writeCall?.[1]);
+			expect(content.trim().split("\n").slice(2)).toEqual([
+				"0,850,14.7",
+				"100,850,14.7",
+				"200,900,14.7",
+				"300,900,14.7",
+				"400,900,14.7",
+			]);
+		});
+
+		it("should not write rows for time spent paused", async () => {
+			const [rpm] = createSamplePids();
+			await manager.startLog([rpm]);
+
+			manager.onFrame({
+				timestamp: 10_000,
+				pid: rpm.pid,
+				value: 850,
+				unit: rpm.unit,
+			});
+			vi.advanceTimersByTime(100);
+			manager.pauseLog();
+			vi.advanceTimersByTime(1000);
+			manager.resumeLog();
+			manager.onFrame({
+				timestamp: 11_100,
+				pid: rpm.pid,
+				value: 900,
+				unit: rpm.unit,
+			});
+			await manager.stopLog();
+
+			const writeCall = vi.mocked(vscode.workspace.fs.writeFile).mock.calls[0];
+			const content = new TextDecoder().decode(writeCall?.[1]);
+			expect(content.trim().split("\n").slice(2)).toEqual([
+				"0,850",
+				"100,850",
+				"1100,900",
+			]);
+		});
+	});
 });
 
 // ─── openLogsFolder Tests ────────────────────────────────────────────────────
@@ -43,12 +43,13 @@ export function createWorkspaceFolders() {
 export function createLoggingConfiguration(
 	logsFolder: string,
 	columns: string[] | "all" = "all",
+	settings: Record<string, unknown> = {},
 ) {
 	return {
 		get: (key: string) => {
 			if (key === "logsFolder") return logsFolder;
 			if (key === "logging.columns") return columns;
-			return undefined;
+			return settings[key];
 		},
 		has: () => true,
 		inspect: () => undefined,
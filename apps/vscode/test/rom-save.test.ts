@@ -1,9 +1,17 @@
 import * as fs from "node:fs/promises";
 import * as path from "node:path";
 import type { ChecksumDefinition } from "@ecu-explorer/core";
-import { validateChecksum } from "@ecu-explorer/core";
+import {
+	PagedRom,
+	ROM_PAGE_SIZE,
+	validateChecksum,
+} from "@ecu-explorer/core";
 import { afterEach, beforeEach, describe, expect, it } from "vitest";
-import { RomSaveManager } from "../src/rom/save-manager.js";
+import { createDesktopRomRangeWriter } from "../src/desktop-rom-writer.js";
+import {
+	type RomRangeWriter,
+	RomSaveManager,
+} from "../src/rom/save-manager.js";
 
 function createFixtureRom(size = 0x80000): Uint8Array {
 	const rom = new Uint8Array(size);
@@ -14,6 +22,26 @@ function createFixtureRom(size = 0x80000): Uint8Array {
 	return rom;
 }
 
+/** Desktop range writer that records whether each save was patched. */
+function recordingRangeWriter(): RomRangeWriter & { patched: boolean[] } {
+	const desktop = createDesktopRomRangeWriter();
+	const patched: boolean[] = [];
+	return {
+		patched,
+		stamp: (romPath) => desktop.stamp(romPath),
+		async writeRanges(romPath, stamp, byteLength, ranges) {
+			const result = await desktop.writeRanges(
+				romPath,
+				stamp,
+				byteLength,
+				ranges,
+			);
+			patched.push(result !== null);
+			return result;
+		},
+	};
+}
+
 describe("ROM Save Integration Test", () => {
 	const testDir = path.join(__dirname, "..", "..", "..", "test-output");
 	const romFileName = "sample.rom.hex";
@@ -140,6 +168,51 @@ describe("ROM Save Integration Test", () => {
 		expect(Array.from(romData)).toEqual(Array.from(savedData));
 	});
 
+	it("reports the checksum write to the document's byte listeners", async () => {
+		const romData = new Uint8Array(await fs.readFile(testRomPath));
+		const checksumDef: ChecksumDefinition = {
+			algorithm: "crc32",
+			regions: [{ start: 0, end: 0x7fffc }],
+			storage: {
+				offset: 0x7fffc,
+				size: 4,
+				endianness: "be",
+			},
+		};
+		const pages = new PagedRom(romData);
+		const updates: { offset?: number; length?: number; dirty?: boolean }[] =
+			[];
+		const editor = {
+			prepareEdit: (offset: number, length: number) => {
+				pages.prepare(offset, length);
+			},
+			updateBytes: (
+				bytes: Uint8Array,
+				offset?: number,
+				length?: number,
+				markDirty?: boolean,
+			) => {
+				expect(bytes).toBe(romData);
+				pages.commit(offset, length);
+				updates.push({ offset, length, dirty: markDirty });
+			},
+		};
+		romData[0x10] = 0xaa;
+
+		const result = await saveManager.save({
+			romPath: testRomPath,
+			romData,
+			checksumDef,
+			pages,
+			editor,
+		});
+
+		expect(result.ok).toBe(true);
+		expect(updates).toEqual([{ offset: 0x7fffc, length: 4, dirty: false }]);
+		const savedData = new Uint8Array(await fs.readFile(testRomPath));
+		expect(Array.from(romData)).toEqual(Array.from(savedData));
+	});
+
 	it("should handle save errors gracefully", async () => {
 		// Try to save to invalid path
 		const invalidPath =
@@ -191,4 +264,90 @@ describe("ROM Save Integration Test", () => {
 		// This test demonstrates that the save manager properly handles checksums
 		expect(result.ok).toBe(true);
 	});
+
+	it("should write only dirty pages in place", async () => {
+		const writer = recordingRangeWriter();
+		const rangeSaveManager = new RomSaveManager(writer);
+		const stamp = await rangeSaveManager.stampFile(testRomPath);
+		const romData = new Uint8Array(await fs.readFile(testRomPath));
+		const pages = new PagedRom(romData);
+		rangeSaveManager.trackFile(testRomPath, pages, stamp);
+
+		// Edit one byte in the sixth page
+		const editOffset = 5 * ROM_PAGE_SIZE + 0x10;
+		pages.prepare(editOffset, 1);
+		romData[editOffset] = 0xa5;
+		pages.commit(editOffset, 1);
+
+		const result = await rangeSaveManager.save({
+			romPath: testRomPath,
+			romData,
+			pages,
+		});
+
+		expect(result.ok).toBe(true);
+		expect(writer.patched).toEqual([true]);
+		const savedData = await fs.readFile(testRomPath);
+		expect(savedData[editOffset]).toBe(0xa5);
+		expect(pages.dirtyPageCount).toBe(0);
+
+		// The stamp follows the patched file, so the next save patches too
+		pages.prepare(0x10, 1);
+		romData[0x10] = 0x5a;
+		pages.commit(0x10, 1);
+		await rangeSaveManager.save({ romPath: testRomPath, romData, pages });
+		expect(writer.patched).toEqual([true, true]);
+		expect((await fs.readFile(testRomPath))[0x10]).toBe(0x5a);
+	});
+
+	it("should rewrite the whole file when it changed since it was read", async () => {
+		const writer = recordingRangeWriter();
+		const rangeSaveManager = new RomSaveManager(writer);
+		const stamp = await rangeSaveManager.stampFile(testRomPath);
+		const romData = new Uint8Array(await fs.readFile(testRomPath));
+		const pages = new PagedRom(romData);
+		rangeSaveManager.trackFile(testRomPath, pages, stamp);
+
+		// Another program rewrites the file with the same size
+		const onDisk = new Uint8Array(romData);
+		onDisk[0x20] = 0x7e;
+		await fs.writeFile(testRomPath, onDisk);
+		await fs.utimes(testRomPath, new Date(1_000_000), new Date(1_000_000));
+
+		pages.prepare(1, 1);
+		romData[1] = 0x42;
+		pages.commit(1, 1);
+		const result = await rangeSaveManager.save({
+			romPath: testRomPath,
+			romData,
+			pages,
+		});
+
+		expect(result.ok).toBe(true);
+		expect(writer.patched).toEqual([false]);
+		expect(await fs.readFile(testRomPath)).toEqual(Buffer.from(romData));
+	});
+
+	it("should fall back to a full write when the file size differs", async () => {
+		await fs.writeFile(testRomPath, new Uint8Array(16));
+		const romData = createFixtureRom();
+		const pages = new PagedRom(romData);
+		pages.prepare(1, 1);
+		romData[1] = 0x42;
+		pages.commit(1, 1);
+
+		const rangeSaveManager = new RomSaveManager(createDesktopRomRangeWriter());
+		const stamp = await rangeSaveManager.stampFile(testRomPath);
+		rangeSaveManager.trackFile(testRomPath, pages, stamp);
+		const result = await rangeSaveManager.save({
+			romPath: testRomPath,
+			romData,
+			pages,
+		});
+
+		expect(result.ok).toBe(true);
+		const savedData = await fs.readFile(testRomPath);
+		expect(savedData.length).toBe(romData.length);
+		expect(savedData[1]).toBe(0x42);
+	});
 });
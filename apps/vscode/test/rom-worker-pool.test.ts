@@ -0,0 +1,132 @@
+import * as fs from "node:fs";
+import * as os from "node:os";
+import * as path from "node:path";
+import { afterEach, beforeEach, describe, expect, it } from "vitest";
+import * as vscode from "vscode";
+import { RomWorkerPool } from "../src/workers/pool.js";
+import { InlineRomTaskRunner } from "../src/workers/task-runner.js";
+
+// Stand-in worker speaking the pool protocol: "validateChecksum" sums the
+// bytes after an optional busy wait, and fails on a negative delay
+const ECHO_WORKER = `
+const { parentPort, threadId } = require("node:worker_threads");
+parentPort.on("message", ({ id, params }) => {
+	if (params.delay < 0) {
+		parentPort.postMessage({ id, ok: false, error: "bad delay" });
+		return;
+	}
+	const until = Date.now() + params.delay;
+	while (Date.now() < until) {}
+	let sum = 0;
+	for (const byte of params.bytes) sum += byte;
+	parentPort.postMessage({ id, ok: true, result: { sum, threadId } });
+});
+`;
+
+type EchoResult = { sum: number; threadId: number };
+
+function createToken() {
+	const emitter = new vscode.EventEmitter<void>();
+	const token = {
+		isCancellationRequested: false,
+		onCancellationRequested: emitter.event,
+	};
+	return {
+		token: token as unknown as vscode.CancellationToken,
+		cancel() {
+			token.isCancellationRequested = true;
+			emitter.fire();
+		},
+	};
+}
+
+describe("RomWorkerPool", () => {
+	let dir: string;
+	let pool: RomWorkerPool;
+
+	const run = (
+		bytes: Uint8Array,
+		delay: number,
+		token?: vscode.CancellationToken,
+	) =>
+		pool.run("validateChecksum", { bytes, delay } as never, {
+			transfer: [bytes.buffer as ArrayBuffer],
+			...(token ? { token } : {}),
+		}) as unknown as Promise<EchoResult>;
+
+	beforeEach(() => {
+		dir = fs.mkdtempSync(path.join(os.tmpdir(), "rom-worker-"));
+		const workerPath = path.join(dir, "echo-worker.cjs");
+		fs.writeFileSync(workerPath, ECHO_WORKER);
+		pool = new RomWorkerPool(workerPath, 2);
+	});
+
+	afterEach(() => {
+		pool.dispose();
+		fs.rmSync(dir, { recursive: true, force: true });
+	});
+
+	it("runs tasks across up to `size` workers", async () => {
+		const results = await Promise.all(
+			Array.from({ length: 6 }, (_, i) => run(new Uint8Array([i, 1]), 20)),
+		);
+		expect(results.map((result) => result.sum)).toEqual([1, 2, 3, 4, 5, 6]);
+		const threads = new Set(results.map((result) => result.threadId));
+		expect(threads.size).toBe(2);
+	});
+
+	it("transfers buffers instead of copying them", async () => {
+		const bytes = new Uint8Array([1, 2, 3]);
+		const result = run(bytes, 0);
+		expect(bytes.byteLength).toBe(0);
+		expect((await result).sum).toBe(6);
+	});
+
+	it("rejects with the worker's error", async () => {
+		await expect(run(new Uint8Array(1), -1)).rejects.toThrow("bad delay");
+		expect((await run(new Uint8Array([7]), 0)).sum).toBe(7);
+	});
+
+	it("cancels running and queued tasks", async () => {
+		const running = createToken();
+		const queued = createToken();
+		const slow = run(new Uint8Array(1), 5000, running.token);
+		// Keeps the other worker busy; rejected when the pool is disposed
+		run(new Uint8Array(1), 5000).catch(() => undefined);
+		const waiting = run(new Uint8Array(1), 0, queued.token);
+
+		queued.cancel();
+		running.cancel();
+		await expect(waiting).rejects.toBeInstanceOf(vscode.CancellationError);
+		await expect(slow).rejects.toBeInstanceOf(vscode.CancellationError);
+
+		// The terminated worker is replaced for later tasks
+		expect((await run(new Uint8Array([2, 3]), 0)).sum).toBe(5);
+	});
+});
+
+describe("InlineRomTaskRunner", () => {
+	it("runs operations on the calling thread", async () => {
+		const runner = new InlineRomTaskRunner();
+		const result = await runner.run("parseCsvTable", {
+			content: new TextEncoder().encode("x,value\n0,1\n1,2"),
+			shape: { kind: "table1d", name: "Boost", rows: 2 },
+		});
+		expect(result.success && Array.from(result.data.z)).toEqual([1, 2]);
+	});
+
+	it("does not start a cancelled task", async () => {
+		const { token, cancel } = createToken();
+		cancel();
+		await expect(
+			new InlineRomTaskRunner().run(
+				"parseCsvTable",
+				{
+					content: new Uint8Array(0),
+					shape: { kind: "table1d", name: "Boost", rows: 2 },
+				},
+				{ token },
+			),
+		).rejects.toBeInstanceOf(vscode.CancellationError);
+	});
+});
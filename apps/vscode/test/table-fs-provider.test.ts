@@ -0,0 +1,152 @@
+import * as fs from "node:fs";
+import * as os from "node:os";
+import * as path from "node:path";
+import type { ROMDefinition } from "@ecu-explorer/core";
+import { afterEach, beforeEach, describe, expect, it, vi } from "vitest";
+import type * as vscode from "vscode";
+import type { RomDocument } from "../src/rom/document.js";
+import { TableFileSystemProvider } from "../src/table-fs-provider.js";
+import { createTableUri } from "../src/table-fs-uri.js";
+import type { WorkspaceState } from "../src/workspace-state.js";
+
+const definition = {
+	uri: "file:///defs/test.xml",
+	name: "Test",
+	fingerprints: [],
+	platform: {},
+	tables: [
+		{
+			id: "boost",
+			name: "Boost",
+			kind: "table1d",
+			rows: 4,
+			z: { id: "boost-z", name: "z", address: 0x10, dtype: "u8" },
+		},
+		{
+			id: "fuel",
+			name: "Fuel",
+			kind: "table2d",
+			rows: 2,
+			cols: 2,
+			x: {
+				id: "fuel-x",
+				kind: "dynamic",
+				name: "x",
+				address: 0x80,
+				length: 2,
+				dtype: "u8",
+			},
+			z: { id: "fuel-z", name: "z", address: 0x40, dtype: "u8" },
+		},
+	],
+} as unknown as ROMDefinition;
+
+describe("TableFileSystemProvider", () => {
+	let dir: string;
+	let romPath: string;
+	let provider: TableFileSystemProvider;
+	let boostUri: vscode.Uri;
+	let fuelUri: vscode.Uri;
+
+	const romDocument = () =>
+		(
+			provider as unknown as { romDocuments: Map<string, RomDocument> }
+		).romDocuments.get(romPath) as RomDocument;
+
+	beforeEach(() => {
+		dir = fs.mkdtempSync(path.join(os.tmpdir(), "table-fs-"));
+		romPath = path.join(dir, "test.bin");
+		fs.writeFileSync(romPath, new Uint8Array(0x100).map((_, i) => i));
+		const stateManager = {
+			getRomDefinition: () => definition.uri,
+			markTableDirty: vi.fn(),
+		} as unknown as WorkspaceState;
+		provider = new TableFileSystemProvider(
+			{ list: () => [{ parse: async () => definition }] as never },
+			stateManager,
+		);
+		boostUri = createTableUri(romPath, "boost", "Boost");
+		fuelUri = createTableUri(romPath, "fuel", "Fuel");
+	});
+
+	afterEach(() => {
+		provider.dispose();
+		fs.rmSync(dir, { recursive: true, force: true });
+	});
+
+	it("reuses materialized table contents", async () => {
+		const first = await provider.readFile(boostUri);
+		expect(await provider.readFile(boostUri)).toBe(first);
+
+		const data = JSON.parse(new TextDecoder().decode(first));
+		expect(data.data).toEqual([0x10, 0x11, 0x12, 0x13]);
+	});
+
+	it("answers stat from the cache once the ROM is loaded", async () => {
+		const content = await provider.readFile(boostUri);
+		const first = await provider.stat(boostUri);
+		const second = await provider.stat(boostUri);
+		expect(first.size).toBe(content.length);
+		expect(second.mtime).toBe(first.mtime);
+		expect((await provider.stat(fuelUri)).size).toBe(0);
+	});
+
+	it("invalidates only the tables an edit touches", async () => {
+		const boost = await provider.readFile(boostUri);
+		const fuel = await provider.readFile(fuelUri);
+		const before = await provider.stat(boostUri);
+		const fuelBefore = await provider.stat(fuelUri);
+		const changes: string[] = [];
+		provider.onDidChangeFile((events) => {
+			changes.push(...events.map((event) => event.uri.toString()));
+		});
+
+		const data = JSON.parse(new TextDecoder().decode(boost));
+		data.data = [1, 2, 3, 4];
+		await provider.writeFile(
+			boostUri,
+			new TextEncoder().encode(JSON.stringify(data)),
+			{ create: false, overwrite: true },
+		);
+
+		expect(changes).toEqual([boostUri.toString()]);
+		expect(await provider.readFile(fuelUri)).toBe(fuel);
+		expect((await provider.stat(fuelUri)).mtime).toBe(fuelBefore.mtime);
+
+		const updated = await provider.readFile(boostUri);
+		expect(updated).not.toBe(boost);
+		expect(JSON.parse(new TextDecoder().decode(updated)).data).toEqual([
+			1, 2, 3, 4,
+		]);
+		expect((await provider.stat(boostUri)).mtime).toBeGreaterThan(
+			before.mtime,
+		);
+	});
+
+	it("invalidates tables whose axis bytes change", async () => {
+		const boost = await provider.readFile(boostUri);
+		const fuel = await provider.readFile(fuelUri);
+		const document = romDocument();
+
+		document.romBytes[0x81] = 0xff;
+		document.updateBytes(document.romBytes, 0x81, 1);
+
+		expect(await provider.readFile(boostUri)).toBe(boost);
+		const updated = await provider.readFile(fuelUri);
+		expect(updated).not.toBe(fuel);
+		expect(JSON.parse(new TextDecoder().decode(updated)).xAxis).toEqual([
+			0x80, 0xff,
+		]);
+	});
+
+	it("invalidates every table when the buffer is replaced", async () => {
+		const boost = await provider.readFile(boostUri);
+		const fuel = await provider.readFile(fuelUri);
+		const document = romDocument();
+
+		document.updateBytes(new Uint8Array(0x100), undefined, undefined, false);
+
+		expect(await provider.readFile(boostUri)).not.toBe(boost);
+		expect(await provider.readFile(fuelUri)).not.toBe(fuel);
+	});
+});
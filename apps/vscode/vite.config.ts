@@ -6,16 +6,21 @@ export default defineConfig({
 	plugins: [svelte()],
 	build: {
 		// Build for the VS Code extension host (Node/desktop), not the browser.
-		ssr: "./src/extension.desktop.ts",
+		// The ROM worker is a second entry so worker threads can load it.
+		ssr: true,
 		outDir: "dist",
 		emptyOutDir: true,
 		sourcemap: true,
 		target: "node18",
 		rollupOptions: {
 			external: ["vscode"],
+			input: {
+				"extension.desktop": "./src/extension.desktop.ts",
+				"rom-worker": "./src/workers/rom-worker.ts",
+			},
 			output: {
 				format: "cjs",
-				entryFileNames: "extension.desktop.cjs",
+				entryFileNames: "[name].cjs",
 			},
 		},
 	},
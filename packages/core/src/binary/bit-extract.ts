@@ -42,6 +42,15 @@ export function extractBits(
 	bitOffset: number,
 	bitLength: number,
 ): number {
+	checkBitRange(buffer, bitOffset, bitLength);
+	return fieldWindow(buffer, bitOffset, bitLength) >>> (32 - bitLength);
+}
+
+function checkBitRange(
+	buffer: Uint8Array,
+	bitOffset: number,
+	bitLength: number,
+): void {
 	if (bitLength <= 0) {
 		throw new Error(`bitLength must be positive, got ${bitLength}`);
 	}
@@ -57,19 +66,34 @@ export function extractBits(
 			`Bit range [${bitOffset}, ${bitOffset + bitLength - 1}] exceeds buffer length ${buffer.length} bytes (${buffer.length * 8} bits)`,
 		);
 	}
+}
 
-	let result = 0;
-
-	for (let i = 0; i < bitLength; i++) {
-		const bitPos = bitOffset + i;
-		const byteIdx = Math.floor(bitPos / 8);
-		// In big-endian bit order, bit 0 of a byte is the MSB (value 128)
-		const bitInByte = 7 - (bitPos % 8);
-		const bitValue = ((buffer[byteIdx] as number) >> bitInByte) & 1;
-		result = (result << 1) | bitValue;
+/**
+ * Load the field starting at `bitOffset` left-aligned in a 32-bit integer
+ * (its first bit becomes bit 31), reading each spanned byte once instead
+ * of walking the field bit by bit. Bits below the field are unspecified.
+ */
+function fieldWindow(
+	buffer: Uint8Array,
+	bitOffset: number,
+	bitLength: number,
+): number {
+	const byte = bitOffset >> 3;
+	const endByte = (bitOffset + bitLength - 1) >> 3;
+	const inByte = bitOffset & 7;
+	let window = 0;
+	for (let i = 0; i < 4; i++) {
+		window <<= 8;
+		if (byte + i <= endByte) {
+			window |= buffer[byte + i] as number;
+		}
 	}
-
-	return result >>> 0; // ensure unsigned 32-bit
+	window <<= inByte;
+	if (endByte - byte === 4) {
+		// A field starting mid-byte can reach into a fifth byte
+		window |= (buffer[byte + 4] as number) >>> (8 - inByte);
+	}
+	return window;
 }
 
 /**
@@ -147,16 +171,10 @@ export function extractSignedBits(
 		);
 	}
 
-	const unsigned = extractBits(buffer, bitOffset, bitLength);
-
-	// Check if the sign bit (MSB of the extracted field) is set
-	const signBit = 1 << (bitLength - 1);
-	if (unsigned & signBit) {
-		// Two's complement: subtract 2^bitLength
-		return unsigned - (1 << bitLength);
-	}
+	checkBitRange(buffer, bitOffset, bitLength);
 
-	return unsigned;
+	// Arithmetic shift copies the field's MSB (the sign bit) down
+	return fieldWindow(buffer, bitOffset, bitLength) >> (32 - bitLength);
 }
 
 /**
@@ -0,0 +1,310 @@
+/**
+ * Precompiled bit-field extraction plans.
+ *
+ * Live-data decoders (MUT-III RAX, Subaru SST) decode the same block layout
+ * on every frame. Calling `extractBits()` per parameter re-derives byte
+ * indices and walks the field each time. A plan does that work once: every
+ * field is classified by its byte alignment and lowered to a pair of shifts
+ * over a single big-endian 32-bit window load, and the results are written
+ * straight into a caller-owned `Float64Array` slot. Running a plan does not
+ * allocate (beyond a `DataView` when the buffer changes).
+ *
+ * Uses the same big-endian bit numbering as `extractBits()`
+ * (bit 0 = MSB of byte 0). Fields are unsigned unless marked `signExtend`.
+ *
+ * @module binary/bit-field-plan
+ */
+
+/**
+ * A bit field to extract and convert.
+ */
+export interface BitFieldDef {
+	/** Starting bit offset (big-endian, 0 = MSB of byte 0) */
+	readonly bitOffset: number;
+	/** Number of bits (1-32) */
+	readonly bitLength: number;
+	/**
+	 * Interpret the field as two's complement, as `extractSignedBits()`
+	 * does, before `convert` sees it (requires bitLength ≥ 2)
+	 */
+	readonly signExtend?: boolean;
+	/** Conversion from raw integer to physical units */
+	readonly convert?: (raw: number) => number;
+}
+
+/**
+ * A field paired with the output slot its converted value is written to.
+ */
+export interface BitFieldPlanEntry {
+	readonly field: BitFieldDef;
+	/** Index into the output `Float64Array` */
+	readonly slot: number;
+}
+
+const identity = (raw: number): number => raw;
+
+/**
+ * Compiled extraction plan.
+ *
+ * Fields are grouped by alignment so each group runs a tight loop over
+ * parallel typed arrays:
+ * - `u8`: unsigned whole byte on a byte boundary
+ * - `u16`: unsigned two whole bytes on a byte boundary
+ * - `packed`: any other field spanning at most 4 bytes. One 32-bit load at
+ *   `packedByte`, then `(window << packedLeft) >>> packedRight` (or `>>`
+ *   when sign-extending). Windows near the end of the block start early so
+ *   they never read past `byteLength` (unless the block is under 4 bytes).
+ * - `wide`: fields spanning 5 bytes (only possible for ≥ 26-bit fields
+ *   that start mid-byte): one 32-bit load plus the trailing byte
+ */
+export interface BitFieldPlan {
+	/** Minimum buffer length (from the start offset) needed to run the plan */
+	readonly byteLength: number;
+	/** Number of fields in the plan */
+	readonly fieldCount: number;
+
+	readonly u8Byte: Uint16Array;
+	readonly u8Slot: Uint32Array;
+	readonly u8Convert: readonly ((raw: number) => number)[];
+
+	readonly u16Byte: Uint16Array;
+	readonly u16Slot: Uint32Array;
+	readonly u16Convert: readonly ((raw: number) => number)[];
+
+	readonly packedByte: Uint16Array;
+	readonly packedLeft: Uint8Array;
+	readonly packedRight: Uint8Array;
+	readonly packedSigned: Uint8Array;
+	readonly packedSlot: Uint32Array;
+	readonly packedConvert: readonly ((raw: number) => number)[];
+
+	readonly wideByte: Uint16Array;
+	/** Bits of the trailing byte below the field */
+	readonly wideLow: Uint8Array;
+	readonly wideRight: Uint8Array;
+	readonly wideSigned: Uint8Array;
+	readonly wideSlot: Uint32Array;
+	readonly wideConvert: readonly ((raw: number) => number)[];
+}
+
+/**
+ * Compile a set of bit fields into an extraction plan.
+ *
+ * @param entries - Fields and the output slots they write to
+ * @returns A plan that can be run repeatedly with {@link runBitFieldPlan}
+ * @throws Error if a field has a bitLength outside 1-32 (2-32 when
+ *   sign-extending) or a negative offset
+ *
+ * @example
+ * const plan = compileBitFieldPlan([
+ *   { field: { bitOffset: 11, bitLength: 11, convert: (r) => r * 7.8125 }, slot: 0 },
+ *   { field: { bitOffset: 24, bitLength: 7, signExtend: true }, slot: 1 },
+ * ]);
+ * const values = new Float64Array(2);
+ * runBitFieldPlan(plan, buffer, values);
+ */
+export function compileBitFieldPlan(
+	entries: readonly BitFieldPlanEntry[],
+): BitFieldPlan {
+	const u8: { byte: number; slot: number; convert: (raw: number) => number }[] =
+		[];
+	const u16: typeof u8 = [];
+	const packed: {
+		bitOffset: number;
+		bitLength: number;
+		signed: boolean;
+		slot: number;
+		convert: (raw: number) => number;
+	}[] = [];
+	const wide: {
+		byte: number;
+		low: number;
+		right: number;
+		signed: boolean;
+		slot: number;
+		convert: (raw: number) => number;
+	}[] = [];
+	let byteLength = 0;
+
+	for (const { field, slot } of entries) {
+		const { bitOffset, bitLength } = field;
+		const signed = field.signExtend === true;
+		if (bitLength <= 0 || bitLength > 32) {
+			throw new Error(`bitLength must be 1-32, got ${bitLength}`);
+		}
+		if (signed && bitLength < 2) {
+			throw new Error(
+				`bitLength must be at least 2 for signed extraction, got ${bitLength}`,
+			);
+		}
+		if (bitOffset < 0) {
+			throw new Error(`bitOffset must be non-negative, got ${bitOffset}`);
+		}
+		const convert = field.convert ?? identity;
+		const byte = bitOffset >> 3;
+		const endByte = (bitOffset + bitLength - 1) >> 3;
+		byteLength = Math.max(byteLength, endByte + 1);
+
+		const aligned = (bitOffset & 7) === 0;
+		if (aligned && bitLength === 8 && !signed) {
+			u8.push({ byte, slot, convert });
+		} else if (aligned && bitLength === 16 && !signed) {
+			u16.push({ byte, slot, convert });
+		} else if (endByte - byte < 4) {
+			packed.push({ bitOffset, bitLength, signed, slot, convert });
+		} else {
+			wide.push({
+				byte,
+				low: 40 - (bitOffset & 7) - bitLength,
+				right: 32 - bitLength,
+				signed,
+				slot,
+				convert,
+			});
+		}
+	}
+
+	// Window starts depend on the final block length
+	const packedByte = Uint16Array.from(packed, (f) =>
+		Math.min(f.bitOffset >> 3, Math.max(0, byteLength - 4)),
+	);
+
+	return {
+		byteLength,
+		fieldCount: entries.length,
+		u8Byte: Uint16Array.from(u8, (f) => f.byte),
+		u8Slot: Uint32Array.from(u8, (f) => f.slot),
+		u8Convert: u8.map((f) => f.convert),
+		u16Byte: Uint16Array.from(u16, (f) => f.byte),
+		u16Slot: Uint32Array.from(u16, (f) => f.slot),
+		u16Convert: u16.map((f) => f.convert),
+		packedByte,
+		packedLeft: Uint8Array.from(
+			packed,
+			(f, i) => f.bitOffset - (packedByte[i] as number) * 8,
+		),
+		packedRight: Uint8Array.from(packed, (f) => 32 - f.bitLength),
+		packedSigned: Uint8Array.from(packed, (f) => (f.signed ? 1 : 0)),
+		packedSlot: Uint32Array.from(packed, (f) => f.slot),
+		packedConvert: packed.map((f) => f.convert),
+		wideByte: Uint16Array.from(wide, (f) => f.byte),
+		wideLow: Uint8Array.from(wide, (f) => f.low),
+		wideRight: Uint8Array.from(wide, (f) => f.right),
+		wideSigned: Uint8Array.from(wide, (f) => (f.signed ? 1 : 0)),
+		wideSlot: Uint32Array.from(wide, (f) => f.slot),
+		wideConvert: wide.map((f) => f.convert),
+	};
+}
+
+// Decoders run plans against the same scratch buffer every frame
+let cachedView: DataView | null = null;
+
+function viewOf(buffer: Uint8Array): DataView {
+	if (
+		cachedView === null ||
+		cachedView.buffer !== buffer.buffer ||
+		cachedView.byteOffset !== buffer.byteOffset ||
+		cachedView.byteLength !== buffer.byteLength
+	) {
+		cachedView = new DataView(
+			buffer.buffer,
+			buffer.byteOffset,
+			buffer.byteLength,
+		);
+	}
+	return cachedView;
+}
+
+/**
+ * Load the big-endian 32-bit window at `byte`, zero-filling past the end of
+ * the buffer (only reachable for blocks shorter than 4 bytes)
+ */
+function window32(view: DataView, byte: number): number {
+	if (byte + 4 <= view.byteLength) {
+		return view.getUint32(byte);
+	}
+	let acc = 0;
+	for (let k = 0; k < 4; k++) {
+		const b = byte + k;
+		acc = (acc << 8) | (b < view.byteLength ? view.getUint8(b) : 0);
+	}
+	return acc;
+}
+
+/**
+ * Run a compiled plan against a buffer, writing each converted field value
+ * into `out[slot]`. Slots not covered by the plan are left untouched.
+ *
+ * Produces the same values as calling `extractBits()` (or
+ * `extractSignedBits()` for `signExtend` fields) and `convert` for each
+ * field, with one 32-bit load per field.
+ *
+ * @param plan - Plan from {@link compileBitFieldPlan}
+ * @param buffer - Source buffer
+ * @param out - Output values, indexed by slot
+ * @param byteOffset - Offset of the block within `buffer` (default 0)
+ * @throws Error if the buffer is too short for the plan
+ */
+export function runBitFieldPlan(
+	plan: BitFieldPlan,
+	buffer: Uint8Array,
+	out: Float64Array,
+	byteOffset = 0,
+): void {
+	if (byteOffset + plan.byteLength > buffer.length) {
+		throw new Error(
+			`Bit field plan needs ${plan.byteLength} bytes at offset ${byteOffset}, buffer has ${buffer.length}`,
+		);
+	}
+	const view = viewOf(buffer);
+
+	const { u8Byte, u8Slot, u8Convert } = plan;
+	for (let i = 0; i < u8Byte.length; i++) {
+		const raw = buffer[byteOffset + (u8Byte[i] as number)] as number;
+		out[u8Slot[i] as number] = (u8Convert[i] as (raw: number) => number)(raw);
+	}
+
+	const { u16Byte, u16Slot, u16Convert } = plan;
+	for (let i = 0; i < u16Byte.length; i++) {
+		const raw = view.getUint16(byteOffset + (u16Byte[i] as number));
+		out[u16Slot[i] as number] = (u16Convert[i] as (raw: number) => number)(
+			raw,
+		);
+	}
+
+	const {
+		packedByte,
+		packedLeft,
+		packedRight,
+		packedSigned,
+		packedSlot,
+		packedConvert,
+	} = plan;
+	for (let i = 0; i < packedByte.length; i++) {
+		const field =
+			window32(view, byteOffset + (packedByte[i] as number)) <<
+			(packedLeft[i] as number);
+		const right = packedRight[i] as number;
+		const raw = packedSigned[i] ? field >> right : field >>> right;
+		out[packedSlot[i] as number] = (
+			packedConvert[i] as (raw: number) => number
+		)(raw);
+	}
+
+	const { wideByte, wideLow, wideRight, wideSigned, wideSlot, wideConvert } =
+		plan;
+	for (let i = 0; i < wideByte.length; i++) {
+		const b = byteOffset + (wideByte[i] as number);
+		const low = wideLow[i] as number;
+		// The field ends in the fifth byte: drop the bits above it from the
+		// window and shift in the trailing byte's bits from below
+		const field =
+			((view.getUint32(b) << (8 - low)) | (view.getUint8(b + 4) >>> low)) <<
+			(wideRight[i] as number);
+		const right = wideRight[i] as number;
+		const raw = wideSigned[i] ? field >> right : field >>> right;
+		out[wideSlot[i] as number] = (wideConvert[i] as (raw: number) => number)(
+			raw,
+		);
+	}
+}
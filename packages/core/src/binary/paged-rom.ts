@@ -0,0 +1,502 @@
+/**
+ * Paged ROM store with dirty-page tracking and copy-on-write snapshots.
+ *
+ * The live ROM stays a single flat `Uint8Array` that editors, table views
+ * and checksums read and write directly, and it is also the committed
+ * contents of every page that has not changed. Writers announce an edit with
+ * {@link PagedRom.prepare} before touching the buffer: the pages it covers
+ * are copied at that point, so snapshots and the last saved version keep
+ * their contents while the live buffer moves on. A snapshot is just the
+ * current page list, and each retained version of the ROM costs memory
+ * proportional to its changes rather than its size.
+ *
+ * Pages that differ from the last saved version are tracked in a bitmap so
+ * a save only has to write those pages back.
+ *
+ * @module binary/paged-rom
+ */
+
+/** Default page size (4 KiB) */
+export const ROM_PAGE_SIZE = 0x1000;
+
+/**
+ * Contiguous byte range within a ROM
+ */
+export interface ByteRange {
+	offset: number;
+	length: number;
+}
+
+/**
+ * Committed contents of one page
+ *
+ * `bytes` is a view of the live buffer until the page is about to be
+ * written, when it is swapped for a copy. Every snapshot holding the page
+ * sees the swap, so none of them observe the write.
+ */
+export interface RomPage {
+	bytes: Uint8Array;
+}
+
+/**
+ * Immutable view of a ROM at one point in time
+ *
+ * Pages are shared with the {@link PagedRom} that produced the snapshot and
+ * with any other snapshot taken while they were unchanged.
+ */
+export class RomSnapshot {
+	/**
+	 * @param pages - Page list (must not be mutated after construction)
+	 * @param byteLength - ROM size in bytes
+	 * @param pageSize - Size of every page but possibly the last
+	 */
+	constructor(
+		private readonly pages: readonly RomPage[],
+		readonly byteLength: number,
+		readonly pageSize: number,
+	) {}
+
+	get pageCount(): number {
+		return this.pages.length;
+	}
+
+	/**
+	 * Get the bytes of one page (a shared view; do not modify)
+	 */
+	page(index: number): Uint8Array {
+		const page = this.pages[index];
+		if (!page) {
+			throw new Error(
+				`Page ${index} out of range (ROM has ${this.pages.length} pages)`,
+			);
+		}
+		return page.bytes;
+	}
+
+	/** Copy of the page list, for a {@link PagedRom} adopting this snapshot */
+	pageList(): RomPage[] {
+		return this.pages.slice();
+	}
+
+	/**
+	 * Copy `length` bytes starting at `offset` out of the snapshot
+	 */
+	read(offset: number, length: number): Uint8Array {
+		if (offset < 0 || length < 0 || offset + length > this.byteLength) {
+			throw new Error(
+				`Range 0x${offset.toString(16)}+${length} exceeds ROM size ${this.byteLength}`,
+			);
+		}
+		const out = new Uint8Array(length);
+		let position = offset;
+		while (position < offset + length) {
+			const index = Math.floor(position / this.pageSize);
+			const pageStart = index * this.pageSize;
+			const page = this.page(index);
+			const from = position - pageStart;
+			const to = Math.min(page.length, offset + length - pageStart);
+			out.set(page.subarray(from, to), position - offset);
+			position = pageStart + to;
+		}
+		return out;
+	}
+
+	/**
+	 * Materialize the whole snapshot as one buffer
+	 */
+	toBytes(): Uint8Array {
+		const out = new Uint8Array(this.byteLength);
+		for (const [index, page] of this.pages.entries()) {
+			out.set(page.bytes, index * this.pageSize);
+		}
+		return out;
+	}
+
+	/**
+	 * Whether `bytes` holds exactly this snapshot's contents
+	 */
+	equals(bytes: Uint8Array): boolean {
+		if (bytes.length !== this.byteLength) {
+			return false;
+		}
+		for (const [index, { bytes: page }] of this.pages.entries()) {
+			const start = index * this.pageSize;
+			if (!pageEquals(page, bytes.subarray(start, start + page.length))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Page-aligned ranges where this snapshot differs from `other`
+	 *
+	 * Pages shared between the two snapshots are skipped without comparing
+	 * their bytes, so diffing two versions of a ROM costs time proportional to
+	 * the pages that were replaced between them.
+	 *
+	 * @throws Error if the snapshots have different sizes or page sizes
+	 */
+	diff(other: RomSnapshot): ByteRange[] {
+		if (
+			other.byteLength !== this.byteLength ||
+			other.pageSize !== this.pageSize
+		) {
+			throw new Error(
+				`Cannot diff snapshots of different layouts (${this.byteLength}/${this.pageSize} vs ${other.byteLength}/${other.pageSize})`,
+			);
+		}
+		const changed: number[] = [];
+		for (const [index, page] of this.pages.entries()) {
+			const otherPage = other.pages[index] as RomPage;
+			if (page !== otherPage && !pageEquals(page.bytes, otherPage.bytes)) {
+				changed.push(index);
+			}
+		}
+		return pagesToRanges(changed, this.pageSize, this.byteLength);
+	}
+}
+
+/**
+ * Live ROM buffer backed by copy-on-write pages
+ *
+ * Edits are announced with {@link prepare}, made to {@link bytes} in place
+ * and then reported with {@link commit}, mirroring how `RomDocument` is
+ * notified.
+ *
+ * @example
+ * ```typescript
+ * const rom = new PagedRom(romBytes);
+ * rom.prepare(address, newValue.length);
+ * romBytes.set(newValue, address);
+ * rom.commit(address, newValue.length);
+ *
+ * const snapshot = rom.snapshot();
+ * for (const { offset, length } of rom.dirtyRanges()) {
+ *   await write(offset, snapshot.read(offset, length));
+ * }
+ * rom.markSaved(snapshot);
+ * ```
+ */
+export class PagedRom {
+	private _bytes: Uint8Array;
+	/** Committed contents; unchanged pages are views of {@link _bytes} */
+	private pages: RomPage[];
+	/** Contents as of the last save */
+	private saved: RomPage[];
+	/** Pages copied by {@link prepare} and not yet committed */
+	private readonly pending = new Set<number>();
+	/** One bit per page: set when the page differs from {@link saved} */
+	private dirty: Uint32Array;
+
+	/**
+	 * @param bytes - Live ROM buffer (not copied; later edits are read from it)
+	 * @param pageSize - Page size in bytes
+	 * @throws Error if pageSize is not a positive integer
+	 */
+	constructor(
+		bytes: Uint8Array,
+		readonly pageSize = ROM_PAGE_SIZE,
+	) {
+		if (!Number.isInteger(pageSize) || pageSize <= 0) {
+			throw new Error(`Invalid page size: ${pageSize}`);
+		}
+		this._bytes = bytes;
+		this.pages = splitPages(bytes, pageSize);
+		this.saved = this.pages.slice();
+		this.dirty = new Uint32Array(Math.ceil(this.pages.length / 32));
+	}
+
+	/** Live ROM buffer */
+	get bytes(): Uint8Array {
+		return this._bytes;
+	}
+
+	get byteLength(): number {
+		return this._bytes.length;
+	}
+
+	get pageCount(): number {
+		return this.pages.length;
+	}
+
+	/**
+	 * Number of pages that differ from the last saved version
+	 */
+	get dirtyPageCount(): number {
+		let count = 0;
+		for (const word of this.dirty) {
+			count += popcount(word);
+		}
+		return count;
+	}
+
+	/**
+	 * Announce a write to `bytes[offset, offset + length)`
+	 *
+	 * Must be called before the live buffer changes: the committed contents
+	 * of the pages in the range are copied so snapshots keep them. Preparing a
+	 * page again before it is committed is free.
+	 */
+	prepare(offset: number, length: number): void {
+		const range = this.pageRange(offset, length);
+		if (!range) {
+			return;
+		}
+		for (let index = range.first; index <= range.last; index++) {
+			if (this.pending.has(index)) {
+				continue;
+			}
+			const page = this.pages[index] as RomPage;
+			page.bytes = page.bytes.slice();
+			this.pending.add(index);
+		}
+	}
+
+	/**
+	 * Committed contents of page `index` while it has a prepared write, or
+	 * null when it has none (its committed contents are then the live bytes)
+	 */
+	preparedPage(index: number): Uint8Array | null {
+		return this.pending.has(index)
+			? (this.pages[index] as RomPage).bytes
+			: null;
+	}
+
+	/**
+	 * Record in-place changes to `bytes[offset, offset + length)`
+	 *
+	 * Prepared pages in the range whose contents changed are replaced;
+	 * snapshots keep the pages they were taken with. A page in the range that
+	 * was never prepared cannot be compared and is marked dirty. Omit the
+	 * range to commit every prepared page.
+	 *
+	 * @returns Number of pages replaced
+	 */
+	commit(offset?: number, length?: number): number {
+		let indices: Iterable<number> = [...this.pending];
+		if (offset !== undefined && length !== undefined) {
+			const range = this.pageRange(offset, length);
+			if (!range) {
+				return 0;
+			}
+			indices = rangeIndices(range.first, range.last);
+		}
+
+		let replaced = 0;
+		for (const index of indices) {
+			const live = this.liveView(index);
+			if (!this.pending.delete(index)) {
+				this.setDirty(index, true);
+				continue;
+			}
+			const page = this.pages[index] as RomPage;
+			if (pageEquals(page.bytes, live)) {
+				page.bytes = live;
+				continue;
+			}
+			// Going back to the saved contents (e.g. undo) shares the saved page
+			const saved = this.saved[index];
+			if (saved && saved !== page && pageEquals(saved.bytes, live)) {
+				saved.bytes = live;
+				this.pages[index] = saved;
+				this.setDirty(index, false);
+			} else {
+				this.pages[index] = { bytes: live };
+				this.setDirty(index, true);
+			}
+			replaced++;
+		}
+		return replaced;
+	}
+
+	/**
+	 * Track a replacement live buffer (e.g. one reloaded from disk)
+	 *
+	 * Pages are compared against the previous contents, so only those that
+	 * changed count as dirty. The previous buffer must not change afterwards.
+	 * Call {@link markSaved} afterwards when the new bytes are already what is
+	 * on disk.
+	 */
+	reset(bytes: Uint8Array): void {
+		const previous = this._bytes;
+		this._bytes = bytes;
+		this.pending.clear();
+		if (bytes.length !== previous.length) {
+			// Saved pages keep viewing the previous buffer until the next save
+			this.pages = splitPages(bytes, this.pageSize);
+			this.dirty = new Uint32Array(Math.ceil(this.pages.length / 32));
+			for (let index = 0; index < this.pages.length; index++) {
+				this.setDirty(index, true);
+			}
+			return;
+		}
+
+		for (const [index, page] of this.pages.entries()) {
+			const live = this.liveView(index);
+			if (pageEquals(page.bytes, live)) {
+				page.bytes = live;
+				continue;
+			}
+			if (page.bytes.buffer === previous.buffer) {
+				// Detach from the previous buffer so it can be collected
+				page.bytes = page.bytes.slice();
+			}
+			const saved = this.saved[index];
+			if (saved && saved !== page && pageEquals(saved.bytes, live)) {
+				saved.bytes = live;
+				this.pages[index] = saved;
+				this.setDirty(index, false);
+			} else {
+				this.pages[index] = { bytes: live };
+				this.setDirty(index, true);
+			}
+		}
+	}
+
+	/**
+	 * Capture the committed contents (O(pages), no bytes are copied)
+	 */
+	snapshot(): RomSnapshot {
+		return new RomSnapshot(
+			this.pages.slice(),
+			this._bytes.length,
+			this.pageSize,
+		);
+	}
+
+	/**
+	 * The version of the ROM that was last saved
+	 */
+	savedSnapshot(): RomSnapshot {
+		return new RomSnapshot(
+			this.saved.slice(),
+			this.saved.reduce((total, page) => total + page.bytes.length, 0),
+			this.pageSize,
+		);
+	}
+
+	/**
+	 * Whether page `index` differs from the last saved version
+	 */
+	isPageDirty(index: number): boolean {
+		return ((this.dirty[index >>> 5] ?? 0) & (1 << (index & 31))) !== 0;
+	}
+
+	/**
+	 * Dirty pages, with adjacent pages merged into one range
+	 */
+	dirtyRanges(): ByteRange[] {
+		const indices: number[] = [];
+		for (let index = 0; index < this.pages.length; index++) {
+			if (this.isPageDirty(index)) {
+				indices.push(index);
+			}
+		}
+		return pagesToRanges(indices, this.pageSize, this._bytes.length);
+	}
+
+	/**
+	 * Record that `snapshot` (default: the committed contents) is on disk
+	 *
+	 * Pages changed after the snapshot was taken stay dirty.
+	 *
+	 * @throws Error if the snapshot does not match this ROM's layout
+	 */
+	markSaved(snapshot: RomSnapshot = this.snapshot()): void {
+		if (
+			snapshot.byteLength !== this._bytes.length ||
+			snapshot.pageSize !== this.pageSize
+		) {
+			throw new Error(
+				`Snapshot layout (${snapshot.byteLength}/${snapshot.pageSize}) does not match ROM (${this._bytes.length}/${this.pageSize})`,
+			);
+		}
+		this.saved = snapshot.pageList();
+		for (let index = 0; index < this.pages.length; index++) {
+			this.setDirty(index, this.pages[index] !== this.saved[index]);
+		}
+	}
+
+	private liveView(index: number): Uint8Array {
+		const start = index * this.pageSize;
+		return this._bytes.subarray(start, start + this.pageSize);
+	}
+
+	/** Pages overlapping a byte range, or null if it covers none */
+	private pageRange(
+		offset: number,
+		length: number,
+	): { first: number; last: number } | null {
+		if (length <= 0 || this.pages.length === 0) {
+			return null;
+		}
+		return {
+			first: Math.max(0, Math.floor(offset / this.pageSize)),
+			last: Math.min(
+				this.pages.length - 1,
+				Math.floor((offset + length - 1) / this.pageSize),
+			),
+		};
+	}
+
+	private setDirty(index: number, dirty: boolean): void {
+		const word = index >>> 5;
+		const bit = 1 << (index & 31);
+		const current = this.dirty[word] ?? 0;
+		this.dirty[word] = dirty ? current | bit : current & ~bit;
+	}
+}
+
+function rangeIndices(first: number, last: number): number[] {
+	const indices: number[] = [];
+	for (let index = first; index <= last; index++) {
+		indices.push(index);
+	}
+	return indices;
+}
+
+function splitPages(bytes: Uint8Array, pageSize: number): RomPage[] {
+	const pages: RomPage[] = [];
+	for (let start = 0; start < bytes.length; start += pageSize) {
+		pages.push({ bytes: bytes.subarray(start, start + pageSize) });
+	}
+	return pages;
+}
+
+function pagesToRanges(
+	indices: readonly number[],
+	pageSize: number,
+	byteLength: number,
+): ByteRange[] {
+	const ranges: ByteRange[] = [];
+	for (const index of indices) {
+		const offset = index * pageSize;
+		const length = Math.min(pageSize, byteLength - offset);
+		const previous = ranges[ranges.length - 1];
+		if (previous && previous.offset + previous.length === offset) {
+			previous.length += length;
+		} else {
+			ranges.push({ offset, length });
+		}
+	}
+	return ranges;
+}
+
+function pageEquals(a: Uint8Array, b: Uint8Array): boolean {
+	if (a.length !== b.length) {
+		return false;
+	}
+	for (let i = 0; i < a.length; i++) {
+		if (a[i] !== b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+function popcount(word: number): number {
+	let value = word - ((word >>> 1) & 0x55555555);
+	value = (value & 0x33333333) + ((value >>> 2) & 0x33333333);
+	return (((value + (value >>> 4)) & 0x0f0f0f0f) * 0x01010101) >>> 24;
+}
@@ -0,0 +1,212 @@
+/**
+ * Incremental checksum maintenance
+ *
+ * Keeps the checksum of a live ROM buffer current as edits land, without
+ * rereading the whole image. Sum, XOR and mitsucan checksums are linear in
+ * the ROM bytes, so an edit only has to fold in `new - old` for each changed
+ * byte. Other algorithms fall back to a full recompute, deferred until the
+ * value is next read.
+ */
+
+import type { PagedRom } from "../binary/paged-rom.js";
+import type { ChecksumDefinition } from "../definition/rom.js";
+import { mitsucanChecksum } from "./algorithms.js";
+import { readChecksum, recomputeChecksum } from "./manager.js";
+
+// Mirrors the constants in mitsucanChecksum()
+const MITSUCAN_FIXUP_OFFSET = 0x0bfff0;
+const MITSUCAN_TARGET = 0x5aa55aa5;
+
+type IncrementalKind = "sum" | "xor" | "mitsucan";
+
+/**
+ * Live checksum state for one paged ROM
+ *
+ * The bytes an edit replaced are read from the {@link PagedRom}'s prepared
+ * pages, so call {@link update} after the live buffer changes but before
+ * the pages are committed. Call {@link reset} when the buffer itself is
+ * replaced.
+ *
+ * @example
+ * ```typescript
+ * const checksum = new IncrementalChecksum(pages, definition.checksum);
+ * pages.prepare(address, newValue.length);
+ * pages.bytes.set(newValue, address);
+ * checksum.update(address, newValue.length);
+ * pages.commit(address, newValue.length);
+ * writeChecksum(pages.bytes, checksum.expected, definition.checksum);
+ * ```
+ */
+export class IncrementalChecksum {
+	private readonly pages: PagedRom;
+	private readonly checksumDef: ChecksumDefinition;
+	private readonly kind: IncrementalKind | null;
+	/** Running sum/XOR; `null` when a full recompute is due */
+	private accumulator: number | null = null;
+
+	/**
+	 * @param pages - Paged live ROM (edits are read from its buffer)
+	 * @param checksumDef - Checksum definition
+	 * @throws Error if the definition's regions don't fit the ROM
+	 */
+	constructor(pages: PagedRom, checksumDef: ChecksumDefinition) {
+		this.pages = pages;
+		this.checksumDef = checksumDef;
+		this.kind = incrementalKind(checksumDef);
+		this.rebuild();
+	}
+
+	/**
+	 * Whether edits are folded in incrementally (otherwise each read after an
+	 * edit recomputes the checksum over the full regions)
+	 */
+	get incremental(): boolean {
+		return this.kind !== null;
+	}
+
+	/**
+	 * Checksum the ROM should carry for its current contents
+	 */
+	get expected(): number {
+		if (this.accumulator === null) {
+			this.rebuild();
+		}
+		return this.finalize(this.accumulator as number);
+	}
+
+	/**
+	 * Checksum currently stored in the ROM
+	 */
+	get stored(): number {
+		return readChecksum(this.pages.bytes, this.checksumDef);
+	}
+
+	/**
+	 * Whether the stored checksum matches the ROM contents
+	 */
+	get valid(): boolean {
+		return this.stored === this.expected;
+	}
+
+	/**
+	 * Fold in changes to `bytes[offset, offset + length)`
+	 *
+	 * Omit the range when it is unknown; the checksum is then recomputed, as
+	 * it is when a page in the range was not prepared.
+	 */
+	update(offset?: number, length?: number): void {
+		if (offset === undefined || length === undefined || this.kind === null) {
+			this.accumulator = null;
+			return;
+		}
+		if (this.accumulator === null) {
+			this.rebuild();
+			return;
+		}
+
+		const romBytes = this.pages.bytes;
+		const { pageSize } = this.pages;
+		const start = Math.max(0, offset);
+		const end = Math.min(romBytes.length, offset + length);
+		const committed: Uint8Array[] = [];
+		for (
+			let index = Math.floor(start / pageSize);
+			index * pageSize < end;
+			index++
+		) {
+			const page = this.pages.preparedPage(index);
+			if (page === null) {
+				this.accumulator = null;
+				return;
+			}
+			committed[index] = page;
+		}
+		const { offset: storageStart, size } = this.checksumDef.storage;
+		const storageEnd = storageStart + size;
+		let accumulator = this.accumulator;
+
+		// Regions are concatenated before checksumming; `base` tracks where
+		// each region starts in that stream (mitsucan words are aligned to it)
+		let base = 0;
+		for (const region of this.checksumDef.regions) {
+			const from = Math.max(start, region.start);
+			const to = Math.min(end, region.end);
+			for (let i = from; i < to; i++) {
+				const index = Math.floor(i / pageSize);
+				const page = committed[index] as Uint8Array;
+				const before = page[i - index * pageSize] as number;
+				const after = romBytes[i] as number;
+				// The storage bytes are zeroed when the checksum is computed
+				if (before === after || (i >= storageStart && i < storageEnd)) {
+					continue;
+				}
+				switch (this.kind) {
+					case "sum":
+						accumulator = (accumulator + after - before) & 0xff;
+						break;
+					case "xor":
+						accumulator ^= before ^ after;
+						break;
+					case "mitsucan": {
+						const position = base + i - region.start;
+						if (
+							position >= MITSUCAN_FIXUP_OFFSET &&
+							position < MITSUCAN_FIXUP_OFFSET + 4
+						) {
+							break;
+						}
+						const shift = (3 - (position & 3)) * 8;
+						const delta = (after - before) * 2 ** shift;
+						accumulator = (accumulator + delta) >>> 0;
+						break;
+					}
+				}
+			}
+			base += region.end - region.start;
+		}
+
+		this.accumulator = accumulator;
+	}
+
+	/**
+	 * Recompute after the pages were reset to a replacement buffer (e.g.
+	 * after revert or an external reload)
+	 */
+	reset(): void {
+		this.rebuild();
+	}
+
+	private rebuild(): void {
+		const value = recomputeChecksum(this.pages.bytes, this.checksumDef);
+		if (this.kind === null) {
+			this.accumulator = value;
+			// Recompute again on the next edit
+			return;
+		}
+		this.accumulator =
+			this.kind === "mitsucan" ? (MITSUCAN_TARGET - value) >>> 0 : value;
+	}
+
+	private finalize(accumulator: number): number {
+		return this.kind === "mitsucan"
+			? (MITSUCAN_TARGET - accumulator) >>> 0
+			: accumulator >>> 0;
+	}
+}
+
+function incrementalKind(
+	checksumDef: ChecksumDefinition,
+): IncrementalKind | null {
+	switch (checksumDef.algorithm) {
+		case "sum":
+			return "sum";
+		case "xor":
+			return "xor";
+		case "custom":
+			return checksumDef.customFunction === mitsucanChecksum
+				? "mitsucan"
+				: null;
+		default:
+			return null;
+	}
+}
@@ -27,12 +27,94 @@ export interface SearchText {
  * @returns The Levenshtein distance between the two strings
  */
 export function levenshteinDistance(a: string, b: string): number {
-	const aLen = a.length;
-	const bLen = b.length;
+	return boundedLevenshteinDistance(a, b, Infinity);
+}
+
+/**
+ * Calculates the Levenshtein distance between two strings, giving up once it
+ * is known to exceed `maxDistance`.
+ *
+ * When the shorter string fits in a machine word (32 characters, which
+ * covers nearly all table names and queries) this uses Myers' bit-parallel
+ * algorithm, processing a whole DP column per character of the longer
+ * string. Longer strings fall back to the row-by-row DP.
+ *
+ * @param a - First string to compare
+ * @param b - Second string to compare
+ * @param maxDistance - Largest distance of interest
+ * @returns The distance, or `maxDistance + 1` if it exceeds `maxDistance`
+ */
+export function boundedLevenshteinDistance(
+	a: string,
+	b: string,
+	maxDistance: number,
+): number {
+	const [pattern, text] = a.length <= b.length ? [a, b] : [b, a];
 
 	// Handle empty strings
-	if (aLen === 0) return bLen;
-	if (bLen === 0) return aLen;
+	if (pattern.length === 0) {
+		return text.length > maxDistance ? maxDistance + 1 : text.length;
+	}
+	// Every extra character of the longer string costs at least one edit
+	if (text.length - pattern.length > maxDistance) {
+		return maxDistance + 1;
+	}
+
+	return pattern.length <= 32
+		? myersDistance(pattern, text, maxDistance)
+		: dpDistance(pattern, text, maxDistance);
+}
+
+/**
+ * Myers (1999) bit-vector edit distance, in Hyyrö's formulation for global
+ * alignment. Bit `i` of the vertical delta vectors describes row `i + 1` of
+ * the DP column; `score` tracks the bottom cell.
+ */
+function myersDistance(
+	pattern: string,
+	text: string,
+	maxDistance: number,
+): number {
+	const m = pattern.length;
+	const n = text.length;
+	const peq = new Map<number, number>();
+	for (let i = 0; i < m; i++) {
+		const code = pattern.charCodeAt(i);
+		peq.set(code, (peq.get(code) ?? 0) | (1 << i));
+	}
+
+	const last = 1 << (m - 1);
+	let pv = -1;
+	let mv = 0;
+	let score = m;
+	for (let j = 0; j < n; j++) {
+		const eq = peq.get(text.charCodeAt(j)) ?? 0;
+		const xv = eq | mv;
+		// Carries out of bit 31 are dropped by the int32 conversion of `^`
+		const xh = (((eq & pv) + pv) ^ pv) | eq;
+		let ph = mv | ~(xh | pv);
+		let mh = pv & xh;
+		if (ph & last) {
+			score++;
+		} else if (mh & last) {
+			score--;
+		}
+		ph = (ph << 1) | 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+
+		// The score drops by at most one per remaining column
+		if (score - (n - j - 1) > maxDistance) {
+			return maxDistance + 1;
+		}
+	}
+	return score;
+}
+
+function dpDistance(a: string, b: string, maxDistance: number): number {
+	const aLen = a.length;
+	const bLen = b.length;
 
 	// Use a more memory-efficient algorithm with two rows
 	let previousRow: number[] = [];
@@ -47,20 +129,29 @@ export function levenshteinDistance(a: string, b: string): number {
 	for (let i = 1; i <= aLen; i++) {
 		// Initialize current row
 		currentRow = [i];
+		let rowMin = i;
 
 		for (let j = 1; j <= bLen; j++) {
 			const cost = a.charAt(i - 1) === b.charAt(j - 1) ? 0 : 1;
 			const deletion = (previousRow[j] ?? 0) + 1;
 			const insertion = (currentRow[j - 1] ?? 0) + 1;
 			const substitution = (previousRow[j - 1] ?? 0) + cost;
-			currentRow[j] = Math.min(deletion, insertion, substitution);
+			const cell = Math.min(deletion, insertion, substitution);
+			currentRow[j] = cell;
+			rowMin = Math.min(rowMin, cell);
+		}
+
+		// Row minima never decrease, so the distance is already out of range
+		if (rowMin > maxDistance) {
+			return maxDistance + 1;
 		}
 
 		// Swap rows
 		[previousRow, currentRow] = [currentRow, previousRow];
 	}
 
-	return previousRow[bLen] ?? Infinity;
+	const distance = previousRow[bLen] ?? Infinity;
+	return distance > maxDistance ? maxDistance + 1 : distance;
 }
 
 /**
@@ -89,9 +180,15 @@ function extractBaseName(candidate: string): string {
  *
  * @param input - The query string
  * @param candidate - The candidate string to score
+ * @param minScore - Scores below this are not of interest; the Levenshtein
+ *   level stops early and returns some score below it
  * @returns Score between 0 and 1 (higher = better match)
  */
-export function scoreCandidate(input: string, candidate: string): number {
+export function scoreCandidate(
+	input: string,
+	candidate: string,
+	minScore = 0,
+): number {
 	const lowerInput = input.toLowerCase();
 	const lowerCandidate = candidate.toLowerCase();
 
@@ -113,7 +210,13 @@ export function scoreCandidate(input: string, candidate: string): number {
 
 	// Level 3: Normalized Levenshtein
 	const maxLen = Math.max(lowerInput.length, lowerCandidate.length);
-	const distance = levenshteinDistance(lowerInput, lowerCandidate);
+	const maxDistance =
+		minScore > 0 ? Math.max(0, Math.floor((1 - minScore) * maxLen)) : Infinity;
+	const distance = boundedLevenshteinDistance(
+		lowerInput,
+		lowerCandidate,
+		maxDistance,
+	);
 	return Math.max(0, Math.min(0.84, 1 - distance / maxLen));
 }
 
@@ -171,8 +274,12 @@ export function rankCandidates<T>(
 
 			let best: RankedMatch<T> | null = null;
 			for (const entry of searchTexts) {
+				const weight = entry.weight ?? 1;
+				// Token scores are averaged below, so only the whole-input score
+				// can be cut off at the threshold
+				const threshold = weight > 0 ? minScore / weight : 0;
 				const weightedScore =
-					scoreCandidate(input, entry.text) * (entry.weight ?? 1);
+					scoreCandidate(input, entry.text, threshold) * weight;
 				if (best === null || weightedScore > best.score) {
 					best = {
 						value: candidate,
@@ -58,8 +58,9 @@ export async function discoverRomDefinitionCandidates(
 
 	for (const provider of providers) {
 		const uris = await provider.discoverDefinitionUris(romUri);
-		for (const uri of uris) {
-			const peek = await provider.peek(uri);
+		// Peek concurrently; providers bound their own I/O
+		const peeks = await Promise.all(uris.map((uri) => provider.peek(uri)));
+		for (const peek of peeks) {
 			allDefinitions.push({ provider, peek });
 			const score = scoreRomDefinition(romBytes, peek);
 			if (score > 0) {
@@ -38,6 +38,310 @@ function getTableSearchTexts(table: TableDefinition): SearchText[] {
 	return texts.filter((entry) => entry.text.trim().length > 0);
 }
 
+/** Candidates kept after trigram prefiltering, beyond full-trigram hits */
+const DEFAULT_MAX_CANDIDATES = 256;
+
+function trigramsOf(text: string): string[] {
+	const trigrams: string[] = [];
+	for (let i = 0; i + 3 <= text.length; i++) {
+		trigrams.push(text.slice(i, i + 3));
+	}
+	return trigrams;
+}
+
+function wordsOf(text: string): string[] {
+	return text
+		.toLowerCase()
+		.split(/[^a-z0-9]+/)
+		.filter((word) => word.length > 0);
+}
+
+/**
+ * Whether `word` starts with `typed` give or take one inserted, deleted or
+ * substituted letter, or one swap of neighbouring letters
+ */
+function startsWithTypo(word: string, typed: string): boolean {
+	for (const length of [typed.length - 1, typed.length, typed.length + 1]) {
+		if (length > 0 && length <= word.length) {
+			if (isOneEditApart(word.slice(0, length), typed)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+function isOneEditApart(a: string, b: string): boolean {
+	if (Math.abs(a.length - b.length) > 1) {
+		return false;
+	}
+	let start = 0;
+	while (start < a.length && start < b.length && a[start] === b[start]) {
+		start++;
+	}
+	let endA = a.length;
+	let endB = b.length;
+	while (endA > start && endB > start && a[endA - 1] === b[endB - 1]) {
+		endA--;
+		endB--;
+	}
+	const restA = a.slice(start, endA);
+	const restB = b.slice(start, endB);
+	if (restA.length <= 1 && restB.length <= 1) {
+		return true;
+	}
+	// Neighbouring letters swapped
+	return (
+		restA.length === 2 &&
+		restB.length === 2 &&
+		restA[0] === restB[1] &&
+		restA[1] === restB[0]
+	);
+}
+
+/**
+ * Trigram inverted index over a definition's tables
+ *
+ * Indexes the lowercased name, ID, category and the other metadata
+ * {@link rankTablesByQuery} scores against. A query is answered by counting,
+ * per table, how many of the query's trigrams it contains; the tables
+ * sharing the most trigrams with the query are then scored with the fuzzy
+ * matcher. Any text containing the query contains all of its trigrams, so
+ * substring matches always survive the prefilter. Budget the trigram hits
+ * leave over goes to tables with a name or category word one edit (or one
+ * swap of neighbouring letters) away from a query word, so typos that share
+ * no trigram with their target ("fule" for "Fuel") are still scored.
+ *
+ * Hit counts are kept between queries and adjusted by the trigrams that
+ * were added or removed, so re-querying as the user types (or deletes)
+ * costs time proportional to the change.
+ *
+ * Obtain instances with {@link getTableSearchIndex} so the index is built
+ * once per definition.
+ */
+export class TableSearchIndex {
+	private readonly postings = new Map<string, number[]>();
+	private readonly names: string[];
+	private readonly categories: string[];
+	/** Lowercased words of each table's name and category */
+	private readonly words: string[][];
+	/** Per-table count of query trigrams present, for {@link lastTrigrams} */
+	private readonly hits: Uint16Array;
+	private lastTrigrams: string[] = [];
+
+	constructor(readonly tables: readonly TableDefinition[]) {
+		this.names = tables.map((table) => table.name.toLowerCase());
+		this.categories = tables.map((table) =>
+			(table.category ?? "").toLowerCase(),
+		);
+		this.words = tables.map((table) =>
+			wordsOf(`${table.name} ${table.category ?? ""}`),
+		);
+		this.hits = new Uint16Array(tables.length);
+
+		for (const [index, table] of tables.entries()) {
+			const trigrams = new Set<string>();
+			const texts = [
+				table.id,
+				...getTableSearchTexts(table).map((entry) => entry.text),
+			];
+			for (const text of texts) {
+				for (const trigram of trigramsOf(text.toLowerCase())) {
+					trigrams.add(trigram);
+				}
+			}
+			for (const trigram of trigrams) {
+				let list = this.postings.get(trigram);
+				if (!list) {
+					list = [];
+					this.postings.set(trigram, list);
+				}
+				list.push(index);
+			}
+		}
+	}
+
+	/**
+	 * Tables worth scoring against `query`
+	 *
+	 * Queries shorter than three characters have no trigrams and return every
+	 * table. Otherwise returns every table containing all of the query's
+	 * trigrams, then the tables sharing the most trigrams, then tables whose
+	 * name or category words are a typo away from the query's, up to
+	 * `maxCandidates` in total.
+	 */
+	candidates(
+		query: string,
+		maxCandidates = DEFAULT_MAX_CANDIDATES,
+	): TableDefinition[] {
+		const trigrams = this.updateHits(query.toLowerCase());
+		if (trigrams.length === 0) {
+			return [...this.tables];
+		}
+
+		const full: number[] = [];
+		const partial: number[] = [];
+		for (let index = 0; index < this.hits.length; index++) {
+			const count = this.hits[index] as number;
+			if (count === trigrams.length) {
+				full.push(index);
+			} else if (count > 0) {
+				partial.push(index);
+			}
+		}
+		const room = Math.max(0, maxCandidates - full.length);
+		if (partial.length > room) {
+			partial.sort(
+				(a, b) => (this.hits[b] as number) - (this.hits[a] as number),
+			);
+			partial.length = room;
+		}
+		const typos =
+			partial.length < room
+				? this.closestByTypos(query, room - partial.length)
+				: [];
+		return [...full, ...partial, ...typos].map(
+			(index) => this.tables[index] as TableDefinition,
+		);
+	}
+
+	/**
+	 * Rank tables against `query` (see {@link rankTablesByQuery})
+	 */
+	rank(
+		query: string,
+		options: {
+			maxResults?: number;
+			minScore?: number;
+			maxCandidates?: number;
+		} = {},
+	): RankedTableMatch[] {
+		if (!query) {
+			return [];
+		}
+		const { maxCandidates, ...rankOptions } = options;
+		return rankCandidates(
+			query,
+			this.candidates(query, maxCandidates),
+			getTableSearchTexts,
+			{ ...rankOptions, tokenizeInput: true },
+		);
+	}
+
+	/**
+	 * Tables whose name or category contains `query` (case-insensitive), in
+	 * definition order
+	 */
+	filter(query: string): TableDefinition[] {
+		const lowerQuery = query.toLowerCase();
+		const trigrams = this.updateHits(lowerQuery);
+		const matches: TableDefinition[] = [];
+		for (const [index, table] of this.tables.entries()) {
+			if (trigrams.length > 0 && this.hits[index] !== trigrams.length) {
+				continue;
+			}
+			if (
+				(this.names[index] as string).includes(lowerQuery) ||
+				(this.categories[index] as string).includes(lowerQuery)
+			) {
+				matches.push(table);
+			}
+		}
+		return matches;
+	}
+
+	/**
+	 * Up to `limit` tables sharing no trigram with the query, ordered by how
+	 * many query words are one typo away from the start of a word in their
+	 * name or category
+	 */
+	private closestByTypos(query: string, limit: number): number[] {
+		const queryWords = wordsOf(query).filter((word) => word.length >= 3);
+		const scored: { index: number; matched: number }[] = [];
+		for (let index = 0; index < this.words.length; index++) {
+			if (this.hits[index] !== 0) continue;
+			const words = this.words[index] as string[];
+			let matched = 0;
+			for (const queryWord of queryWords) {
+				if (words.some((word) => startsWithTypo(word, queryWord))) {
+					matched++;
+				}
+			}
+			if (matched > 0) {
+				scored.push({ index, matched });
+			}
+		}
+		scored.sort((a, b) => b.matched - a.matched);
+		return scored.slice(0, limit).map((entry) => entry.index);
+	}
+
+	/**
+	 * Bring {@link hits} in line with `query`, touching only the postings of
+	 * trigrams that differ from the previous query
+	 */
+	private updateHits(query: string): string[] {
+		const next = trigramsOf(query);
+		const previous = this.lastTrigrams;
+		let common = 0;
+		while (
+			common < previous.length &&
+			common < next.length &&
+			previous[common] === next[common]
+		) {
+			common++;
+		}
+		for (let i = common; i < previous.length; i++) {
+			for (const index of this.postings.get(previous[i] as string) ?? []) {
+				this.hits[index] = (this.hits[index] as number) - 1;
+			}
+		}
+		for (let i = common; i < next.length; i++) {
+			for (const index of this.postings.get(next[i] as string) ?? []) {
+				this.hits[index] = (this.hits[index] as number) + 1;
+			}
+		}
+		this.lastTrigrams = next;
+		return next;
+	}
+}
+
+const tableSearchIndexes = new WeakMap<
+	readonly TableDefinition[],
+	TableSearchIndex
+>();
+
+/**
+ * Get the search index for a table list, building it on first use
+ *
+ * Indexes are cached per array; an index is rebuilt if the array's entries
+ * changed since it was built (tables added, removed or replaced).
+ */
+export function getTableSearchIndex(
+	tables: readonly TableDefinition[],
+): TableSearchIndex {
+	let index = tableSearchIndexes.get(tables);
+	if (!index || !sameTables(index.tables, tables)) {
+		index = new TableSearchIndex([...tables]);
+		tableSearchIndexes.set(tables, index);
+	}
+	return index;
+}
+
+function sameTables(
+	indexed: readonly TableDefinition[],
+	tables: readonly TableDefinition[],
+): boolean {
+	if (indexed.length !== tables.length) {
+		return false;
+	}
+	for (let i = 0; i < tables.length; i++) {
+		if (indexed[i] !== tables[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 export function rankTablesByQuery(
 	query: string,
 	tables: TableDefinition[],
@@ -46,10 +350,7 @@ export function rankTablesByQuery(
 		minScore?: number;
 	} = {},
 ): RankedTableMatch[] {
-	return rankCandidates(query, tables, getTableSearchTexts, {
-		...options,
-		tokenizeInput: true,
-	});
+	return getTableSearchIndex(tables).rank(query, options);
 }
 
 export function findClosestTableMatches(
@@ -1,6 +1,9 @@
 export * from "./binary/bit-extract.js";
+export * from "./binary/bit-field-plan.js";
+export * from "./binary/paged-rom.js";
 export * from "./binary.js";
 export * from "./checksum/algorithms.js";
+export * from "./checksum/incremental.js";
 export * from "./checksum/manager.js";
 export * from "./definition/fuzzy-match.js";
 export * from "./definition/match.js";
@@ -9,6 +12,8 @@ export * from "./definition/resolution.js";
 export * from "./definition/rom.js";
 export * from "./definition/table.js";
 export * from "./definition/table-search.js";
+export * from "./logging/log-binning.js";
+export * from "./logging/sample-fusion.js";
 export * from "./math/operations.js";
 export * from "./runtime.js";
 export * from "./units.js";
@@ -0,0 +1,368 @@
+/**
+ * Binning of logged samples onto table axes.
+ *
+ * Tuning compares what the engine did with what a map asks for: AFR, knock
+ * or boost error logged against RPM and load, grouped by the breakpoints of
+ * the table that governs them. {@link LogBinner} accumulates samples into a
+ * grid shaped like the table in one streaming pass and keeps count, weight,
+ * min, max, mean and variance per cell, without storing the samples.
+ *
+ * Grids are row-major like table data: rows follow the Y axis and columns
+ * the X axis. A 1D table bins onto a single row.
+ *
+ * @module logging/log-binning
+ */
+
+import type { TableDefinition } from "../definition/table.js";
+import { TableView } from "../view/table.js";
+
+/**
+ * How a sample is assigned to cells
+ *
+ * - `nearest`: the whole sample goes to the cell of the nearest breakpoint
+ * - `interpolate`: the sample is split between the surrounding cells with
+ *   the same (bi)linear weights the ECU uses when it reads the table
+ */
+export type BinWeighting = "nearest" | "interpolate";
+
+/**
+ * Options for {@link LogBinner}
+ */
+export interface LogBinnerOptions {
+	/** X (column) breakpoints, strictly ascending or descending */
+	xAxis: ArrayLike<number>;
+	/** Y (row) breakpoints; omit for a single row */
+	yAxis?: ArrayLike<number>;
+	/** Cell assignment (default "nearest") */
+	weighting?: BinWeighting;
+	/**
+	 * Samples beyond the first or last breakpoint are counted in the edge
+	 * cell (`clamp`, default) or dropped (`skip`)
+	 */
+	outOfRange?: "clamp" | "skip";
+}
+
+/**
+ * Per-cell statistics produced by {@link LogBinner.result}
+ *
+ * Every array has `rows * cols` entries in row-major order. Statistics of
+ * cells without samples are NaN.
+ */
+export interface BinnedGrid {
+	rows: number;
+	cols: number;
+	xAxis: number[];
+	yAxis: number[] | undefined;
+	/** Samples that contributed to each cell */
+	count: Uint32Array;
+	/** Total weight of each cell (`count` when unweighted and nearest) */
+	weight: Float64Array;
+	/** Weighted mean */
+	mean: Float64Array;
+	min: Float64Array;
+	max: Float64Array;
+	/** Weighted population standard deviation */
+	stddev: Float64Array;
+}
+
+/**
+ * Columns fed to {@link LogBinner.addColumns}, indexed by row
+ */
+export interface BinColumns {
+	x: ArrayLike<number>;
+	/** Required when the binner has a Y axis */
+	y?: ArrayLike<number>;
+	value: ArrayLike<number>;
+	/** Per-sample weight (default 1) */
+	weight?: ArrayLike<number>;
+}
+
+/**
+ * Finds the breakpoint interval of a value
+ *
+ * Consecutive log samples usually fall in the same or a neighbouring
+ * interval, so the previous result is tried before a binary search.
+ */
+class AxisLocator {
+	readonly length: number;
+	/** Breakpoints, negated for descending axes so the search is ascending */
+	private readonly points: Float64Array;
+	private readonly sign: number;
+	private hint = 0;
+	/** Lower breakpoint of the last located interval */
+	index = 0;
+	/** Position between `index` and `index + 1`, from 0 to 1 */
+	fraction = 0;
+
+	constructor(axis: ArrayLike<number>, label: string) {
+		this.length = axis.length;
+		if (this.length === 0) {
+			throw new Error(`${label} axis has no breakpoints`);
+		}
+		const first = axis[0] as number;
+		const last = axis[this.length - 1] as number;
+		this.sign = last < first ? -1 : 1;
+		this.points = Float64Array.from(axis, (v) => v * this.sign);
+		for (let i = 0; i < this.length; i++) {
+			const point = this.points[i] as number;
+			if (
+				Number.isNaN(point) ||
+				(i > 0 && point <= (this.points[i - 1] as number))
+			) {
+				throw new Error(`${label} axis must be strictly monotonic`);
+			}
+		}
+	}
+
+	/**
+	 * Locate `value`, setting {@link index} and {@link fraction}
+	 *
+	 * @returns False if the value is NaN, or outside the axis and not clamped
+	 */
+	locate(value: number, clamp: boolean): boolean {
+		const v = value * this.sign;
+		if (Number.isNaN(v)) return false;
+		const points = this.points;
+		const last = this.length - 1;
+		const lowest = points[0] as number;
+		const highest = points[last] as number;
+		if ((v < lowest || v > highest) && !clamp) return false;
+		if (v <= lowest || last === 0) {
+			this.index = 0;
+			this.fraction = 0;
+			return true;
+		}
+		if (v >= highest) {
+			this.index = last - 1;
+			this.fraction = 1;
+			return true;
+		}
+
+		let i = this.hint;
+		if (!(v >= (points[i] as number) && v < (points[i + 1] as number))) {
+			let lo = 0;
+			let hi = last;
+			while (hi - lo > 1) {
+				const mid = (lo + hi) >>> 1;
+				if ((points[mid] as number) <= v) lo = mid;
+				else hi = mid;
+			}
+			i = lo;
+			this.hint = i;
+		}
+		const lower = points[i] as number;
+		this.index = i;
+		this.fraction = (v - lower) / ((points[i + 1] as number) - lower);
+		return true;
+	}
+}
+
+/**
+ * Streaming accumulator of samples on a table grid
+ *
+ * Statistics are updated incrementally (weighted Welford), so memory is
+ * proportional to the table, not the log, and {@link result} can be taken
+ * at any point while more samples keep arriving.
+ *
+ * @example
+ * const binner = new LogBinner({ xAxis: rpmAxis, yAxis: loadAxis });
+ * binner.addColumns({ x: rpm, y: load, value: afr }, selectedRows);
+ * const { mean, count } = binner.result();
+ */
+export class LogBinner {
+	readonly rows: number;
+	readonly cols: number;
+	readonly weighting: BinWeighting;
+	private readonly x: AxisLocator;
+	private readonly y: AxisLocator | null;
+	private readonly xAxis: number[];
+	private readonly yAxis: number[] | undefined;
+	private readonly clamp: boolean;
+	private readonly count: Uint32Array;
+	private readonly weights: Float64Array;
+	private readonly means: Float64Array;
+	/** Weighted sum of squared deviations from the mean */
+	private readonly squares: Float64Array;
+	private readonly mins: Float64Array;
+	private readonly maxes: Float64Array;
+
+	/**
+	 * @param options - Axes and binning behaviour
+	 * @throws Error if an axis is empty or not strictly monotonic
+	 */
+	constructor(options: LogBinnerOptions) {
+		this.x = new AxisLocator(options.xAxis, "X");
+		this.y = options.yAxis ? new AxisLocator(options.yAxis, "Y") : null;
+		this.xAxis = Array.from(options.xAxis);
+		this.yAxis = options.yAxis ? Array.from(options.yAxis) : undefined;
+		this.rows = this.y?.length ?? 1;
+		this.cols = this.x.length;
+		this.weighting = options.weighting ?? "nearest";
+		this.clamp = (options.outOfRange ?? "clamp") === "clamp";
+
+		const cells = this.rows * this.cols;
+		this.count = new Uint32Array(cells);
+		this.weights = new Float64Array(cells);
+		this.means = new Float64Array(cells);
+		this.squares = new Float64Array(cells);
+		this.mins = new Float64Array(cells).fill(Number.POSITIVE_INFINITY);
+		this.maxes = new Float64Array(cells).fill(Number.NEGATIVE_INFINITY);
+	}
+
+	/**
+	 * Add one sample
+	 *
+	 * @param x - Position on the X axis
+	 * @param y - Position on the Y axis (ignored without a Y axis)
+	 * @param value - Sample value
+	 * @param weight - Sample weight (default 1)
+	 * @returns False if the sample was dropped (NaN input, non-positive
+	 * weight, or out of range with `outOfRange: "skip"`)
+	 */
+	add(x: number, y: number, value: number, weight = 1): boolean {
+		if (Number.isNaN(value) || !(weight > 0)) return false;
+		if (!this.x.locate(x, this.clamp)) return false;
+		const { y: yAxis } = this;
+		if (yAxis && !yAxis.locate(y, this.clamp)) return false;
+
+		const col = this.x.index;
+		const fx = this.x.fraction;
+		const row = yAxis ? yAxis.index : 0;
+		const fy = yAxis ? yAxis.fraction : 0;
+
+		if (this.weighting === "nearest") {
+			const c = fx < 0.5 ? col : col + 1;
+			const r = fy < 0.5 ? row : row + 1;
+			this.accumulate(r * this.cols + c, value, weight);
+			return true;
+		}
+
+		const base = row * this.cols + col;
+		this.accumulate(base, value, weight * (1 - fx) * (1 - fy));
+		this.accumulate(base + 1, value, weight * fx * (1 - fy));
+		this.accumulate(base + this.cols, value, weight * (1 - fx) * fy);
+		this.accumulate(base + this.cols + 1, value, weight * fx * fy);
+		return true;
+	}
+
+	/**
+	 * Add samples from columns
+	 *
+	 * @param columns - Axis, value and optional weight columns
+	 * @param rows - Row indices to add (default: every row of `columns.value`)
+	 * @returns Number of samples binned
+	 * @throws Error if the binner has a Y axis and no Y column is given
+	 */
+	addColumns(columns: BinColumns, rows?: ArrayLike<number>): number {
+		const { x, y, value, weight } = columns;
+		if (this.y && !y) {
+			throw new Error("A Y column is required to bin onto a 2D table");
+		}
+		const total = rows ? rows.length : value.length;
+		let binned = 0;
+		for (let i = 0; i < total; i++) {
+			const row = rows ? (rows[i] as number) : i;
+			if (
+				this.add(
+					x[row] as number,
+					y ? (y[row] as number) : 0,
+					value[row] as number,
+					weight ? (weight[row] as number) : 1,
+				)
+			) {
+				binned++;
+			}
+		}
+		return binned;
+	}
+
+	/** Drop all accumulated samples */
+	reset(): void {
+		this.count.fill(0);
+		this.weights.fill(0);
+		this.means.fill(0);
+		this.squares.fill(0);
+		this.mins.fill(Number.POSITIVE_INFINITY);
+		this.maxes.fill(Number.NEGATIVE_INFINITY);
+	}
+
+	/**
+	 * Snapshot the per-cell statistics
+	 */
+	result(): BinnedGrid {
+		const cells = this.count.length;
+		const mean = new Float64Array(cells);
+		const min = new Float64Array(cells);
+		const max = new Float64Array(cells);
+		const stddev = new Float64Array(cells);
+		for (let i = 0; i < cells; i++) {
+			const w = this.weights[i] as number;
+			if (w > 0) {
+				mean[i] = this.means[i] as number;
+				min[i] = this.mins[i] as number;
+				max[i] = this.maxes[i] as number;
+				stddev[i] = Math.sqrt(Math.max(0, (this.squares[i] as number) / w));
+			} else {
+				mean[i] = min[i] = max[i] = stddev[i] = Number.NaN;
+			}
+		}
+		return {
+			rows: this.rows,
+			cols: this.cols,
+			xAxis: this.xAxis.slice(),
+			yAxis: this.yAxis?.slice(),
+			count: this.count.slice(),
+			weight: this.weights.slice(),
+			mean,
+			min,
+			max,
+			stddev,
+		};
+	}
+
+	private accumulate(cell: number, value: number, weight: number): void {
+		if (!(weight > 0)) return;
+		const total = (this.weights[cell] as number) + weight;
+		const mean = this.means[cell] as number;
+		const delta = value - mean;
+		const next = mean + (delta * weight) / total;
+		this.weights[cell] = total;
+		this.means[cell] = next;
+		this.squares[cell] =
+			(this.squares[cell] as number) + weight * delta * (value - next);
+		this.count[cell] = (this.count[cell] as number) + 1;
+		if (value < (this.mins[cell] as number)) this.mins[cell] = value;
+		if (value > (this.maxes[cell] as number)) this.maxes[cell] = value;
+	}
+}
+
+/**
+ * Create a binner shaped like a table, using its breakpoints from the ROM
+ *
+ * @param table - Table definition with an X axis (and a Y axis for 2D tables)
+ * @param rom - ROM image the axes are read from
+ * @param options - Binning behaviour
+ * @throws Error if the table has no X axis, or is 2D without a Y axis
+ */
+export function createTableBinner(
+	table: TableDefinition,
+	rom: Uint8Array,
+	options: Pick<LogBinnerOptions, "weighting" | "outOfRange"> = {},
+): LogBinner {
+	if (!table.x) {
+		throw new Error(`Table "${table.name}" has no X axis to bin onto`);
+	}
+	const view = new TableView(rom, table);
+	const xAxis = view.readAxis(table.x).values;
+	if (table.kind === "table1d") {
+		return new LogBinner({ ...options, xAxis });
+	}
+	if (!table.y) {
+		throw new Error(`Table "${table.name}" has no Y axis to bin onto`);
+	}
+	return new LogBinner({
+		...options,
+		xAxis,
+		yAxis: view.readAxis(table.y).values,
+	});
+}
@@ -0,0 +1,280 @@
+/**
+ * Time alignment of samples from independently clocked sources.
+ *
+ * Live logging combines streams that arrive at different rates: ECU
+ * parameters polled over the diagnostic link and a wideband controller
+ * reporting on its own serial schedule. Each source keeps its recent
+ * samples in a fixed-capacity {@link SampleRing}, and {@link SampleFusion}
+ * resamples every source onto one steady timebase, so each emitted row
+ * holds one value per source for the same instant.
+ *
+ * Timestamps are milliseconds on a shared clock (`Date.now()` for the
+ * built-in sources). A source that reports late, such as a wideband sensor
+ * with transport and sensor lag, is shifted back by its latency before it
+ * is stored.
+ *
+ * @module logging/sample-fusion
+ */
+
+/** How a source is sampled between its own readings */
+export type ResampleMode = "hold" | "linear";
+
+/**
+ * Fixed-capacity ring of timestamped samples
+ *
+ * Timestamps must not decrease; out-of-order samples are rejected. Samples
+ * are addressed by sequence number (the count of samples pushed before
+ * them), which stays valid until the sample is overwritten.
+ */
+export class SampleRing {
+	readonly capacity: number;
+	private readonly times: Float64Array;
+	private readonly values: Float64Array;
+	private pushed = 0;
+
+	/**
+	 * @param capacity - Number of samples retained
+	 */
+	constructor(capacity: number) {
+		if (!Number.isInteger(capacity) || capacity < 1) {
+			throw new Error(`Ring capacity must be a positive integer: ${capacity}`);
+		}
+		this.capacity = capacity;
+		this.times = new Float64Array(capacity);
+		this.values = new Float64Array(capacity);
+	}
+
+	/** Number of samples retained */
+	get size(): number {
+		return Math.min(this.pushed, this.capacity);
+	}
+
+	/** Sequence number of the oldest retained sample */
+	get first(): number {
+		return this.pushed - this.size;
+	}
+
+	/** Sequence number the next sample will get */
+	get end(): number {
+		return this.pushed;
+	}
+
+	/** Timestamp of the newest sample, or NaN when empty */
+	get lastTime(): number {
+		return this.pushed > 0 ? this.timeAt(this.pushed - 1) : Number.NaN;
+	}
+
+	/**
+	 * Append a sample, overwriting the oldest one when full
+	 *
+	 * @param timestamp - Sample time in milliseconds
+	 * @param value - Sample value
+	 * @returns False if the timestamp is NaN or earlier than the newest sample
+	 */
+	push(timestamp: number, value: number): boolean {
+		if (Number.isNaN(timestamp)) return false;
+		if (this.pushed > 0 && timestamp < this.lastTime) return false;
+		const slot = this.pushed % this.capacity;
+		this.times[slot] = timestamp;
+		this.values[slot] = value;
+		this.pushed++;
+		return true;
+	}
+
+	/**
+	 * @param seq - Sequence number in `[first, end)`
+	 */
+	timeAt(seq: number): number {
+		return this.times[seq % this.capacity] as number;
+	}
+
+	/**
+	 * @param seq - Sequence number in `[first, end)`
+	 */
+	valueAt(seq: number): number {
+		return this.values[seq % this.capacity] as number;
+	}
+
+	/** Drop all samples */
+	clear(): void {
+		this.pushed = 0;
+	}
+}
+
+/**
+ * Per-source options for {@link SampleFusion}
+ */
+export interface FusionSourceOptions {
+	/** Samples retained (default 256) */
+	capacity?: number;
+	/** Resampling mode (default "hold") */
+	mode?: ResampleMode;
+	/** Reporting delay subtracted from each timestamp (default 0) */
+	latencyMs?: number;
+	/** Samples older than this relative to a tick are not used (default: no limit) */
+	maxAgeMs?: number;
+}
+
+/**
+ * Timebase options for {@link SampleFusion}
+ */
+export interface SampleFusionOptions {
+	/** Spacing between emitted rows in milliseconds */
+	periodMs: number;
+	/** Time of the first tick (default: set by {@link SampleFusion.start}) */
+	originMs?: number;
+}
+
+/**
+ * Receives one fused row. `values` is parallel to the sources, NaN where a
+ * source has no usable sample, and is reused for the next row.
+ */
+export type FusedRowCallback = (timeMs: number, values: Float64Array) => void;
+
+const DEFAULT_CAPACITY = 256;
+
+/**
+ * Resamples several sources onto a common timebase
+ *
+ * Samples are pushed as they arrive. {@link drain} then emits a row for
+ * every tick up to a given time. Callers should drain only up to a point
+ * every source has reported past (for example, the current time minus the
+ * largest latency and one source period), since a tick is emitted once.
+ *
+ * @example
+ * const fusion = new SampleFusion(
+ * 	[{}, { mode: "linear", latencyMs: 120 }],
+ * 	{ periodMs: 50, originMs: Date.now() },
+ * );
+ * fusion.push(0, frame.timestamp, frame.value);
+ * fusion.push(1, reading.timestamp, reading.value);
+ * fusion.drain(Date.now() - 200, (time, values) => writeRow(time, values));
+ */
+export class SampleFusion {
+	readonly periodMs: number;
+	private readonly rings: SampleRing[];
+	private readonly modes: ResampleMode[];
+	private readonly latencies: Float64Array;
+	private readonly maxAges: Float64Array;
+	/** Per source: sequence number of the last sample at or before the last tick */
+	private readonly cursors: Float64Array;
+	private readonly row: Float64Array;
+	private originMs = Number.NaN;
+	private tick = 0;
+
+	/**
+	 * @param sources - One entry per source, in row order
+	 * @param options - Timebase
+	 */
+	constructor(
+		sources: readonly FusionSourceOptions[],
+		options: SampleFusionOptions,
+	) {
+		if (!(options.periodMs > 0)) {
+			throw new Error(`Fusion period must be positive: ${options.periodMs}`);
+		}
+		this.periodMs = options.periodMs;
+		this.rings = sources.map(
+			(source) => new SampleRing(source.capacity ?? DEFAULT_CAPACITY),
+		);
+		this.modes = sources.map((source) => source.mode ?? "hold");
+		this.latencies = Float64Array.from(
+			sources,
+			(source) => source.latencyMs ?? 0,
+		);
+		this.maxAges = Float64Array.from(
+			sources,
+			(source) => source.maxAgeMs ?? Number.POSITIVE_INFINITY,
+		);
+		this.cursors = new Float64Array(sources.length).fill(-1);
+		this.row = new Float64Array(sources.length);
+		if (options.originMs !== undefined) this.start(options.originMs);
+	}
+
+	/** Number of sources */
+	get sourceCount(): number {
+		return this.rings.length;
+	}
+
+	/** Time of the next tick to be emitted, or NaN before {@link start} */
+	get nextTickMs(): number {
+		return this.originMs + this.tick * this.periodMs;
+	}
+
+	/**
+	 * Restart the timebase at `originMs` and drop all buffered samples
+	 */
+	start(originMs: number): void {
+		this.originMs = originMs;
+		this.tick = 0;
+		for (const ring of this.rings) ring.clear();
+		this.cursors.fill(-1);
+	}
+
+	/**
+	 * Skip ticks before `timeMs` without emitting them (e.g. after a pause)
+	 */
+	seek(timeMs: number): void {
+		const tick = Math.ceil((timeMs - this.originMs) / this.periodMs);
+		if (tick > this.tick) this.tick = tick;
+	}
+
+	/**
+	 * Buffer a sample
+	 *
+	 * @param source - Source index
+	 * @param timestamp - Reported time in milliseconds
+	 * @param value - Sample value
+	 * @returns False if the sample was out of order and dropped
+	 */
+	push(source: number, timestamp: number, value: number): boolean {
+		const ring = this.rings[source];
+		if (!ring) throw new Error(`Unknown fusion source: ${source}`);
+		return ring.push(timestamp - (this.latencies[source] as number), value);
+	}
+
+	/**
+	 * Emit a row for every tick up to and including `untilMs`
+	 *
+	 * Ticks where no source has a usable sample are skipped.
+	 *
+	 * @param untilMs - Last time to emit
+	 * @param emit - Row callback
+	 * @returns Number of rows emitted
+	 */
+	drain(untilMs: number, emit: FusedRowCallback): number {
+		let emitted = 0;
+		for (let time = this.nextTickMs; time <= untilMs; time = this.nextTickMs) {
+			this.tick++;
+			let any = false;
+			for (let i = 0; i < this.rings.length; i++) {
+				const value = this.sample(i, time);
+				this.row[i] = value;
+				if (value === value) any = true;
+			}
+			if (any) {
+				emit(time, this.row);
+				emitted++;
+			}
+		}
+		return emitted;
+	}
+
+	private sample(source: number, time: number): number {
+		const ring = this.rings[source] as SampleRing;
+		const end = ring.end;
+		// Ticks only move forward, so the cursor never needs to back up
+		let seq = Math.max(this.cursors[source] as number, ring.first - 1);
+		while (seq + 1 < end && ring.timeAt(seq + 1) <= time) seq++;
+		this.cursors[source] = seq;
+		if (seq < ring.first) return Number.NaN;
+
+		const t0 = ring.timeAt(seq);
+		if (time - t0 > (this.maxAges[source] as number)) return Number.NaN;
+		const v0 = ring.valueAt(seq);
+		if (this.modes[source] === "hold" || seq + 1 >= end) return v0;
+
+		const t1 = ring.timeAt(seq + 1);
+		return v0 + ((ring.valueAt(seq + 1) - v0) * (time - t0)) / (t1 - t0);
+	}
+}
@@ -72,3 +72,39 @@ export interface ValidationOptions {
 	/** Check monotonic constraints */
 	checkMonotonic?: boolean;
 }
+
+/**
+ * Options for bulk validation
+ */
+export interface BulkValidationOptions extends ValidationOptions {
+	/** Number of failures to build full results for (default: 100) */
+	maxFailures?: number;
+}
+
+/**
+ * One failure reported in detail by bulk validation
+ */
+export interface BulkValidationFailure {
+	/** Index of the value in the validated input */
+	index: number;
+	/** The invalid value */
+	value: number;
+	/** Full validation result, as {@link ValidationResult} from validateValue */
+	result: ValidationResult;
+}
+
+/**
+ * Result of validating many values at once
+ */
+export interface BulkValidationResult {
+	/** Number of values validated */
+	count: number;
+	/** Number of invalid values */
+	invalidCount: number;
+	/** Bit `i % 32` of word `i >> 5` is set when value `i` is invalid */
+	invalid: Uint32Array;
+	/** Number of invalid values per error code */
+	countsByCode: Partial<Record<ValidationErrorCode, number>>;
+	/** The first `maxFailures` failures, in index order */
+	failures: BulkValidationFailure[];
+}
@@ -1,11 +1,16 @@
 import {
+	getScalarTypeRange,
 	validateDataType,
 	validateMinMax,
 	validateMonotonicIncreasing,
 	validateNumber,
 } from "./rules.js";
 import type {
+	BulkValidationFailure,
+	BulkValidationOptions,
+	BulkValidationResult,
 	ValidationContext,
+	ValidationErrorCode,
 	ValidationOptions,
 	ValidationResult,
 } from "./types.js";
@@ -122,6 +127,138 @@ export function validateValues(
 	return results;
 }
 
+/** Default number of failures {@link validateValuesBulk} details */
+const DEFAULT_MAX_FAILURES = 100;
+
+// Index into the per-code counters of validateValuesBulk
+const INVALID_NUMBER = 0;
+const TYPE_OUT_OF_RANGE = 1;
+const VALUE_BELOW_MIN = 2;
+const VALUE_ABOVE_MAX = 3;
+const NOT_STRICTLY_INCREASING = 4;
+const BULK_CODES: readonly ValidationErrorCode[] = [
+	"INVALID_NUMBER",
+	"TYPE_OUT_OF_RANGE",
+	"VALUE_BELOW_MIN",
+	"VALUE_ABOVE_MAX",
+	"NOT_STRICTLY_INCREASING",
+];
+
+/**
+ * Validate many values in one pass without allocating per-value results
+ *
+ * Applies the same rules, in the same order, as {@link validateValues}, but
+ * records failures in a bitset with per-code counts. Full
+ * {@link ValidationResult}s (messages and suggestions) are only built for
+ * the first `maxFailures` failures.
+ *
+ * @param values - Values to validate (a `Float64Array` avoids boxing)
+ * @param context - Validation context with constraints and metadata
+ * @param options - Validation options, plus how many failures to detail
+ * @returns Bitset of invalid indices, counts and the first failures
+ *
+ * @example
+ * const result = validateValuesBulk(values, { dtype: "u8", max: 200 });
+ * if (result.invalidCount > 0) {
+ *   console.warn(`${result.invalidCount} invalid values`, result.failures);
+ * }
+ */
+export function validateValuesBulk(
+	values: ArrayLike<number>,
+	context: ValidationContext,
+	options: BulkValidationOptions = {},
+): BulkValidationResult {
+	const {
+		checkDataType = true,
+		checkMinMax = true,
+		checkMonotonic = false,
+		maxFailures = DEFAULT_MAX_FAILURES,
+	} = options;
+
+	const typeRange = checkDataType
+		? getScalarTypeRange(context.dtype)
+		: { min: -Infinity, max: Infinity };
+	const min = checkMinMax ? (context.min ?? -Infinity) : -Infinity;
+	const max = checkMinMax ? (context.max ?? Infinity) : Infinity;
+	// Finite values inside both ranges pass the number, type and min/max
+	// checks; the MAX_VALUE bounds keep infinities out
+	const low = Math.max(-Number.MAX_VALUE, typeRange.min, min);
+	const high = Math.min(Number.MAX_VALUE, typeRange.max, max);
+
+	const length = values.length;
+	const invalid = new Uint32Array(Math.ceil(length / 32));
+	const codeCounts = new Uint32Array(BULK_CODES.length);
+	const failures: BulkValidationFailure[] = [];
+	let invalidCount = 0;
+
+	for (let i = 0; i < length; i++) {
+		const value = values[i] as number;
+		const monotonicFailed =
+			checkMonotonic && i > 0 && value <= (values[i - 1] as number);
+		// NaN fails both comparisons, so it takes the slow path too
+		if (value >= low && value <= high && !monotonicFailed) {
+			continue;
+		}
+
+		let code: number;
+		if (!Number.isFinite(value)) {
+			code = INVALID_NUMBER;
+		} else if (value < typeRange.min || value > typeRange.max) {
+			code = TYPE_OUT_OF_RANGE;
+		} else if (value < min) {
+			code = VALUE_BELOW_MIN;
+		} else if (value > max) {
+			code = VALUE_ABOVE_MAX;
+		} else {
+			code = NOT_STRICTLY_INCREASING;
+		}
+
+		invalid[i >>> 5] = (invalid[i >>> 5] as number) | (1 << (i & 31));
+		codeCounts[code] = (codeCounts[code] as number) + 1;
+		invalidCount++;
+
+		if (failures.length < maxFailures) {
+			failures.push({
+				index: i,
+				value,
+				result: validateValue(
+					value,
+					{
+						...context,
+						previousValue: i > 0 ? values[i - 1] : undefined,
+						nextValue: i < length - 1 ? values[i + 1] : undefined,
+					},
+					options,
+				),
+			});
+		}
+	}
+
+	const countsByCode: Partial<Record<ValidationErrorCode, number>> = {};
+	for (const [index, code] of BULK_CODES.entries()) {
+		const count = codeCounts[index] as number;
+		if (count > 0) {
+			countsByCode[code] = count;
+		}
+	}
+
+	return { count: length, invalidCount, invalid, countsByCode, failures };
+}
+
+/**
+ * Check whether the value at `index` failed bulk validation
+ *
+ * @param result - Result of {@link validateValuesBulk}
+ * @param index - Index into the validated values
+ * @returns True if the value is invalid
+ */
+export function isInvalidAt(
+	result: BulkValidationResult,
+	index: number,
+): boolean {
+	return ((result.invalid[index >>> 5] ?? 0) & (1 << (index & 31))) !== 0;
+}
+
 /**
  * Check if all validation results are valid
  *
@@ -275,6 +275,13 @@ describe("extractSignedBits", () => {
 			expect(extractSignedBits(buffer, 0, 8)).toBe(-1);
 		});
 
+		it("handles full 32-bit signed fields", () => {
+			const buffer = new Uint8Array([0x0f, 0xff, 0xff, 0xff, 0xe0]);
+			expect(extractSignedBits(buffer, 0, 32)).toBe(0x0fffffff);
+			// Starts mid-byte and ends in the fifth byte
+			expect(extractSignedBits(buffer, 4, 32)).toBe(-2);
+		});
+
 		it("handles signed 7-bit field (timing advance pattern)", () => {
 			// Timing advance BITS(24,7): value - 20 gives °BTDC
 			// Raw 0b1101101 = 109, which as 7-bit signed = 109 - 128 = -19
@@ -0,0 +1,163 @@
+import { describe, expect, it } from "vitest";
+import {
+	extractBits,
+	extractSignedBits,
+} from "../src/binary/bit-extract.js";
+import {
+	type BitFieldPlanEntry,
+	compileBitFieldPlan,
+	runBitFieldPlan,
+} from "../src/binary/bit-field-plan.js";
+
+describe("compileBitFieldPlan", () => {
+	it("groups fields by byte alignment", () => {
+		const plan = compileBitFieldPlan([
+			{ field: { bitOffset: 0, bitLength: 8 }, slot: 0 },
+			{ field: { bitOffset: 8, bitLength: 16 }, slot: 1 },
+			{ field: { bitOffset: 11, bitLength: 11 }, slot: 2 },
+			{ field: { bitOffset: 3, bitLength: 32 }, slot: 3 },
+		]);
+
+		expect(plan.u8Byte).toEqual(new Uint16Array([0]));
+		expect(plan.u16Byte).toEqual(new Uint16Array([1]));
+		expect(plan.packedByte).toEqual(new Uint16Array([1]));
+		expect(plan.packedLeft).toEqual(new Uint8Array([3]));
+		expect(plan.packedRight).toEqual(new Uint8Array([21]));
+		expect(plan.wideByte).toEqual(new Uint16Array([0]));
+		expect(plan.fieldCount).toBe(4);
+		expect(plan.byteLength).toBe(5);
+	});
+
+	it("rejects invalid bit lengths", () => {
+		expect(() =>
+			compileBitFieldPlan([{ field: { bitOffset: 0, bitLength: 0 }, slot: 0 }]),
+		).toThrow("bitLength must be 1-32");
+		expect(() =>
+			compileBitFieldPlan([
+				{ field: { bitOffset: 0, bitLength: 33 }, slot: 0 },
+			]),
+		).toThrow("bitLength must be 1-32");
+		expect(() =>
+			compileBitFieldPlan([
+				{ field: { bitOffset: 0, bitLength: 1, signExtend: true }, slot: 0 },
+			]),
+		).toThrow("at least 2");
+	});
+
+	it("starts windows early so they stay inside the block", () => {
+		const plan = compileBitFieldPlan([
+			{ field: { bitOffset: 0, bitLength: 8 }, slot: 0 },
+			{ field: { bitOffset: 44, bitLength: 4 }, slot: 1 },
+		]);
+
+		expect(plan.byteLength).toBe(6);
+		expect(plan.packedByte).toEqual(new Uint16Array([2]));
+		expect(plan.packedLeft).toEqual(new Uint8Array([28]));
+	});
+});
+
+describe("runBitFieldPlan", () => {
+	const buffer = new Uint8Array([
+		0x25, 0x18, 0x3f, 0x64, 0xa5, 0xc3, 0xff, 0x01, 0x80, 0x7e,
+	]);
+
+	it("matches extractBits for every offset and length", () => {
+		const entries: { field: { bitOffset: number; bitLength: number } }[] =
+			[];
+		for (let bitLength = 1; bitLength <= 32; bitLength++) {
+			for (
+				let bitOffset = 0;
+				bitOffset + bitLength <= buffer.length * 8;
+				bitOffset++
+			) {
+				entries.push({ field: { bitOffset, bitLength } });
+			}
+		}
+
+		const plan = compileBitFieldPlan(
+			entries.map((entry, slot) => ({ ...entry, slot })),
+		);
+		const out = new Float64Array(entries.length);
+		runBitFieldPlan(plan, buffer, out);
+
+		entries.forEach(({ field }, slot) => {
+			expect(out[slot]).toBe(
+				extractBits(buffer, field.bitOffset, field.bitLength),
+			);
+		});
+	});
+
+	it("matches extractSignedBits for sign-extended fields", () => {
+		const entries: BitFieldPlanEntry[] = [];
+		for (let bitLength = 2; bitLength <= 32; bitLength++) {
+			for (
+				let bitOffset = 0;
+				bitOffset + bitLength <= buffer.length * 8;
+				bitOffset++
+			) {
+				entries.push({
+					field: { bitOffset, bitLength, signExtend: true },
+					slot: entries.length,
+				});
+			}
+		}
+
+		const plan = compileBitFieldPlan(entries);
+		const out = new Float64Array(entries.length);
+		runBitFieldPlan(plan, buffer, out);
+
+		for (const { field, slot } of entries) {
+			expect(out[slot]).toBe(
+				extractSignedBits(buffer, field.bitOffset, field.bitLength),
+			);
+		}
+	});
+
+	it("decodes blocks shorter than a window", () => {
+		const plan = compileBitFieldPlan([
+			{ field: { bitOffset: 4, bitLength: 8 }, slot: 0 },
+			{ field: { bitOffset: 12, bitLength: 4, signExtend: true }, slot: 1 },
+		]);
+		const out = new Float64Array(2);
+		runBitFieldPlan(plan, buffer.subarray(8), out);
+
+		expect(out[0]).toBe(0x07);
+		expect(out[1]).toBe(-2);
+	});
+
+	it("applies convert and writes only the planned slots", () => {
+		const plan = compileBitFieldPlan([
+			{
+				field: { bitOffset: 11, bitLength: 11, convert: (r) => r * 7.8125 },
+				slot: 2,
+			},
+		]);
+		const out = new Float64Array([-1, -1, -1, -1]);
+		runBitFieldPlan(plan, buffer, out);
+
+		expect(out[2]).toBe(extractBits(buffer, 11, 11) * 7.8125);
+		expect(out[0]).toBe(-1);
+		expect(out[3]).toBe(-1);
+	});
+
+	it("reads a block at a byte offset within a larger buffer", () => {
+		const plan = compileBitFieldPlan([
+			{ field: { bitOffset: 0, bitLength: 8 }, slot: 0 },
+			{ field: { bitOffset: 4, bitLength: 8 }, slot: 1 },
+		]);
+		const out = new Float64Array(2);
+		runBitFieldPlan(plan, buffer, out, 4);
+
+		expect(out[0]).toBe(0xa5);
+		expect(out[1]).toBe(0x5c);
+	});
+
+	it("throws when the buffer is too short", () => {
+		const plan = compileBitFieldPlan([
+			{ field: { bitOffset: 8, bitLength: 16 }, slot: 0 },
+		]);
+		expect(() =>
+			runBitFieldPlan(plan, new Uint8Array(2), new Float64Array(1)),
+		).toThrow("needs 3 bytes");
+	});
+});
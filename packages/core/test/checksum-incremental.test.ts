@@ -0,0 +1,145 @@
+import { describe, expect, it } from "vitest";
+import { PagedRom } from "../src/binary/paged-rom.js";
+import { mitsucanChecksum } from "../src/checksum/algorithms.js";
+import { IncrementalChecksum } from "../src/checksum/incremental.js";
+import { recomputeChecksum, writeChecksum } from "../src/checksum/manager.js";
+import type { ChecksumDefinition } from "../src/definition/rom.js";
+
+function patternRom(size: number): Uint8Array {
+	const rom = new Uint8Array(size);
+	for (let i = 0; i < size; i++) {
+		rom[i] = (i * 31 + 7) & 0xff;
+	}
+	return rom;
+}
+
+/** Write through the pages, folding the edit into the checksum. */
+function write(
+	pages: PagedRom,
+	checksum: IncrementalChecksum,
+	offset: number,
+	values: ArrayLike<number>,
+): void {
+	pages.prepare(offset, values.length);
+	pages.bytes.set(values, offset);
+	checksum.update(offset, values.length);
+	pages.commit(offset, values.length);
+}
+
+/** Apply random edits and check the state against a full recompute. */
+function fuzz(rom: Uint8Array, checksumDef: ChecksumDefinition, edits = 200) {
+	const pages = new PagedRom(rom, 16);
+	const checksum = new IncrementalChecksum(pages, checksumDef);
+	let seed = 1;
+	const random = () => {
+		seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+		return seed;
+	};
+	for (let n = 0; n < edits; n++) {
+		const offset = random() % rom.length;
+		const length = Math.min(1 + (random() % 8), rom.length - offset);
+		const values = Array.from({ length }, () => random() & 0xff);
+		write(pages, checksum, offset, values);
+		expect(checksum.expected).toBe(recomputeChecksum(rom, checksumDef));
+	}
+	return checksum;
+}
+
+describe("IncrementalChecksum", () => {
+	it("tracks a sum checksum across edits", () => {
+		const checksum = fuzz(patternRom(256), {
+			algorithm: "sum",
+			regions: [
+				{ start: 0, end: 100 },
+				{ start: 120, end: 256 },
+			],
+			storage: { offset: 130, size: 1 },
+		});
+		expect(checksum.incremental).toBe(true);
+	});
+
+	it("tracks an XOR checksum across edits", () => {
+		fuzz(patternRom(256), {
+			algorithm: "xor",
+			regions: [{ start: 16, end: 256 }],
+			storage: { offset: 0, size: 1 },
+		});
+	});
+
+	it("tracks the mitsucan fixup across edits", () => {
+		const rom = patternRom(0x100000);
+		const checksumDef: ChecksumDefinition = {
+			algorithm: "custom",
+			regions: [{ start: 0, end: 0x100000 }],
+			storage: { offset: 0x0bfff0, size: 4, endianness: "be" },
+			customFunction: mitsucanChecksum,
+		};
+		const pages = new PagedRom(rom);
+		const checksum = new IncrementalChecksum(pages, checksumDef);
+
+		for (const offset of [0x0, 0x1001, 0x0bffee, 0x0bfff1, 0xfffff]) {
+			write(pages, checksum, offset, [(rom[offset] ?? 0) ^ 0x5a]);
+			expect(checksum.expected).toBe(mitsucanChecksum(rom));
+		}
+		expect(checksum.incremental).toBe(true);
+	});
+
+	it("reports whether the stored checksum is current", () => {
+		const rom = patternRom(64);
+		const checksumDef: ChecksumDefinition = {
+			algorithm: "sum",
+			regions: [{ start: 0, end: 64 }],
+			storage: { offset: 60, size: 1 },
+		};
+		const pages = new PagedRom(rom);
+		const checksum = new IncrementalChecksum(pages, checksumDef);
+		writeChecksum(rom, checksum.expected, checksumDef);
+		expect(checksum.valid).toBe(true);
+
+		write(pages, checksum, 5, [(rom[5] ?? 0) + 1]);
+		expect(checksum.valid).toBe(false);
+
+		writeChecksum(rom, checksum.expected, checksumDef);
+		expect(checksum.valid).toBe(true);
+	});
+
+	it("recomputes CRC32 after edits", () => {
+		const rom = patternRom(128);
+		const checksumDef: ChecksumDefinition = {
+			algorithm: "crc32",
+			regions: [{ start: 0, end: 124 }],
+			storage: { offset: 124, size: 4 },
+		};
+		const pages = new PagedRom(rom);
+		const checksum = new IncrementalChecksum(pages, checksumDef);
+		expect(checksum.incremental).toBe(false);
+
+		write(pages, checksum, 10, [0xaa]);
+		expect(checksum.expected).toBe(recomputeChecksum(rom, checksumDef));
+	});
+
+	it("recomputes when the edited range is unknown or the buffer changes", () => {
+		const checksumDef: ChecksumDefinition = {
+			algorithm: "sum",
+			regions: [{ start: 0, end: 32 }],
+			storage: { offset: 31, size: 1 },
+		};
+		const rom = patternRom(32);
+		const pages = new PagedRom(rom);
+		const checksum = new IncrementalChecksum(pages, checksumDef);
+
+		rom.fill(1, 0, 16);
+		checksum.update();
+		expect(checksum.expected).toBe(recomputeChecksum(rom, checksumDef));
+
+		// Without a prepared before-image the edit cannot be folded in
+		rom[20] = 0x33;
+		checksum.update(20, 1);
+		expect(checksum.expected).toBe(recomputeChecksum(rom, checksumDef));
+
+		const replacement = new Uint8Array(32).fill(2);
+		pages.reset(replacement);
+		checksum.reset();
+		expect(checksum.expected).toBe((31 * 2) & 0xff);
+	});
+});
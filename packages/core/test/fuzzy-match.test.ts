@@ -1,5 +1,6 @@
 import { describe, expect, it } from "vitest";
 import {
+	boundedLevenshteinDistance,
 	findClosestMatches,
 	levenshteinDistance,
 } from "../src/definition/fuzzy-match.js";
@@ -43,6 +44,58 @@ describe("levenshteinDistance", () => {
 	it("is case sensitive", () => {
 		expect(levenshteinDistance("Hello", "hello")).toBe(1);
 	});
+
+	it("matches a reference DP on random strings", () => {
+		const reference = (a: string, b: string) => {
+			const rows = Array.from({ length: a.length + 1 }, (_, i) =>
+				Array.from({ length: b.length + 1 }, (_, j) => (i === 0 ? j : i)),
+			);
+			for (let i = 1; i <= a.length; i++) {
+				for (let j = 1; j <= b.length; j++) {
+					const row = rows[i] as number[];
+					const above = rows[i - 1] as number[];
+					row[j] = Math.min(
+						(above[j] as number) + 1,
+						(row[j - 1] as number) + 1,
+						(above[j - 1] as number) + (a[i - 1] === b[j - 1] ? 0 : 1),
+					);
+				}
+			}
+			return rows[a.length]?.[b.length];
+		};
+		let seed = 7;
+		const randomString = (maxLength: number) => {
+			seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+			const length = seed % maxLength;
+			let text = "";
+			for (let i = 0; i < length; i++) {
+				seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+				text += "abcd_ "[seed % 6];
+			}
+			return text;
+		};
+		for (let n = 0; n < 300; n++) {
+			// Covers both the bit-parallel (<= 32) and the DP (> 32) paths
+			const a = randomString(n % 2 === 0 ? 34 : 48);
+			const b = randomString(48);
+			expect(levenshteinDistance(a, b)).toBe(reference(a, b));
+		}
+	});
+});
+
+describe("boundedLevenshteinDistance", () => {
+	it("returns the exact distance within the bound", () => {
+		expect(boundedLevenshteinDistance("kitten", "sitting", 3)).toBe(3);
+		expect(boundedLevenshteinDistance("Fuel_Tabl", "Fuel_Table", 1)).toBe(1);
+	});
+
+	it("returns maxDistance + 1 beyond the bound", () => {
+		expect(boundedLevenshteinDistance("kitten", "sitting", 2)).toBe(3);
+		expect(boundedLevenshteinDistance("abc", "abcdefgh", 2)).toBe(3);
+		expect(boundedLevenshteinDistance("x".repeat(40), "y".repeat(40), 5)).toBe(
+			6,
+		);
+	});
 });
 
 describe("findClosestMatches", () => {
@@ -0,0 +1,148 @@
+import { describe, expect, it } from "vitest";
+import type { Table2DDefinition } from "../src/definition/table.js";
+import { createTableBinner, LogBinner } from "../src/logging/log-binning.js";
+
+describe("LogBinner", () => {
+	it("bins samples to the nearest breakpoint with per-cell statistics", () => {
+		const binner = new LogBinner({ xAxis: [1000, 2000, 3000] });
+		binner.add(900, 0, 14);
+		binner.add(1400, 0, 12);
+		binner.add(1600, 0, 11);
+		binner.add(2400, 0, 13);
+
+		const grid = binner.result();
+		expect(grid.rows).toBe(1);
+		expect(Array.from(grid.count)).toEqual([2, 2, 0]);
+		expect(Array.from(grid.mean.subarray(0, 2))).toEqual([13, 12]);
+		expect(Array.from(grid.min.subarray(0, 2))).toEqual([12, 11]);
+		expect(Array.from(grid.max.subarray(0, 2))).toEqual([14, 13]);
+		expect(Array.from(grid.stddev.subarray(0, 2))).toEqual([1, 1]);
+		expect(grid.mean[2]).toBeNaN();
+		expect(grid.stddev[2]).toBeNaN();
+	});
+
+	it("splits samples between surrounding cells when interpolating", () => {
+		const binner = new LogBinner({
+			xAxis: [0, 10],
+			yAxis: [0, 100],
+			weighting: "interpolate",
+		});
+		binner.add(2.5, 50, 8);
+
+		const { count, weight, mean } = binner.result();
+		expect(Array.from(count)).toEqual([1, 1, 1, 1]);
+		expect(Array.from(weight)).toEqual([0.375, 0.125, 0.375, 0.125]);
+		expect(Array.from(mean)).toEqual([8, 8, 8, 8]);
+	});
+
+	it("uses weights for the mean and standard deviation", () => {
+		const binner = new LogBinner({ xAxis: [0] });
+		binner.add(0, 0, 10, 3);
+		binner.add(0, 0, 20, 1);
+		binner.add(0, 0, 99, 0);
+
+		const grid = binner.result();
+		expect(grid.count[0]).toBe(2);
+		expect(grid.weight[0]).toBe(4);
+		expect(grid.mean[0]).toBe(12.5);
+		expect(grid.stddev[0]).toBeCloseTo(Math.sqrt(18.75), 12);
+	});
+
+	it("clamps or skips samples outside the axes", () => {
+		const clamped = new LogBinner({ xAxis: [1, 2], yAxis: [10, 20] });
+		const skipped = new LogBinner({
+			xAxis: [1, 2],
+			yAxis: [10, 20],
+			outOfRange: "skip",
+		});
+		for (const binner of [clamped, skipped]) {
+			binner.add(5, 15.1, 1);
+			binner.add(1.2, -3, 2);
+			binner.add(1.6, 12, 3);
+		}
+
+		expect(Array.from(clamped.result().count)).toEqual([1, 1, 0, 1]);
+		expect(Array.from(skipped.result().count)).toEqual([0, 1, 0, 0]);
+	});
+
+	it("locates values on descending axes", () => {
+		const binner = new LogBinner({ xAxis: [300, 200, 100] });
+		binner.add(290, 0, 1);
+		binner.add(140, 0, 2);
+		binner.add(90, 0, 3);
+
+		expect(Array.from(binner.result().mean)).toEqual([1, Number.NaN, 2.5]);
+	});
+
+	it("bins selected rows of columns and skips missing values", () => {
+		const binner = new LogBinner({ xAxis: [1000, 2000], yAxis: [0.5, 1] });
+		const rpm = Float64Array.from([1000, 2000, 2000, Number.NaN, 1000]);
+		const load = Float64Array.from([0.5, 1, 0.5, 1, 1]);
+		const afr = Float64Array.from([14.7, 11.5, Number.NaN, 12, 13]);
+
+		expect(
+			binner.addColumns({ x: rpm, y: load, value: afr }, [0, 1, 2, 3]),
+		).toBe(2);
+		expect(Array.from(binner.result().count)).toEqual([1, 0, 0, 1]);
+		expect(() => binner.addColumns({ x: rpm, value: afr })).toThrow(
+			/Y column/,
+		);
+	});
+
+	it("rejects axes that are not strictly monotonic", () => {
+		expect(() => new LogBinner({ xAxis: [] })).toThrow(/no breakpoints/);
+		expect(() => new LogBinner({ xAxis: [1, 3, 2] })).toThrow(/monotonic/);
+		expect(() => new LogBinner({ xAxis: [1, 2], yAxis: [5, 5] })).toThrow(
+			/Y axis/,
+		);
+	});
+});
+
+describe("createTableBinner", () => {
+	it("reads breakpoints from the ROM for a 2D table", () => {
+		const rom = new Uint8Array([10, 20, 30, 1, 2]);
+		const table: Table2DDefinition = {
+			kind: "table2d",
+			name: "Fuel Map",
+			rows: 2,
+			cols: 3,
+			x: {
+				kind: "dynamic",
+				name: "RPM",
+				address: 0,
+				length: 3,
+				dtype: "u8",
+				scale: 100,
+			},
+			y: {
+				kind: "dynamic",
+				name: "Load",
+				address: 3,
+				length: 2,
+				dtype: "u8",
+			},
+			z: { name: "Fuel", address: 16, dtype: "u8" },
+		};
+
+		const binner = createTableBinner(table, rom);
+		binner.add(2900, 1.9, 12);
+		const grid = binner.result();
+		expect(grid.xAxis).toEqual([1000, 2000, 3000]);
+		expect(grid.yAxis).toEqual([1, 2]);
+		expect(grid.mean[5]).toBe(12);
+	});
+
+	it("requires the axes of the table", () => {
+		const table: Table2DDefinition = {
+			kind: "table2d",
+			name: "Fuel Map",
+			rows: 2,
+			cols: 2,
+			x: { kind: "static", name: "RPM", values: [1, 2] },
+			z: { name: "Fuel", address: 0, dtype: "u8" },
+		};
+		expect(() => createTableBinner(table, new Uint8Array(4))).toThrow(
+			/no Y axis/,
+		);
+	});
+});
@@ -0,0 +1,153 @@
+import { describe, expect, it } from "vitest";
+import { PagedRom } from "../src/binary/paged-rom.js";
+
+const PAGE = 16;
+
+function patternRom(size: number): Uint8Array {
+	return new Uint8Array(size).map((_, i) => (i * 13 + 5) & 0xff);
+}
+
+/** Write through the live buffer the way RomDocument's callers do. */
+function write(rom: PagedRom, offset: number, values: number[]): void {
+	rom.prepare(offset, values.length);
+	rom.bytes.set(values, offset);
+	rom.commit(offset, values.length);
+}
+
+describe("PagedRom", () => {
+	it("tracks dirty pages from committed edits", () => {
+		const bytes = patternRom(PAGE * 8);
+		const rom = new PagedRom(bytes, PAGE);
+
+		rom.prepare(PAGE * 2 + 3, 1);
+		rom.prepare(PAGE * 3 - 1, 3);
+		bytes[PAGE * 2 + 3] = 0;
+		bytes.set([1, 2, 3], PAGE * 3 - 1);
+		rom.commit(PAGE * 2 + 3, 1);
+		rom.commit(PAGE * 3 - 1, 3);
+		write(rom, PAGE * 6, [0]);
+
+		expect(rom.dirtyPageCount).toBe(3);
+		expect(rom.dirtyRanges()).toEqual([
+			{ offset: PAGE * 2, length: PAGE * 2 },
+			{ offset: PAGE * 6, length: PAGE },
+		]);
+	});
+
+	it("ignores commits that do not change bytes", () => {
+		const bytes = patternRom(PAGE * 4);
+		const rom = new PagedRom(bytes, PAGE);
+		rom.prepare(0, bytes.length);
+		expect(rom.commit(0, bytes.length)).toBe(0);
+		rom.prepare(PAGE, 1);
+		expect(rom.commit()).toBe(0);
+		expect(rom.dirtyRanges()).toEqual([]);
+	});
+
+	it("clears a page that is edited back to its saved contents", () => {
+		const bytes = patternRom(PAGE * 4);
+		const rom = new PagedRom(bytes, PAGE);
+		const before = bytes[5] as number;
+
+		write(rom, 5, [before ^ 0xff]);
+		expect(rom.isPageDirty(0)).toBe(true);
+
+		write(rom, 5, [before]);
+		expect(rom.isPageDirty(0)).toBe(false);
+	});
+
+	it("keeps snapshots unchanged by later edits", () => {
+		const bytes = patternRom(PAGE * 4 + 5);
+		const rom = new PagedRom(bytes, PAGE);
+		const original = bytes.slice();
+		const snapshot = rom.snapshot();
+
+		write(rom, PAGE, new Array(PAGE).fill(0xee));
+		write(rom, PAGE * 4 + 2, [0]);
+
+		expect(snapshot.toBytes()).toEqual(original);
+		expect(snapshot.equals(original)).toBe(true);
+		expect(snapshot.equals(bytes)).toBe(false);
+		expect(snapshot.read(PAGE - 2, 4)).toEqual(
+			original.subarray(PAGE - 2, PAGE + 2),
+		);
+		expect(rom.snapshot().toBytes()).toEqual(bytes);
+	});
+
+	it("shares unchanged pages between snapshots", () => {
+		const bytes = patternRom(PAGE * 64);
+		const rom = new PagedRom(bytes, PAGE);
+		const first = rom.snapshot();
+
+		write(rom, PAGE * 10, [(bytes[PAGE * 10] ?? 0) ^ 1]);
+		const second = rom.snapshot();
+
+		let shared = 0;
+		for (let index = 0; index < first.pageCount; index++) {
+			if (first.page(index) === second.page(index)) {
+				shared++;
+			}
+		}
+		expect(shared).toBe(63);
+		expect(first.diff(second)).toEqual([{ offset: PAGE * 10, length: PAGE }]);
+	});
+
+	it("keeps pages edited during a save dirty", () => {
+		const bytes = patternRom(PAGE * 4);
+		const rom = new PagedRom(bytes, PAGE);
+		write(rom, 0, [(bytes[0] ?? 0) ^ 1]);
+		const saving = rom.snapshot();
+
+		// Edit lands while the snapshot is being written
+		write(rom, PAGE * 3, [(bytes[PAGE * 3] ?? 0) ^ 1]);
+		rom.markSaved(saving);
+
+		expect(rom.dirtyRanges()).toEqual([{ offset: PAGE * 3, length: PAGE }]);
+		expect(rom.savedSnapshot().equals(saving.toBytes())).toBe(true);
+	});
+
+	it("compares a reloaded buffer against the committed pages", () => {
+		const bytes = patternRom(PAGE * 4);
+		const rom = new PagedRom(bytes, PAGE);
+		const reloaded = bytes.slice();
+		reloaded[PAGE + 1] = (reloaded[PAGE + 1] ?? 0) ^ 1;
+
+		rom.reset(reloaded);
+		expect(rom.bytes).toBe(reloaded);
+		expect(rom.dirtyRanges()).toEqual([{ offset: PAGE, length: PAGE }]);
+
+		rom.markSaved();
+		expect(rom.dirtyPageCount).toBe(0);
+	});
+
+	it("clips the last range to a partial final page", () => {
+		const bytes = patternRom(PAGE * 2 + 3);
+		const rom = new PagedRom(bytes, PAGE);
+		write(rom, PAGE * 2 + 1, [(bytes[PAGE * 2 + 1] ?? 0) ^ 1]);
+		expect(rom.dirtyRanges()).toEqual([{ offset: PAGE * 2, length: 3 }]);
+	});
+
+	it("keeps only copies of changed pages", () => {
+		const bytes = patternRom(PAGE * 8);
+		const rom = new PagedRom(bytes, PAGE);
+		const saved = rom.savedSnapshot();
+
+		expect(saved.page(2).buffer).toBe(bytes.buffer);
+		write(rom, PAGE * 2, [0xaa]);
+
+		// The saved page was copied before the write; the rest still view
+		// the live buffer
+		expect(saved.page(2).buffer).not.toBe(bytes.buffer);
+		expect(saved.page(3).buffer).toBe(bytes.buffer);
+		expect(rom.snapshot().page(2).buffer).toBe(bytes.buffer);
+		expect(saved.equals(patternRom(PAGE * 8))).toBe(true);
+	});
+
+	it("marks unprepared writes dirty", () => {
+		const bytes = patternRom(PAGE * 4);
+		const rom = new PagedRom(bytes, PAGE);
+		bytes[PAGE + 1] = 0;
+		rom.commit(PAGE + 1, 1);
+		expect(rom.dirtyRanges()).toEqual([{ offset: PAGE, length: PAGE }]);
+	});
+});
@@ -0,0 +1,119 @@
+import { describe, expect, it } from "vitest";
+import { SampleFusion, SampleRing } from "../src/logging/sample-fusion.js";
+
+function collect(fusion: SampleFusion, untilMs: number) {
+	const rows: Array<[number, number[]]> = [];
+	fusion.drain(untilMs, (time, values) => {
+		rows.push([time, Array.from(values)]);
+	});
+	return rows;
+}
+
+describe("SampleRing", () => {
+	it("overwrites the oldest samples once full", () => {
+		const ring = new SampleRing(3);
+		for (let i = 0; i < 5; i++) ring.push(i * 10, i);
+		expect(ring.size).toBe(3);
+		expect(ring.first).toBe(2);
+		expect(ring.end).toBe(5);
+		expect([2, 3, 4].map((seq) => ring.valueAt(seq))).toEqual([2, 3, 4]);
+		expect(ring.lastTime).toBe(40);
+	});
+
+	it("rejects samples that go back in time", () => {
+		const ring = new SampleRing(4);
+		expect(ring.push(100, 1)).toBe(true);
+		expect(ring.push(100, 2)).toBe(true);
+		expect(ring.push(99, 3)).toBe(false);
+		expect(ring.push(Number.NaN, 4)).toBe(false);
+		expect(ring.size).toBe(2);
+	});
+
+	it("rejects non-positive capacities", () => {
+		expect(() => new SampleRing(0)).toThrow(/positive integer/);
+	});
+});
+
+describe("SampleFusion", () => {
+	it("holds the latest sample of each source at every tick", () => {
+		const fusion = new SampleFusion([{}, {}], { periodMs: 100, originMs: 0 });
+		fusion.push(0, 0, 1000);
+		fusion.push(1, 50, 14.7);
+		fusion.push(0, 120, 2000);
+		fusion.push(0, 180, 3000);
+
+		expect(collect(fusion, 200)).toEqual([
+			[0, [1000, Number.NaN]],
+			[100, [1000, 14.7]],
+			[200, [3000, 14.7]],
+		]);
+	});
+
+	it("interpolates linear sources between readings", () => {
+		const fusion = new SampleFusion([{ mode: "linear" }], {
+			periodMs: 25,
+			originMs: 0,
+		});
+		fusion.push(0, 0, 10);
+		fusion.push(0, 100, 20);
+
+		expect(collect(fusion, 125).map(([, [value]]) => value)).toEqual([
+			10, 12.5, 15, 17.5, 20, 20,
+		]);
+	});
+
+	it("shifts late sources back by their latency", () => {
+		const fusion = new SampleFusion([{}, { latencyMs: 100 }], {
+			periodMs: 100,
+			originMs: 1000,
+		});
+		fusion.push(0, 1000, 3000);
+		fusion.push(1, 1100, 12.5);
+
+		expect(collect(fusion, 1000)).toEqual([[1000, [3000, 12.5]]]);
+	});
+
+	it("drops samples older than maxAgeMs and skips empty ticks", () => {
+		const fusion = new SampleFusion([{ maxAgeMs: 150 }], {
+			periodMs: 100,
+			originMs: 0,
+		});
+		fusion.push(0, 100, 1);
+
+		expect(collect(fusion, 400)).toEqual([
+			[100, [1]],
+			[200, [1]],
+		]);
+		expect(fusion.nextTickMs).toBe(500);
+	});
+
+	it("resumes from the next tick after a seek", () => {
+		const fusion = new SampleFusion([{}], { periodMs: 100, originMs: 0 });
+		fusion.push(0, 0, 1);
+		fusion.seek(250);
+		fusion.push(0, 260, 2);
+
+		expect(collect(fusion, 300)).toEqual([[300, [2]]]);
+	});
+
+	it("keeps sampling once old readings are overwritten", () => {
+		const fusion = new SampleFusion([{ capacity: 2, mode: "linear" }], {
+			periodMs: 10,
+			originMs: 0,
+		});
+		for (let t = 0; t <= 50; t += 5) fusion.push(0, t, t);
+		expect(collect(fusion, 30)).toEqual([]);
+
+		fusion.start(100);
+		for (let t = 100; t <= 160; t += 20) {
+			fusion.push(0, t, t);
+			collect(fusion, t - 20);
+		}
+		expect(
+			collect(fusion, 160).map(([time, [value]]) => [time, value]),
+		).toEqual([
+			[150, 150],
+			[160, 160],
+		]);
+	});
+});
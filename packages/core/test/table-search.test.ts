@@ -6,7 +6,9 @@ import type {
 } from "../src/definition/table.js";
 import {
 	findClosestTableMatches,
+	getTableSearchIndex,
 	rankTablesByQuery,
+	TableSearchIndex,
 } from "../src/definition/table-search.js";
 
 describe("table search", () => {
@@ -108,4 +110,84 @@ describe("table search", () => {
 		const results = rankTablesByQuery("fueling", tables);
 		expect(results[0]?.value.name).toBe("Primary Open Loop Fueling");
 	});
+
+	describe("TableSearchIndex", () => {
+		const manyTables: TableDefinition[] = Array.from(
+			{ length: 500 },
+			(_, i) => ({
+				...coolantCompensation,
+				id: `filler-${i}`,
+				name: `Filler Table ${i}`,
+				category: i % 2 === 0 ? "Misc" : "Idle",
+			}),
+		);
+		manyTables.push(highOctaneIgnition, primaryOpenLoopFueling);
+
+		it("is built once per table list", () => {
+			expect(getTableSearchIndex(tables)).toBe(getTableSearchIndex(tables));
+		});
+
+		it("keeps substring matches when prefiltering", () => {
+			const index = new TableSearchIndex(manyTables);
+			const candidates = index.candidates("octane", 10);
+			expect(candidates).toContain(highOctaneIgnition);
+			expect(candidates.length).toBeLessThanOrEqual(10);
+		});
+
+		it("scores typos that share no trigram with their target", () => {
+			const index = new TableSearchIndex(manyTables);
+			// "fule" shares no trigram with "Fueling" or the "Fuel" category
+			expect(index.candidates("fule", 10)).toContain(primaryOpenLoopFueling);
+			expect(findClosestTableMatches("fule", manyTables, 1)).toEqual([
+				primaryOpenLoopFueling,
+			]);
+			expect(
+				rankTablesByQuery("ingition", manyTables, { maxResults: 1 })[0]
+					?.value,
+			).toBe(highOctaneIgnition);
+		});
+
+		it("rebuilds when an entry of the list is replaced", () => {
+			const list: TableDefinition[] = [
+				highOctaneIgnition,
+				coolantCompensation,
+			];
+			const before = getTableSearchIndex(list);
+			list[1] = primaryOpenLoopFueling;
+			const after = getTableSearchIndex(list);
+			expect(after).not.toBe(before);
+			expect(after.tables).toEqual([
+				highOctaneIgnition,
+				primaryOpenLoopFueling,
+			]);
+			expect(
+				rankTablesByQuery("open loop", list, { maxResults: 1 })[0]?.value,
+			).toBe(primaryOpenLoopFueling);
+		});
+
+		it("ranks the same as a fresh index while the query is typed", () => {
+			const index = new TableSearchIndex(manyTables);
+			const typed = "primary open loop";
+			for (let i = 1; i <= typed.length; i++) {
+				const query = typed.slice(0, i);
+				expect(index.rank(query, { maxResults: 5 })).toEqual(
+					new TableSearchIndex(manyTables).rank(query, { maxResults: 5 }),
+				);
+			}
+			// Deleting back and replacing the query
+			expect(index.rank("prim", { maxResults: 1 })[0]?.value).toBe(
+				primaryOpenLoopFueling,
+			);
+			expect(index.rank("ignition", { maxResults: 1 })[0]?.value).toBe(
+				highOctaneIgnition,
+			);
+		});
+
+		it("filters tables by name or category substring", () => {
+			const index = new TableSearchIndex(manyTables);
+			expect(index.filter("table 49")).toHaveLength(11);
+			expect(index.filter("IDLE")).toHaveLength(250);
+			expect(index.filter("ig")).toEqual([highOctaneIgnition]);
+		});
+	});
 });
@@ -13,8 +13,10 @@ import {
 	areAllValid,
 	getInvalidCount,
 	getInvalidResults,
+	isInvalidAt,
 	validateValue,
 	validateValues,
+	validateValuesBulk,
 } from "../src/validation/validator.js";
 
 const INVALID_SCALAR_TYPE = "unknown" as ScalarType;
@@ -510,6 +512,67 @@ describe("Validator", () => {
 		});
 	});
 
+	describe("validateValuesBulk", () => {
+		it("agrees with validateValues value by value", () => {
+			const context: ValidationContext = { dtype: "u8", min: 10, max: 200 };
+			const values = Float64Array.from([
+				5, 10, 150, 150, 201, 300, -1, NaN, Infinity, 120, 199, 200,
+			]);
+			for (const checkMonotonic of [false, true]) {
+				const options = { checkMonotonic };
+				const expected = validateValues(Array.from(values), context, options);
+				const bulk = validateValuesBulk(values, context, options);
+
+				expect(bulk.count).toBe(values.length);
+				expect(bulk.invalidCount).toBe(getInvalidCount(expected));
+				expect(bulk.failures.map((failure) => failure.result)).toEqual(
+					getInvalidResults(expected),
+				);
+				for (const [index, result] of expected.entries()) {
+					expect(isInvalidAt(bulk, index)).toBe(!result.valid);
+				}
+			}
+		});
+
+		it("counts failures by code", () => {
+			const result = validateValuesBulk(
+				Float64Array.from([1, 300, 300, -5, NaN]),
+				{ dtype: "u8", min: 0, max: 100 },
+			);
+			expect(result.countsByCode).toEqual({
+				INVALID_NUMBER: 1,
+				TYPE_OUT_OF_RANGE: 3,
+			});
+		});
+
+		it("only details the first maxFailures failures", () => {
+			const values = new Float64Array(10_000).fill(500);
+			values[0] = 1;
+			const result = validateValuesBulk(
+				values,
+				{ dtype: "u8" },
+				{ maxFailures: 3 },
+			);
+			expect(result.invalidCount).toBe(9_999);
+			expect(result.failures.map((failure) => failure.index)).toEqual([
+				1, 2, 3,
+			]);
+			expect(result.failures[0]?.result.code).toBe("TYPE_OUT_OF_RANGE");
+			expect(isInvalidAt(result, 0)).toBe(false);
+			expect(isInvalidAt(result, 9_999)).toBe(true);
+		});
+
+		it("rejects infinities with range checks disabled", () => {
+			const result = validateValuesBulk(
+				[1, Infinity],
+				{ dtype: "u8" },
+				{ checkDataType: false, checkMinMax: false },
+			);
+			expect(result.invalidCount).toBe(1);
+			expect(result.failures[0]?.result.code).toBe("INVALID_NUMBER");
+		});
+	});
+
 	describe("areAllValid", () => {
 		it("returns true when all results are valid", () => {
 			const results = [{ valid: true }, { valid: true }, { valid: true }];
@@ -17,6 +17,15 @@ import type {
 } from "@ecu-explorer/core";
 import { mitsucanChecksum } from "@ecu-explorer/core";
 import { XMLParser } from "fast-xml-parser";
+import { RomIdIndex } from "./romid-index.js";
+
+export {
+	type RomIdHeader,
+	RomIdIndex,
+	type RomIdIndexOptions,
+	readRomIdHeader,
+	scanRomIdHeader,
+} from "./romid-index.js";
 
 const DEFAULT_WIN_DIR = "%ProgramFiles(x86)%\\OpenECU\\EcuFlash\\rommetadata";
 
@@ -454,21 +463,6 @@ function normalizeLookupToken(value: string): string {
 	return value.trim().toLowerCase();
 }
 
-async function readRomXmlId(fsPath: string): Promise<string | undefined> {
-	try {
-		const raw = await fs.readFile(fsPath, "utf8");
-		const romidMatch = raw.match(/<romid\b[^>]*>([\s\S]*?)<\/romid>/i);
-		if (!romidMatch) return undefined;
-		const xmlidMatch = romidMatch[1]?.match(
-			/<xmlid\b[^>]*>([\s\S]*?)<\/xmlid>/i,
-		);
-		const xmlid = xmlidMatch?.[1]?.trim();
-		return xmlid ? xmlid : undefined;
-	} catch {
-		return undefined;
-	}
-}
-
 function buildScalingIndex(rom: Raw): Map<string, ScalingNode> {
 	const scalings = asArray((rom as Raw).scaling as ScalingNode | ScalingNode[]);
 	const map = new Map<string, ScalingNode>();
@@ -868,6 +862,15 @@ async function listXmlFilesInDirectory(dir: string): Promise<string[]> {
 	return out;
 }
 
+export interface EcuFlashProviderOptions {
+	/**
+	 * Shared index of definition headers, e.g. one backed by a sidecar file
+	 * so identification survives provider re-creation and restarts. The
+	 * provider keeps a private in-memory index when omitted.
+	 */
+	romIdIndex?: RomIdIndex;
+}
+
 export class EcuFlashProvider implements ROMDefinitionProvider {
 	id = "ecuflash";
 	label = "ECUFlash";
@@ -875,13 +878,21 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 	private cachedDefinitionUris: string[] | null = null;
 	private additionalSearchPaths: string[] = [];
 	private includeAliasIndex: Map<string, string> | null = null;
+	private readonly romIds: RomIdIndex;
+	private readonly ownsRomIds: boolean;
 
 	/**
 	 * Create a new EcuFlashProvider
 	 * @param searchPaths Additional paths to search for definition files (e.g., workspace folders)
+	 * @param options Provider options
 	 */
-	constructor(searchPaths: string[] = []) {
+	constructor(
+		searchPaths: string[] = [],
+		options: EcuFlashProviderOptions = {},
+	) {
 		this.additionalSearchPaths = searchPaths;
+		this.ownsRomIds = options.romIdIndex === undefined;
+		this.romIds = options.romIdIndex ?? new RomIdIndex();
 	}
 
 	/**
@@ -899,6 +910,9 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 	dispose(): void {
 		this.cachedDefinitionUris = null;
 		this.includeAliasIndex = null;
+		if (this.ownsRomIds) {
+			this.romIds.dispose();
+		}
 	}
 
 	async discoverDefinitionUris(romUri?: string): Promise<string[]> {
@@ -984,21 +998,18 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 		return uniqueFiles.map(fsPathToUri);
 	}
 
+	/**
+	 * Identify a definition from its `<romid>` header alone
+	 *
+	 * The header is read by a streaming scanner and cached in the ROM ID
+	 * index, so peeking a whole metadata directory never builds a DOM and
+	 * only re-reads files that changed.
+	 */
 	async peek(definitionUri: string): Promise<ROMDefinitionStub> {
-		const doc = await this.readXml(definitionUri);
-		const rom = extractRom(doc);
-		if (!rom) {
-			return {
-				uri: definitionUri,
-				name: "ECUFlash Definition",
-				fingerprints: [],
-			};
-		}
-
-		const romid = (rom as Raw).romid as Raw | undefined;
-		const xmlid = extractText(romid?.xmlid);
-		const internalidaddress = extractText(romid?.internalidaddress);
-		const internalidhex = extractText(romid?.internalidhex);
+		const header = await this.romIds.read(uriToFsPath(definitionUri));
+		const xmlid = header?.xmlid;
+		const internalidaddress = header?.internalidaddress;
+		const internalidhex = header?.internalidhex;
 
 		const name = xmlid ?? internalidhex ?? "ECUFlash Definition";
 		const fingerprints: ROMFingerprint[] = [];
@@ -1115,14 +1126,18 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 		const visited = new Set<string>([rootDefinitionPath]);
 		const recursiveFileCache = new Map<string, string[]>();
 		const includeXmlIdLookupCache = new Map<string, string | null>();
-		const fileXmlIdCache = new Map<string, string | null>();
+
+		// Headers come from the shared ROM ID index, scanned concurrently
+		const xmlIdsOf = async (files: string[]) =>
+			(await this.romIds.readAll(files)).map((header) => header?.xmlid);
 
 		const getIncludeAliasIndex = async (): Promise<Map<string, string>> => {
 			if (this.includeAliasIndex) return this.includeAliasIndex;
 			const index = new Map<string, string>();
 			for (const root of searchRoots) {
 				const files = await recursiveXmlFilesForRoot(root);
-				for (const file of files) {
+				const xmlIds = await xmlIdsOf(files);
+				for (const [i, file] of files.entries()) {
 					const baseName = path.basename(file, ".xml");
 					const normalizedBase = normalizeLookupToken(baseName);
 					if (normalizedBase && !index.has(normalizedBase)) {
@@ -1137,7 +1152,7 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 							index.set(normalizedShort, file);
 						}
 					}
-					const fileXmlId = await readRomXmlId(file);
+					const fileXmlId = xmlIds[i];
 					if (!fileXmlId) continue;
 					const normalizedXmlId = normalizeLookupToken(fileXmlId);
 					if (normalizedXmlId && !index.has(normalizedXmlId)) {
@@ -1240,14 +1255,9 @@ export class EcuFlashProvider implements ROMDefinitionProvider {
 
 			for (const root of searchRoots) {
 				const files = await recursiveXmlFilesForRoot(root);
-				for (const file of files) {
-					let fileXmlId: string | null;
-					if (fileXmlIdCache.has(file)) {
-						fileXmlId = fileXmlIdCache.get(file) ?? null;
-					} else {
-						fileXmlId = (await readRomXmlId(file)) ?? null;
-						fileXmlIdCache.set(file, fileXmlId);
-					}
+				const xmlIds = await xmlIdsOf(files);
+				for (const [i, file] of files.entries()) {
+					const fileXmlId = xmlIds[i];
 					if (!fileXmlId) continue;
 					if (normalizeLookupToken(fileXmlId) === normalizedLookupToken) {
 						includeXmlIdLookupCache.set(normalizedLookupToken, file);
@@ -0,0 +1,560 @@
+import * as fs from "node:fs/promises";
+import * as path from "node:path";
+
+/** Bytes read per step while looking for the end of `<romid>` */
+const READ_CHUNK_SIZE = 16 * 1024;
+
+/** Files scanned at once by a {@link RomIdIndex} */
+const DEFAULT_CONCURRENCY = 8;
+
+/** Delay before a changed index is written back to its sidecar file */
+const SAVE_DELAY_MS = 2000;
+
+const INDEX_VERSION = 1;
+
+const LT = 0x3c;
+const GT = 0x3e;
+const SLASH = 0x2f;
+const QUESTION = 0x3f;
+const BANG = 0x21;
+const DQUOTE = 0x22;
+const SQUOTE = 0x27;
+
+const encoder = new TextEncoder();
+const decoder = new TextDecoder();
+const COMMENT_START = encoder.encode("<!--");
+const COMMENT_END = encoder.encode("-->");
+const CDATA_START = encoder.encode("<![CDATA[");
+const CDATA_END = encoder.encode("]]>");
+const PI_END = encoder.encode("?>");
+
+/**
+ * ROM identification fields read from a definition's `<rom><romid>` header
+ */
+export interface RomIdHeader {
+	xmlid?: string;
+	internalidaddress?: string;
+	internalidhex?: string;
+}
+
+type RomIdField = keyof RomIdHeader;
+
+const ROMID_FIELDS: ReadonlySet<string> = new Set<RomIdField>([
+	"xmlid",
+	"internalidaddress",
+	"internalidhex",
+]);
+
+/**
+ * Incremental scanner for the `<romid>` header of an ECUFlash definition
+ *
+ * Walks the XML token by token straight from the bytes, tracking only the
+ * open element names, and stops at `</romid>` (or as soon as the root is
+ * not `<rom>`). Nothing past the header is read or decoded, so identifying
+ * a definition costs a few kilobytes of I/O instead of a full parse.
+ * Element names are matched case-sensitively, as the full parser does.
+ */
+export class RomIdScanner {
+	private buffer = new Uint8Array(0);
+	private readonly stack: string[] = [];
+	private readonly text: Partial<Record<RomIdField, string>> = {};
+	private found = false;
+	private finished = false;
+
+	/**
+	 * Feed the next chunk of the file
+	 *
+	 * @returns `true` once the header is complete and no more input is needed
+	 */
+	push(chunk: Uint8Array): boolean {
+		if (this.finished) {
+			return true;
+		}
+		if (this.buffer.length === 0) {
+			this.buffer = chunk;
+		} else {
+			const joined = new Uint8Array(this.buffer.length + chunk.length);
+			joined.set(this.buffer);
+			joined.set(chunk, this.buffer.length);
+			this.buffer = joined;
+		}
+		const consumed = this.scan();
+		// Keep only the unfinished token; copy so large chunks are released
+		this.buffer = this.finished
+			? new Uint8Array(0)
+			: this.buffer.slice(consumed);
+		return this.finished;
+	}
+
+	/**
+	 * @returns The header, or undefined if the input has no `<rom><romid>`
+	 */
+	end(): RomIdHeader | undefined {
+		this.finished = true;
+		this.buffer = new Uint8Array(0);
+		if (!this.found) {
+			return undefined;
+		}
+		const header: RomIdHeader = {};
+		for (const [field, value] of Object.entries(this.text)) {
+			const trimmed = value.trim();
+			if (trimmed) {
+				header[field as RomIdField] = trimmed;
+			}
+		}
+		return header;
+	}
+
+	/**
+	 * Process every complete token in the buffer
+	 *
+	 * @returns Offset of the first byte not consumed
+	 */
+	private scan(): number {
+		const bytes = this.buffer;
+		let pos = 0;
+		while (pos < bytes.length && !this.finished) {
+			if (bytes[pos] !== LT) {
+				const next = bytes.indexOf(LT, pos);
+				if (next === -1) {
+					return pos;
+				}
+				this.appendText(bytes, pos, next);
+				pos = next;
+				continue;
+			}
+
+			if (bytes[pos + 1] === BANG) {
+				if (startsWith(bytes, pos, COMMENT_START)) {
+					const end = indexOfSequence(bytes, COMMENT_END, pos + 4);
+					if (end === -1) return pos;
+					pos = end + COMMENT_END.length;
+				} else if (startsWith(bytes, pos, CDATA_START)) {
+					const end = indexOfSequence(bytes, CDATA_END, pos + 9);
+					if (end === -1) return pos;
+					this.appendText(bytes, pos + CDATA_START.length, end, false);
+					pos = end + CDATA_END.length;
+				} else if (
+					isTruncated(bytes, pos, COMMENT_START) ||
+					isTruncated(bytes, pos, CDATA_START)
+				) {
+					return pos;
+				} else {
+					// Declarations such as <!DOCTYPE>
+					const end = tagEnd(bytes, pos + 2);
+					if (end === -1) return pos;
+					pos = end + 1;
+				}
+			} else if (pos + 1 >= bytes.length) {
+				return pos;
+			} else if (bytes[pos + 1] === QUESTION) {
+				const end = indexOfSequence(bytes, PI_END, pos + 2);
+				if (end === -1) return pos;
+				pos = end + PI_END.length;
+			} else {
+				const end = tagEnd(bytes, pos + 1);
+				if (end === -1) return pos;
+				this.tag(bytes, pos, end);
+				pos = end + 1;
+			}
+		}
+		return pos;
+	}
+
+	/**
+	 * Handle the start or end tag spanning `bytes[start, end]`
+	 */
+	private tag(bytes: Uint8Array, start: number, end: number): void {
+		if (bytes[start + 1] === SLASH) {
+			const name = tagName(bytes, start + 2, end);
+			if (this.stack[this.stack.length - 1] === name) {
+				this.stack.pop();
+			}
+			if (name === "romid" && this.stack.length === 1) {
+				this.finished = true;
+			} else if (this.stack.length === 0) {
+				// Closed the root without a header
+				this.finished = true;
+			}
+			return;
+		}
+
+		const name = tagName(bytes, start + 1, end);
+		if (this.stack.length === 0 && name !== "rom") {
+			// Not an ECUFlash definition
+			this.finished = true;
+			return;
+		}
+		if (this.stack.length === 1 && name === "romid") {
+			this.found = true;
+		}
+		if (bytes[end - 1] !== SLASH) {
+			this.stack.push(name);
+		}
+	}
+
+	private appendText(
+		bytes: Uint8Array,
+		start: number,
+		end: number,
+		entities = true,
+	): void {
+		const field = this.stack[2];
+		if (
+			this.stack.length !== 3 ||
+			this.stack[1] !== "romid" ||
+			field === undefined ||
+			!ROMID_FIELDS.has(field)
+		) {
+			return;
+		}
+		const raw = decoder.decode(bytes.subarray(start, end));
+		const value = entities ? decodeEntities(raw) : raw;
+		const key = field as RomIdField;
+		this.text[key] = (this.text[key] ?? "") + value;
+	}
+}
+
+/**
+ * Read the `<romid>` header of a definition file, stopping as soon as the
+ * header is complete
+ */
+export async function readRomIdHeader(
+	fsPath: string,
+): Promise<RomIdHeader | undefined> {
+	const handle = await fs.open(fsPath, "r");
+	try {
+		const scanner = new RomIdScanner();
+		// The scanner copies whatever it keeps, so one chunk can be reused
+		const chunk = new Uint8Array(READ_CHUNK_SIZE);
+		for (;;) {
+			const { bytesRead } = await handle.read(chunk, 0, chunk.length, null);
+			if (bytesRead === 0 || scanner.push(chunk.subarray(0, bytesRead))) {
+				return scanner.end();
+			}
+		}
+	} finally {
+		await handle.close();
+	}
+}
+
+/**
+ * Scan a complete document held in memory
+ */
+export function scanRomIdHeader(bytes: Uint8Array): RomIdHeader | undefined {
+	const scanner = new RomIdScanner();
+	scanner.push(bytes);
+	return scanner.end();
+}
+
+export interface RomIdIndexOptions {
+	/** Sidecar file the index is loaded from and saved to; in-memory if unset */
+	path?: string;
+	/** Maximum number of files stat'ed or scanned at once */
+	concurrency?: number;
+}
+
+interface RomIdIndexEntry {
+	mtimeMs: number;
+	size: number;
+	header?: RomIdHeader;
+}
+
+interface RomIdIndexFile {
+	version: number;
+	entries: Record<string, RomIdIndexEntry>;
+}
+
+/**
+ * Index of definition headers, keyed by file path
+ *
+ * Each lookup stats the file and rescans it only when its size or mtime
+ * changed, so after the first pass over a metadata directory only edited
+ * files are read again. Lookups share a bounded I/O pool, so callers may
+ * request a whole directory at once. With a sidecar path, the index
+ * survives restarts: it is loaded on first use and written back shortly
+ * after it changes (and on {@link flush}).
+ */
+export class RomIdIndex {
+	private readonly entries = new Map<string, RomIdIndexEntry>();
+	private readonly pending = new Map<
+		string,
+		Promise<RomIdHeader | undefined>
+	>();
+	private readonly waiters: Array<() => void> = [];
+	private readonly concurrency: number;
+	private active = 0;
+	private loaded: Promise<void> | null = null;
+	private dirty = false;
+	private saveTimer: ReturnType<typeof setTimeout> | null = null;
+
+	constructor(private readonly options: RomIdIndexOptions = {}) {
+		this.concurrency = Math.max(
+			1,
+			options.concurrency ?? DEFAULT_CONCURRENCY,
+		);
+	}
+
+	/**
+	 * Get the header of a definition file
+	 *
+	 * @returns The header, or undefined if the file has no `<rom><romid>`
+	 * @throws If the file cannot be read
+	 */
+	read(fsPath: string): Promise<RomIdHeader | undefined> {
+		const key = path.resolve(fsPath);
+		let result = this.pending.get(key);
+		if (!result) {
+			result = this.lookup(key).finally(() => this.pending.delete(key));
+			this.pending.set(key, result);
+		}
+		return result;
+	}
+
+	/**
+	 * Get the headers of several files concurrently, in input order;
+	 * unreadable files yield undefined
+	 */
+	readAll(fsPaths: string[]): Promise<Array<RomIdHeader | undefined>> {
+		return Promise.all(
+			fsPaths.map((fsPath) => this.read(fsPath).catch(() => undefined)),
+		);
+	}
+
+	/**
+	 * Write pending changes to the sidecar file
+	 */
+	async flush(): Promise<void> {
+		if (this.saveTimer) {
+			clearTimeout(this.saveTimer);
+			this.saveTimer = null;
+		}
+		const target = this.options.path;
+		if (!target || !this.dirty) {
+			return;
+		}
+		this.dirty = false;
+		const file: RomIdIndexFile = {
+			version: INDEX_VERSION,
+			entries: Object.fromEntries(this.entries),
+		};
+		try {
+			await fs.mkdir(path.dirname(target), { recursive: true });
+			const temp = `${target}.${process.pid}.tmp`;
+			await fs.writeFile(temp, JSON.stringify(file), "utf8");
+			await fs.rename(temp, target);
+		} catch {
+			// The index is only a cache; the next change retries
+			this.dirty = true;
+		}
+	}
+
+	dispose(): void {
+		void this.flush();
+	}
+
+	private async lookup(fsPath: string): Promise<RomIdHeader | undefined> {
+		await this.load();
+		await this.acquire();
+		try {
+			let stat: Awaited<ReturnType<typeof fs.stat>>;
+			try {
+				stat = await fs.stat(fsPath);
+			} catch (error) {
+				if (this.entries.delete(fsPath)) {
+					this.markDirty();
+				}
+				throw error;
+			}
+			const cached = this.entries.get(fsPath);
+			if (
+				cached &&
+				cached.mtimeMs === stat.mtimeMs &&
+				cached.size === stat.size
+			) {
+				return cached.header;
+			}
+			const header = await readRomIdHeader(fsPath);
+			this.entries.set(fsPath, {
+				mtimeMs: stat.mtimeMs,
+				size: stat.size,
+				...(header ? { header } : {}),
+			});
+			this.markDirty();
+			return header;
+		} finally {
+			this.release();
+		}
+	}
+
+	private load(): Promise<void> {
+		this.loaded ??= (async () => {
+			const source = this.options.path;
+			if (!source) {
+				return;
+			}
+			try {
+				const file = JSON.parse(
+					await fs.readFile(source, "utf8"),
+				) as RomIdIndexFile;
+				if (file.version !== INDEX_VERSION || !file.entries) {
+					return;
+				}
+				for (const [fsPath, entry] of Object.entries(file.entries)) {
+					if (!this.entries.has(fsPath)) {
+						this.entries.set(fsPath, entry);
+					}
+				}
+			} catch {
+				// Missing or corrupt index: start empty
+			}
+		})();
+		return this.loaded;
+	}
+
+	private markDirty(): void {
+		this.dirty = true;
+		if (!this.options.path || this.saveTimer) {
+			return;
+		}
+		this.saveTimer = setTimeout(() => {
+			this.saveTimer = null;
+			void this.flush();
+		}, SAVE_DELAY_MS);
+		this.saveTimer.unref?.();
+	}
+
+	private acquire(): Promise<void> {
+		if (this.active < this.concurrency) {
+			this.active++;
+			return Promise.resolve();
+		}
+		return new Promise((resolve) => this.waiters.push(resolve));
+	}
+
+	private release(): void {
+		const next = this.waiters.shift();
+		if (next) {
+			// Hand the slot straight to the next lookup
+			next();
+		} else {
+			this.active--;
+		}
+	}
+}
+
+function startsWith(
+	bytes: Uint8Array,
+	offset: number,
+	prefix: Uint8Array,
+): boolean {
+	if (offset + prefix.length > bytes.length) {
+		return false;
+	}
+	for (let i = 0; i < prefix.length; i++) {
+		if (bytes[offset + i] !== prefix[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Whether the buffer ends partway through `prefix` at `offset`
+ */
+function isTruncated(
+	bytes: Uint8Array,
+	offset: number,
+	prefix: Uint8Array,
+): boolean {
+	if (offset + prefix.length <= bytes.length) {
+		return false;
+	}
+	for (let i = offset; i < bytes.length; i++) {
+		if (bytes[i] !== prefix[i - offset]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+function indexOfSequence(
+	bytes: Uint8Array,
+	sequence: Uint8Array,
+	from: number,
+): number {
+	const first = sequence[0] as number;
+	for (
+		let i = bytes.indexOf(first, from);
+		i !== -1;
+		i = bytes.indexOf(first, i + 1)
+	) {
+		if (startsWith(bytes, i, sequence)) {
+			return i;
+		}
+		if (i + sequence.length > bytes.length) {
+			break;
+		}
+	}
+	return -1;
+}
+
+/**
+ * Find the `>` closing a tag, skipping quoted attribute values
+ */
+function tagEnd(bytes: Uint8Array, from: number): number {
+	let quote = 0;
+	for (let i = from; i < bytes.length; i++) {
+		const code = bytes[i] as number;
+		if (quote !== 0) {
+			if (code === quote) quote = 0;
+		} else if (code === DQUOTE || code === SQUOTE) {
+			quote = code;
+		} else if (code === GT) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+function tagName(bytes: Uint8Array, start: number, end: number): string {
+	let name = "";
+	for (let i = start; i < end; i++) {
+		const code = bytes[i] as number;
+		// Whitespace or "/" ends the name
+		if (code <= 0x20 || code === SLASH) {
+			break;
+		}
+		name += String.fromCharCode(code);
+	}
+	return name;
+}
+
+function decodeEntities(text: string): string {
+	if (!text.includes("&")) {
+		return text;
+	}
+	return text.replace(
+		/&(lt|gt|amp|quot|apos|#\d+|#x[0-9a-fA-F]+);/g,
+		(_m, entity: string) => {
+			switch (entity) {
+				case "lt":
+					return "<";
+				case "gt":
+					return ">";
+				case "amp":
+					return "&";
+				case "quot":
+					return '"';
+				case "apos":
+					return "'";
+				default:
+					return String.fromCodePoint(
+						entity[1] === "x"
+							? Number.parseInt(entity.slice(2), 16)
+							: Number.parseInt(entity.slice(1), 10),
+					);
+			}
+		},
+	);
+}
@@ -0,0 +1,132 @@
+import * as fs from "node:fs/promises";
+import * as os from "node:os";
+import * as path from "node:path";
+import { afterEach, beforeEach, describe, expect, it } from "vitest";
+import {
+	RomIdIndex,
+	RomIdScanner,
+	readRomIdHeader,
+	scanRomIdHeader,
+} from "../src/romid-index.js";
+
+const encode = (text: string) => new TextEncoder().encode(text);
+
+const definitionXml = (xmlid: string) => `<?xml version="1.0" encoding="utf-8"?>
+<!-- generated <romid> comment -->
+<rom>
+	<romid>
+		<xmlid>${xmlid}</xmlid>
+		<internalidaddress>5002a</internalidaddress>
+		<internalidhex>56890009</internalidhex>
+		<make>Mitsubishi &amp; Co</make>
+	</romid>
+	<table name="Fuel" address="1000" />
+</rom>
+`;
+
+describe("scanRomIdHeader", () => {
+	it("extracts the identification fields", () => {
+		expect(scanRomIdHeader(encode(definitionXml("56890009")))).toEqual({
+			xmlid: "56890009",
+			internalidaddress: "5002a",
+			internalidhex: "56890009",
+		});
+	});
+
+	it("decodes entities and CDATA", () => {
+		const xml =
+			"<rom><romid><xmlid>a&amp;b&#x41;<![CDATA[<c>]]></xmlid></romid></rom>";
+		expect(scanRomIdHeader(encode(xml))).toEqual({ xmlid: "a&bA<c>" });
+	});
+
+	it("ignores documents without a rom root", () => {
+		const xml = "<root><rom><romid><xmlid>x</xmlid></romid></rom></root>";
+		expect(scanRomIdHeader(encode(xml))).toBeUndefined();
+		expect(scanRomIdHeader(encode("<rom><table /></rom>"))).toBeUndefined();
+	});
+
+	it("ignores elements nested below the header fields", () => {
+		const xml =
+			'<rom><romid><xmlid>id</xmlid><flags><xmlid a=">">no</xmlid></flags></romid></rom>';
+		expect(scanRomIdHeader(encode(xml))).toEqual({ xmlid: "id" });
+	});
+});
+
+describe("RomIdScanner", () => {
+	it("resumes tokens split across chunks and stops after the header", () => {
+		const bytes = encode(definitionXml("split-id"));
+		const end = new TextDecoder().decode(bytes).indexOf("</romid>") + 8;
+		for (const size of [1, 3, 7, 64]) {
+			const scanner = new RomIdScanner();
+			let offset = 0;
+			while (!scanner.push(bytes.subarray(offset, offset + size))) {
+				offset += size;
+			}
+			expect(offset + size).toBeGreaterThanOrEqual(end);
+			expect(offset).toBeLessThan(end);
+			expect(scanner.end()?.xmlid).toBe("split-id");
+		}
+	});
+});
+
+describe("RomIdIndex", () => {
+	let dir: string;
+
+	beforeEach(async () => {
+		dir = await fs.mkdtemp(path.join(os.tmpdir(), "ecuflash-romid-"));
+	});
+
+	afterEach(async () => {
+		await fs.rm(dir, { recursive: true, force: true });
+	});
+
+	it("reads the header from the start of a large file", async () => {
+		const file = path.join(dir, "large.xml");
+		const tables = '\t<table name="t" address="0" />\n'.repeat(20000);
+		await fs.writeFile(
+			file,
+			definitionXml("large").replace("</rom>", `${tables}</rom>`),
+		);
+		expect((await readRomIdHeader(file))?.xmlid).toBe("large");
+	});
+
+	it("rescans only files that changed", async () => {
+		const a = path.join(dir, "a.xml");
+		const b = path.join(dir, "b.xml");
+		await fs.writeFile(a, definitionXml("a"));
+		await fs.writeFile(b, definitionXml("b"));
+		const index = new RomIdIndex({ concurrency: 1 });
+
+		const first = await index.readAll([a, b, path.join(dir, "missing.xml")]);
+		expect(first.map((header) => header?.xmlid)).toEqual(["a", "b", undefined]);
+
+		await fs.writeFile(a, definitionXml("a2"));
+		await fs.utimes(a, new Date(), new Date(Date.now() + 5000));
+		expect((await index.read(a))?.xmlid).toBe("a2");
+		await expect(index.read(path.join(dir, "missing.xml"))).rejects.toThrow();
+	});
+
+	it("persists entries to a sidecar file", async () => {
+		const a = path.join(dir, "a.xml");
+		const sidecar = path.join(dir, "cache", "romid-index.json");
+		await fs.writeFile(a, definitionXml("a"));
+
+		const index = new RomIdIndex({ path: sidecar });
+		await index.read(a);
+		await index.flush();
+		const saved = JSON.parse(await fs.readFile(sidecar, "utf8"));
+		expect(saved.entries[path.resolve(a)].header.xmlid).toBe("a");
+
+		// A fresh index trusts the sidecar while the file is unchanged
+		const stat = await fs.stat(a);
+		saved.entries[path.resolve(a)].header.xmlid = "from-sidecar";
+		await fs.writeFile(sidecar, JSON.stringify(saved));
+		const reloaded = new RomIdIndex({ path: sidecar });
+		expect((await reloaded.read(a))?.xmlid).toBe("from-sidecar");
+
+		await fs.writeFile(a, definitionXml("changed"));
+		await fs.utimes(a, stat.atime, new Date(stat.mtimeMs + 5000));
+		expect((await reloaded.read(a))?.xmlid).toBe("changed");
+		reloaded.dispose();
+	});
+});
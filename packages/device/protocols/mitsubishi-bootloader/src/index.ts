@@ -5,7 +5,7 @@ import type {
 	RomProgress,
 	WriteOptions,
 } from "@ecu-explorer/device";
-import { computeChangedSectors } from "@ecu-explorer/device";
+import { FlashWritePipeline } from "@ecu-explorer/device";
 
 // Ref: HANDSHAKE_ANALYSIS.md — Mitsubishi mitsuecu class
 // Boot sync bytes
@@ -199,15 +199,27 @@ export class MitsubishiBootloaderProtocol implements EcuProtocol {
 		// Determine which sectors need to be erased and written.
 		// When originalRom is provided, only changed sectors are processed.
 		// When not provided, all sectors are processed (full flash — backward compatible).
-		const sectorsToWrite = options?.originalRom
-			? computeChangedSectors(options.originalRom, rom, SECTOR_SIZE)
-			: Array.from({ length: ROM_SIZE / SECTOR_SIZE }, (_, i) => i);
+		// Write frames for the next sector are built while this one is on the
+		// wire.
+		const pipeline = new FlashWritePipeline(rom, {
+			sectorSize: SECTOR_SIZE,
+			blockSize: BLOCK_SIZE,
+			headerLength: 5,
+			writeHeader: (frame, { offset }) => {
+				const addr = ROM_START + offset;
+				frame[0] = CMD_WRITE;
+				frame[1] = (addr >> 16) & 0xff;
+				frame[2] = (addr >> 8) & 0xff;
+				frame[3] = addr & 0xff;
+				frame[4] = BLOCK_SIZE;
+			},
+			originalRom: options?.originalRom,
+		});
 
-		const blocksPerSector = SECTOR_SIZE / BLOCK_SIZE;
 		let bytesWritten = 0;
-		const totalBytesToWrite = sectorsToWrite.length * SECTOR_SIZE;
+		const totalBytesToWrite = pipeline.totalBytes;
 
-		for (const sectorIndex of sectorsToWrite) {
+		for await (const { sectorIndex, frames } of pipeline) {
 			const sectorAddr = ROM_START + sectorIndex * SECTOR_SIZE;
 
 			// Emit SECTOR_ERASE_STARTED before erasing this sector
@@ -254,30 +266,7 @@ export class MitsubishiBootloaderProtocol implements EcuProtocol {
 			});
 
 			// Step 3: Write blocks within this sector
-			for (
-				let blockInSector = 0;
-				blockInSector < blocksPerSector;
-				blockInSector++
-			) {
-				const block = sectorIndex * blocksPerSector + blockInSector;
-				const addr = ROM_START + block * BLOCK_SIZE;
-				const blockData = rom.slice(
-					block * BLOCK_SIZE,
-					(block + 1) * BLOCK_SIZE,
-				);
-
-				const addrByte0 = (addr >> 16) & 0xff;
-				const addrByte1 = (addr >> 8) & 0xff;
-				const addrByte2 = addr & 0xff;
-
-				const frame = new Uint8Array(5 + BLOCK_SIZE);
-				frame[0] = CMD_WRITE;
-				frame[1] = addrByte0;
-				frame[2] = addrByte1;
-				frame[3] = addrByte2;
-				frame[4] = BLOCK_SIZE;
-				frame.set(blockData, 5);
-
+			for (const frame of frames) {
 				await connection.sendFrame(frame);
 
 				bytesWritten += BLOCK_SIZE;
@@ -1,14 +1,21 @@
-import type {
-	DeviceConnection,
-	EcuEvent,
-	EcuProtocol,
-	LiveDataFrame,
-	LiveDataHealth,
-	LiveDataSession,
-	PidDescriptor,
-	RomProgress,
+import { type BitFieldPlan, runBitFieldPlan } from "@ecu-explorer/core";
+import {
+	type DeviceConnection,
+	type EcuEvent,
+	type EcuProtocol,
+	groupByRate,
+	type LiveDataFrame,
+	type LiveDataHealth,
+	type LiveDataOptions,
+	type LiveDataRateClass,
+	LiveDataScheduler,
+	type LiveDataSession,
+	type PidDescriptor,
+	type RomProgress,
+	resolvePidRate,
 } from "@ecu-explorer/device";
-import { extractAllRaxParameters, RAX_BLOCKS } from "./rax-decoder.js";
+import { compileRaxExtractionPlan, RAX_BLOCKS } from "./rax-decoder.js";
+import type { RaxBlockDef, RaxParameterCategory } from "./rax-parameters.js";
 import { computeSecurityKey } from "./security.js";
 
 // Ref: https://github.com/harshadura/libmut/blob/master/libmut/mut.py
@@ -43,10 +50,34 @@ const CMD_SET_ADDRESS = 0xe0; // E0: Set 4-byte RAM address pointer
 const CMD_READ_WORD_INC = 0xe5; // E5: Read 2 bytes and auto-increment address by 2
 const CMD_READ_BYTE = 0xe1; // E1: Read 1 byte at current address (for odd-size remainder)
 
-// Polling interval between full RAX cycle iterations (ms).
-// RAX blocks refresh at ~10-20 Hz on CAN, ~10 Hz on K-line.
-// A 20 ms cycle gives headroom for multiple block reads per cycle.
-const RAX_POLL_INTERVAL_MS = 20;
+// Largest span fetched by one bulk RAX read. The request's length field
+// allows 0xFF, but the positive response (0x63 + data) must also fit in
+// 255 bytes, so spans stop one byte short.
+const MAX_BULK_READ_SIZE = 0xfe;
+
+// Negative response codes meaning the ECU will never serve a bulk RAX read:
+// serviceNotSupported, subFunctionNotSupported, requestOutOfRange,
+// securityAccessDenied, serviceNotSupportedInActiveSession. Any other
+// rejection (busy, conditions not correct, ...) is retried.
+const BULK_READ_UNSUPPORTED_NRCS: ReadonlySet<number> = new Set([
+	0x11, 0x12, 0x31, 0x33, 0x7f,
+]);
+
+// Default poll rate class per RAX parameter category. RAX blocks refresh at
+// ~10-20 Hz on CAN; a block is polled at the fastest rate of the parameters
+// requested from it.
+const RAX_CATEGORY_RATE_CLASS: Readonly<
+	Record<RaxParameterCategory, LiveDataRateClass>
+> = {
+	engine: "fast",
+	intake: "fast",
+	throttle: "fast",
+	fuel: "normal",
+	vvt: "normal",
+	calculated: "normal",
+	fuel_trim: "slow",
+	vehicle: "slow",
+};
 
 // Base PID number for synthetic MUT-III RAX PIDs.
 // OBD-II Mode 01 uses PIDs 0x00–0xFF. We use 0x8000–0x8FFF as a proprietary
@@ -166,6 +197,117 @@ async function readRaxBlock(
 	return result;
 }
 
+/**
+ * A contiguous RAM span covering one or more RAX blocks, fetched with a single
+ * bulk read.
+ */
+interface RaxReadSpan {
+	/** Start address of the span */
+	address: number;
+	/** Span length in bytes */
+	length: number;
+	/** Indices into RAX_BLOCKS of the blocks contained in this span */
+	blockIndices: number[];
+}
+
+/**
+ * Group RAX blocks into contiguous RAM spans for bulk reads.
+ *
+ * The RAX blocks live next to each other in ECU RAM (0x238051a8–0x238051c9
+ * on the 4B11T), so a whole logging cycle usually fits in one span. Blocks
+ * are merged while the span stays within {@link MAX_BULK_READ_SIZE}.
+ *
+ * @param blockIndices - Indices into `blockDefs` of the blocks to read
+ * @param blockDefs - Block table (default: RAX_BLOCKS)
+ * @returns Read spans ordered by address
+ */
+function planRaxReadSpans(
+	blockIndices: Iterable<number>,
+	blockDefs: readonly RaxBlockDef[] = RAX_BLOCKS,
+): RaxReadSpan[] {
+	const blocks = [...new Set(blockIndices)]
+		.filter((blockIdx) => blockDefs[blockIdx] !== undefined)
+		.sort(
+			(a, b) =>
+				(blockDefs[a]?.requestId ?? 0) - (blockDefs[b]?.requestId ?? 0),
+		);
+
+	const spans: RaxReadSpan[] = [];
+	let current: RaxReadSpan | null = null;
+	for (const blockIdx of blocks) {
+		const block = blockDefs[blockIdx];
+		if (block === undefined) continue;
+		const blockEnd = block.requestId + block.blockSize;
+		if (
+			current !== null &&
+			blockEnd - current.address <= MAX_BULK_READ_SIZE
+		) {
+			current.length = Math.max(current.length, blockEnd - current.address);
+			current.blockIndices.push(blockIdx);
+			continue;
+		}
+		current = {
+			address: block.requestId,
+			length: block.blockSize,
+			blockIndices: [blockIdx],
+		};
+		spans.push(current);
+	}
+	return spans;
+}
+
+/**
+ * Read a span of ECU RAM in one round trip using UDS ReadMemoryByAddress
+ * (0x23) with a 4-byte address and 1-byte length.
+ *
+ * Request:  `[0x23, 0x14, a3, a2, a1, a0, length]`
+ * Response: `[0x63, ...data]`
+ *
+ * @param connection - Active device connection
+ * @param address    - 4-byte RAM start address
+ * @param length     - Number of bytes to read (1–255)
+ * @returns The requested bytes, or `null` if the ECU answered with a
+ *          negative response saying the request is not supported, meaning
+ *          the caller should fall back to E0/E5
+ * @throws Error on any other negative response or a malformed reply; these
+ *         may be transient, so the caller should retry the bulk read
+ */
+async function readRaxMemory(
+	connection: DeviceConnection,
+	address: number,
+	length: number,
+): Promise<Uint8Array | null> {
+	const response = await connection.sendFrame(
+		new Uint8Array([
+			SID_READ_MEMORY_BY_ADDRESS,
+			ADDRESS_AND_LENGTH_FORMAT,
+			(address >>> 24) & 0xff,
+			(address >>> 16) & 0xff,
+			(address >>> 8) & 0xff,
+			address & 0xff,
+			length,
+		]),
+	);
+	if (response[0] === 0x7f && response[1] === SID_READ_MEMORY_BY_ADDRESS) {
+		const nrc = response[2] ?? 0;
+		if (BULK_READ_UNSUPPORTED_NRCS.has(nrc)) {
+			return null;
+		}
+		throw new Error(
+			`ReadMemoryByAddress rejected with NRC 0x${nrc.toString(16)}`,
+		);
+	}
+	if (
+		response[0] !== SID_READ_MEMORY_BY_ADDRESS + 0x40 ||
+		response.length < 1 + length
+	) {
+		throw new Error(
+			`Malformed ReadMemoryByAddress response (${response.length} bytes)`,
+		);
+	}
+	return response.subarray(1, 1 + length);
+}
+
 /**
  * MUT-III ECU protocol implementation for Mitsubishi 4B11T ECUs (EVO X).
  *
@@ -230,20 +372,29 @@ export class Mut3Protocol implements EcuProtocol {
 	 *
 	 * ## How it works
 	 *
-	 * 1. Map the requested PIDs to the minimal set of RAX blocks needed.
-	 * 2. Each polling cycle, for each required block:
+	 * 1. Map the requested PIDs to the minimal set of RAX blocks needed, and
+	 *    group those blocks by target rate (the fastest rate class of the
+	 *    parameters requested from each block, or `options.rates`).
+	 * 2. Each rate group becomes one task on a shared
+	 *    {@link LiveDataScheduler}. A task reads its blocks' contiguous RAM
+	 *    spans with one ReadMemoryByAddress (`0x23`) request per span.
+	 * 3. If the ECU rejects `0x23` as unsupported, fall back for the rest of
+	 *    the session to per-block reads (a timeout or busy reply only drops
+	 *    that cycle):
 	 *    a. Send `[0xE0, addr3, addr2, addr1, addr0]` to set the address.
 	 *    b. Read block data using `[0xE5]` (2-byte read + auto-increment) pairs,
 	 *       plus a final `[0xE1]` for any odd byte.
-	 *    c. Decode the raw bytes using `extractAllRaxParameters()`.
-	 *    d. Emit one `LiveDataFrame` per requested parameter in that block.
-	 * 3. Wait `RAX_POLL_INTERVAL_MS` before the next cycle.
-	 * 4. Report health metrics (samples/s, dropped frames, latency) periodically.
+	 * 4. Decode each block with its precompiled extraction plan (see
+	 *    `compileRaxExtractionPlan()`) into a preallocated value array and
+	 *    emit one `LiveDataFrame` per requested parameter in that block.
+	 * 5. The scheduler reports requested vs. achieved rates, per-request cost
+	 *    and dropped frames through `onHealth`.
 	 *
 	 * @param connection - Active device connection
 	 * @param pids - Synthetic RAX PID numbers to stream (from getSupportedPids)
 	 * @param onFrame - Called for each decoded parameter value
 	 * @param onHealth - Optional callback for health/performance metrics
+	 * @param options - Optional per-PID target rates
 	 * @returns LiveDataSession — call `.stop()` to halt streaming
 	 */
 	streamLiveData(
@@ -251,132 +402,176 @@ export class Mut3Protocol implements EcuProtocol {
 		pids: number[],
 		onFrame: (frame: LiveDataFrame) => void,
 		onHealth?: (health: LiveDataHealth) => void,
+		options?: LiveDataOptions,
 	): LiveDataSession {
-		let running = true;
 		const startTime = Date.now();
 
-		// Map each requested pid to its block index and param index
-		const pidMap = new Map<
+		// Assign each requested RAX pid an output slot, grouped by block
+		const slotPids: number[] = [];
+		const slotUnits: string[] = [];
+		const blockParamSlots = new Map<
 			number,
-			{ blockIdx: number; paramIdx: number; unit: string }
+			{ paramIdx: number; slot: number }[]
 		>();
+		const blockRates = new Map<number, number>();
 		for (const pid of pids) {
 			const decoded = decodeRaxPid(pid);
-			if (!decoded) continue;
+			if (!decoded || slotPids.includes(pid)) continue;
 
 			const param = RAX_BLOCKS[decoded.blockIdx]?.parameters[decoded.paramIdx];
 			if (!param) continue;
 
-			pidMap.set(pid, { ...decoded, unit: param.unit });
+			const slot = slotPids.length;
+			slotPids.push(pid);
+			slotUnits.push(param.unit);
+			const paramSlots = blockParamSlots.get(decoded.blockIdx) ?? [];
+			paramSlots.push({ paramIdx: decoded.paramIdx, slot });
+			blockParamSlots.set(decoded.blockIdx, paramSlots);
+
+			const rate = resolvePidRate(
+				pid,
+				RAX_CATEGORY_RATE_CLASS[param.category],
+				options?.rates,
+			);
+			blockRates.set(
+				decoded.blockIdx,
+				Math.max(rate, blockRates.get(decoded.blockIdx) ?? 0),
+			);
 		}
 
-		// Derive the unique set of block indices needed for requested pids
-		const requiredBlockIndices = new Set<number>(
-			[...pidMap.values()].map((v) => v.blockIdx),
-		);
-
-		// Health tracking
-		let frameCount = 0;
-		let droppedFrames = 0;
-		let lastHealthReportTime = startTime;
-		let totalLatencyMs = 0;
-		let latencySamples = 0;
-
-		const poll = async () => {
-			while (running) {
-				const cycleStart = Date.now();
+		// Compile one extraction plan per required block. Decoded values land in
+		// a single preallocated array indexed by slot, so per-frame decoding
+		// does not allocate.
+		const blockPlans = new Map<
+			number,
+			{ plan: BitFieldPlan; slots: Uint32Array }
+		>();
+		for (const [blockIdx, paramSlots] of blockParamSlots) {
+			const block = RAX_BLOCKS[blockIdx];
+			if (!block) continue;
+			blockPlans.set(blockIdx, {
+				plan: compileRaxExtractionPlan(block, paramSlots),
+				slots: Uint32Array.from(paramSlots, (p) => p.slot),
+			});
+		}
+		const values = new Float64Array(slotPids.length);
+
+		// Becomes false (for the rest of the session) once the ECU says it does
+		// not support ReadMemoryByAddress. Timeouts and other errors only drop
+		// the current cycle; the next one tries the bulk read again.
+		let bulkReadSupported = true;
+
+		// Decode one block (at `offset` within `data`) and emit the requested
+		// parameters it contains. Returns the number of frames emitted.
+		const emitBlock = (
+			blockIdx: number,
+			data: Uint8Array,
+			offset: number,
+		): number => {
+			const compiled = blockPlans.get(blockIdx);
+			if (!compiled || !scheduler.isRunning) return 0;
+			runBitFieldPlan(compiled.plan, data, values, offset);
+			const timestamp = Date.now() - startTime;
+
+			for (const slot of compiled.slots) {
+				onFrame({
+					timestamp,
+					pid: slotPids[slot] as number,
+					value: values[slot] as number,
+					unit: slotUnits[slot] as string,
+				});
+			}
+			return compiled.slots.length;
+		};
 
-				for (const blockIdx of requiredBlockIndices) {
-					if (!running) break;
+		// Read spans in bulk. Returns null if the ECU does not support it.
+		const pollBulk = async (
+			spans: RaxReadSpan[],
+		): Promise<number | null> => {
+			let emitted = 0;
+			for (const span of spans) {
+				const spanData = await readRaxMemory(
+					connection,
+					span.address,
+					span.length,
+				);
+				if (spanData === null) {
+					bulkReadSupported = false;
+					return null;
+				}
 
+				for (const blockIdx of span.blockIndices) {
 					const block = RAX_BLOCKS[blockIdx];
 					if (!block) continue;
-
-					try {
-						const blockStart = Date.now();
-						const rawData = await readRaxBlock(
-							connection,
-							block.requestId,
-							block.blockSize,
-						);
-						const latency = Date.now() - blockStart;
-						totalLatencyMs += latency;
-						latencySamples++;
-
-						// Decode all parameters in this block
-						const values = extractAllRaxParameters(rawData, block);
-						const timestamp = Date.now() - startTime;
-
-						// Emit only the parameters that were requested
-						for (const [pid, { blockIdx: bIdx, paramIdx, unit }] of pidMap) {
-							if (bIdx === blockIdx) {
-								const paramName =
-									RAX_BLOCKS[blockIdx]?.parameters[paramIdx]?.name;
-								if (paramName === undefined) continue;
-								const value = values[paramName];
-								if (value !== undefined) {
-									onFrame({ timestamp, pid, value, unit });
-									frameCount++;
-								}
-							}
-						}
-					} catch (error) {
-						droppedFrames++;
-						console.error(
-							`[MUT-III] Failed to read RAX block ${block.blockId} (0x${block.requestId.toString(16)}):`,
-							error,
-						);
-					}
-				}
-
-				// Report health metrics periodically (every second)
-				const now = Date.now();
-				const elapsed = now - lastHealthReportTime;
-				if (onHealth && elapsed >= 1000) {
-					const samplesPerSecond = frameCount / (elapsed / 1000);
-					const avgLatencyMs =
-						latencySamples > 0
-							? Math.round(totalLatencyMs / latencySamples)
-							: 0;
-					const status =
-						samplesPerSecond === 0
-							? "stalled"
-							: samplesPerSecond < 5
-								? "degraded"
-								: "healthy";
-
-					onHealth({
-						samplesPerSecond: Math.round(samplesPerSecond),
-						droppedFrames,
-						latencyMs: avgLatencyMs,
-						status,
-					});
-
-					// Reset counters for next window
-					frameCount = 0;
-					droppedFrames = 0;
-					totalLatencyMs = 0;
-					latencySamples = 0;
-					lastHealthReportTime = now;
+					emitted += emitBlock(
+						blockIdx,
+						spanData,
+						block.requestId - span.address,
+					);
 				}
+			}
+			return emitted;
+		};
 
-				// Wait before next polling cycle
-				const cycleElapsed = Date.now() - cycleStart;
-				const waitMs = Math.max(0, RAX_POLL_INTERVAL_MS - cycleElapsed);
-				if (waitMs > 0) {
-					await new Promise<void>((resolve) => setTimeout(resolve, waitMs));
+		// Read blocks one at a time with E0/E5/E1. A failing block does not
+		// stop the others; the first error is rethrown to count a dropped frame.
+		const pollPerBlock = async (blockIndices: number[]): Promise<number> => {
+			let emitted = 0;
+			let firstError: unknown = null;
+			for (const blockIdx of blockIndices) {
+				const block = RAX_BLOCKS[blockIdx];
+				if (!block) continue;
+				try {
+					const rawData = await readRaxBlock(
+						connection,
+						block.requestId,
+						block.blockSize,
+					);
+					emitted += emitBlock(blockIdx, rawData, 0);
+				} catch (error) {
+					firstError ??= new Error(
+						`Failed to read RAX block ${block.blockId} (0x${block.requestId.toString(16)}): ${error instanceof Error ? error.message : String(error)}`,
+					);
 				}
 			}
+			if (firstError !== null && emitted === 0) {
+				throw firstError;
+			}
+			return emitted;
 		};
 
-		// Start the polling loop (fire and forget; errors are caught within poll)
-		poll().catch((error) => {
-			console.error("[MUT-III] Streaming poll loop exited with error:", error);
+		// One scheduler task per rate group of blocks
+		const rateGroups = groupByRate(
+			blockPlans.keys(),
+			(blockIdx) => blockRates.get(blockIdx) ?? 0,
+		);
+		const tasks = [...rateGroups].map(([rateHz, blockIndices]) => {
+			const spans = planRaxReadSpans(blockIndices);
+			const blockIds = blockIndices.map((idx) => RAX_BLOCKS[idx]?.blockId);
+			return {
+				id: `RAX_${blockIds.join("")}`,
+				rateHz,
+				run: async () => {
+					if (bulkReadSupported) {
+						const emitted = await pollBulk(spans);
+						if (emitted !== null) return emitted;
+					}
+					return pollPerBlock(blockIndices);
+				},
+			};
+		});
+
+		const scheduler = new LiveDataScheduler(tasks, {
+			...(onHealth ? { onHealth } : {}),
+			onError: (task, error) => {
+				console.error(`[MUT-III] Failed to poll ${task.id}:`, error);
+			},
 		});
+		scheduler.start();
 
 		return {
 			stop: () => {
-				running = false;
+				scheduler.stop();
 			},
 		};
 	}
@@ -514,6 +709,8 @@ export {
 	buildRaxPidDescriptors,
 	decodeRaxPid,
 	readRaxBlock,
+	readRaxMemory,
+	planRaxReadSpans,
 	CMD_SET_ADDRESS,
 	CMD_READ_WORD_INC,
 	CMD_READ_BYTE,
@@ -14,6 +14,7 @@
  */
 
 import {
+	compileRaxExtractionPlan,
 	extractAllRaxParameters,
 	extractRaxParameter,
 	RAX_A_BLOCK,
@@ -43,6 +44,7 @@ export {
 	RAX_BLOCK_BY_REQUEST_ID,
 	extractRaxParameter,
 	extractAllRaxParameters,
+	compileRaxExtractionPlan,
 };
 
 function getRequiredParameter(block: RaxBlockDef, index: number) {
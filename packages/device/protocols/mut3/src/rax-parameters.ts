@@ -18,7 +18,11 @@
  * @see MUT3_LOGGING_CAPABILITIES.md
  */
 
-import { extractBits } from "@ecu-explorer/core";
+import {
+	type BitFieldPlan,
+	compileBitFieldPlan,
+	extractBits,
+} from "@ecu-explorer/core";
 
 /**
  * Categories for RAX parameters used for display organization
@@ -622,3 +626,40 @@ export function extractAllRaxParameters(
 	}
 	return result;
 }
+
+/**
+ * Compile an extraction plan for the given parameters of a RAX block.
+ *
+ * The plan reads the block's bytes as they sit in ECU RAM from
+ * `blockDef.requestId` onwards, whether they arrive from an E0/E5 block read
+ * or inside a ReadMemoryByAddress span. In the span case, pass the block's
+ * distance from the span start as the `byteOffset` of `runBitFieldPlan()`.
+ *
+ * @param blockDef - Block definition with parameter metadata
+ * @param paramSlots - Parameter indices within the block and their output slots
+ * @returns A compiled plan
+ * @throws Error if a parameter index does not exist in the block
+ *
+ * @example
+ * const plan = compileRaxExtractionPlan(RAX_C_BLOCK, [
+ *   { paramIdx: 0, slot: 0 },
+ * ]);
+ * const values = new Float64Array(1);
+ * runBitFieldPlan(plan, span, values, RAX_C_BLOCK.requestId - spanAddress);
+ */
+export function compileRaxExtractionPlan(
+	blockDef: RaxBlockDef,
+	paramSlots: readonly { paramIdx: number; slot: number }[],
+): BitFieldPlan {
+	return compileBitFieldPlan(
+		paramSlots.map(({ paramIdx, slot }) => {
+			const field = blockDef.parameters[paramIdx];
+			if (!field) {
+				throw new Error(
+					`RAX_${blockDef.blockId} parameter definition missing at index ${paramIdx}`,
+				);
+			}
+			return { field, slot };
+		}),
+	);
+}
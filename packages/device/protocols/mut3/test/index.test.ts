@@ -11,9 +11,11 @@ import {
 	CMD_SET_ADDRESS,
 	decodeRaxPid,
 	Mut3Protocol,
+	planRaxReadSpans,
 	RAX_PID_BASE,
 	RAX_PID_DESCRIPTORS,
 	readRaxBlock,
+	readRaxMemory,
 } from "../src/index.js";
 import { RAX_A_BLOCK, RAX_BLOCKS, RAX_C_BLOCK } from "../src/rax-decoder.js";
 import { computeSecurityKey } from "../src/security.js";
@@ -707,6 +709,8 @@ describe("Mut3Protocol.streamLiveData()", () => {
 	 * - E0 (set address): returns [0x00]
 	 * - E5 (read word + inc): returns the next 2 bytes from `blockBytes`
 	 * - E1 (read byte): returns next 1 byte from `blockBytes`
+	 * - 0x23 (ReadMemoryByAddress): serviceNotSupported, so the session
+	 *   reads per block
 	 *
 	 * The mock uses a round-robin per-block counter so multiple polling
 	 * cycles return consistent data.
@@ -751,6 +755,9 @@ describe("Mut3Protocol.streamLiveData()", () => {
 					offsets.set(currentAddress, offset + 1);
 					return new Uint8Array([b]);
 				}
+				if (data[0] === 0x23) {
+					return new Uint8Array([0x7f, 0x23, 0x11]);
+				}
 				return new Uint8Array([0x00]);
 			}),
 			startStream: vi.fn(),
@@ -1001,3 +1008,304 @@ describe("Mut3Protocol.streamLiveData()", () => {
 		}
 	});
 });
+
+describe("planRaxReadSpans()", () => {
+	it("merges adjacent and overlapping RAX blocks into one span", () => {
+		const spans = planRaxReadSpans(RAX_BLOCKS.map((_, idx) => idx));
+		expect(spans).toHaveLength(1);
+
+		const span = spans[0];
+		if (span === undefined) throw new Error("Expected one span");
+		const start = Math.min(...RAX_BLOCKS.map((b) => b.requestId));
+		const end = Math.max(...RAX_BLOCKS.map((b) => b.requestId + b.blockSize));
+		expect(span.address).toBe(start);
+		expect(span.length).toBe(end - start);
+		expect([...span.blockIndices].sort()).toEqual(
+			RAX_BLOCKS.map((_, idx) => idx),
+		);
+	});
+
+	it("splits blocks that would make a 255-byte span", () => {
+		// Two blocks 255 bytes apart end to end; each response must carry
+		// 0x63 plus the data within 255 bytes
+		const first = { ...RAX_A_BLOCK, requestId: 0x1000, blockSize: 4 };
+		const blocks = [first, { ...first, requestId: 0x1000 + 255 - 4 }];
+
+		const spans = planRaxReadSpans([0, 1], blocks);
+
+		expect(spans.map((span) => span.length)).toEqual([4, 4]);
+		expect(spans.map((span) => span.blockIndices)).toEqual([[0], [1]]);
+	});
+
+	it("merges blocks into a span of up to 254 bytes", () => {
+		const first = { ...RAX_A_BLOCK, requestId: 0x1000, blockSize: 4 };
+		const blocks = [first, { ...first, requestId: 0x1000 + 254 - 4 }];
+
+		const spans = planRaxReadSpans([0, 1], blocks);
+
+		expect(spans).toHaveLength(1);
+		expect(spans[0]?.length).toBe(254);
+	});
+
+	it("returns no spans when no blocks are requested", () => {
+		expect(planRaxReadSpans([])).toEqual([]);
+	});
+
+	it("ignores unknown block indices", () => {
+		expect(planRaxReadSpans([RAX_BLOCKS.length + 5])).toEqual([]);
+	});
+});
+
+describe("readRaxMemory()", () => {
+	it("sends ReadMemoryByAddress with a 4-byte address and 1-byte length", async () => {
+		const connection = makeMockConnection("openport2", async () =>
+			new Uint8Array([0x63, 0x11, 0x22, 0x33]),
+		);
+
+		const data = await readRaxMemory(connection, 0x238051a8, 3);
+
+		expect(connection.sendFrame).toHaveBeenCalledWith(
+			new Uint8Array([0x23, 0x14, 0x23, 0x80, 0x51, 0xa8, 0x03]),
+		);
+		expect(data).toEqual(new Uint8Array([0x11, 0x22, 0x33]));
+	});
+
+	it("returns null on a negative response", async () => {
+		const connection = makeMockConnection("openport2", async () =>
+			new Uint8Array([0x7f, 0x23, 0x11]),
+		);
+		expect(await readRaxMemory(connection, 0x238051a8, 4)).toBeNull();
+	});
+
+	it("throws on a negative response that may be transient", async () => {
+		const connection = makeMockConnection("openport2", async () =>
+			new Uint8Array([0x7f, 0x23, 0x21]),
+		);
+		await expect(readRaxMemory(connection, 0x238051a8, 4)).rejects.toThrow(
+			"NRC 0x21",
+		);
+	});
+
+	it("throws on a negative response to another service", async () => {
+		const connection = makeMockConnection("openport2", async () =>
+			new Uint8Array([0x7f, 0x27, 0x11]),
+		);
+		await expect(readRaxMemory(connection, 0x238051a8, 4)).rejects.toThrow(
+			"Malformed",
+		);
+	});
+
+	it("throws on a short response", async () => {
+		const connection = makeMockConnection("openport2", async () =>
+			new Uint8Array([0x63, 0x00]),
+		);
+		await expect(readRaxMemory(connection, 0x238051a8, 4)).rejects.toThrow(
+			"Malformed",
+		);
+	});
+});
+
+describe("Mut3Protocol.streamLiveData() — bulk RAX reads", () => {
+	/**
+	 * Build a connection mock that exposes a flat RAM image around the RAX
+	 * blocks. ReadMemoryByAddress (0x23) is answered from the image unless
+	 * `bulkSupported` is false, in which case it gets a negative response and
+	 * E0/E5/E1 are served from the same image.
+	 */
+	function makeRaxRamMock(
+		ram: Map<number, number>,
+		bulkSupported: boolean,
+	): DeviceConnection {
+		let pointer = 0;
+		return makeMockConnection(
+			"openport2",
+			vi.fn(async (data: Uint8Array): Promise<Uint8Array> => {
+				if (data[0] === 0x23) {
+					if (!bulkSupported) return new Uint8Array([0x7f, 0x23, 0x11]);
+					const address =
+						(((data[2] ?? 0) << 24) |
+							((data[3] ?? 0) << 16) |
+							((data[4] ?? 0) << 8) |
+							(data[5] ?? 0)) >>>
+						0;
+					const length = data[6] ?? 0;
+					const response = new Uint8Array(1 + length);
+					response[0] = 0x63;
+					for (let i = 0; i < length; i++) {
+						response[1 + i] = ram.get(address + i) ?? 0;
+					}
+					return response;
+				}
+				if (data[0] === CMD_SET_ADDRESS) {
+					pointer =
+						(((data[1] ?? 0) << 24) |
+							((data[2] ?? 0) << 16) |
+							((data[3] ?? 0) << 8) |
+							(data[4] ?? 0)) >>>
+						0;
+					return new Uint8Array([0x00]);
+				}
+				if (data[0] === CMD_READ_WORD_INC) {
+					const word = new Uint8Array([
+						ram.get(pointer) ?? 0,
+						ram.get(pointer + 1) ?? 0,
+					]);
+					pointer += 2;
+					return word;
+				}
+				if (data[0] === CMD_READ_BYTE) {
+					const byte = new Uint8Array([ram.get(pointer) ?? 0]);
+					pointer += 1;
+					return byte;
+				}
+				return new Uint8Array([0x00]);
+			}),
+		);
+	}
+
+	/** Fill RAX_A (fuel trims) with 0x90 → +1.6% and RAX_C with zeros. */
+	function makeRam(): Map<number, number> {
+		const ram = new Map<number, number>();
+		for (let i = 0; i < RAX_A_BLOCK.blockSize; i++) {
+			ram.set(RAX_A_BLOCK.requestId + i, 0x90);
+		}
+		for (let i = 0; i < RAX_C_BLOCK.blockSize; i++) {
+			ram.set(RAX_C_BLOCK.requestId + i, 0x00);
+		}
+		return ram;
+	}
+
+	const aBlockIdx = RAX_BLOCKS.findIndex((b) => b.blockId === "A");
+	const cBlockIdx = RAX_BLOCKS.findIndex((b) => b.blockId === "C");
+	const pidA = RAX_PID_BASE + aBlockIdx * 100 + 0; // STFT Bank 1
+	const pidC = RAX_PID_BASE + cBlockIdx * 100 + 0; // RPM
+
+	function sentCommands(connection: DeviceConnection): number[] {
+		return (connection.sendFrame as ReturnType<typeof vi.fn>).mock.calls.map(
+			(call: Uint8Array[]) => call[0]?.[0] ?? -1,
+		);
+	}
+
+	it("reads all requested blocks with one ReadMemoryByAddress per cycle", async () => {
+		const protocol = new Mut3Protocol();
+		const connection = makeRaxRamMock(makeRam(), true);
+
+		// Same target rate for both blocks so they share one span read
+		const rates = new Map([
+			[pidA, 20],
+			[pidC, 20],
+		]);
+		const frames: LiveDataFrame[] = [];
+		const session = protocol.streamLiveData?.(
+			connection,
+			[pidA, pidC],
+			(f) => frames.push(f),
+			undefined,
+			{ rates },
+		);
+
+		await new Promise<void>((resolve) => setTimeout(resolve, 80));
+		session.stop();
+
+		const commands = sentCommands(connection);
+		expect(commands.length).toBeGreaterThan(0);
+		expect(commands.every((cmd) => cmd === 0x23)).toBe(true);
+
+		// Every bulk read yields one frame for each requested PID
+		const trimFrames = frames.filter((f) => f.pid === pidA);
+		const rpmFrames = frames.filter((f) => f.pid === pidC);
+		expect(trimFrames.length).toBe(commands.length);
+		expect(rpmFrames.length).toBe(commands.length);
+		expect(trimFrames[0]?.value).toBeCloseTo(1.6);
+		expect(rpmFrames[0]?.value).toBe(0);
+	});
+
+	it("falls back to E0/E5 reads when ReadMemoryByAddress is rejected", async () => {
+		const protocol = new Mut3Protocol();
+		const connection = makeRaxRamMock(makeRam(), false);
+
+		const frames: LiveDataFrame[] = [];
+		const session = protocol.streamLiveData?.(
+			connection,
+			[pidA, pidC],
+			(f) => frames.push(f),
+		);
+
+		await new Promise<void>((resolve) => setTimeout(resolve, 80));
+		session.stop();
+
+		const commands = sentCommands(connection);
+		// Bulk read is probed exactly once, then never retried
+		expect(commands.filter((cmd) => cmd === 0x23)).toHaveLength(1);
+		expect(commands[0]).toBe(0x23);
+		expect(commands).toContain(CMD_SET_ADDRESS);
+
+		const trimFrames = frames.filter((f) => f.pid === pidA);
+		expect(trimFrames.length).toBeGreaterThan(0);
+		expect(trimFrames[0]?.value).toBeCloseTo(1.6);
+	});
+
+	it("keeps bulk reads after a transient failure", async () => {
+		const protocol = new Mut3Protocol();
+		const ramConnection = makeRaxRamMock(makeRam(), true);
+		let failures = 1;
+		const connection = makeMockConnection(
+			"openport2",
+			vi.fn(async (data: Uint8Array): Promise<Uint8Array> => {
+				if (data[0] === 0x23 && failures > 0) {
+					failures--;
+					throw new Error("Timeout waiting for response");
+				}
+				return ramConnection.sendFrame(data);
+			}),
+		);
+
+		const frames: LiveDataFrame[] = [];
+		const session = protocol.streamLiveData?.(
+			connection,
+			[pidA],
+			(f) => frames.push(f),
+			undefined,
+			{ rates: new Map([[pidA, 20]]) },
+		);
+
+		await new Promise<void>((resolve) => setTimeout(resolve, 150));
+		session.stop();
+
+		const commands = sentCommands(connection);
+		expect(commands.filter((cmd) => cmd === 0x23).length).toBeGreaterThan(1);
+		expect(commands).not.toContain(CMD_SET_ADDRESS);
+		expect(frames.filter((f) => f.pid === pidA).length).toBeGreaterThan(0);
+	});
+});
+
+describe("Mut3Protocol.streamLiveData() — rate scheduling", () => {
+	it("polls fast blocks more often than slow blocks", async () => {
+		const protocol = new Mut3Protocol();
+		const cBlockIdx = RAX_BLOCKS.findIndex((b) => b.blockId === "C");
+		const gBlockIdx = RAX_BLOCKS.findIndex((b) => b.blockId === "G");
+		const rpmPid = RAX_PID_BASE + cBlockIdx * 100 + 0; // engine — fast
+		const coolantPid = RAX_PID_BASE + gBlockIdx * 100 + 2; // vehicle — slow
+
+		const frames: LiveDataFrame[] = [];
+		const connection = makeMockConnection("openport2", async (data) =>
+			data[0] === 0x23
+				? new Uint8Array(1 + (data[6] ?? 0)).fill(0x63, 0, 1)
+				: new Uint8Array([0x00]),
+		);
+		const session = protocol.streamLiveData?.(
+			connection,
+			[rpmPid, coolantPid],
+			(f) => frames.push(f),
+		);
+
+		await new Promise<void>((resolve) => setTimeout(resolve, 300));
+		session.stop();
+
+		const rpmFrames = frames.filter((f) => f.pid === rpmPid);
+		const coolantFrames = frames.filter((f) => f.pid === coolantPid);
+		// 20 Hz vs 1 Hz over 300 ms
+		expect(coolantFrames).toHaveLength(1);
+		expect(rpmFrames.length).toBeGreaterThanOrEqual(4);
+	});
+});
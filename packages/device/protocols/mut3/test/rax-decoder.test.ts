@@ -9,8 +9,10 @@
  * 5. Parameter registry integrity (all blocks present, correct RequestIDs)
  */
 
+import { runBitFieldPlan } from "@ecu-explorer/core";
 import { describe, expect, it } from "vitest";
 import {
+	compileRaxExtractionPlan,
 	decodeRaxA,
 	decodeRaxB,
 	decodeRaxBlock,
@@ -630,6 +632,44 @@ describe("extractAllRaxParameters", () => {
 	});
 });
 
+describe("compileRaxExtractionPlan", () => {
+	it("produces the same values as extractAllRaxParameters for every block", () => {
+		const buffer = new Uint8Array([
+			0x25, 0x18, 0x3f, 0x64, 0xa5, 0xc3, 0x7e, 0x81,
+		]);
+		for (const block of RAX_BLOCKS) {
+			const plan = compileRaxExtractionPlan(
+				block,
+				block.parameters.map((_, paramIdx) => ({ paramIdx, slot: paramIdx })),
+			);
+			const values = new Float64Array(block.parameters.length);
+			runBitFieldPlan(plan, buffer, values);
+
+			const expected = extractAllRaxParameters(buffer, block);
+			block.parameters.forEach((param, idx) => {
+				expect(values[idx]).toBe(expected[param.name]);
+			});
+		}
+	});
+
+	it("writes only the requested parameters to their slots", () => {
+		const plan = compileRaxExtractionPlan(RAX_A_BLOCK, [
+			{ paramIdx: 1, slot: 0 },
+		]);
+		const values = new Float64Array([Number.NaN, Number.NaN]);
+		runBitFieldPlan(plan, new Uint8Array([0x80, 0x90, 0x70, 0x88]), values);
+
+		expect(values[0]).toBeCloseTo(1.6, 5); // LTFT Bank 1
+		expect(values[1]).toBeNaN();
+	});
+
+	it("throws for a parameter index outside the block", () => {
+		expect(() =>
+			compileRaxExtractionPlan(RAX_A_BLOCK, [{ paramIdx: 99, slot: 0 }]),
+		).toThrow("RAX_A parameter definition missing at index 99");
+	});
+});
+
 // ---------------------------------------------------------------------------
 // Boundary / edge case tests
 // ---------------------------------------------------------------------------
@@ -1,9 +1,15 @@
-import type {
-	DeviceConnection,
-	EcuProtocol,
-	LiveDataFrame,
-	LiveDataSession,
-	PidDescriptor,
+import {
+	type DeviceConnection,
+	type EcuProtocol,
+	groupByRate,
+	type LiveDataFrame,
+	type LiveDataHealth,
+	type LiveDataOptions,
+	type LiveDataRateClass,
+	LiveDataScheduler,
+	type LiveDataSession,
+	type PidDescriptor,
+	resolvePidRate,
 } from "@ecu-explorer/device";
 
 /**
@@ -69,6 +75,179 @@ export const STANDARD_PIDS: PidDescriptor[] = [
 	},
 ];
 
+/**
+ * Maximum number of PIDs packed into a single Mode 01 request.
+ * Ref: ISO 15765-4 §6.2.2 — a request message may contain up to six PIDs.
+ */
+export const MAX_PIDS_PER_REQUEST = 6;
+
+/**
+ * Decoder for a single Mode 01 PID.
+ * `dataLength` is required to walk multi-PID responses, which carry no
+ * per-PID length field.
+ */
+export interface Obd2PidDecoder {
+	readonly pid: number;
+	readonly unit: string;
+	/** Number of data bytes following the PID echo in a Mode 01 response */
+	readonly dataLength: number;
+	/** Convert raw data bytes A and B to physical units */
+	readonly decode: (a: number, b: number) => number;
+	/** Default poll rate class for this PID */
+	readonly rateClass: LiveDataRateClass;
+}
+
+/** Rate class for PIDs without a decoder */
+const DEFAULT_RATE_CLASS: LiveDataRateClass = "normal";
+
+const STANDARD_PID_FORMULAS: ReadonlyArray<Omit<Obd2PidDecoder, "unit">> = [
+	// RPM: ((A*256)+B)/4
+	{
+		pid: 0x0c,
+		dataLength: 2,
+		decode: (a, b) => (a * 256 + b) / 4,
+		rateClass: "fast",
+	},
+	// Speed: A
+	{ pid: 0x0d, dataLength: 1, decode: (a) => a, rateClass: "normal" },
+	// Load: A*100/255
+	{
+		pid: 0x04,
+		dataLength: 1,
+		decode: (a) => (a * 100) / 255,
+		rateClass: "normal",
+	},
+	// Coolant temp: A-40
+	{ pid: 0x05, dataLength: 1, decode: (a) => a - 40, rateClass: "slow" },
+	// MAP: A
+	{ pid: 0x0b, dataLength: 1, decode: (a) => a, rateClass: "fast" },
+	// IAT: A-40
+	{ pid: 0x0f, dataLength: 1, decode: (a) => a - 40, rateClass: "slow" },
+	// MAF: ((A*256)+B)/100
+	{
+		pid: 0x10,
+		dataLength: 2,
+		decode: (a, b) => (a * 256 + b) / 100,
+		rateClass: "fast",
+	},
+	// Throttle: A*100/255
+	{
+		pid: 0x11,
+		dataLength: 1,
+		decode: (a) => (a * 100) / 255,
+		rateClass: "fast",
+	},
+];
+
+/**
+ * Build the PID → decoder lookup table, indexed directly by PID number.
+ * Built once at module load so the per-frame path never searches
+ * `STANDARD_PIDS`.
+ */
+function buildPidDecoderTable(): ReadonlyArray<Obd2PidDecoder | undefined> {
+	const table = new Array<Obd2PidDecoder | undefined>(0x100).fill(undefined);
+	for (const formula of STANDARD_PID_FORMULAS) {
+		const descriptor = STANDARD_PIDS.find((p) => p.pid === formula.pid);
+		table[formula.pid] = { ...formula, unit: descriptor?.unit ?? "" };
+	}
+	return table;
+}
+
+/** Precomputed PID → decoder table for Mode 01 responses. */
+export const PID_DECODERS: ReadonlyArray<Obd2PidDecoder | undefined> =
+	buildPidDecoderTable();
+
+/**
+ * Split requested PIDs into Mode 01 request batches.
+ *
+ * Only PIDs with a known decoder can share a request: multi-PID responses
+ * are walked using each PID's data length, so an unknown PID would make the
+ * rest of the response unparseable. Unknown PIDs are always polled alone.
+ *
+ * @param pids - PIDs to poll
+ * @param maxPerRequest - Upper bound on PIDs per request (1–6)
+ * @returns Batches of PIDs, each sent as one `01 <pid> [<pid> ...]` request
+ */
+export function buildPidBatches(
+	pids: readonly number[],
+	maxPerRequest: number = MAX_PIDS_PER_REQUEST,
+): number[][] {
+	const batchSize = Math.max(1, Math.min(maxPerRequest, MAX_PIDS_PER_REQUEST));
+	const batches: number[][] = [];
+	let current: number[] = [];
+	for (const pid of new Set(pids)) {
+		if (PID_DECODERS[pid] === undefined) {
+			batches.push([pid]);
+			continue;
+		}
+		current.push(pid);
+		if (current.length === batchSize) {
+			batches.push(current);
+			current = [];
+		}
+	}
+	if (current.length > 0) {
+		batches.push(current);
+	}
+	return batches;
+}
+
+/**
+ * Walk a (possibly multi-PID) Mode 01 positive response and invoke `onValue`
+ * for every decoded PID.
+ *
+ * Response layout: `41 <pidA> <dataA...> <pidB> <dataB...> ...`.
+ * ECUs omit PIDs they do not support, so the response may contain fewer
+ * PIDs than were requested.
+ *
+ * @param response - Raw response bytes starting with 0x41
+ * @param requested - PIDs included in the request
+ * @param onValue - Called with each decoded PID, value and unit
+ * @returns Number of PIDs decoded from the response
+ */
+export function parseMultiPidResponse(
+	response: Uint8Array,
+	requested: readonly number[],
+	onValue: (pid: number, value: number, unit: string) => void,
+): number {
+	if (response.length < 3 || response[0] !== 0x41) {
+		return 0;
+	}
+
+	// A single unknown PID carries no length information; take the bytes that follow.
+	if (requested.length === 1) {
+		const pid = requested[0] ?? -1;
+		if (response[1] !== pid) {
+			return 0;
+		}
+		const decoder = PID_DECODERS[pid];
+		const a = response[2] ?? 0;
+		const b = response[3] ?? 0;
+		onValue(pid, decoder ? decoder.decode(a, b) : a, decoder?.unit ?? "");
+		return 1;
+	}
+
+	let decoded = 0;
+	let offset = 1;
+	while (offset < response.length) {
+		const pid = response[offset] ?? -1;
+		const decoder = PID_DECODERS[pid];
+		if (decoder === undefined || !requested.includes(pid)) {
+			break;
+		}
+		const dataStart = offset + 1;
+		if (dataStart + decoder.dataLength > response.length) {
+			break;
+		}
+		const a = response[dataStart] ?? 0;
+		const b = decoder.dataLength > 1 ? (response[dataStart + 1] ?? 0) : 0;
+		onValue(pid, decoder.decode(a, b), decoder.unit);
+		decoded++;
+		offset = dataStart + decoder.dataLength;
+	}
+	return decoded;
+}
+
 export class Obd2Protocol implements EcuProtocol {
 	readonly name = "OBD-II (Generic)";
 
@@ -94,77 +273,104 @@ export class Obd2Protocol implements EcuProtocol {
 		return STANDARD_PIDS;
 	}
 
+	/**
+	 * Stream live data for the requested Mode 01 PIDs.
+	 *
+	 * PIDs are grouped by target rate (their decoder's rate class, or
+	 * `options.rates`) and each group is packed into multi-PID requests (up to
+	 * six per request). Requests are run by a shared {@link LiveDataScheduler},
+	 * so coolant temperature is not polled as often as RPM. If the ECU rejects
+	 * a multi-PID request or sends a reply that cannot be parsed, the session
+	 * falls back to one PID per request. PIDs left out of an otherwise valid
+	 * reply are unsupported by the ECU and are no longer polled.
+	 */
 	streamLiveData(
 		connection: DeviceConnection,
 		pids: number[],
 		onFrame: (frame: LiveDataFrame) => void,
+		onHealth?: (health: LiveDataHealth) => void,
+		options?: LiveDataOptions,
 	): LiveDataSession {
-		let running = true;
 		const startTime = Date.now();
+		let multiPid = true;
+		const unsupported = new Set<number>();
+
+		const rateOf = (pid: number) =>
+			resolvePidRate(
+				pid,
+				PID_DECODERS[pid]?.rateClass ?? DEFAULT_RATE_CLASS,
+				options?.rates,
+			);
+
+		const pollBatch = async (batch: number[]): Promise<number> => {
+			const request = new Uint8Array(1 + batch.length);
+			request[0] = 0x01;
+			request.set(batch, 1);
 
-		const poll = async () => {
-			while (running) {
-				for (const pid of pids) {
-					if (!running) break;
-					try {
-						const response = await connection.sendFrame(
-							new Uint8Array([0x01, pid]),
-						);
-						if (
-							response.length >= 3 &&
-							response[0] === 0x41 &&
-							response[1] === pid
-						) {
-							const data = response.slice(2);
-							const value = this.decodePid(pid, data);
-							const descriptor = STANDARD_PIDS.find((p) => p.pid === pid);
-
-							onFrame({
-								timestamp: Date.now() - startTime,
-								pid,
-								value,
-								unit: descriptor?.unit ?? "",
-							});
-						}
-					} catch (error) {
-						console.error(`Failed to poll PID 0x${pid.toString(16)}:`, error);
-					}
-					// Small delay between PIDs to avoid flooding
-					await new Promise((resolve) => setTimeout(resolve, 10));
+			const response = await connection.sendFrame(request);
+			if (!scheduler.isRunning) return 0;
+
+			const timestamp = Date.now() - startTime;
+			const received = new Set<number>();
+			// Bytes accounted for by the decoded PIDs, after the 0x41 SID
+			let parsedLength = 1;
+			const decoded = parseMultiPidResponse(
+				response,
+				batch,
+				(pid, value, unit) => {
+					received.add(pid);
+					parsedLength += 1 + (PID_DECODERS[pid]?.dataLength ?? 0);
+					onFrame({ timestamp, pid, value, unit });
+				},
+			);
+			if (batch.length === 1) return decoded;
+
+			if (response[0] === 0x41 && parsedLength === response.length) {
+				// A well-formed reply leaves out the PIDs the ECU does not support
+				const omitted = batch.filter((pid) => !received.has(pid));
+				if (omitted.length > 0) {
+					for (const pid of omitted) unsupported.add(pid);
+					scheduler.setTasks(
+						buildTasks(multiPid ? MAX_PIDS_PER_REQUEST : 1),
+					);
 				}
+			} else if (multiPid) {
+				// Negative response or malformed reply; poll one PID at a time
+				multiPid = false;
+				scheduler.setTasks(buildTasks(1));
 			}
+			return decoded;
 		};
 
-		poll();
+		const buildTasks = (maxPerRequest: number) =>
+			[
+				...groupByRate(
+					new Set(pids.filter((pid) => !unsupported.has(pid))),
+					rateOf,
+				),
+			].flatMap(([rateHz, group]) =>
+				buildPidBatches(group, maxPerRequest).map((batch) => ({
+					id: batch.map((pid) => `0x${pid.toString(16)}`).join(","),
+					rateHz,
+					run: () => pollBatch(batch),
+				})),
+			);
+
+		const scheduler = new LiveDataScheduler(
+			buildTasks(MAX_PIDS_PER_REQUEST),
+			{
+				...(onHealth ? { onHealth } : {}),
+				onError: (task, error) => {
+					console.error(`Failed to poll PID(s) ${task.id}:`, error);
+				},
+			},
+		);
+		scheduler.start();
 
 		return {
 			stop: () => {
-				running = false;
+				scheduler.stop();
 			},
 		};
 	}
-
-	private decodePid(pid: number, data: Uint8Array): number {
-		const a = data[0] ?? 0;
-		const b = data[1] ?? 0;
-
-		switch (pid) {
-			case 0x0c: // RPM: ((A*256)+B)/4
-				return (a * 256 + b) / 4;
-			case 0x0d: // Speed: A
-				return a;
-			case 0x04: // Load: A*100/255
-			case 0x11: // Throttle: A*100/255
-				return (a * 100) / 255;
-			case 0x05: // Temp: A-40
-			case 0x0f: // IAT: A-40
-				return a - 40;
-			case 0x0b: // MAP: A
-				return a;
-			case 0x10: // MAF: ((A*256)+B)/100
-				return (a * 256 + b) / 100;
-			default:
-				return a;
-		}
-	}
 }
@@ -1,6 +1,13 @@
 import type { DeviceConnection } from "@ecu-explorer/device";
 import { beforeEach, describe, expect, it, vi } from "vitest";
-import { Obd2Protocol, STANDARD_PIDS } from "../src/index.js";
+import {
+	buildPidBatches,
+	MAX_PIDS_PER_REQUEST,
+	Obd2Protocol,
+	PID_DECODERS,
+	parseMultiPidResponse,
+	STANDARD_PIDS,
+} from "../src/index.js";
 
 function createMockConnection(
 	responseMap: Map<string, Uint8Array>,
@@ -22,6 +29,42 @@ function createMockConnection(
 	};
 }
 
+/**
+ * Mock ECU that answers single- and multi-PID Mode 01 requests from a table of
+ * raw PID data bytes, mirroring the mock J2534 DLL's Mode 01 responder.
+ * When `multiPid` is false, requests with more than one PID are rejected with
+ * a negative response.
+ */
+function createMockEcu(
+	pidData: Map<number, number[]>,
+	multiPid = true,
+): DeviceConnection {
+	return {
+		deviceInfo: {
+			id: "test-device",
+			name: "Test Device",
+			transportName: "test",
+			connected: true,
+		},
+		sendFrame: vi.fn(async (data: Uint8Array) => {
+			if (data[0] !== 0x01 || (!multiPid && data.length > 2)) {
+				return new Uint8Array([0x7f, data[0] ?? 0, 0x12]);
+			}
+			const response = [0x41];
+			for (const pid of data.subarray(1)) {
+				const bytes = pidData.get(pid);
+				if (bytes !== undefined) {
+					response.push(pid, ...bytes);
+				}
+			}
+			return new Uint8Array(response);
+		}),
+		startStream: vi.fn(),
+		stopStream: vi.fn(),
+		close: vi.fn(async () => {}),
+	};
+}
+
 describe("Obd2Protocol", () => {
 	let protocol: Obd2Protocol;
 
@@ -229,4 +272,250 @@ describe("Obd2Protocol", () => {
 			expect(frame?.value).toBe(5.0);
 		});
 	});
+
+	describe("multi-PID batching", () => {
+		it("packs known PIDs into requests of at most six PIDs", () => {
+			const pids = STANDARD_PIDS.map((p) => p.pid);
+			const batches = buildPidBatches(pids);
+
+			expect(batches).toHaveLength(2);
+			expect(batches[0]).toHaveLength(MAX_PIDS_PER_REQUEST);
+			expect(batches.flat()).toEqual(pids);
+		});
+
+		it("polls unknown PIDs on their own", () => {
+			const batches = buildPidBatches([0x0c, 0x42, 0x0d]);
+			expect(batches).toEqual([[0x42], [0x0c, 0x0d]]);
+		});
+
+		it("has a decoder for every standard PID", () => {
+			for (const descriptor of STANDARD_PIDS) {
+				expect(PID_DECODERS[descriptor.pid]?.unit).toBe(descriptor.unit);
+			}
+		});
+
+		it("decodes a multiplexed response", () => {
+			// RPM = 1000, speed = 80, coolant = 60°C
+			const response = new Uint8Array([
+				0x41, 0x0c, 15, 160, 0x0d, 80, 0x05, 100,
+			]);
+			const values = new Map<number, number>();
+			const decoded = parseMultiPidResponse(
+				response,
+				[0x0c, 0x0d, 0x05],
+				(pid, value) => values.set(pid, value),
+			);
+
+			expect(decoded).toBe(3);
+			expect(values.get(0x0c)).toBe(1000);
+			expect(values.get(0x0d)).toBe(80);
+			expect(values.get(0x05)).toBe(60);
+		});
+
+		it("stops at a truncated PID record", () => {
+			const response = new Uint8Array([0x41, 0x0d, 80, 0x0c, 15]);
+			const onValue = vi.fn();
+			const decoded = parseMultiPidResponse(response, [0x0d, 0x0c], onValue);
+
+			expect(decoded).toBe(1);
+			expect(onValue).toHaveBeenCalledWith(0x0d, 80, "km/h");
+		});
+
+		it("polls eight PIDs with two requests per cycle", async () => {
+			const pidData = new Map<number, number[]>([
+				[0x0c, [15, 160]],
+				[0x0d, [80]],
+				[0x04, [128]],
+				[0x05, [100]],
+				[0x0b, [101]],
+				[0x0f, [70]],
+				[0x10, [1, 244]],
+				[0x11, [51]],
+			]);
+			const connection = createMockEcu(pidData);
+			const onFrame = vi.fn();
+			const pids = [...pidData.keys()];
+
+			// Same target rate for every PID so they share requests
+			const rates = new Map(pids.map((pid) => [pid, 20]));
+
+			const session = protocol.streamLiveData(
+				connection,
+				pids,
+				onFrame,
+				undefined,
+				{ rates },
+			);
+			await new Promise((resolve) => setTimeout(resolve, 100));
+			session.stop();
+
+			const requests = vi.mocked(connection.sendFrame).mock.calls;
+			expect(requests[0]?.[0]).toEqual(
+				new Uint8Array([0x01, 0x0c, 0x0d, 0x04, 0x05, 0x0b, 0x0f]),
+			);
+			expect(requests[1]?.[0]).toEqual(new Uint8Array([0x01, 0x10, 0x11]));
+
+			const receivedPids = new Set(
+				onFrame.mock.calls.map((call) => call[0]?.pid),
+			);
+			expect(receivedPids).toEqual(new Set(pids));
+			const maf = onFrame.mock.calls.find((call) => call[0]?.pid === 0x10);
+			expect(maf?.[0]?.value).toBe(5.0);
+		});
+
+		it("falls back to single-PID requests when multi-PID is rejected", async () => {
+			const pidData = new Map<number, number[]>([
+				[0x0c, [15, 160]],
+				[0x0d, [80]],
+			]);
+			const connection = createMockEcu(pidData, false);
+			const onFrame = vi.fn();
+
+			const rates = new Map([
+				[0x0c, 20],
+				[0x0d, 20],
+			]);
+
+			const session = protocol.streamLiveData(
+				connection,
+				[0x0c, 0x0d],
+				onFrame,
+				undefined,
+				{ rates },
+			);
+			await new Promise((resolve) => setTimeout(resolve, 100));
+			session.stop();
+
+			expect(vi.mocked(connection.sendFrame).mock.calls[0]?.[0]).toEqual(
+				new Uint8Array([0x01, 0x0c, 0x0d]),
+			);
+			const lastRequest = vi.mocked(connection.sendFrame).mock.calls.at(-1);
+			expect(lastRequest?.[0]).toHaveLength(2);
+			const receivedPids = new Set(
+				onFrame.mock.calls.map((call) => call[0]?.pid),
+			);
+			expect(receivedPids).toEqual(new Set([0x0c, 0x0d]));
+		});
+
+		it("keeps batching when the ECU omits unsupported PIDs", async () => {
+			const pidData = new Map<number, number[]>([
+				[0x0c, [15, 160]],
+				[0x11, [128]],
+			]);
+			const connection = createMockEcu(pidData);
+			const onFrame = vi.fn();
+
+			const rates = new Map([
+				[0x0c, 20],
+				[0x0d, 20],
+				[0x11, 20],
+			]);
+
+			const session = protocol.streamLiveData(
+				connection,
+				[0x0c, 0x0d, 0x11],
+				onFrame,
+				undefined,
+				{ rates },
+			);
+			await new Promise((resolve) => setTimeout(resolve, 150));
+			session.stop();
+
+			const requests = vi
+				.mocked(connection.sendFrame)
+				.mock.calls.map((call) => call[0]);
+			expect(requests[0]).toEqual(new Uint8Array([0x01, 0x0c, 0x0d, 0x11]));
+			expect(requests.length).toBeGreaterThan(1);
+			for (const request of requests.slice(1)) {
+				expect(request).toEqual(new Uint8Array([0x01, 0x0c, 0x11]));
+			}
+			const receivedPids = new Set(
+				onFrame.mock.calls.map((call) => call[0]?.pid),
+			);
+			expect(receivedPids).toEqual(new Set([0x0c, 0x11]));
+		});
+
+		it("falls back to single-PID requests on a malformed reply", async () => {
+			const connection = createMockConnection(
+				new Map([
+					// Truncated RPM record
+					["1,12,13", new Uint8Array([0x41, 0x0c, 0x0f])],
+					["1,12", new Uint8Array([0x41, 0x0c, 0x0f, 0xa0])],
+					["1,13", new Uint8Array([0x41, 0x0d, 0x50])],
+				]),
+			);
+			const onFrame = vi.fn();
+
+			const rates = new Map([
+				[0x0c, 20],
+				[0x0d, 20],
+			]);
+
+			const session = protocol.streamLiveData(
+				connection,
+				[0x0c, 0x0d],
+				onFrame,
+				undefined,
+				{ rates },
+			);
+			await new Promise((resolve) => setTimeout(resolve, 100));
+			session.stop();
+
+			const lastRequest = vi.mocked(connection.sendFrame).mock.calls.at(-1);
+			expect(lastRequest?.[0]).toHaveLength(2);
+			const receivedPids = new Set(
+				onFrame.mock.calls.map((call) => call[0]?.pid),
+			);
+			expect(receivedPids).toEqual(new Set([0x0c, 0x0d]));
+		});
+	});
+
+	describe("rate scheduling", () => {
+		it("polls fast PIDs more often than slow PIDs", async () => {
+			const pidData = new Map<number, number[]>([
+				[0x0c, [15, 160]], // RPM — fast
+				[0x05, [100]], // Coolant — slow
+			]);
+			const connection = createMockEcu(pidData);
+			const onFrame = vi.fn();
+
+			const session = protocol.streamLiveData(
+				connection,
+				[0x0c, 0x05],
+				onFrame,
+			);
+			await new Promise((resolve) => setTimeout(resolve, 300));
+			session.stop();
+
+			const requests = vi
+				.mocked(connection.sendFrame)
+				.mock.calls.map((call) => Array.from(call[0] ?? []));
+			const rpmRequests = requests.filter((r) => r[1] === 0x0c);
+			const coolantRequests = requests.filter((r) => r[1] === 0x05);
+
+			// 20 Hz vs 1 Hz over 300 ms
+			expect(coolantRequests).toHaveLength(1);
+			expect(rpmRequests.length).toBeGreaterThanOrEqual(4);
+			expect(requests.every((r) => r.length === 2)).toBe(true);
+		});
+
+		it("honours per-PID rate overrides", async () => {
+			const pidData = new Map<number, number[]>([[0x05, [100]]]);
+			const connection = createMockEcu(pidData);
+
+			const session = protocol.streamLiveData(
+				connection,
+				[0x05],
+				vi.fn(),
+				undefined,
+				{ rates: new Map([[0x05, 50]]) },
+			);
+			await new Promise((resolve) => setTimeout(resolve, 200));
+			session.stop();
+
+			expect(
+				vi.mocked(connection.sendFrame).mock.calls.length,
+			).toBeGreaterThanOrEqual(5);
+		});
+	});
 });
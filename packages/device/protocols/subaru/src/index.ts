@@ -1,17 +1,46 @@
+import { type BitFieldPlan, runBitFieldPlan } from "@ecu-explorer/core";
 import type {
 	DeviceConnection,
 	EcuEvent,
 	EcuProtocol,
+	LiveDataFrame,
+	LiveDataHealth,
+	LiveDataOptions,
+	LiveDataRateClass,
+	LiveDataSession,
 	PidDescriptor,
 	RomProgress,
 	WriteOptions,
 } from "@ecu-explorer/device";
-import { computeChangedSectors } from "@ecu-explorer/device";
+import {
+	FlashWritePipeline,
+	LiveDataScheduler,
+	resolvePidRate,
+} from "@ecu-explorer/device";
 
 import { computeSubaruKey } from "./security.js";
-import { getAllSstParameterPids } from "./sst-parameters.js";
+import {
+	buildSsmReadAddressesRequest,
+	parseSsmReadAddressesResponse,
+	SSM_MAX_ADDRESSES_PER_READ,
+	SSM_TCU_ID,
+} from "./ssm.js";
+import {
+	compileSstExtractionPlan,
+	getAllSstParameterPids,
+	SST_BLOCKS,
+	type SstBlockDef,
+	type SstParameterCategory,
+} from "./sst-parameters.js";
 
-// Re-export SST components for convenient access
+// Re-export SSM and SST components for convenient access
+export {
+	buildSsmReadAddressesRequest,
+	parseSsmReadAddressesResponse,
+	SSM_ECU_ID,
+	SSM_MAX_ADDRESSES_PER_READ,
+	SSM_TCU_ID,
+} from "./ssm.js";
 export {
 	decodeSstBlock,
 	decodeSstBlockSet,
@@ -77,6 +106,52 @@ const BLOCK_SIZE = 0x80; // 128 bytes per KWP2000 ReadMemoryByAddress request
 // Ref: HANDSHAKE_ANALYSIS.md §2.8 — SH7058 memory model
 const SECTOR_SIZE = 0x10000;
 
+// SSM live data: a full A8 request/E8 response can take ~300 ms at 4800 baud
+const SSM_RESPONSE_TIMEOUT_MS = 1000;
+
+// Default poll rate class per SST category. All requested addresses share
+// one A8 request, so the session polls at the fastest requested rate.
+const SST_CATEGORY_RATE_CLASS: Readonly<
+	Record<SstParameterCategory, LiveDataRateClass>
+> = {
+	transmission_core: "fast",
+	transmission_slip: "fast",
+	wheel_speed: "fast",
+	transmission_solenoid: "fast",
+	transmission_pressure: "normal",
+	transmission_state: "normal",
+	vvt_transmission: "normal",
+	transmission_calculated: "normal",
+};
+
+/**
+ * Options for {@link SubaruProtocol}.
+ */
+export interface SubaruProtocolOptions {
+	/**
+	 * SSM RAM address of each SST block, keyed by block ID (e.g. "TRANS").
+	 * Takes precedence over `SstBlockDef.blockAddress`. Addresses depend on
+	 * the TCU software, so they normally come from a logger definition.
+	 */
+	readonly sstBlockAddresses?: ReadonlyMap<string, number>;
+	/**
+	 * Try SSM fast-poll (continuous A8 responses) before falling back to one
+	 * request per cycle (default: true).
+	 */
+	readonly fastPoll?: boolean;
+}
+
+/** Requested bytes of one SST block and where they land in the A8 response. */
+interface SstBlockRead {
+	plan: BitFieldPlan;
+	/** Block image the plan runs against; unrequested bytes stay zero */
+	scratch: Uint8Array;
+	/** Offset within `scratch` for each copied byte */
+	blockOffsets: Uint16Array;
+	/** Index of that byte within the concatenated response data */
+	responseIndices: Uint16Array;
+}
+
 /**
  * Subaru/Denso ECU protocol implementation (KWP2000 SecurityAccess + CAN ISO 15765-4).
  *
@@ -95,13 +170,16 @@ const SECTOR_SIZE = 0x10000;
 export class SubaruProtocol implements EcuProtocol {
 	readonly name = "Subaru/Denso KWP2000 (CAN)";
 
+	constructor(private readonly options: SubaruProtocolOptions = {}) {}
+
 	/**
 	 * Probe the connection to determine if this protocol can communicate
 	 * with the connected ECU.
 	 *
 	 * Returns true if the device is an OpenPort 2.0 (transportName === "openport2")
-	 * for CAN-based KWP2000, or a K-line transport (transportName === "kline")
-	 * for Subaru ECUs using the SSM protocol over K-line.
+	 * for CAN-based KWP2000, or a K-line transport (transportName === "kline" or
+	 * "k-line", as reported by `KLineTransport`) for Subaru ECUs using the SSM
+	 * protocol over K-line.
 	 *
 	 * Ref: HANDSHAKE_ANALYSIS.md — §4.4 subarucantool::ready_port (0x6df3a)
 	 *
@@ -110,7 +188,8 @@ export class SubaruProtocol implements EcuProtocol {
 	async canHandle(connection: DeviceConnection): Promise<boolean> {
 		return (
 			connection.deviceInfo.transportName === "openport2" ||
-			connection.deviceInfo.transportName === "kline"
+			connection.deviceInfo.transportName === "kline" ||
+			connection.deviceInfo.transportName === "k-line"
 		);
 	}
 
@@ -226,15 +305,23 @@ export class SubaruProtocol implements EcuProtocol {
 		// Determine which sectors need to be erased and written.
 		// When originalRom is provided, only changed sectors are processed.
 		// When not provided, all sectors are processed (full flash — backward compatible).
-		const sectorsToWrite = options?.originalRom
-			? computeChangedSectors(options.originalRom, rom, SECTOR_SIZE)
-			: Array.from({ length: ROM_SIZE / SECTOR_SIZE }, (_, i) => i);
+		// TransferData frames for the next sector are built while this one is
+		// on the wire.
+		const pipeline = new FlashWritePipeline(rom, {
+			sectorSize: SECTOR_SIZE,
+			blockSize: BLOCK_SIZE,
+			headerLength: 2,
+			writeHeader: (frame, { blockInSector }) => {
+				frame[0] = SID_TRANSFER_DATA;
+				frame[1] = (blockInSector + 1) & 0xff; // sequence number (resets per sector)
+			},
+			originalRom: options?.originalRom,
+		});
 
-		const blocksPerSector = SECTOR_SIZE / BLOCK_SIZE;
 		let bytesWritten = 0;
-		const totalBytesToWrite = sectorsToWrite.length * SECTOR_SIZE;
+		const totalBytesToWrite = pipeline.totalBytes;
 
-		for (const sectorIndex of sectorsToWrite) {
+		for await (const { sectorIndex, frames } of pipeline) {
 			const sectorAddr = ROM_START + sectorIndex * SECTOR_SIZE;
 
 			const sectorAddrByte0 = (sectorAddr >> 16) & 0xff;
@@ -299,22 +386,7 @@ export class SubaruProtocol implements EcuProtocol {
 			);
 
 			// Step 4: Transfer data blocks within this sector
-			for (
-				let blockInSector = 0;
-				blockInSector < blocksPerSector;
-				blockInSector++
-			) {
-				const block = sectorIndex * blocksPerSector + blockInSector;
-				const blockData = rom.slice(
-					block * BLOCK_SIZE,
-					(block + 1) * BLOCK_SIZE,
-				);
-
-				const frame = new Uint8Array(2 + BLOCK_SIZE);
-				frame[0] = SID_TRANSFER_DATA;
-				frame[1] = (blockInSector + 1) & 0xff; // sequence number (resets per sector)
-				frame.set(blockData, 2);
-
+			for (const frame of frames) {
 				await connection.sendFrame(frame);
 
 				bytesWritten += BLOCK_SIZE;
@@ -350,9 +422,9 @@ export class SubaruProtocol implements EcuProtocol {
 	 * Uses synthetic PID range 0x8000+ to avoid conflicts with standard OBD-II
 	 * PIDs (0x00-0xFF), following the MUT-III pattern.
 	 *
-	 * NOTE: Real-time streaming via SSM/K-line is currently not implemented
-	 * (blocked by lack of K-line transport support). This method provides the
-	 * parameter catalog for when K-line streaming becomes available.
+	 * Only parameters whose SST block has an SSM address (see
+	 * `SubaruProtocolOptions.sstBlockAddresses`) can be streamed with
+	 * {@link SubaruProtocol.streamLiveData}.
 	 *
 	 * @returns Promise resolving to array of PID descriptors for all SST parameters
 	 *
@@ -384,6 +456,313 @@ export class SubaruProtocol implements EcuProtocol {
 		}));
 	}
 
+	/**
+	 * Stream SST parameters over SSM.
+	 *
+	 * Every byte the requested parameters occupy is packed into one A8
+	 * read-addresses request to the TCU, so each cycle is a single round trip
+	 * (split only past {@link SSM_MAX_ADDRESSES_PER_READ} addresses). The
+	 * response is decoded with precompiled SST extraction plans.
+	 *
+	 * When the request fits in one packet and `fastPoll` is enabled, the
+	 * first request asks for fast-poll mode. If the TCU answers, later
+	 * responses are taken from the connection's stream without sending
+	 * anything; otherwise the session falls back to one single-mode request
+	 * per cycle. Stopping the session sends a single-mode request to end
+	 * fast-poll.
+	 *
+	 * PIDs whose block has no SSM address are skipped with a warning.
+	 *
+	 * The transport must carry whole SSM packets: `sendFrame` sends the
+	 * packet as-is and resolves with the bytes received, and `startStream`
+	 * delivers each received packet. `KLineTransport` does this for any
+	 * complete, physically addressed ISO 14230 frame, which an SSM packet is.
+	 *
+	 * @param connection - Active device connection (K-line, SSM framing)
+	 * @param pids - Synthetic SST PIDs (0x8000+) to stream
+	 * @param onFrame - Called with each decoded value
+	 * @param onHealth - Optional health metrics callback
+	 * @param options - Optional per-PID rate overrides
+	 * @returns Session handle; call `stop()` to end streaming
+	 */
+	streamLiveData(
+		connection: DeviceConnection,
+		pids: number[],
+		onFrame: (frame: LiveDataFrame) => void,
+		onHealth?: (health: LiveDataHealth) => void,
+		options?: LiveDataOptions,
+	): LiveDataSession {
+		const startTime = Date.now();
+
+		// Assign each requested SST pid an output slot, grouped by block
+		const slotPids: number[] = [];
+		const slotUnits: string[] = [];
+		const blockParamSlots = new Map<
+			SstBlockDef,
+			{ paramIdx: number; slot: number }[]
+		>();
+		const unaddressed: number[] = [];
+		let rateHz = 0;
+		for (const block of SST_BLOCKS) {
+			block.parameters.forEach((param, paramIdx) => {
+				const pid = param.pid;
+				if (pid === undefined || !pids.includes(pid)) return;
+				if (this.sstBlockAddress(block) === undefined) {
+					unaddressed.push(pid);
+					return;
+				}
+
+				const slot = slotPids.length;
+				slotPids.push(pid);
+				slotUnits.push(param.unit);
+				const paramSlots = blockParamSlots.get(block) ?? [];
+				paramSlots.push({ paramIdx, slot });
+				blockParamSlots.set(block, paramSlots);
+
+				rateHz = Math.max(
+					rateHz,
+					resolvePidRate(
+						pid,
+						SST_CATEGORY_RATE_CLASS[param.category],
+						options?.rates,
+					),
+				);
+			});
+		}
+		if (unaddressed.length > 0) {
+			console.warn(
+				`[SSM] No SSM address for SST block of PIDs ${unaddressed.map((pid) => `0x${pid.toString(16)}`).join(", ")}; skipping`,
+			);
+		}
+
+		// Collect the bytes each block's plan reads. Addresses are shared
+		// across blocks, so each is requested once.
+		const addresses: number[] = [];
+		const addressIndex = new Map<number, number>();
+		const blockReads: SstBlockRead[] = [];
+		for (const [block, paramSlots] of blockParamSlots) {
+			const baseAddress = this.sstBlockAddress(block) as number;
+			const plan = compileSstExtractionPlan(block, paramSlots);
+
+			const offsets = new Set<number>();
+			for (const { paramIdx } of paramSlots) {
+				const param = block.parameters[paramIdx];
+				if (!param) continue;
+				const first = param.bitOffset >> 3;
+				const last = (param.bitOffset + param.bitLength - 1) >> 3;
+				for (let offset = first; offset <= last; offset++) {
+					offsets.add(offset);
+				}
+			}
+
+			const blockOffsets = Uint16Array.from(offsets).sort();
+			const responseIndices = blockOffsets.map((offset) => {
+				const address = baseAddress + offset;
+				let index = addressIndex.get(address);
+				if (index === undefined) {
+					index = addresses.length;
+					addresses.push(address);
+					addressIndex.set(address, index);
+				}
+				return index;
+			});
+
+			blockReads.push({
+				plan,
+				scratch: new Uint8Array(plan.byteLength),
+				blockOffsets,
+				responseIndices,
+			});
+		}
+
+		// Requests are built once and resent every cycle
+		const packets: { request: Uint8Array; start: number; count: number }[] =
+			[];
+		for (
+			let start = 0;
+			start < addresses.length;
+			start += SSM_MAX_ADDRESSES_PER_READ
+		) {
+			const chunk = addresses.slice(start, start + SSM_MAX_ADDRESSES_PER_READ);
+			packets.push({
+				request: buildSsmReadAddressesRequest(chunk, SSM_TCU_ID),
+				start,
+				count: chunk.length,
+			});
+		}
+		const fastPollRequest =
+			packets.length === 1 && this.options.fastPoll !== false
+				? buildSsmReadAddressesRequest(addresses, SSM_TCU_ID, true)
+				: null;
+
+		const responseData = new Uint8Array(addresses.length);
+		const values = new Float64Array(slotPids.length);
+
+		// Decode the assembled response and emit every requested parameter
+		const emitCycle = (): number => {
+			if (!scheduler.isRunning) return 0;
+			for (const read of blockReads) {
+				const { plan, scratch, blockOffsets, responseIndices } = read;
+				for (let i = 0; i < blockOffsets.length; i++) {
+					const byte = responseData[responseIndices[i] as number] as number;
+					scratch[blockOffsets[i] as number] = byte;
+				}
+				runBitFieldPlan(plan, scratch, values);
+			}
+
+			const timestamp = Date.now() - startTime;
+			for (let slot = 0; slot < slotPids.length; slot++) {
+				onFrame({
+					timestamp,
+					pid: slotPids[slot] as number,
+					value: values[slot] as number,
+					unit: slotUnits[slot] as string,
+				});
+			}
+			return slotPids.length;
+		};
+
+		// ── Fast-poll ────────────────────────────────────────────────────────
+		// "untested" until the first cycle, then "active" or "unsupported".
+		let fastPoll: "untested" | "active" | "unsupported" =
+			fastPollRequest === null ? "unsupported" : "untested";
+		// Set when a streamed response has been copied into responseData but
+		// not decoded yet; `waiter` is the pending reader, if any.
+		let fresh = false;
+		let waiter: (() => void) | null = null;
+
+		// Copy straight into responseData: decoding is synchronous, so a
+		// response never lands mid-cycle, and the transport may reuse `frame`.
+		const onStreamFrame = (frame: Uint8Array) => {
+			try {
+				responseData.set(
+					parseSsmReadAddressesResponse(frame, addresses.length, SSM_TCU_ID),
+				);
+			} catch {
+				return; // Not an A8 response (e.g. request echo); ignore
+			}
+			fresh = true;
+			waiter?.();
+		};
+
+		const nextStreamedResponse = (): Promise<void> => {
+			if (fresh) {
+				fresh = false;
+				return Promise.resolve();
+			}
+			return new Promise<void>((resolve, reject) => {
+				const timer = setTimeout(() => {
+					waiter = null;
+					reject(
+						new Error(
+							`No SSM fast-poll response within ${SSM_RESPONSE_TIMEOUT_MS} ms`,
+						),
+					);
+				}, SSM_RESPONSE_TIMEOUT_MS);
+				waiter = () => {
+					clearTimeout(timer);
+					waiter = null;
+					fresh = false;
+					resolve();
+				};
+			});
+		};
+
+		const pollFastPoll = async (): Promise<number> => {
+			if (fastPoll === "untested" && fastPollRequest) {
+				let data: Uint8Array;
+				try {
+					const frame = await connection.sendFrame(
+						fastPollRequest,
+						SSM_RESPONSE_TIMEOUT_MS,
+					);
+					data = parseSsmReadAddressesResponse(
+						frame,
+						addresses.length,
+						SSM_TCU_ID,
+					);
+				} catch {
+					fastPoll = "unsupported";
+					return pollSingle();
+				}
+				fastPoll = "active";
+				connection.startStream(onStreamFrame);
+				responseData.set(data);
+				return emitCycle();
+			}
+
+			try {
+				await nextStreamedResponse();
+			} catch (error) {
+				if (!scheduler.isRunning) return 0;
+				// The TCU stopped streaming; poll explicitly from now on
+				fastPoll = "unsupported";
+				connection.stopStream();
+				throw error;
+			}
+			return emitCycle();
+		};
+
+		// ── Single-mode requests ─────────────────────────────────────────────
+		const pollSingle = async (): Promise<number> => {
+			for (const packet of packets) {
+				const frame = await connection.sendFrame(
+					packet.request,
+					SSM_RESPONSE_TIMEOUT_MS,
+				);
+				responseData.set(
+					parseSsmReadAddressesResponse(frame, packet.count, SSM_TCU_ID),
+					packet.start,
+				);
+			}
+			return emitCycle();
+		};
+
+		const tasks =
+			addresses.length === 0
+				? []
+				: [
+						{
+							id: `SSM_A8x${addresses.length}`,
+							rateHz,
+							run: () =>
+								fastPoll === "unsupported" ? pollSingle() : pollFastPoll(),
+						},
+					];
+
+		const scheduler = new LiveDataScheduler(tasks, {
+			...(onHealth ? { onHealth } : {}),
+			onError: (task, error) => {
+				console.error(`[SSM] Failed to poll ${task.id}:`, error);
+			},
+		});
+		scheduler.start();
+
+		return {
+			stop: () => {
+				scheduler.stop();
+				if (fastPoll === "active") {
+					fastPoll = "unsupported";
+					connection.stopStream();
+					// Any new request ends fast-poll mode on the TCU
+					const stopRequest = packets[0]?.request;
+					if (stopRequest) {
+						connection.sendFrame(stopRequest).catch((error) => {
+							console.warn("[SSM] Failed to end fast-poll:", error);
+						});
+					}
+				}
+			},
+		};
+	}
+
+	/** SSM address of an SST block, if known. */
+	private sstBlockAddress(block: SstBlockDef): number | undefined {
+		return (
+			this.options.sstBlockAddresses?.get(block.blockId) ?? block.blockAddress
+		);
+	}
+
 	private async enterProgrammingMode(
 		connection: DeviceConnection,
 		onEvent?: (event: EcuEvent) => void,
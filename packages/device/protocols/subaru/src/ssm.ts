@@ -0,0 +1,155 @@
+/**
+ * Subaru Select Monitor (SSM) packet helpers.
+ *
+ * SSM is Subaru's K-line diagnostic protocol. Every packet has the form:
+ *
+ * ```
+ * [0x80] [dest] [src] [len] [command, params...] [checksum]
+ * ```
+ *
+ * Live data is read with the A8 "read addresses" command, which takes a list
+ * of 3-byte RAM addresses and returns one byte per address in a single E8
+ * response. Packing every address a logging session needs into one A8
+ * request means one round trip per cycle, which matters on a 4800-baud link.
+ *
+ * The second A8 parameter byte selects single (0x00) or fast-poll (0x01)
+ * mode. In fast-poll mode the controller keeps answering the same request
+ * until another request is sent, so the tester only has to listen.
+ *
+ * Ref: RomRaider SSMProtocol / SSMResponseProcessor
+ *
+ * @module subaru/ssm
+ */
+
+import { ssmChecksum } from "@ecu-explorer/core";
+
+/** Fixed first byte of every SSM packet */
+export const SSM_HEADER = 0x80;
+/** Diagnostic tester address */
+export const SSM_TESTER_ID = 0xf0;
+/** Engine control unit address */
+export const SSM_ECU_ID = 0x10;
+/** Transmission control unit address (SST parameters live here) */
+export const SSM_TCU_ID = 0x18;
+
+/** Read single bytes at a list of addresses */
+export const SSM_CMD_READ_ADDRESSES = 0xa8;
+/** Positive response to {@link SSM_CMD_READ_ADDRESSES} */
+export const SSM_RSP_READ_ADDRESSES = 0xe8;
+
+/** A8 parameter: answer once */
+export const SSM_READ_SINGLE = 0x00;
+/** A8 parameter: keep answering until the next request (fast-poll) */
+export const SSM_READ_FAST_POLL = 0x01;
+
+/**
+ * Most addresses a single A8 request can carry. The length byte counts the
+ * command, the mode byte and 3 bytes per address, and cannot exceed 0xFF.
+ */
+export const SSM_MAX_ADDRESSES_PER_READ = Math.floor((0xff - 2) / 3);
+
+// Header, dest, src and length bytes before the data
+const SSM_PREFIX_LENGTH = 4;
+
+/**
+ * Build an A8 read-addresses request.
+ *
+ * @param addresses - 24-bit RAM addresses to read, in response order
+ * @param destination - Controller address (default: {@link SSM_ECU_ID})
+ * @param fastPoll - Request continuous responses (default: false)
+ * @returns Complete SSM packet including checksum
+ * @throws Error if no addresses or more than {@link SSM_MAX_ADDRESSES_PER_READ} are given
+ *
+ * @example
+ * // Read 0x000008 from the ECU once
+ * buildSsmReadAddressesRequest([0x000008]);
+ * // => [0x80, 0x10, 0xF0, 0x05, 0xA8, 0x00, 0x00, 0x00, 0x08, 0x35]
+ */
+export function buildSsmReadAddressesRequest(
+	addresses: readonly number[],
+	destination = SSM_ECU_ID,
+	fastPoll = false,
+): Uint8Array {
+	if (
+		addresses.length === 0 ||
+		addresses.length > SSM_MAX_ADDRESSES_PER_READ
+	) {
+		throw new Error(
+			`SSM read request must contain 1-${SSM_MAX_ADDRESSES_PER_READ} addresses, got ${addresses.length}`,
+		);
+	}
+
+	const dataLength = 2 + addresses.length * 3;
+	const packet = new Uint8Array(SSM_PREFIX_LENGTH + dataLength + 1);
+	packet[0] = SSM_HEADER;
+	packet[1] = destination;
+	packet[2] = SSM_TESTER_ID;
+	packet[3] = dataLength;
+	packet[4] = SSM_CMD_READ_ADDRESSES;
+	packet[5] = fastPoll ? SSM_READ_FAST_POLL : SSM_READ_SINGLE;
+
+	let offset = 6;
+	for (const address of addresses) {
+		packet[offset++] = (address >> 16) & 0xff;
+		packet[offset++] = (address >> 8) & 0xff;
+		packet[offset++] = address & 0xff;
+	}
+	packet[offset] = ssmChecksum(packet);
+	return packet;
+}
+
+/**
+ * Locate and validate an E8 read-addresses response.
+ *
+ * K-line is half-duplex, so depending on the adapter the frame may start
+ * with the echo of the request; the response is found by its header rather
+ * than assumed to be at offset 0.
+ *
+ * @param frame - Bytes received from the transport
+ * @param addressCount - Number of addresses in the request
+ * @param source - Controller address the response must come from (default: {@link SSM_ECU_ID})
+ * @returns View of the data bytes (one per requested address) within `frame`
+ * @throws Error if no response header is found, or the length, command or checksum is wrong
+ */
+export function parseSsmReadAddressesResponse(
+	frame: Uint8Array,
+	addressCount: number,
+	source = SSM_ECU_ID,
+): Uint8Array {
+	const packetLength = SSM_PREFIX_LENGTH + 1 + addressCount + 1;
+
+	// A request echo or stray data may precede the response; keep scanning
+	// past header-like bytes that do not form a valid packet.
+	let lastError: string | null = null;
+	for (let start = 0; start + packetLength <= frame.length; start++) {
+		if (
+			frame[start] !== SSM_HEADER ||
+			frame[start + 1] !== SSM_TESTER_ID ||
+			frame[start + 2] !== source
+		) {
+			continue;
+		}
+
+		const dataLength = frame[start + 3] as number;
+		const command = frame[start + 4] as number;
+		if (
+			dataLength !== addressCount + 1 ||
+			command !== SSM_RSP_READ_ADDRESSES
+		) {
+			lastError = `Unexpected SSM response: command 0x${command.toString(16).toUpperCase()}, length ${dataLength} (expected 0xE8, length ${addressCount + 1})`;
+			continue;
+		}
+
+		const packet = frame.subarray(start, start + packetLength);
+		if (packet[packetLength - 1] !== ssmChecksum(packet)) {
+			lastError = "SSM response checksum mismatch";
+			continue;
+		}
+		return packet.subarray(SSM_PREFIX_LENGTH + 1, packetLength - 1);
+	}
+
+	throw new Error(
+		lastError ??
+			`No SSM read response from 0x${source.toString(16).toUpperCase()} in ${frame.length}-byte frame`,
+	);
+}
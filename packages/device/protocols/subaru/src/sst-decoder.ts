@@ -17,6 +17,7 @@
  */
 
 import {
+	compileSstExtractionPlan,
 	extractAllSstParameters,
 	extractSstParameter,
 	getAllSstParameterPids,
@@ -45,6 +46,7 @@ export {
 	SST_TRANS_BLOCK,
 	extractSstParameter,
 	extractAllSstParameters,
+	compileSstExtractionPlan,
 	getAllSstParameterPids,
 	getSstParameterCount,
 };
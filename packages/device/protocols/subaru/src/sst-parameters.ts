@@ -13,16 +13,22 @@
  * - Bit 7 = LSB of byte 0
  * - Bit 8 = MSB of byte 1, etc.
  *
- * NOTE: SSM protocol real-time streaming is blocked by lack of K-line transport.
- * This registry is prepared for Phase 2 (streaming implementation).
- * See SUBARU_EVOSCAN_FINDINGS.md § Part 7 for implementation roadmap.
+ * Streaming reads each block's bytes with SSM A8 requests (see
+ * `SubaruProtocol.streamLiveData`). Blocks carry no `blockAddress` by
+ * default: the RAM location depends on the TCU software, so addresses are
+ * supplied per session via `SubaruProtocolOptions.sstBlockAddresses`.
+ * See SUBARU_EVOSCAN_FINDINGS.md § Part 7 for the implementation roadmap.
  *
  * @module subaru/sst-parameters
  * @see SUBARU_EVOSCAN_FINDINGS.md
  * @see packages/device/protocols/mut3/src/rax-parameters.ts (pattern reference)
  */
 
-import { extractBits } from "@ecu-explorer/core";
+import {
+	type BitFieldPlan,
+	compileBitFieldPlan,
+	extractBits,
+} from "@ecu-explorer/core";
 
 /**
  * Categories for SST parameters used for display organization
@@ -631,6 +637,43 @@ export function extractAllSstParameters(
 	return result;
 }
 
+/**
+ * Compile an extraction plan for the given parameters of a SST block.
+ *
+ * The plan expects the same buffer as {@link extractSstParameter}: the
+ * block's data bytes alone, with bit 0 at the MSB of the first byte. The
+ * buffer only has to reach the last bit a planned parameter reads, not
+ * `blockSize`, which is still an estimate for SST_TRANS.
+ *
+ * @param blockDef - Block definition with parameter metadata
+ * @param paramSlots - Parameter indices within the block and their output slots
+ * @returns A compiled plan
+ * @throws Error if a parameter index does not exist in the block
+ *
+ * @example
+ * const plan = compileSstExtractionPlan(SST_TRANS_BLOCK, [
+ *   { paramIdx: 0, slot: 0 },
+ * ]);
+ * const values = new Float64Array(1);
+ * runBitFieldPlan(plan, blockData, values);
+ */
+export function compileSstExtractionPlan(
+	blockDef: SstBlockDef,
+	paramSlots: readonly { paramIdx: number; slot: number }[],
+): BitFieldPlan {
+	return compileBitFieldPlan(
+		paramSlots.map(({ paramIdx, slot }) => {
+			const field = blockDef.parameters[paramIdx];
+			if (!field) {
+				throw new Error(
+					`SST_${blockDef.blockId} parameter definition missing at index ${paramIdx}`,
+				);
+			}
+			return { field, slot };
+		}),
+	);
+}
+
 /**
  * Get all SST parameters as synthetic PID descriptors for logging/display.
  *
@@ -1,4 +1,9 @@
-import type { DeviceConnection, DeviceInfo } from "@ecu-explorer/device";
+import { ssmChecksum } from "@ecu-explorer/core";
+import type {
+	DeviceConnection,
+	DeviceInfo,
+	LiveDataFrame,
+} from "@ecu-explorer/device";
 import { describe, expect, it, vi } from "vitest";
 import { SubaruProtocol } from "../src/index.js";
 import { computeSubaruKey } from "../src/security.js";
@@ -87,6 +92,57 @@ function makeKwp2000Mock(): (data: Uint8Array) => Promise<Uint8Array> {
 	};
 }
 
+/**
+ * Build a sendFrame mock for an SSM TCU that answers A8 read-addresses
+ * requests from `ram`. Each response is preceded by the request echo, as on
+ * a half-duplex K-line.
+ *
+ * @param ram - Byte value per address (unlisted addresses read as 0)
+ * @param requests - Receives every request packet
+ * @param fastPollSupported - Whether fast-poll (A8 01) requests are answered
+ */
+function makeSsmTcuMock(
+	ram: ReadonlyMap<number, number>,
+	requests: Uint8Array[],
+	fastPollSupported: boolean,
+): (data: Uint8Array) => Promise<Uint8Array> {
+	return async (data: Uint8Array): Promise<Uint8Array> => {
+		requests.push(data);
+		expect(data[0]).toBe(0x80);
+		expect(data[1]).toBe(0x18); // TCU
+		expect(data[4]).toBe(0xa8);
+		expect(data[data.length - 1]).toBe(ssmChecksum(data));
+		if (data[5] === 0x01 && !fastPollSupported) {
+			return new Uint8Array(data); // echo only; the TCU stays silent
+		}
+		return new Uint8Array([...data, ...makeSsmResponse(ram, data)]);
+	};
+}
+
+/** E8 response from the TCU for an A8 request. */
+function makeSsmResponse(
+	ram: ReadonlyMap<number, number>,
+	request: Uint8Array,
+): Uint8Array {
+	const count = ((request[3] as number) - 2) / 3;
+	const response = new Uint8Array(6 + count);
+	response.set([0x80, 0xf0, 0x18, count + 1, 0xe8]);
+	for (let i = 0; i < count; i++) {
+		const at = 6 + i * 3;
+		const address =
+			((request[at] as number) << 16) |
+			((request[at + 1] as number) << 8) |
+			(request[at + 2] as number);
+		response[5 + i] = ram.get(address) ?? 0;
+	}
+	response[response.length - 1] = ssmChecksum(response);
+	return response;
+}
+
+function sleep(ms: number): Promise<void> {
+	return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
 function getRequiredFrame(frames: Uint8Array[], index: number): Uint8Array {
 	const frame = frames[index];
 	if (!frame) {
@@ -107,6 +163,14 @@ describe("SubaruProtocol", () => {
 			expect(await protocol.canHandle(connection)).toBe(true);
 		});
 
+		it("returns true for K-line connections", async () => {
+			const protocol = new SubaruProtocol();
+			expect(await protocol.canHandle(makeMockConnection("kline"))).toBe(true);
+			expect(await protocol.canHandle(makeMockConnection("k-line"))).toBe(
+				true,
+			);
+		});
+
 		it("returns false for non-openport2 connections", async () => {
 			const protocol = new SubaruProtocol();
 			const connection = makeMockConnection("elm327");
@@ -1058,3 +1122,154 @@ describe("SubaruProtocol onEvent callbacks", () => {
 		});
 	});
 });
+
+describe("SubaruProtocol.streamLiveData() — SSM", () => {
+	// TRANS at 0x1000, PRES at 0x2000
+	const sstBlockAddresses = new Map([
+		["TRANS", 0x1000],
+		["PRES", 0x2000],
+	]);
+	const ram = new Map([
+		[0x1000, 0x64], // Transmission Temperature: 100 - 40 = 60 °C
+		[0x1001, 0x60], // Gear Selection: bits 8-10 = 0b011
+		[0x2000, 0x19], // Clutch 1 Pressure: bits 0-9 = 100 → 10 Bar
+		[0x2001, 0x03], // Clutch 2 Pressure: bits 10-19 = 50 → 5 Bar
+		[0x2002, 0x20],
+	]);
+	const pids = [0x8001, 0x8002, 0x8010, 0x8011];
+
+	function latestValues(frames: LiveDataFrame[]): Map<number, number> {
+		return new Map(frames.map((f) => [f.pid, f.value]));
+	}
+
+	it("packs every requested byte into one A8 request per cycle", async () => {
+		const protocol = new SubaruProtocol({
+			sstBlockAddresses,
+			fastPoll: false,
+		});
+		const requests: Uint8Array[] = [];
+		const connection = makeMockConnection(
+			"kline",
+			makeSsmTcuMock(ram, requests, true),
+		);
+		const frames: LiveDataFrame[] = [];
+
+		const session = protocol.streamLiveData(connection, pids, (f) =>
+			frames.push(f),
+		);
+		await sleep(120);
+		session.stop();
+
+		expect(requests.length).toBeGreaterThan(1);
+		const request = getRequiredFrame(requests, 0);
+		// 5 addresses: 2 bytes of TRANS, 3 bytes of PRES (shared byte 0x2001)
+		expect([...request.subarray(0, 6)]).toEqual([
+			0x80, 0x18, 0xf0, 2 + 5 * 3, 0xa8, 0x00,
+		]);
+		expect([...request.subarray(6, -1)]).toEqual([
+			0x00, 0x10, 0x00, 0x00, 0x10, 0x01, 0x00, 0x20, 0x00, 0x00, 0x20, 0x01,
+			0x00, 0x20, 0x02,
+		]);
+		for (const r of requests) {
+			expect(r).toEqual(request);
+		}
+
+		const values = latestValues(frames);
+		expect(values.get(0x8001)).toBe(60);
+		expect(values.get(0x8002)).toBe(3);
+		expect(values.get(0x8010)).toBeCloseTo(10);
+		expect(values.get(0x8011)).toBeCloseTo(5);
+		expect(frames.find((f) => f.pid === 0x8010)?.unit).toBe("Bar");
+	});
+
+	it("skips PIDs whose block has no SSM address", async () => {
+		const warn = vi.spyOn(console, "warn").mockImplementation(() => {});
+		const protocol = new SubaruProtocol({
+			sstBlockAddresses: new Map([["TRANS", 0x1000]]),
+			fastPoll: false,
+		});
+		const requests: Uint8Array[] = [];
+		const connection = makeMockConnection(
+			"kline",
+			makeSsmTcuMock(ram, requests, true),
+		);
+		const frames: LiveDataFrame[] = [];
+
+		const session = protocol.streamLiveData(connection, pids, (f) =>
+			frames.push(f),
+		);
+		await sleep(60);
+		session.stop();
+
+		expect(warn).toHaveBeenCalledWith(expect.stringContaining("0x8010"));
+		expect(getRequiredFrame(requests, 0)[3]).toBe(2 + 2 * 3);
+		expect(new Set(frames.map((f) => f.pid))).toEqual(
+			new Set([0x8001, 0x8002]),
+		);
+		warn.mockRestore();
+	});
+
+	it("falls back to single requests when fast-poll is not answered", async () => {
+		const protocol = new SubaruProtocol({ sstBlockAddresses });
+		const requests: Uint8Array[] = [];
+		const connection = makeMockConnection(
+			"kline",
+			makeSsmTcuMock(ram, requests, false),
+		);
+		const frames: LiveDataFrame[] = [];
+
+		const session = protocol.streamLiveData(connection, pids, (f) =>
+			frames.push(f),
+		);
+		await sleep(120);
+		session.stop();
+
+		expect(getRequiredFrame(requests, 0)[5]).toBe(0x01);
+		expect(requests.slice(1).every((r) => r[5] === 0x00)).toBe(true);
+		expect(requests.length).toBeGreaterThan(2);
+		expect(latestValues(frames).get(0x8001)).toBe(60);
+		expect(connection.startStream).not.toHaveBeenCalled();
+	});
+
+	it("listens for fast-poll responses instead of re-sending", async () => {
+		const protocol = new SubaruProtocol({ sstBlockAddresses });
+		const requests: Uint8Array[] = [];
+		const connection = makeMockConnection(
+			"kline",
+			makeSsmTcuMock(ram, requests, true),
+		);
+		let onStreamFrame: ((frame: Uint8Array) => void) | null = null;
+		vi.mocked(connection.startStream).mockImplementation((cb) => {
+			onStreamFrame = cb;
+		});
+		const frames: LiveDataFrame[] = [];
+
+		const session = protocol.streamLiveData(
+			connection,
+			pids,
+			(f) => frames.push(f),
+			undefined,
+			{ rates: new Map(pids.map((pid) => [pid, 100])) },
+		);
+		await sleep(10);
+		expect(onStreamFrame).not.toBeNull();
+
+		// The TCU keeps answering the fast-poll request on its own
+		const fastPollRequest = getRequiredFrame(requests, 0);
+		const streamRam = new Map(ram).set(0x1000, 0x6e); // 70 °C
+		const timer = setInterval(() => {
+			onStreamFrame?.(makeSsmResponse(streamRam, fastPollRequest));
+		}, 5);
+		await sleep(120);
+		clearInterval(timer);
+		session.stop();
+
+		expect(fastPollRequest[5]).toBe(0x01);
+		// Only the fast-poll request, then a single-mode request to end it
+		expect(requests).toHaveLength(2);
+		expect(getRequiredFrame(requests, 1)[5]).toBe(0x00);
+		expect(connection.stopStream).toHaveBeenCalled();
+		expect(frames.filter((f) => f.pid === 0x8001).length).toBeGreaterThan(2);
+		expect(latestValues(frames).get(0x8001)).toBe(70);
+	});
+});
@@ -0,0 +1,75 @@
+import { describe, expect, it } from "vitest";
+import {
+	buildSsmReadAddressesRequest,
+	parseSsmReadAddressesResponse,
+	SSM_MAX_ADDRESSES_PER_READ,
+	SSM_TCU_ID,
+} from "../src/ssm.js";
+
+describe("buildSsmReadAddressesRequest()", () => {
+	it("builds a single-mode A8 request with checksum", () => {
+		expect([...buildSsmReadAddressesRequest([0x000008])]).toEqual([
+			0x80, 0x10, 0xf0, 0x05, 0xa8, 0x00, 0x00, 0x00, 0x08, 0x35,
+		]);
+	});
+
+	it("packs several addresses and the fast-poll flag", () => {
+		const packet = buildSsmReadAddressesRequest(
+			[0x123456, 0xff6a5f],
+			SSM_TCU_ID,
+			true,
+		);
+		expect([...packet.subarray(0, -1)]).toEqual([
+			0x80, 0x18, 0xf0, 0x08, 0xa8, 0x01, 0x12, 0x34, 0x56, 0xff, 0x6a, 0x5f,
+		]);
+		const sum = packet.subarray(0, -1).reduce((a, b) => a + b, 0);
+		expect(packet[packet.length - 1]).toBe(sum & 0xff);
+	});
+
+	it("rejects empty and oversized address lists", () => {
+		expect(() => buildSsmReadAddressesRequest([])).toThrow("1-84 addresses");
+		const tooMany = new Array(SSM_MAX_ADDRESSES_PER_READ + 1).fill(0);
+		expect(() => buildSsmReadAddressesRequest(tooMany)).toThrow("got 85");
+	});
+});
+
+describe("parseSsmReadAddressesResponse()", () => {
+	// E8 response from the TCU with data bytes 0x64 0x60
+	const response = new Uint8Array([0x80, 0xf0, 0x18, 0x03, 0xe8, 0x64, 0x60, 0]);
+	response[7] = response.subarray(0, 7).reduce((a, b) => a + b, 0) & 0xff;
+
+	it("returns the data bytes", () => {
+		expect([
+			...parseSsmReadAddressesResponse(response, 2, SSM_TCU_ID),
+		]).toEqual([0x64, 0x60]);
+	});
+
+	it("skips a leading request echo", () => {
+		const echo = buildSsmReadAddressesRequest([0x1000, 0x1001], SSM_TCU_ID);
+		const frame = new Uint8Array([...echo, ...response]);
+		expect([
+			...parseSsmReadAddressesResponse(frame, 2, SSM_TCU_ID),
+		]).toEqual([0x64, 0x60]);
+	});
+
+	it("rejects a bad checksum", () => {
+		const corrupt = response.slice();
+		corrupt[5] = 0x65;
+		expect(() =>
+			parseSsmReadAddressesResponse(corrupt, 2, SSM_TCU_ID),
+		).toThrow("checksum mismatch");
+	});
+
+	it("rejects a response from another controller or of the wrong length", () => {
+		expect(() => parseSsmReadAddressesResponse(response, 2)).toThrow(
+			"No SSM read response from 0x10",
+		);
+		expect(() =>
+			parseSsmReadAddressesResponse(
+				new Uint8Array([...response, 0, 0]),
+				3,
+				SSM_TCU_ID,
+			),
+		).toThrow("expected 0xE8, length 4");
+	});
+});
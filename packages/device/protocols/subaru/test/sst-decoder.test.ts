@@ -14,8 +14,10 @@
  * - Edge cases and boundary conditions
  */
 
+import { runBitFieldPlan } from "@ecu-explorer/core";
 import { describe, expect, it } from "vitest";
 import {
+	compileSstExtractionPlan,
 	decodeSstBlock,
 	decodeSstBlockSet,
 	decodeSstCalc,
@@ -38,8 +40,10 @@ import {
 	validateSstBlockBuffer,
 } from "../src/sst-decoder.js";
 import {
+	extractAllSstParameters,
 	getAllSstParameterPids,
 	getSstParameterCount,
+	SST_BLOCKS,
 } from "../src/sst-parameters.js";
 
 /**
@@ -630,6 +634,27 @@ describe("Data Validation and Limits", () => {
 	});
 });
 
+describe("compileSstExtractionPlan", () => {
+	it("produces the same values as extractAllSstParameters for every block", () => {
+		const buffer = new Uint8Array([
+			0x50, 0x18, 0x3f, 0x64, 0xa5, 0xc3, 0x7e, 0x81, 0x12, 0xef,
+		]);
+		for (const block of SST_BLOCKS) {
+			const plan = compileSstExtractionPlan(
+				block,
+				block.parameters.map((_, paramIdx) => ({ paramIdx, slot: paramIdx })),
+			);
+			const values = new Float64Array(block.parameters.length);
+			runBitFieldPlan(plan, buffer, values);
+
+			const expected = extractAllSstParameters(buffer, block);
+			block.parameters.forEach((param, idx) => {
+				expect(values[idx]).toBe(expected[param.name]);
+			});
+		}
+	});
+});
+
 // ---------------------------------------------------------------------------
 // Performance and Size Tests
 // ---------------------------------------------------------------------------
@@ -5,7 +5,7 @@ import type {
 	RomProgress,
 	WriteOptions,
 } from "@ecu-explorer/device";
-import { computeChangedSectors } from "@ecu-explorer/device";
+import { FlashWritePipeline } from "@ecu-explorer/device";
 
 import { UDS_NEGATIVE_RESPONSE, UDS_NRC, UDS_SERVICES } from "./services.js";
 
@@ -539,15 +539,23 @@ export class UdsProtocol implements EcuProtocol {
 		// Determine which sectors need to be erased and written.
 		// When originalRom is provided, only changed sectors are processed.
 		// When not provided, all sectors are processed (full flash — backward compatible).
-		const sectorsToWrite = options?.originalRom
-			? computeChangedSectors(options.originalRom, rom, this.SECTOR_SIZE)
-			: Array.from({ length: this.ROM_SIZE / this.SECTOR_SIZE }, (_, i) => i);
+		// TransferData frames for the next sector are built while this one is
+		// on the wire.
+		const pipeline = new FlashWritePipeline(rom, {
+			sectorSize: this.SECTOR_SIZE,
+			blockSize: this.BLOCK_SIZE,
+			headerLength: 2,
+			writeHeader: (frame, { blockInSector }) => {
+				frame[0] = UDS_SERVICES.TRANSFER_DATA;
+				frame[1] = (blockInSector + 1) & 0xff; // blockSequenceCounter (resets per sector)
+			},
+			originalRom: options?.originalRom,
+		});
 
-		const blocksPerSector = this.SECTOR_SIZE / this.BLOCK_SIZE;
 		let bytesWritten = 0;
-		const totalBytesToWrite = sectorsToWrite.length * this.SECTOR_SIZE;
+		const totalBytesToWrite = pipeline.totalBytes;
 
-		for (const sectorIndex of sectorsToWrite) {
+		for await (const { sectorIndex, frames } of pipeline) {
 			const sectorAddr = this.ROM_START + sectorIndex * this.SECTOR_SIZE;
 
 			const addrByte0 = (sectorAddr >> 16) & 0xff;
@@ -601,22 +609,7 @@ export class UdsProtocol implements EcuProtocol {
 
 			// Step 4: Transfer data blocks within this sector
 			// Ref: ISO 14229-1 §11.6 — TransferData
-			for (
-				let blockInSector = 0;
-				blockInSector < blocksPerSector;
-				blockInSector++
-			) {
-				const block = sectorIndex * blocksPerSector + blockInSector;
-				const blockData = rom.slice(
-					block * this.BLOCK_SIZE,
-					(block + 1) * this.BLOCK_SIZE,
-				);
-
-				const frame = new Uint8Array(2 + this.BLOCK_SIZE);
-				frame[0] = UDS_SERVICES.TRANSFER_DATA;
-				frame[1] = (blockInSector + 1) & 0xff; // blockSequenceCounter (resets per sector)
-				frame.set(blockData, 2);
-
+			for (const frame of frames) {
 				await connection.sendFrame(frame);
 
 				bytesWritten += this.BLOCK_SIZE;
@@ -2,8 +2,9 @@
  * Identifies which flash sectors differ between two ROM images.
  *
  * Operates at sector (erase block) granularity because flash can only be
- * erased in whole sectors. Uses O(n) byte comparison per sector with early
- * exit on first difference.
+ * erased in whole sectors. Uses O(n) comparison per sector with early exit
+ * on first difference, four bytes at a time when both images are 32-bit
+ * aligned.
  *
  * @param original   - ROM image read from the ECU (before modification)
  * @param modified   - ROM image to be written (after modification)
@@ -37,6 +38,36 @@ export function computeChangedSectors(
 	const changedSectors: number[] = [];
 	const numSectors = modified.length / sectorSize;
 
+	// Word-wise comparison when both views can be read as 32-bit words
+	if (
+		sectorSize % 4 === 0 &&
+		original.byteOffset % 4 === 0 &&
+		modified.byteOffset % 4 === 0
+	) {
+		const originalWords = new Uint32Array(
+			original.buffer,
+			original.byteOffset,
+			original.length / 4,
+		);
+		const modifiedWords = new Uint32Array(
+			modified.buffer,
+			modified.byteOffset,
+			modified.length / 4,
+		);
+		const sectorWords = sectorSize / 4;
+		for (let i = 0; i < numSectors; i++) {
+			const start = i * sectorWords;
+			const end = start + sectorWords;
+			for (let j = start; j < end; j++) {
+				if (originalWords[j] !== modifiedWords[j]) {
+					changedSectors.push(i);
+					break;
+				}
+			}
+		}
+		return changedSectors;
+	}
+
 	for (let i = 0; i < numSectors; i++) {
 		const start = i * sectorSize;
 		const end = start + sectorSize;
@@ -0,0 +1,344 @@
+/**
+ * Parallel ROM flashing across several adapters.
+ *
+ * A bench with one ECU per adapter can flash all of them at once: every
+ * device gets a worker loop that takes jobs from a shared queue and runs
+ * `EcuProtocol.writeRom` on its own connection. Jobs pinned to a device are
+ * only taken by that device's worker; unpinned jobs go to whichever worker
+ * is free first.
+ *
+ * ROM preparation (checksum recompute and any other image fix-ups) starts
+ * as soon as a job is queued and runs ahead of the flash, so a worker never
+ * does CPU-heavy work between USB transfers; it only awaits the finished
+ * image.
+ *
+ * Progress and protocol events from every job are tagged with the job and
+ * device and merged into one aggregate stream.
+ */
+
+import type { DeviceConnection, EcuProtocol } from "./index.js";
+import type { EcuEvent, RomProgress, WriteOptions } from "./types.js";
+
+/**
+ * One adapter with an ECU attached, ready to flash.
+ */
+export interface FlashWorkerTarget {
+	/** Stable device identifier (usually `connection.deviceInfo.id`) */
+	readonly deviceId: string;
+	readonly connection: DeviceConnection;
+	readonly protocol: EcuProtocol;
+}
+
+/**
+ * A ROM image to flash.
+ */
+export interface FlashJob {
+	readonly id: string;
+	readonly rom: Uint8Array;
+	/** Only this device may run the job (the ECU wired to that adapter) */
+	readonly deviceId?: string;
+	/**
+	 * Prepare the image before flashing, e.g. recompute checksums. Runs
+	 * ahead of the flash, concurrently with other jobs' I/O.
+	 */
+	readonly prepare?: (rom: Uint8Array) => Uint8Array | Promise<Uint8Array>;
+	readonly options?: WriteOptions;
+}
+
+export type FlashJobStatus =
+	| "queued"
+	| "preparing"
+	| "ready"
+	| "flashing"
+	| "done"
+	| "failed";
+
+/**
+ * Current state of one job.
+ */
+export interface FlashJobState {
+	readonly jobId: string;
+	status: FlashJobStatus;
+	/** Device running (or that ran) the job */
+	deviceId: string | null;
+	/** Latest progress reported by the protocol */
+	progress: RomProgress | null;
+	error: Error | null;
+	/** Wall time spent flashing, once finished */
+	durationMs: number | null;
+}
+
+/**
+ * Aggregate progress across all jobs.
+ */
+export interface FlashOrchestratorProgress {
+	/** Sum of bytes processed by every job */
+	bytesProcessed: number;
+	/** Sum of the image sizes of every job */
+	totalBytes: number;
+	percentComplete: number;
+	/** Jobs finished (done or failed) */
+	completedJobs: number;
+	totalJobs: number;
+	/** Per-job state, in submission order */
+	jobs: readonly FlashJobState[];
+}
+
+export interface FlashOrchestratorOptions {
+	/** Called whenever any job's state or progress changes */
+	onProgress?: (progress: FlashOrchestratorProgress) => void;
+	/** Protocol events from every job, tagged with job and device */
+	onEvent?: (jobId: string, deviceId: string, event: EcuEvent) => void;
+	/**
+	 * Stop a device's worker after one of its jobs fails (default: true).
+	 * A failed flash can leave the ECU in boot mode, so the adapter should
+	 * not be handed another job until someone has looked at it.
+	 */
+	stopWorkerOnFailure?: boolean;
+}
+
+interface QueuedJob {
+	job: FlashJob;
+	state: FlashJobState;
+	prepared: Promise<Uint8Array>;
+	/** Size used for aggregate progress until the protocol reports one */
+	totalBytes: number;
+}
+
+/**
+ * Runs flash jobs on several devices concurrently.
+ *
+ * @example
+ * const orchestrator = new FlashOrchestrator(
+ *   [
+ *     { deviceId: "openport2:A", connection: a, protocol: mut3 },
+ *     { deviceId: "openport2:B", connection: b, protocol: mut3 },
+ *   ],
+ *   { onProgress: (p) => console.log(`${p.percentComplete.toFixed(0)}%`) },
+ * );
+ * const results = await orchestrator.run([
+ *   { id: "ecu-a", rom: romA, deviceId: "openport2:A", prepare: fixChecksums },
+ *   { id: "ecu-b", rom: romB, deviceId: "openport2:B", prepare: fixChecksums },
+ * ]);
+ */
+export class FlashOrchestrator {
+	private readonly targets: readonly FlashWorkerTarget[];
+	private readonly options: FlashOrchestratorOptions;
+	private running = false;
+
+	constructor(
+		targets: readonly FlashWorkerTarget[],
+		options: FlashOrchestratorOptions = {},
+	) {
+		const ids = new Set(targets.map((target) => target.deviceId));
+		if (ids.size !== targets.length) {
+			throw new Error("Flash targets must have unique device IDs");
+		}
+		for (const target of targets) {
+			if (!target.protocol.writeRom) {
+				throw new Error(
+					`Protocol "${target.protocol.name}" on ${target.deviceId} does not support ROM writing`,
+				);
+			}
+		}
+		this.targets = targets;
+		this.options = options;
+	}
+
+	/**
+	 * Flash every job and wait for all of them to finish.
+	 *
+	 * Individual failures do not stop other jobs; check each state's
+	 * `status` and `error`. Jobs that no remaining worker can take (their
+	 * device is unknown or its worker stopped) fail without being flashed.
+	 *
+	 * @returns Final state of every job, in submission order
+	 */
+	async run(jobs: readonly FlashJob[]): Promise<FlashJobState[]> {
+		if (this.running) {
+			throw new Error("Flash orchestrator is already running");
+		}
+		const ids = new Set(jobs.map((job) => job.id));
+		if (ids.size !== jobs.length) {
+			throw new Error("Flash jobs must have unique IDs");
+		}
+
+		this.running = true;
+		try {
+			const queued = jobs.map((job) => this.enqueue(job));
+			const pending = [...queued];
+			await Promise.all(
+				this.targets.map((target) => this.workerLoop(target, pending, queued)),
+			);
+
+			// Whatever is left had no worker able to run it
+			for (const entry of pending) {
+				this.finish(
+					entry,
+					queued,
+					new Error(
+						entry.job.deviceId != null
+							? `No available worker for device ${entry.job.deviceId}`
+							: "No available worker",
+					),
+				);
+			}
+			return queued.map((entry) => entry.state);
+		} finally {
+			this.running = false;
+		}
+	}
+
+	/** Create the job's state and start preparing its image. */
+	private enqueue(job: FlashJob): QueuedJob {
+		const state: FlashJobState = {
+			jobId: job.id,
+			status: "queued",
+			deviceId: null,
+			progress: null,
+			error: null,
+			durationMs: null,
+		};
+		const entry: QueuedJob = {
+			job,
+			state,
+			prepared: Promise.resolve(job.rom),
+			totalBytes: job.rom.length,
+		};
+
+		if (job.prepare) {
+			const prepare = job.prepare;
+			state.status = "preparing";
+			// Start on a fresh macrotask so preparation never runs inside a
+			// worker's I/O continuation
+			entry.prepared = new Promise<void>((resolve) =>
+				setTimeout(resolve, 0),
+			)
+				.then(() => prepare(job.rom))
+				.then((rom) => {
+					entry.totalBytes = rom.length;
+					if (state.status === "preparing") {
+						state.status = "ready";
+					}
+					return rom;
+				});
+			// Failures surface when a worker awaits the image
+			entry.prepared.catch(() => {});
+		}
+		return entry;
+	}
+
+	private async workerLoop(
+		target: FlashWorkerTarget,
+		pending: QueuedJob[],
+		all: readonly QueuedJob[],
+	): Promise<void> {
+		const stopOnFailure = this.options.stopWorkerOnFailure ?? true;
+		for (;;) {
+			const index = pending.findIndex(
+				(entry) =>
+					entry.job.deviceId == null ||
+					entry.job.deviceId === target.deviceId,
+			);
+			if (index < 0) {
+				break;
+			}
+			const [entry] = pending.splice(index, 1) as [QueuedJob];
+			const succeeded = await this.runJob(target, entry, all);
+			if (!succeeded && stopOnFailure) {
+				break;
+			}
+		}
+	}
+
+	/** Flash one job on `target`. Never throws; failures land in the state. */
+	private async runJob(
+		target: FlashWorkerTarget,
+		entry: QueuedJob,
+		all: readonly QueuedJob[],
+	): Promise<boolean> {
+		const { job, state } = entry;
+		state.deviceId = target.deviceId;
+
+		let rom: Uint8Array;
+		try {
+			rom = await entry.prepared;
+		} catch (error) {
+			this.finish(entry, all, error);
+			// The device was never touched; keep the worker going
+			return true;
+		}
+
+		state.status = "flashing";
+		this.emitProgress(all);
+		const startedAt = Date.now();
+		try {
+			await target.protocol.writeRom?.(
+				target.connection,
+				rom,
+				(progress) => {
+					state.progress = progress;
+					this.emitProgress(all);
+				},
+				job.options,
+				(event) => this.options.onEvent?.(job.id, target.deviceId, event),
+			);
+		} catch (error) {
+			state.durationMs = Date.now() - startedAt;
+			this.finish(entry, all, error);
+			return false;
+		}
+		state.durationMs = Date.now() - startedAt;
+		this.finish(entry, all, null);
+		return true;
+	}
+
+	private finish(
+		entry: QueuedJob,
+		all: readonly QueuedJob[],
+		error: unknown,
+	): void {
+		if (error == null) {
+			entry.state.status = "done";
+		} else {
+			entry.state.status = "failed";
+			entry.state.error =
+				error instanceof Error ? error : new Error(String(error));
+		}
+		this.emitProgress(all);
+	}
+
+	private emitProgress(all: readonly QueuedJob[]): void {
+		const onProgress = this.options.onProgress;
+		if (!onProgress) {
+			return;
+		}
+
+		let bytesProcessed = 0;
+		let totalBytes = 0;
+		let completedJobs = 0;
+		for (const { state, totalBytes: jobBytes } of all) {
+			const total = state.progress?.totalBytes ?? jobBytes;
+			totalBytes += total;
+			if (state.status === "done") {
+				bytesProcessed += total;
+			} else {
+				const processed = state.progress?.bytesProcessed ?? 0;
+				bytesProcessed += Math.min(processed, total);
+			}
+			if (state.status === "done" || state.status === "failed") {
+				completedJobs++;
+			}
+		}
+
+		onProgress({
+			bytesProcessed,
+			totalBytes,
+			percentComplete:
+				totalBytes > 0 ? (bytesProcessed / totalBytes) * 100 : 0,
+			completedJobs,
+			totalJobs: all.length,
+			jobs: all.map((entry) => entry.state),
+		});
+	}
+}
@@ -0,0 +1,171 @@
+/**
+ * Staged preparation of flash write frames.
+ *
+ * The write loops of the flash protocols used to slice every block out of
+ * the ROM and assemble its frame between two bus round trips, so the link
+ * sat idle while the CPU copied. `FlashWritePipeline` moves that work off
+ * the bus path: the sector diff runs once up front, and the frames for
+ * sector N+1 are assembled into preallocated buffers in a macrotask that
+ * runs while sector N's frames are on the wire.
+ *
+ * Two frame sets are allocated and used alternately, so a flash of any
+ * size allocates the same two sector's worth of frames.
+ */
+
+import { computeChangedSectors } from "./diff.js";
+
+/**
+ * Position of one block within the ROM, passed to
+ * {@link FlashWritePipelineOptions.writeHeader}.
+ */
+export interface FlashBlockRef {
+	/** Sector containing the block */
+	readonly sectorIndex: number;
+	/** Zero-based block index within the sector */
+	readonly blockInSector: number;
+	/** Zero-based block index within the ROM */
+	readonly block: number;
+	/** Byte offset of the block within the ROM */
+	readonly offset: number;
+}
+
+export interface FlashWritePipelineOptions {
+	/** Flash erase block size in bytes */
+	readonly sectorSize: number;
+	/** Payload bytes per write frame */
+	readonly blockSize: number;
+	/** Protocol bytes before the block payload in each frame */
+	readonly headerLength: number;
+	/** Fill in the protocol header (the first `headerLength` bytes) */
+	readonly writeHeader: (frame: Uint8Array, block: FlashBlockRef) => void;
+	/**
+	 * ROM currently on the ECU. When given, only sectors that differ are
+	 * written (see {@link computeChangedSectors}).
+	 */
+	readonly originalRom?: Uint8Array | undefined;
+}
+
+/**
+ * Frames for one sector, ready to send in order.
+ *
+ * The frames are views of a buffer that is refilled two sectors later:
+ * finish sending them before requesting the next sector but one.
+ */
+export interface PreparedFlashSector {
+	readonly sectorIndex: number;
+	readonly frames: readonly Uint8Array[];
+}
+
+interface FrameSlot {
+	frames: Uint8Array[];
+}
+
+/**
+ * Iterate the sectors to write, with each sector's frames already built.
+ *
+ * @example
+ * const pipeline = new FlashWritePipeline(rom, {
+ *   sectorSize: 0x10000,
+ *   blockSize: 0x80,
+ *   headerLength: 2,
+ *   writeHeader: (frame, { blockInSector }) => {
+ *     frame[0] = 0x36;
+ *     frame[1] = (blockInSector + 1) & 0xff;
+ *   },
+ *   originalRom,
+ * });
+ * for await (const sector of pipeline) {
+ *   for (const frame of sector.frames) await connection.sendFrame(frame);
+ * }
+ */
+export class FlashWritePipeline implements AsyncIterable<PreparedFlashSector> {
+	/** Sectors that will be written, in order */
+	readonly sectors: readonly number[];
+	private readonly rom: Uint8Array;
+	private readonly options: FlashWritePipelineOptions;
+	private readonly blocksPerSector: number;
+
+	constructor(rom: Uint8Array, options: FlashWritePipelineOptions) {
+		if (rom.length % options.sectorSize !== 0) {
+			throw new Error(
+				`ROM size ${rom.length} is not a multiple of sector size ${options.sectorSize}`,
+			);
+		}
+		if (options.sectorSize % options.blockSize !== 0) {
+			throw new Error(
+				`Sector size ${options.sectorSize} is not a multiple of block size ${options.blockSize}`,
+			);
+		}
+		this.rom = rom;
+		this.options = options;
+		this.blocksPerSector = options.sectorSize / options.blockSize;
+		this.sectors = options.originalRom
+			? computeChangedSectors(options.originalRom, rom, options.sectorSize)
+			: Array.from({ length: rom.length / options.sectorSize }, (_, i) => i);
+	}
+
+	/** Payload bytes that will be written */
+	get totalBytes(): number {
+		return this.sectors.length * this.options.sectorSize;
+	}
+
+	async *[Symbol.asyncIterator](): AsyncIterator<PreparedFlashSector> {
+		if (this.sectors.length === 0) {
+			return;
+		}
+		const slots = [this.createSlot(), this.createSlot()] as const;
+
+		this.fillSlot(slots[0], this.sectors[0] as number);
+		for (let i = 0; i < this.sectors.length; i++) {
+			const slot = slots[i % 2] as FrameSlot;
+			const nextSector = this.sectors[i + 1];
+			// Build the next sector once the consumer is waiting on the bus.
+			// Its slot held sector i - 1, which the consumer has finished with.
+			const next =
+				nextSector === undefined
+					? null
+					: deferred(() =>
+							this.fillSlot(slots[(i + 1) % 2] as FrameSlot, nextSector),
+						);
+			yield { sectorIndex: this.sectors[i] as number, frames: slot.frames };
+			await next;
+		}
+	}
+
+	private createSlot(): FrameSlot {
+		const { headerLength, blockSize } = this.options;
+		const frameLength = headerLength + blockSize;
+		const buffer = new Uint8Array(frameLength * this.blocksPerSector);
+		const frames: Uint8Array[] = [];
+		for (let i = 0; i < this.blocksPerSector; i++) {
+			frames.push(buffer.subarray(i * frameLength, (i + 1) * frameLength));
+		}
+		return { frames };
+	}
+
+	private fillSlot(slot: FrameSlot, sectorIndex: number): void {
+		const { headerLength, blockSize, writeHeader } = this.options;
+		const firstBlock = sectorIndex * this.blocksPerSector;
+		for (let i = 0; i < this.blocksPerSector; i++) {
+			const frame = slot.frames[i] as Uint8Array;
+			const block = firstBlock + i;
+			const offset = block * blockSize;
+			writeHeader(frame, { sectorIndex, blockInSector: i, block, offset });
+			frame.set(this.rom.subarray(offset, offset + blockSize), headerLength);
+		}
+	}
+}
+
+/** Run `work` in a later macrotask. */
+function deferred(work: () => void): Promise<void> {
+	return new Promise((resolve, reject) => {
+		setTimeout(() => {
+			try {
+				work();
+				resolve();
+			} catch (error) {
+				reject(error);
+			}
+		}, 0);
+	});
+}
@@ -4,6 +4,7 @@ import type {
 	EcuEvent,
 	LiveDataFrame,
 	LiveDataHealth,
+	LiveDataOptions,
 	LiveDataSession,
 	PidDescriptor,
 	RomProgress,
@@ -155,12 +156,16 @@ export interface EcuProtocol {
 	 * Begin streaming live data for the specified PIDs.
 	 * Returns a LiveDataSession that can be used to stop streaming
 	 * and optionally record the session to a file.
+	 *
+	 * PIDs are polled at per-PID target rates (see `LiveDataOptions.rates`
+	 * and `LIVE_DATA_RATE_CLASSES`) rather than round-robin.
 	 */
 	streamLiveData?(
 		connection: DeviceConnection,
 		pids: number[],
 		onFrame: (frame: LiveDataFrame) => void,
 		onHealth?: (health: LiveDataHealth) => void,
+		options?: LiveDataOptions,
 	): LiveDataSession;
 }
 
@@ -192,6 +197,9 @@ export interface DeviceManager {
 export * from "./browser-serial-runtime.js";
 export * from "./diagnostic-workflow.js";
 export * from "./diff.js";
+export * from "./flash-orchestrator.js";
+export * from "./flash-pipeline.js";
 export * from "./hardware-runtime.js";
+export * from "./live-data-scheduler.js";
 export * from "./trace.js";
 export * from "./types.js";
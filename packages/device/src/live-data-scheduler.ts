@@ -0,0 +1,343 @@
+/**
+ * Deadline-driven live data poll scheduler shared by the protocol pollers.
+ *
+ * Each poll task (a PID, a multi-PID request or a RAM block read) has its
+ * own target rate. Tasks are released once per period and the ready task
+ * with the earliest deadline runs next (EDF). A task that finishes late is
+ * re-released immediately rather than replaying missed periods, so an
+ * overloaded link degrades every task proportionally instead of starving
+ * the slow ones or bursting to catch up.
+ *
+ * The scheduler measures the round-trip cost of every poll and reports the
+ * requested vs. achieved rates through `LiveDataHealth`.
+ */
+
+import type { LiveDataHealth, LiveDataTaskHealth } from "./types.js";
+
+/**
+ * Named target rates (Hz) for live data PIDs.
+ *
+ * - `fast`: values that change every engine cycle (RPM, knock, timing, boost)
+ * - `normal`: values that change quickly but are rarely charted per-event
+ * - `slow`: thermally or electrically damped values (coolant, battery)
+ */
+export const LIVE_DATA_RATE_CLASSES = {
+	fast: 20,
+	normal: 5,
+	slow: 1,
+} as const;
+
+export type LiveDataRateClass = keyof typeof LIVE_DATA_RATE_CLASSES;
+
+/**
+ * One schedulable poll.
+ */
+export interface LiveDataPollTask {
+	/** Identifier reported in health statistics */
+	readonly id: string;
+	/** Target poll rate (Hz) */
+	readonly rateHz: number;
+	/**
+	 * Issue the request(s) and emit frames.
+	 * @returns Number of samples emitted. A thrown error counts as a dropped frame.
+	 */
+	readonly run: () => Promise<number>;
+}
+
+export interface LiveDataSchedulerOptions {
+	/** Receives health metrics once per `healthIntervalMs` */
+	onHealth?: (health: LiveDataHealth) => void;
+	/** Health reporting window (default 1000 ms) */
+	healthIntervalMs?: number;
+	/** Called when a task throws (default: log to console) */
+	onError?: (task: LiveDataPollTask, error: unknown) => void;
+}
+
+// Fraction of the requested rate below which the schedule is "degraded"
+const DEGRADED_RATE_RATIO = 0.8;
+// Exponential smoothing factor for the measured poll cost
+const COST_SMOOTHING = 0.2;
+
+interface TaskState {
+	task: LiveDataPollTask;
+	periodMs: number;
+	releaseAt: number;
+	avgCostMs: number;
+	/** Successful polls in the current health window */
+	runs: number;
+	missedDeadlines: number;
+}
+
+/**
+ * Resolve the target rate for a PID: explicit override first, then the
+ * protocol's default rate class.
+ *
+ * @param pid - PID to look up
+ * @param defaultClass - Protocol default rate class for this PID
+ * @param rates - Optional per-PID overrides (Hz)
+ * @returns Target rate in Hz
+ */
+export function resolvePidRate(
+	pid: number,
+	defaultClass: LiveDataRateClass,
+	rates?: ReadonlyMap<number, number>,
+): number {
+	const override = rates?.get(pid);
+	if (override !== undefined && override > 0) {
+		return override;
+	}
+	return LIVE_DATA_RATE_CLASSES[defaultClass];
+}
+
+/**
+ * Group items by target rate, preserving input order within each group.
+ *
+ * @param items - Items to group
+ * @param rateOf - Target rate (Hz) for an item
+ * @returns Map from rate to items, fastest rate first
+ */
+export function groupByRate<T>(
+	items: Iterable<T>,
+	rateOf: (item: T) => number,
+): Map<number, T[]> {
+	const groups = new Map<number, T[]>();
+	for (const item of items) {
+		const rate = rateOf(item);
+		const group = groups.get(rate);
+		if (group) {
+			group.push(item);
+		} else {
+			groups.set(rate, [item]);
+		}
+	}
+	return new Map([...groups].sort(([a], [b]) => b - a));
+}
+
+/**
+ * Earliest-deadline-first poll scheduler.
+ *
+ * @example
+ * const scheduler = new LiveDataScheduler(
+ *   [{ id: "rpm", rateHz: 20, run: pollRpm }, { id: "ect", rateHz: 1, run: pollEct }],
+ *   { onHealth },
+ * );
+ * scheduler.start();
+ * // ...
+ * scheduler.stop();
+ */
+export class LiveDataScheduler {
+	private states: TaskState[] = [];
+	private running = false;
+	private readonly healthIntervalMs: number;
+	// Resolves the current idle sleep early (new tasks or stop)
+	private wake: (() => void) | null = null;
+
+	// Current health window
+	private windowStart = 0;
+	private samples = 0;
+	private droppedFrames = 0;
+	private totalCostMs = 0;
+	private costSamples = 0;
+
+	constructor(
+		tasks: readonly LiveDataPollTask[],
+		private readonly options: LiveDataSchedulerOptions = {},
+	) {
+		this.healthIntervalMs = options.healthIntervalMs ?? 1000;
+		this.setTasks(tasks);
+	}
+
+	get isRunning(): boolean {
+		return this.running;
+	}
+
+	/**
+	 * Replace the task set, e.g. after a protocol falls back to a different
+	 * request layout. New tasks are released immediately.
+	 */
+	setTasks(tasks: readonly LiveDataPollTask[]): void {
+		const now = Date.now();
+		this.states = tasks
+			.filter((task) => task.rateHz > 0)
+			.map((task) => ({
+				task,
+				periodMs: 1000 / task.rateHz,
+				releaseAt: now,
+				avgCostMs: 0,
+				runs: 0,
+				missedDeadlines: 0,
+			}));
+		this.wake?.();
+	}
+
+	/** Start the polling loop. Errors are contained within the loop. */
+	start(): void {
+		if (this.running) return;
+		this.running = true;
+		this.windowStart = Date.now();
+		this.loop().catch((error) => {
+			console.error("[LiveData] Scheduler loop exited with error:", error);
+		});
+	}
+
+	/** Stop polling. An in-flight request completes but emits nothing further. */
+	stop(): void {
+		this.running = false;
+		this.wake?.();
+	}
+
+	private async loop(): Promise<void> {
+		while (this.running) {
+			const now = Date.now();
+			const next = this.pickNext(now);
+
+			if (next === null || next.releaseAt > now) {
+				// Nothing ready — sleep until the earliest release
+				const waitMs =
+					next === null ? this.healthIntervalMs : next.releaseAt - now;
+				await this.idle(Math.min(waitMs, this.healthIntervalMs));
+				this.reportHealthIfDue();
+				continue;
+			}
+
+			await this.runTask(next);
+			this.reportHealthIfDue();
+
+			// Always yield a macrotask so stop() and other I/O can interleave
+			// even when the link is saturated.
+			await delay(0);
+		}
+	}
+
+	/** Sleep until `ms` elapses or `wake()` is called. */
+	private idle(ms: number): Promise<void> {
+		return new Promise<void>((resolve) => {
+			const timer = setTimeout(() => {
+				this.wake = null;
+				resolve();
+			}, ms);
+			this.wake = () => {
+				clearTimeout(timer);
+				this.wake = null;
+				resolve();
+			};
+		});
+	}
+
+	/**
+	 * Ready task with the earliest deadline, or the task released soonest if
+	 * none is ready.
+	 */
+	private pickNext(now: number): TaskState | null {
+		let best: TaskState | null = null;
+		let bestDeadline = Number.POSITIVE_INFINITY;
+		let soonest: TaskState | null = null;
+		for (const state of this.states) {
+			if (state.releaseAt <= now) {
+				const deadline = state.releaseAt + state.periodMs;
+				if (deadline < bestDeadline) {
+					best = state;
+					bestDeadline = deadline;
+				}
+			} else if (soonest === null || state.releaseAt < soonest.releaseAt) {
+				soonest = state;
+			}
+		}
+		return best ?? soonest;
+	}
+
+	private async runTask(state: TaskState): Promise<void> {
+		const deadline = state.releaseAt + state.periodMs;
+		const start = Date.now();
+		try {
+			const emitted = await state.task.run();
+			if (this.running) this.samples += emitted;
+			state.runs++;
+		} catch (error) {
+			this.droppedFrames++;
+			if (this.options.onError) {
+				this.options.onError(state.task, error);
+			} else {
+				console.error(`[LiveData] Poll "${state.task.id}" failed:`, error);
+			}
+		}
+		const finish = Date.now();
+		const cost = finish - start;
+
+		state.avgCostMs =
+			state.avgCostMs === 0
+				? cost
+				: state.avgCostMs + (cost - state.avgCostMs) * COST_SMOOTHING;
+		this.totalCostMs += cost;
+		this.costSamples++;
+		if (finish > deadline) {
+			state.missedDeadlines++;
+		}
+
+		// Next period; if we are already past it, release now instead of
+		// queueing a burst of catch-up polls.
+		state.releaseAt = Math.max(state.releaseAt + state.periodMs, finish);
+	}
+
+	private reportHealthIfDue(): void {
+		const now = Date.now();
+		const elapsed = now - this.windowStart;
+		if (elapsed < this.healthIntervalMs) return;
+
+		if (this.options.onHealth && this.running) {
+			this.options.onHealth(this.buildHealth(elapsed));
+		}
+
+		this.windowStart = now;
+		this.samples = 0;
+		this.droppedFrames = 0;
+		this.totalCostMs = 0;
+		this.costSamples = 0;
+		for (const state of this.states) {
+			state.runs = 0;
+			state.missedDeadlines = 0;
+		}
+	}
+
+	private buildHealth(elapsedMs: number): LiveDataHealth {
+		const seconds = elapsedMs / 1000;
+		const tasks: LiveDataTaskHealth[] = this.states.map((state) => ({
+			id: state.task.id,
+			requestedHz: state.task.rateHz,
+			achievedHz: round2(state.runs / seconds),
+			avgCostMs: round2(state.avgCostMs),
+			missedDeadlines: state.missedDeadlines,
+		}));
+		const requestedHz = tasks.reduce((sum, t) => sum + t.requestedHz, 0);
+		const achievedHz = tasks.reduce((sum, t) => sum + t.achievedHz, 0);
+		const samplesPerSecond = this.samples / seconds;
+
+		const status =
+			samplesPerSecond === 0
+				? "stalled"
+				: achievedHz < requestedHz * DEGRADED_RATE_RATIO
+					? "degraded"
+					: "healthy";
+
+		return {
+			samplesPerSecond: Math.round(samplesPerSecond),
+			droppedFrames: this.droppedFrames,
+			latencyMs:
+				this.costSamples > 0
+					? Math.round(this.totalCostMs / this.costSamples)
+					: 0,
+			status,
+			requestedHz: round2(requestedHz),
+			achievedHz: round2(achievedHz),
+			tasks,
+		};
+	}
+}
+
+function delay(ms: number): Promise<void> {
+	return new Promise<void>((resolve) => setTimeout(resolve, ms));
+}
+
+function round2(value: number): number {
+	return Math.round(value * 100) / 100;
+}
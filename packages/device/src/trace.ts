@@ -1,10 +1,12 @@
 /**
  * Trace support for device diagnostics.
  *
- * Provides structured event capture and raw transfer logging in JSON Lines format
- * for field debugging and replay analysis.
+ * Provides structured event capture and raw transfer logging for field
+ * debugging and replay analysis. Traces are streamed to a compact binary
+ * file and exported to JSON Lines for tooling.
  */
 
+import type { FileHandle } from "node:fs/promises";
 import {
 	type DiagnosticEvent,
 	DiagnosticStage,
@@ -53,7 +55,7 @@ export interface TraceEvent extends DiagnosticEvent {
 }
 
 /**
- * JSON Lines record structure for trace output.
+ * Trace record structure, one per line of the JSON Lines export.
  * Each line is a valid JSON object with consistent fields.
  */
 export interface TraceRecord {
@@ -87,20 +89,64 @@ export interface TraceRecord {
 export interface TraceWriterOptions {
 	/** Output file path */
 	outputPath: string;
-	/** Whether to sync writes to disk immediately (default: false for performance) */
+	/** Whether to fsync after every block write (default: false) */
 	sync?: boolean;
 	/** Include raw transfer data in trace (default: true) */
 	includeRaw?: boolean;
+	/** Size of the in-memory record block in bytes (default: 64 KiB) */
+	blockSize?: number;
+	/** Longest a record waits in memory before it is written (default: 1000) */
+	flushIntervalMs?: number;
+	/**
+	 * Blocks allowed to wait for the disk before writes apply back-pressure
+	 * (default: 4)
+	 */
+	maxQueuedBlocks?: number;
+}
+
+// "ECUTRC" + format version + reserved byte
+const TRACE_MAGIC = [0x45, 0x43, 0x55, 0x54, 0x52, 0x43] as const;
+const TRACE_FORMAT_VERSION = 1;
+const TRACE_HEADER_LENGTH = 8;
+
+const DEFAULT_BLOCK_SIZE = 64 * 1024;
+const DEFAULT_FLUSH_INTERVAL_MS = 1000;
+const DEFAULT_MAX_QUEUED_BLOCKS = 4;
+
+// Binary payload tags; exported to JSONL as `raw` and `details.response_raw`
+const BLOB_RAW = 1;
+const BLOB_RESPONSE_RAW = 2;
+
+type TraceBlob = readonly [tag: number, data: Uint8Array];
+
+const textEncoder = new TextEncoder();
+const textDecoder = new TextDecoder();
+
+async function openTraceFile(
+	path: string,
+	flags: "r" | "w",
+): Promise<FileHandle> {
+	const fs = await import("node:fs/promises");
+	return fs.open(path, flags);
 }
 
 /**
- * Writes trace events in JSON Lines format.
+ * Streams trace events to an append-only binary trace file.
+ *
+ * Records are encoded into a fixed-size block that is handed to a
+ * background write queue when it fills up or `flushIntervalMs` after its
+ * first record, so a long capture runs in constant memory and a crash loses
+ * at most the last interval. Raw transfer bytes are stored as
+ * length-prefixed binary rather than hex text.
+ *
+ * File layout (all integers little-endian):
+ * - header: `ECUTRC`, format version (u8), reserved (u8)
+ * - records: JSON length (u32), UTF-8 {@link TraceRecord} JSON without the
+ *   raw fields, blob count (u8), then per blob: tag (u8), length (u32),
+ *   bytes
  *
- * Each line is a valid JSON object, making it easy to:
- * - Stream and process incrementally
- * - Filter with tools like jq
- * - Replay with log replay tools
- * - Archive and diff
+ * Use {@link readTraceRecords} or {@link exportTraceToJsonl} to get JSON
+ * Lines for jq and replay tools.
  *
  * @example
  * ```typescript
@@ -114,16 +160,29 @@ export interface TraceWriterOptions {
  * });
  * await trace.writeRawTransfer("out", new Uint8Array([0x01, 0x02, 0x03]));
  * await trace.close();
+ * await exportTraceToJsonl("./diagnostic.trace", "./diagnostic.jsonl");
  * ```
  */
 export class TraceWriter {
 	private readonly outputPath: string;
 	private readonly includeRaw: boolean;
-	private readonly lines: string[] = [];
+	private readonly sync: boolean;
+	private readonly blockSize: number;
+	private readonly flushIntervalMs: number;
+	private readonly maxQueuedBlocks: number;
+	private readonly pool: Uint8Array[] = [];
+	private block: Uint8Array | null = null;
+	private blockLength = 0;
+	private headerWritten = false;
+	private queuedBlocks = 0;
+	private writeQueue: Promise<void> = Promise.resolve();
+	private handle: Promise<FileHandle> | null = null;
+	private flushTimer: ReturnType<typeof setTimeout> | null = null;
+	private error: unknown = null;
 	private closed = false;
 
 	/**
-	 * Creates a new TraceWriter.
+	 * Creates a new TraceWriter. The file is created on the first write.
 	 *
 	 * @param outputPath - Path to write the trace file
 	 * @param options - Optional configuration
@@ -131,6 +190,12 @@ export class TraceWriter {
 	constructor(outputPath: string, options?: TraceWriterOptions) {
 		this.outputPath = outputPath;
 		this.includeRaw = options?.includeRaw ?? true;
+		this.sync = options?.sync ?? false;
+		this.blockSize = options?.blockSize ?? DEFAULT_BLOCK_SIZE;
+		this.flushIntervalMs =
+			options?.flushIntervalMs ?? DEFAULT_FLUSH_INTERVAL_MS;
+		this.maxQueuedBlocks =
+			options?.maxQueuedBlocks ?? DEFAULT_MAX_QUEUED_BLOCKS;
 	}
 
 	/**
@@ -139,12 +204,7 @@ export class TraceWriter {
 	 * @param event - The diagnostic event to trace
 	 */
 	async write(event: TraceEvent): Promise<void> {
-		if (this.closed) {
-			throw new Error("TraceWriter is closed");
-		}
-
-		const record = this.eventToRecord(event);
-		this.lines.push(JSON.stringify(record));
+		await this.append(this.eventToRecord(event));
 	}
 
 	/**
@@ -161,10 +221,6 @@ export class TraceWriter {
 		stage: DiagnosticStage,
 		summary: string,
 	): Promise<void> {
-		if (this.closed) {
-			throw new Error("TraceWriter is closed");
-		}
-
 		const timestamp = Date.now();
 		const record: TraceRecord = {
 			timestamp: new Date(timestamp).toISOString(),
@@ -176,11 +232,7 @@ export class TraceWriter {
 			direction,
 		};
 
-		if (this.includeRaw) {
-			record.raw = this.bytesToHex(data);
-		}
-
-		this.lines.push(JSON.stringify(record));
+		await this.append(record, this.includeRaw ? [[BLOB_RAW, data]] : []);
 	}
 
 	/**
@@ -197,10 +249,6 @@ export class TraceWriter {
 		response: Uint8Array | null,
 		stage: DiagnosticStage,
 	): Promise<void> {
-		if (this.closed) {
-			throw new Error("TraceWriter is closed");
-		}
-
 		const timestamp = Date.now();
 		const record: TraceRecord = {
 			timestamp: new Date(timestamp).toISOString(),
@@ -213,17 +261,15 @@ export class TraceWriter {
 			details: { command },
 		};
 
+		const blobs: TraceBlob[] = [];
 		if (this.includeRaw) {
-			record.raw = this.bytesToHex(data);
+			blobs.push([BLOB_RAW, data]);
 			if (response) {
-				record.details = {
-					...record.details,
-					response_raw: this.bytesToHex(response),
-				};
+				blobs.push([BLOB_RESPONSE_RAW, response]);
 			}
 		}
 
-		this.lines.push(JSON.stringify(record));
+		await this.append(record, blobs);
 	}
 
 	/**
@@ -240,10 +286,6 @@ export class TraceWriter {
 		details?: Record<string, unknown>,
 		stage: DiagnosticStage = DiagnosticStage.PROBE,
 	): Promise<void> {
-		if (this.closed) {
-			throw new Error("TraceWriter is closed");
-		}
-
 		const timestamp = Date.now();
 		const record: TraceRecord = {
 			timestamp: new Date(timestamp).toISOString(),
@@ -258,7 +300,7 @@ export class TraceWriter {
 			},
 		};
 
-		this.lines.push(JSON.stringify(record));
+		await this.append(record);
 	}
 
 	/**
@@ -275,10 +317,6 @@ export class TraceWriter {
 		summary: string,
 		stage: DiagnosticStage = DiagnosticStage.OPERATION,
 	): Promise<void> {
-		if (this.closed) {
-			throw new Error("TraceWriter is closed");
-		}
-
 		const timestamp = Date.now();
 		const record: TraceRecord = {
 			timestamp: new Date(timestamp).toISOString(),
@@ -289,21 +327,31 @@ export class TraceWriter {
 			summary,
 		};
 
+		const blobs: TraceBlob[] = [];
 		if (
 			frameType === "logging_frame" &&
 			data instanceof Uint8Array &&
 			this.includeRaw
 		) {
-			record.raw = this.bytesToHex(data);
+			blobs.push([BLOB_RAW, data]);
 		} else if (frameType === "health_event" && typeof data === "object") {
 			record.details = data as Record<string, unknown>;
 		}
 
-		this.lines.push(JSON.stringify(record));
+		await this.append(record, blobs);
+	}
+
+	/**
+	 * Writes any buffered records and waits until the disk has them.
+	 */
+	async flush(): Promise<void> {
+		this.enqueueBlock();
+		await this.writeQueue;
+		this.throwIfFailed();
 	}
 
 	/**
-	 * Closes the trace writer and writes all pending lines to the output file.
+	 * Flushes pending records and closes the trace file.
 	 *
 	 * @returns Promise that resolves when the file is written
 	 */
@@ -314,10 +362,17 @@ export class TraceWriter {
 
 		this.closed = true;
 
-		// Write to file using Node.js fs/promises
-		const fs = await import("node:fs/promises");
-		const content = this.lines.join("\n") + (this.lines.length > 0 ? "\n" : "");
-		await fs.writeFile(this.outputPath, content, "utf-8");
+		// An empty trace still gets a file with a header
+		if (!this.headerWritten) {
+			this.reserve(0);
+		}
+		this.enqueueBlock();
+		await this.writeQueue;
+		if (this.handle) {
+			const handle = await this.handle.catch(() => null);
+			await handle?.close();
+		}
+		this.throwIfFailed();
 	}
 
 	/**
@@ -327,6 +382,133 @@ export class TraceWriter {
 		return this.outputPath;
 	}
 
+	/**
+	 * Encodes one record into the current block.
+	 */
+	private async append(
+		record: TraceRecord,
+		blobs: readonly TraceBlob[] = [],
+	): Promise<void> {
+		if (this.closed) {
+			throw new Error("TraceWriter is closed");
+		}
+		this.throwIfFailed();
+
+		const json = JSON.stringify(record);
+		// UTF-8 needs at most 3 bytes per UTF-16 code unit
+		let maxLength = 4 + json.length * 3 + 1;
+		for (const [, data] of blobs) {
+			maxLength += 5 + data.length;
+		}
+
+		const block = this.reserve(maxLength);
+		const view = new DataView(block.buffer, block.byteOffset, block.length);
+		let offset = this.blockLength;
+		const { written } = textEncoder.encodeInto(
+			json,
+			block.subarray(offset + 4),
+		);
+		view.setUint32(offset, written, true);
+		offset += 4 + written;
+		block[offset++] = blobs.length;
+		for (const [tag, data] of blobs) {
+			block[offset] = tag;
+			view.setUint32(offset + 1, data.length, true);
+			block.set(data, offset + 5);
+			offset += 5 + data.length;
+		}
+		this.blockLength = offset;
+
+		if (this.blockLength >= this.blockSize) {
+			this.enqueueBlock();
+		} else {
+			this.flushTimer ??= setTimeout(() => {
+				this.flushTimer = null;
+				this.enqueueBlock();
+			}, this.flushIntervalMs);
+		}
+
+		// Back-pressure: don't let blocks pile up faster than the disk drains
+		if (this.queuedBlocks > this.maxQueuedBlocks) {
+			await this.writeQueue;
+			this.throwIfFailed();
+		}
+	}
+
+	/**
+	 * Returns the current block, starting a new one if `length` bytes won't
+	 * fit. Records larger than a block get a one-off buffer.
+	 */
+	private reserve(length: number): Uint8Array {
+		if (this.block && this.blockLength + length > this.block.length) {
+			this.enqueueBlock();
+		}
+		if (!this.block) {
+			const needed = length + (this.headerWritten ? 0 : TRACE_HEADER_LENGTH);
+			this.block =
+				needed > this.blockSize
+					? new Uint8Array(needed)
+					: (this.pool.pop() ?? new Uint8Array(this.blockSize));
+			this.blockLength = 0;
+			if (!this.headerWritten) {
+				this.block.set(TRACE_MAGIC);
+				this.block[6] = TRACE_FORMAT_VERSION;
+				this.block[7] = 0;
+				this.blockLength = TRACE_HEADER_LENGTH;
+				this.headerWritten = true;
+			}
+		}
+		return this.block;
+	}
+
+	/**
+	 * Hands the current block to the write queue.
+	 */
+	private enqueueBlock(): void {
+		if (this.flushTimer != null) {
+			clearTimeout(this.flushTimer);
+			this.flushTimer = null;
+		}
+		const block = this.block;
+		const length = this.blockLength;
+		this.block = null;
+		this.blockLength = 0;
+		if (!block || length === 0) {
+			return;
+		}
+
+		this.queuedBlocks++;
+		this.writeQueue = this.writeQueue
+			.then(async () => {
+				if (this.error != null) {
+					return;
+				}
+				this.handle ??= openTraceFile(this.outputPath, "w");
+				const handle = await this.handle;
+				await handle.write(block, 0, length);
+				if (this.sync) {
+					await handle.sync();
+				}
+			})
+			.catch((error: unknown) => {
+				this.error ??= error;
+			})
+			.finally(() => {
+				this.queuedBlocks--;
+				if (block.length === this.blockSize) {
+					this.pool.push(block);
+				}
+			});
+	}
+
+	private throwIfFailed(): void {
+		if (this.error != null) {
+			throw this.error instanceof Error
+				? this.error
+				: new Error(String(this.error));
+		}
+	}
+
 	/**
 	 * Converts a DiagnosticEvent to a TraceRecord.
 	 */
@@ -362,15 +544,160 @@ export class TraceWriter {
 
 		return record;
 	}
+}
 
-	/**
-	 * Converts a Uint8Array to a hex string.
-	 */
-	private bytesToHex(bytes: Uint8Array): string {
-		return Array.from(bytes)
-			.map((b) => b.toString(16).padStart(2, "0"))
-			.join(" ");
+/**
+ * Reads a binary trace file record by record.
+ *
+ * Binary payloads are hex-encoded into `raw` and `details.response_raw`,
+ * giving the same records the JSON Lines export contains. The file is read
+ * in blocks, so memory use does not grow with the trace. A record cut short
+ * at the end of the file (the writer crashed mid-block) is ignored.
+ *
+ * @param tracePath - Trace file written by {@link TraceWriter}
+ */
+export async function* readTraceRecords(
+	tracePath: string,
+): AsyncGenerator<TraceRecord> {
+	const handle = await openTraceFile(tracePath, "r");
+	try {
+		let buffer = new Uint8Array(DEFAULT_BLOCK_SIZE);
+		let start = 0;
+		let end = 0;
+		let headerChecked = false;
+
+		for (;;) {
+			if (start > 0) {
+				buffer.copyWithin(0, start, end);
+				end -= start;
+				start = 0;
+			}
+			if (end === buffer.length) {
+				const grown = new Uint8Array(buffer.length * 2);
+				grown.set(buffer);
+				buffer = grown;
+			}
+			const { bytesRead } = await handle.read(
+				buffer,
+				end,
+				buffer.length - end,
+				null,
+			);
+			end += bytesRead;
+
+			if (!headerChecked) {
+				if (end < TRACE_HEADER_LENGTH) {
+					if (bytesRead === 0) {
+						throw new Error(`${tracePath} is not a trace file`);
+					}
+					continue;
+				}
+				if (
+					TRACE_MAGIC.some((byte, i) => buffer[i] !== byte) ||
+					buffer[6] !== TRACE_FORMAT_VERSION
+				) {
+					throw new Error(`${tracePath} is not a trace file`);
+				}
+				start = TRACE_HEADER_LENGTH;
+				headerChecked = true;
+			}
+
+			for (;;) {
+				const length = recordLength(buffer, start, end);
+				if (length < 0) {
+					break;
+				}
+				yield decodeRecord(buffer.subarray(start, start + length));
+				start += length;
+			}
+
+			if (bytesRead === 0) {
+				return;
+			}
+		}
+	} finally {
+		await handle.close();
+	}
+}
+
+/**
+ * Converts a binary trace file to JSON Lines.
+ *
+ * @param tracePath - Trace file written by {@link TraceWriter}
+ * @param outputPath - JSON Lines file to write
+ * @returns Number of records exported
+ */
+export async function exportTraceToJsonl(
+	tracePath: string,
+	outputPath: string,
+): Promise<number> {
+	const output = await openTraceFile(outputPath, "w");
+	try {
+		let count = 0;
+		let chunk = "";
+		for await (const record of readTraceRecords(tracePath)) {
+			chunk += `${JSON.stringify(record)}\n`;
+			count++;
+			if (chunk.length >= DEFAULT_BLOCK_SIZE) {
+				const bytes = textEncoder.encode(chunk);
+				await output.write(bytes, 0, bytes.length);
+				chunk = "";
+			}
+		}
+		if (chunk.length > 0) {
+			const bytes = textEncoder.encode(chunk);
+			await output.write(bytes, 0, bytes.length);
+		}
+		return count;
+	} finally {
+		await output.close();
+	}
+}
+
+/**
+ * Returns the encoded length of the record at `start`, or -1 if it is not
+ * complete in `buffer[start..end)`.
+ */
+function recordLength(buffer: Uint8Array, start: number, end: number): number {
+	const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.length);
+	if (end - start < 5) {
+		return -1;
+	}
+	let offset = start + 4 + view.getUint32(start, true);
+	if (offset >= end) {
+		return -1;
+	}
+	const blobCount = buffer[offset++] as number;
+	for (let i = 0; i < blobCount; i++) {
+		if (offset + 5 > end) {
+			return -1;
+		}
+		offset += 5 + view.getUint32(offset + 1, true);
+	}
+	return offset <= end ? offset - start : -1;
+}
+
+function decodeRecord(bytes: Uint8Array): TraceRecord {
+	const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.length);
+	const jsonLength = view.getUint32(0, true);
+	const record = JSON.parse(
+		textDecoder.decode(bytes.subarray(4, 4 + jsonLength)),
+	) as TraceRecord;
+
+	let offset = 4 + jsonLength;
+	const blobCount = bytes[offset++] as number;
+	for (let i = 0; i < blobCount; i++) {
+		const tag = bytes[offset];
+		const length = view.getUint32(offset + 1, true);
+		const data = bytes.subarray(offset + 5, offset + 5 + length);
+		offset += 5 + length;
+		if (tag === BLOB_RAW) {
+			record.raw = hexEncode(data);
+		} else if (tag === BLOB_RESPONSE_RAW) {
+			record.details = { ...record.details, response_raw: hexEncode(data) };
+		}
 	}
+	return record;
 }
 
 /**
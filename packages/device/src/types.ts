@@ -51,6 +51,39 @@ export interface LiveDataHealth {
 	droppedFrames: number;
 	latencyMs: number;
 	status: "healthy" | "degraded" | "stalled";
+	/** Sum of the target poll rates of all scheduled requests (Hz) */
+	requestedHz?: number;
+	/** Sum of the poll rates actually achieved in the last window (Hz) */
+	achievedHz?: number;
+	/** Per-request schedule statistics for the last window */
+	tasks?: LiveDataTaskHealth[];
+}
+
+/**
+ * Schedule statistics for one polled request (a PID, PID batch or block).
+ */
+export interface LiveDataTaskHealth {
+	/** Task identifier, e.g. "0x0c" or "RAX_C" */
+	id: string;
+	/** Target poll rate (Hz) */
+	requestedHz: number;
+	/** Achieved poll rate in the last window (Hz) */
+	achievedHz: number;
+	/** Smoothed round-trip cost of one poll (ms) */
+	avgCostMs: number;
+	/** Polls in the last window that finished after their deadline */
+	missedDeadlines: number;
+}
+
+/**
+ * Options for a live data session.
+ */
+export interface LiveDataOptions {
+	/**
+	 * Target poll rate (Hz) per PID. PIDs not listed use the protocol's
+	 * default rate class for that PID.
+	 */
+	rates?: ReadonlyMap<number, number>;
 }
 
 export interface DtcCode {
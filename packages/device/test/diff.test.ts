@@ -212,6 +212,24 @@ describe("computeChangedSectors()", () => {
 		});
 	});
 
+	// ── Alignment ─────────────────────────────────────────────────────────────
+
+	describe("unaligned views", () => {
+		it("finds single-byte changes in views that are not 32-bit aligned", () => {
+			const backing = new Uint8Array(0x4001);
+			const original = backing.subarray(1); // byteOffset 1
+			const modified = makeRom(0x4000, 0x00);
+			modified[0x2003] = 0x01; // sector 2
+			expect(computeChangedSectors(original, modified, 0x1000)).toEqual([2]);
+		});
+
+		it("finds a change in the last byte of a word in aligned views", () => {
+			const original = makeRom(0x4000, 0x00);
+			const modified = withByteChanged(original, 0x3fff, 0x01);
+			expect(computeChangedSectors(original, modified, 0x1000)).toEqual([3]);
+		});
+	});
+
 	// ── 1 MB ROM with 16 sectors (realistic scenario) ────────────────────────
 
 	describe("realistic 1 MB ROM scenario", () => {
@@ -0,0 +1,233 @@
+import { describe, expect, it, vi } from "vitest";
+import {
+	FlashOrchestrator,
+	type FlashOrchestratorProgress,
+	type FlashWorkerTarget,
+} from "../src/flash-orchestrator.js";
+import type { DeviceConnection, EcuProtocol } from "../src/index.js";
+import type { EcuEvent, RomProgress, WriteOptions } from "../src/types.js";
+
+function sleep(ms: number): Promise<void> {
+	return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+function createConnection(id: string): DeviceConnection {
+	return {
+		deviceInfo: {
+			id,
+			name: id,
+			transportName: "test-transport",
+			connected: true,
+		},
+		sendFrame: vi.fn().mockResolvedValue(new Uint8Array()),
+		startStream: vi.fn(),
+		stopStream: vi.fn(),
+		close: vi.fn().mockResolvedValue(undefined),
+	};
+}
+
+/**
+ * Protocol whose writeRom reports progress in 4 chunks, `chunkMs` apart,
+ * and records which device flashed which image.
+ */
+function createFlashProtocol(options: { chunkMs?: number; failOn?: string }) {
+	const log: { deviceId: string; rom: Uint8Array; end: number }[] = [];
+	let active = 0;
+	let maxActive = 0;
+	const protocol: EcuProtocol = {
+		name: "Test Flash",
+		canHandle: vi.fn().mockResolvedValue(true),
+		writeRom: vi.fn(
+			async (
+				connection: DeviceConnection,
+				rom: Uint8Array,
+				onProgress: (progress: RomProgress) => void,
+				_options?: WriteOptions,
+				onEvent?: (event: EcuEvent) => void,
+			) => {
+				const deviceId = connection.deviceInfo.id;
+				active++;
+				maxActive = Math.max(maxActive, active);
+				try {
+					onEvent?.({ type: "BOOT_MODE_ENTERED", timestamp: Date.now() });
+					for (let chunk = 1; chunk <= 4; chunk++) {
+						await sleep(options.chunkMs ?? 5);
+						if (deviceId === options.failOn) {
+							throw new Error(`Write failed on ${deviceId}`);
+						}
+						onProgress({
+							phase: "writing",
+							bytesProcessed: (rom.length * chunk) / 4,
+							totalBytes: rom.length,
+							percentComplete: chunk * 25,
+						});
+					}
+				} finally {
+					active--;
+				}
+				log.push({ deviceId, rom, end: Date.now() });
+			},
+		),
+	};
+	return { protocol, log, maxActive: () => maxActive };
+}
+
+function targets(
+	protocol: EcuProtocol,
+	...deviceIds: string[]
+): FlashWorkerTarget[] {
+	return deviceIds.map((deviceId) => ({
+		deviceId,
+		connection: createConnection(deviceId),
+		protocol,
+	}));
+}
+
+describe("FlashOrchestrator", () => {
+	it("flashes pinned jobs on their devices concurrently", async () => {
+		const { protocol, log, maxActive } = createFlashProtocol({ chunkMs: 10 });
+		const orchestrator = new FlashOrchestrator(
+			targets(protocol, "A", "B", "C"),
+		);
+
+		const results = await orchestrator.run([
+			{ id: "ecu-a", rom: new Uint8Array(64).fill(1), deviceId: "A" },
+			{ id: "ecu-b", rom: new Uint8Array(64).fill(2), deviceId: "B" },
+			{ id: "ecu-c", rom: new Uint8Array(64).fill(3), deviceId: "C" },
+		]);
+
+		expect(results.map((result) => [result.jobId, result.status])).toEqual([
+			["ecu-a", "done"],
+			["ecu-b", "done"],
+			["ecu-c", "done"],
+		]);
+		expect(maxActive()).toBe(3);
+		for (const entry of log) {
+			expect(entry.rom[0]).toBe(entry.deviceId.charCodeAt(0) - 0x40);
+		}
+	});
+
+	it("shares unpinned jobs between free workers", async () => {
+		const { protocol, log } = createFlashProtocol({ chunkMs: 2 });
+		const orchestrator = new FlashOrchestrator(targets(protocol, "A", "B"));
+
+		const results = await orchestrator.run(
+			Array.from({ length: 6 }, (_, i) => ({
+				id: `job-${i}`,
+				rom: new Uint8Array(16),
+			})),
+		);
+
+		expect(results.every((result) => result.status === "done")).toBe(true);
+		const perDevice = new Map<string, number>();
+		for (const entry of log) {
+			perDevice.set(entry.deviceId, (perDevice.get(entry.deviceId) ?? 0) + 1);
+		}
+		expect(perDevice.get("A")).toBeGreaterThan(0);
+		expect(perDevice.get("B")).toBeGreaterThan(0);
+	});
+
+	it("prepares images ahead of the flash and writes the prepared image", async () => {
+		const { protocol, log } = createFlashProtocol({ chunkMs: 10 });
+		const orchestrator = new FlashOrchestrator(targets(protocol, "A"));
+		const preparedAt: number[] = [];
+		const prepare = vi.fn((rom: Uint8Array) => {
+			preparedAt.push(Date.now());
+			const fixed = rom.slice();
+			fixed[fixed.length - 1] = 0xcc; // stand-in for a checksum
+			return fixed;
+		});
+
+		await orchestrator.run([
+			{ id: "first", rom: new Uint8Array(8), prepare },
+			{ id: "second", rom: new Uint8Array(8), prepare },
+		]);
+
+		expect(prepare).toHaveBeenCalledTimes(2);
+		expect(log.map((entry) => entry.rom[7])).toEqual([0xcc, 0xcc]);
+		// The second image was ready before the first flash finished
+		expect(preparedAt[1]).toBeLessThan(log[0]?.end ?? 0);
+	});
+
+	it("isolates failures and stops the failed device's worker", async () => {
+		const { protocol, log } = createFlashProtocol({ failOn: "B" });
+		const orchestrator = new FlashOrchestrator(targets(protocol, "A", "B"));
+
+		const results = await orchestrator.run([
+			{ id: "a1", rom: new Uint8Array(8), deviceId: "A" },
+			{ id: "b1", rom: new Uint8Array(8), deviceId: "B" },
+			{ id: "b2", rom: new Uint8Array(8), deviceId: "B" },
+			{ id: "a2", rom: new Uint8Array(8), deviceId: "A" },
+		]);
+
+		expect(results.map((result) => result.status)).toEqual([
+			"done",
+			"failed",
+			"failed",
+			"done",
+		]);
+		expect(results[1]?.error?.message).toBe("Write failed on B");
+		expect(results[2]?.error?.message).toBe(
+			"No available worker for device B",
+		);
+		expect(log.map((entry) => entry.deviceId)).toEqual(["A", "A"]);
+	});
+
+	it("fails a job whose preparation throws without touching the device", async () => {
+		const { protocol, log } = createFlashProtocol({});
+		const orchestrator = new FlashOrchestrator(targets(protocol, "A"));
+
+		const results = await orchestrator.run([
+			{
+				id: "bad",
+				rom: new Uint8Array(8),
+				prepare: () => {
+					throw new Error("Checksum region out of range");
+				},
+			},
+			{ id: "good", rom: new Uint8Array(8) },
+		]);
+
+		expect(results.map((result) => result.status)).toEqual(["failed", "done"]);
+		expect(results[0]?.error?.message).toBe("Checksum region out of range");
+		expect(log).toHaveLength(1);
+	});
+
+	it("aggregates progress and tags events with job and device", async () => {
+		const { protocol } = createFlashProtocol({});
+		const progress: FlashOrchestratorProgress[] = [];
+		const onEvent = vi.fn();
+		const orchestrator = new FlashOrchestrator(targets(protocol, "A", "B"), {
+			onProgress: (update) => progress.push(structuredClone(update)),
+			onEvent,
+		});
+
+		await orchestrator.run([
+			{ id: "ecu-a", rom: new Uint8Array(100), deviceId: "A" },
+			{ id: "ecu-b", rom: new Uint8Array(300), deviceId: "B" },
+		]);
+
+		const last = progress.at(-1);
+		expect(last?.totalBytes).toBe(400);
+		expect(last?.bytesProcessed).toBe(400);
+		expect(last?.percentComplete).toBe(100);
+		expect(last?.completedJobs).toBe(2);
+		const percents = progress.map((update) => update.percentComplete);
+		expect(percents).toEqual([...percents].sort((a, b) => a - b));
+		expect(onEvent).toHaveBeenCalledWith(
+			"ecu-b",
+			"B",
+			expect.objectContaining({ type: "BOOT_MODE_ENTERED" }),
+		);
+	});
+
+	it("rejects targets whose protocol cannot write", () => {
+		const protocol: EcuProtocol = {
+			name: "Read Only",
+			canHandle: vi.fn().mockResolvedValue(true),
+		};
+		expect(() => new FlashOrchestrator(targets(protocol, "A"))).toThrow(
+			'Protocol "Read Only" on A does not support ROM writing',
+		);
+	});
+});
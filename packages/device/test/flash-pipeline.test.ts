@@ -0,0 +1,127 @@
+import { describe, expect, it } from "vitest";
+import {
+	type FlashBlockRef,
+	FlashWritePipeline,
+	type PreparedFlashSector,
+} from "../src/flash-pipeline.js";
+
+const SECTOR_SIZE = 0x100;
+const BLOCK_SIZE = 0x40;
+
+function makeRom(sectors: number): Uint8Array {
+	const rom = new Uint8Array(sectors * SECTOR_SIZE);
+	for (let i = 0; i < rom.length; i++) {
+		rom[i] = (i * 7) & 0xff;
+	}
+	return rom;
+}
+
+function createPipeline(rom: Uint8Array, originalRom?: Uint8Array) {
+	return new FlashWritePipeline(rom, {
+		sectorSize: SECTOR_SIZE,
+		blockSize: BLOCK_SIZE,
+		headerLength: 2,
+		writeHeader: (frame, { blockInSector }) => {
+			frame[0] = 0x36;
+			frame[1] = blockInSector + 1;
+		},
+		originalRom,
+	});
+}
+
+describe("FlashWritePipeline", () => {
+	it("frames every block of every sector with its ROM bytes", async () => {
+		const rom = makeRom(3);
+		const sent: number[][] = [];
+		const sectors: number[] = [];
+
+		for await (const sector of createPipeline(rom)) {
+			sectors.push(sector.sectorIndex);
+			for (const frame of sector.frames) {
+				sent.push(Array.from(frame));
+			}
+		}
+
+		expect(sectors).toEqual([0, 1, 2]);
+		expect(sent).toHaveLength(3 * (SECTOR_SIZE / BLOCK_SIZE));
+		for (const [i, frame] of sent.entries()) {
+			const offset = i * BLOCK_SIZE;
+			expect(frame.slice(0, 2)).toEqual([0x36, (i % 4) + 1]);
+			expect(frame.slice(2)).toEqual(
+				Array.from(rom.subarray(offset, offset + BLOCK_SIZE)),
+			);
+		}
+	});
+
+	it("only yields sectors that differ from the original ROM", async () => {
+		const original = makeRom(4);
+		const rom = original.slice();
+		rom[0x110] = 0;
+		rom[0x3ff] = 0;
+		const pipeline = createPipeline(rom, original);
+
+		const sectors: number[] = [];
+		for await (const sector of pipeline) {
+			sectors.push(sector.sectorIndex);
+		}
+
+		expect(pipeline.sectors).toEqual([1, 3]);
+		expect(pipeline.totalBytes).toBe(2 * SECTOR_SIZE);
+		expect(sectors).toEqual([1, 3]);
+	});
+
+	it("passes block positions to the header writer", async () => {
+		const refs: FlashBlockRef[] = [];
+		const pipeline = new FlashWritePipeline(makeRom(2), {
+			sectorSize: SECTOR_SIZE,
+			blockSize: BLOCK_SIZE,
+			headerLength: 1,
+			writeHeader: (_frame, ref) => {
+				refs.push(ref);
+			},
+		});
+
+		for await (const _sector of pipeline) {
+			// Drain
+		}
+
+		expect(refs[5]).toEqual({
+			sectorIndex: 1,
+			blockInSector: 1,
+			block: 5,
+			offset: 5 * BLOCK_SIZE,
+		});
+	});
+
+	it("builds the next sector while the current one is being sent", async () => {
+		const rom = makeRom(2);
+		const pipeline = createPipeline(rom);
+		const iterator = pipeline[Symbol.asyncIterator]();
+
+		const first = (await iterator.next()).value as PreparedFlashSector;
+		// Stand-in for the bus round trips of sector 0
+		await new Promise((resolve) => setTimeout(resolve, 5));
+		expect(first.sectorIndex).toBe(0);
+
+		const second = (await iterator.next()).value as PreparedFlashSector;
+		expect(second.sectorIndex).toBe(1);
+		expect(Array.from(second.frames[0] ?? []).slice(2)).toEqual(
+			Array.from(rom.subarray(SECTOR_SIZE, SECTOR_SIZE + BLOCK_SIZE)),
+		);
+		expect((await iterator.next()).done).toBe(true);
+	});
+
+	it("reuses two frame buffers for any number of sectors", async () => {
+		const buffers = new Set<ArrayBufferLike>();
+		for await (const sector of createPipeline(makeRom(6))) {
+			buffers.add((sector.frames[0] as Uint8Array).buffer);
+		}
+		expect(buffers.size).toBe(2);
+	});
+
+	it("rejects ROMs that are not a whole number of sectors", () => {
+		expect(() => createPipeline(new Uint8Array(SECTOR_SIZE + 1))).toThrow(
+			`ROM size ${SECTOR_SIZE + 1} is not a multiple of sector size ${SECTOR_SIZE}`,
+		);
+	});
+});
@@ -0,0 +1,187 @@
+import { describe, expect, it, vi } from "vitest";
+import {
+	groupByRate,
+	LIVE_DATA_RATE_CLASSES,
+	LiveDataScheduler,
+	resolvePidRate,
+} from "../src/live-data-scheduler.js";
+import type { LiveDataHealth } from "../src/types.js";
+
+// ── Helpers ───────────────────────────────────────────────────────────────────
+
+function sleep(ms: number): Promise<void> {
+	return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+/** Poll task that records each run and emits one sample. */
+function countingTask(id: string, rateHz: number, costMs = 0) {
+	const runs: string[] = [];
+	return {
+		runs,
+		task: {
+			id,
+			rateHz,
+			run: async () => {
+				runs.push(id);
+				if (costMs > 0) await sleep(costMs);
+				return 1;
+			},
+		},
+	};
+}
+
+// ── Tests ─────────────────────────────────────────────────────────────────────
+
+describe("resolvePidRate()", () => {
+	it("uses the default rate class when no override is given", () => {
+		expect(resolvePidRate(0x05, "slow")).toBe(LIVE_DATA_RATE_CLASSES.slow);
+		expect(resolvePidRate(0x0c, "fast")).toBe(LIVE_DATA_RATE_CLASSES.fast);
+	});
+
+	it("prefers a positive per-PID override", () => {
+		const rates = new Map([
+			[0x05, 10],
+			[0x0c, 0],
+		]);
+		expect(resolvePidRate(0x05, "slow", rates)).toBe(10);
+		expect(resolvePidRate(0x0c, "fast", rates)).toBe(
+			LIVE_DATA_RATE_CLASSES.fast,
+		);
+	});
+});
+
+describe("groupByRate()", () => {
+	it("groups items by rate, fastest first, preserving order", () => {
+		const groups = groupByRate([1, 2, 3, 4], (n) => (n % 2 === 0 ? 1 : 20));
+		expect([...groups.keys()]).toEqual([20, 1]);
+		expect(groups.get(20)).toEqual([1, 3]);
+		expect(groups.get(1)).toEqual([2, 4]);
+	});
+});
+
+describe("LiveDataScheduler", () => {
+	it("runs the task with the earliest deadline first", async () => {
+		const order: string[] = [];
+		const scheduler = new LiveDataScheduler([
+			{ id: "slow", rateHz: 1, run: async () => (order.push("slow"), 1) },
+			{ id: "fast", rateHz: 50, run: async () => (order.push("fast"), 1) },
+		]);
+		scheduler.start();
+		await sleep(20);
+		scheduler.stop();
+
+		expect(order[0]).toBe("fast");
+		expect(order).toContain("slow");
+	});
+
+	it("polls each task in proportion to its target rate", async () => {
+		const fast = countingTask("fast", 100);
+		const slow = countingTask("slow", 10);
+		const scheduler = new LiveDataScheduler([fast.task, slow.task]);
+
+		scheduler.start();
+		await sleep(320);
+		scheduler.stop();
+
+		// 10 ms vs 100 ms periods; allow for timer jitter
+		expect(slow.runs.length).toBeGreaterThanOrEqual(3);
+		expect(slow.runs.length).toBeLessThanOrEqual(5);
+		expect(fast.runs.length).toBeGreaterThan(slow.runs.length * 4);
+	});
+
+	it("reports requested and achieved rates through health", async () => {
+		const health: LiveDataHealth[] = [];
+		const fast = countingTask("fast", 40);
+		const slow = countingTask("slow", 5);
+		const scheduler = new LiveDataScheduler([fast.task, slow.task], {
+			onHealth: (h) => health.push(h),
+			healthIntervalMs: 200,
+		});
+
+		scheduler.start();
+		await sleep(450);
+		scheduler.stop();
+
+		expect(health.length).toBeGreaterThan(0);
+		const report = health[0];
+		expect(report?.requestedHz).toBe(45);
+		expect(report?.tasks?.map((t) => t.id)).toEqual(["fast", "slow"]);
+		expect(report?.tasks?.[0]?.achievedHz).toBeGreaterThan(20);
+		expect(report?.samplesPerSecond).toBeGreaterThan(0);
+		expect(report?.status).toBe("healthy");
+	});
+
+	it("reports a degraded schedule and missed deadlines under overload", async () => {
+		const health: LiveDataHealth[] = [];
+		// 20 ms per poll cannot sustain 100 Hz
+		const busy = countingTask("busy", 100, 20);
+		const scheduler = new LiveDataScheduler([busy.task], {
+			onHealth: (h) => health.push(h),
+			healthIntervalMs: 200,
+		});
+
+		scheduler.start();
+		await sleep(450);
+		scheduler.stop();
+
+		const report = health[0];
+		expect(report?.status).toBe("degraded");
+		expect(report?.achievedHz).toBeLessThan(100);
+		expect(report?.tasks?.[0]?.missedDeadlines).toBeGreaterThan(0);
+		expect(report?.latencyMs).toBeGreaterThanOrEqual(15);
+	});
+
+	it("counts failed polls as dropped frames", async () => {
+		const health: LiveDataHealth[] = [];
+		const onError = vi.fn();
+		const scheduler = new LiveDataScheduler(
+			[
+				{
+					id: "broken",
+					rateHz: 50,
+					run: async () => {
+						throw new Error("timeout");
+					},
+				},
+			],
+			{ onHealth: (h) => health.push(h), healthIntervalMs: 100, onError },
+		);
+
+		scheduler.start();
+		await sleep(250);
+		scheduler.stop();
+
+		expect(onError).toHaveBeenCalled();
+		expect(health[0]?.droppedFrames).toBeGreaterThan(0);
+		expect(health[0]?.status).toBe("stalled");
+	});
+
+	it("stops polling after stop()", async () => {
+		const fast = countingTask("fast", 100);
+		const scheduler = new LiveDataScheduler([fast.task]);
+
+		scheduler.start();
+		await sleep(50);
+		scheduler.stop();
+		const countAfterStop = fast.runs.length;
+
+		await sleep(50);
+		expect(fast.runs.length).toBe(countAfterStop);
+		expect(scheduler.isRunning).toBe(false);
+	});
+
+	it("releases replacement tasks immediately after setTasks()", async () => {
+		const first = countingTask("first", 1);
+		const second = countingTask("second", 1);
+		const scheduler = new LiveDataScheduler([first.task]);
+
+		scheduler.start();
+		await sleep(20);
+		scheduler.setTasks([second.task]);
+		await sleep(20);
+		scheduler.stop();
+
+		expect(first.runs).toHaveLength(1);
+		expect(second.runs).toHaveLength(1);
+	});
+});
@@ -0,0 +1,212 @@
+import * as fs from "node:fs/promises";
+import * as os from "node:os";
+import * as path from "node:path";
+import { afterEach, beforeEach, describe, expect, it } from "vitest";
+import {
+	DiagnosticStage,
+	DiagnosticStatus,
+} from "../src/diagnostic-workflow.js";
+import {
+	exportTraceToJsonl,
+	readTraceRecords,
+	type TraceRecord,
+	TraceWriter,
+} from "../src/trace.js";
+
+async function readAll(tracePath: string): Promise<TraceRecord[]> {
+	const records: TraceRecord[] = [];
+	for await (const record of readTraceRecords(tracePath)) {
+		records.push(record);
+	}
+	return records;
+}
+
+describe("TraceWriter", () => {
+	let tmpDir: string;
+	let tracePath: string;
+
+	beforeEach(async () => {
+		tmpDir = await fs.mkdtemp(path.join(os.tmpdir(), "ecu-trace-"));
+		tracePath = path.join(tmpDir, "session.trace");
+	});
+
+	afterEach(async () => {
+		await fs.rm(tmpDir, { recursive: true, force: true });
+	});
+
+	it("round-trips events and raw transfers", async () => {
+		const trace = new TraceWriter(tracePath);
+		await trace.write({
+			stage: DiagnosticStage.PROBE,
+			status: DiagnosticStatus.START,
+			type: "protocol_probe",
+			timestamp: 1_700_000_000_000,
+			summary: "Probing protocols...",
+			duration: 12,
+		});
+		await trace.writeRawTransfer(
+			"out",
+			Uint8Array.of(0x01, 0xab, 0xff),
+			DiagnosticStage.CONNECT,
+			"ati",
+		);
+		await trace.writeInitializationFlow(
+			"ata",
+			Uint8Array.of(0x61),
+			Uint8Array.of(0x0d, 0x0a),
+			DiagnosticStage.CONNECT,
+		);
+		await trace.close();
+
+		const records = await readAll(tracePath);
+		expect(records).toHaveLength(3);
+		expect(records[0]).toMatchObject({
+			timestamp: "2023-11-14T22:13:20.000Z",
+			event_type: "protocol_probe",
+			summary: "Probing protocols...",
+			duration_ms: 12,
+		});
+		expect(records[1]).toMatchObject({
+			event_type: "raw_transfer",
+			direction: "out",
+			raw: "01 ab ff",
+		});
+		expect(records[2]?.raw).toBe("61");
+		expect(records[2]?.details).toEqual({
+			command: "ata",
+			response_raw: "0d 0a",
+		});
+	});
+
+	it("stores raw bytes as binary rather than hex", async () => {
+		const trace = new TraceWriter(tracePath);
+		const payload = new Uint8Array(4096).fill(0x5a);
+		await trace.writeRawTransfer(
+			"in",
+			payload,
+			DiagnosticStage.OPERATION,
+			"block",
+		);
+		await trace.close();
+
+		const { size } = await fs.stat(tracePath);
+		expect(size).toBeGreaterThan(payload.length);
+		expect(size).toBeLessThan(payload.length + 512);
+	});
+
+	it("omits raw payloads when includeRaw is false", async () => {
+		const trace = new TraceWriter(tracePath, {
+			outputPath: tracePath,
+			includeRaw: false,
+		});
+		await trace.writeLoggingEvent(
+			"logging_frame",
+			Uint8Array.of(1, 2, 3),
+			"frame",
+		);
+		await trace.close();
+
+		const [record] = await readAll(tracePath);
+		expect(record?.raw).toBeUndefined();
+	});
+
+	it("streams blocks to disk before close", async () => {
+		const trace = new TraceWriter(tracePath, {
+			outputPath: tracePath,
+			blockSize: 1024,
+		});
+		for (let i = 0; i < 64; i++) {
+			await trace.writeLoggingEvent(
+				"logging_frame",
+				new Uint8Array(100).fill(i),
+				`frame ${i}`,
+			);
+		}
+		await trace.flush();
+
+		// Readable while the writer is still open
+		const records = await readAll(tracePath);
+		expect(records).toHaveLength(64);
+		expect(records[63]?.summary).toBe("frame 63");
+		await trace.close();
+	});
+
+	it("flushes a partial block after flushIntervalMs", async () => {
+		const trace = new TraceWriter(tracePath, {
+			outputPath: tracePath,
+			flushIntervalMs: 5,
+		});
+		await trace.writeProtocolProbe("SSM", true);
+		await new Promise((resolve) => setTimeout(resolve, 50));
+
+		expect(await readAll(tracePath)).toHaveLength(1);
+		await trace.close();
+	});
+
+	it("writes records larger than a block", async () => {
+		const trace = new TraceWriter(tracePath, {
+			outputPath: tracePath,
+			blockSize: 256,
+		});
+		const payload = new Uint8Array(2000).map((_, i) => i & 0xff);
+		await trace.writeRawTransfer("in", payload, DiagnosticStage.OPERATION, "");
+		await trace.writeProtocolProbe("UDS", false);
+		await trace.close();
+
+		const records = await readAll(tracePath);
+		expect(records).toHaveLength(2);
+		expect(records[0]?.raw?.length).toBe(2000 * 3 - 1);
+		expect(records[1]?.event_type).toBe("protocol_probe");
+	});
+
+	it("ignores a record truncated by a crash", async () => {
+		const trace = new TraceWriter(tracePath);
+		await trace.writeProtocolProbe("SSM", true);
+		await trace.writeProtocolProbe("UDS", false);
+		await trace.close();
+
+		const bytes = await fs.readFile(tracePath);
+		await fs.writeFile(tracePath, bytes.subarray(0, bytes.length - 3));
+
+		const records = await readAll(tracePath);
+		expect(records).toHaveLength(1);
+		expect(records[0]?.details?.protocol).toBe("SSM");
+	});
+
+	it("rejects writes after close", async () => {
+		const trace = new TraceWriter(tracePath);
+		await trace.close();
+		await expect(trace.writeProtocolProbe("SSM", true)).rejects.toThrow(
+			"TraceWriter is closed",
+		);
+		expect(await readAll(tracePath)).toEqual([]);
+	});
+
+	it("exports JSON Lines", async () => {
+		const trace = new TraceWriter(tracePath);
+		await trace.writeProtocolProbe("SSM", true);
+		await trace.writeRawTransfer(
+			"in",
+			Uint8Array.of(0x7e),
+			DiagnosticStage.PROBE,
+			"reply",
+		);
+		await trace.close();
+
+		const jsonlPath = path.join(tmpDir, "session.jsonl");
+		const count = await exportTraceToJsonl(tracePath, jsonlPath);
+
+		const lines = (await fs.readFile(jsonlPath, "utf-8")).trimEnd().split("\n");
+		expect(count).toBe(2);
+		expect(lines.map((line) => JSON.parse(line).event_type)).toEqual([
+			"protocol_probe",
+			"raw_transfer",
+		]);
+		expect(JSON.parse(lines[1] as string).raw).toBe("7e");
+	});
+
+	it("rejects files that are not traces", async () => {
+		await fs.writeFile(tracePath, '{"event_type":"trace"}\n');
+		await expect(readAll(tracePath)).rejects.toThrow("is not a trace file");
+	});
+});
@@ -54,6 +54,11 @@ export class FlowControlManager {
 		return this.config.maxRetries;
 	}
 
+	/** Get response timeout configured */
+	getResponseTimeoutMs(): number {
+		return this.config.responseTimeoutMs;
+	}
+
 	/**
 	 * Transition to "waiting for CTS" state
 	 * Sets up a timeout to trigger if CTS is not received
@@ -10,6 +10,7 @@ export {
 	encodeFrame,
 	extractPayload,
 	getFrameLength,
+	isAddressedFrame,
 	parseFrames,
 	validateChecksum,
 } from "./iso14230-framing.js";
@@ -18,5 +19,7 @@ export {
 	type FlowControlConfig,
 	FlowControlState,
 	type Frame,
+	type FrameAddress,
+	type FrameHeaderOptions,
 	type KLineHealth,
 } from "./types.js";
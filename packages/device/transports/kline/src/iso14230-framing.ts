@@ -2,22 +2,33 @@
  * ISO 14230 K-line framing encoder/decoder
  *
  * Implements the data link layer frame format:
- * [PCI byte][Payload bytes...][Checksum byte]
+ * [Fmt][Tgt][Src][Len][Payload bytes...][Checksum]
  *
- * PCI (Protocol Control Information) format:
- * - Bits 7-4: Reserved (0x0)
- * - Bits 3-0: Length of payload (0x0-0xF, max 15 bytes)
+ * Format byte:
+ * - Bits 7-6: Address mode (00 = no address bytes, 10 = physical,
+ *   11 = functional). Target and source bytes follow for 10 and 11.
+ * - Bits 5-0: Length of payload (1-63), or 0 when a separate length byte
+ *   follows the address bytes (payloads of up to 255 bytes)
  *
- * Checksum: Sum of (PCI + all payload bytes) & 0xFF
+ * Checksum: Sum of (all header bytes + all payload bytes) & 0xFF
+ *
+ * Short MUT-III frames use the smallest form, `[0x0N][Payload][Checksum]`.
+ * SSM packets (`0x80 dest src len ... checksum`) are physically addressed
+ * frames that always carry a length byte.
  */
 
-import type { Frame } from "./types.js";
+import type { Frame, FrameAddress, FrameHeaderOptions } from "./types.js";
 
-/**
- * Maximum single-frame payload size for K-line (7 bytes typical, 15 max per PCI format)
- * For simplicity, we enforce 7-byte limit to match MUT-III single-frame protocol
- */
-const MAX_PAYLOAD_LENGTH = 7;
+/** Largest payload a length byte can describe */
+const MAX_PAYLOAD_LENGTH = 0xff;
+/** Largest payload the format byte itself can describe */
+const MAX_FORMAT_LENGTH = 0x3f;
+
+const ADDRESS_MODE_MASK = 0xc0;
+const ADDRESS_MODE_PHYSICAL = 0x80;
+const ADDRESS_MODE_FUNCTIONAL = 0xc0;
+// Physical and functional modes are followed by target and source bytes
+const ADDRESS_BYTES_FLAG = 0x80;
 
 /**
  * Calculate ISO 14230 checksum for a buffer
@@ -37,12 +48,12 @@ export function calculateChecksum(data: Uint8Array): number {
 /**
  * Validate checksum of a frame
  *
- * @param frameData - Complete frame data (PCI + payload + checksum)
+ * @param frameData - Complete frame data (header + payload + checksum)
  * @returns true if checksum is valid, false otherwise
  */
 export function validateChecksum(frameData: Uint8Array): boolean {
 	if (frameData.length < 2) {
-		return false; // Frame too short (need at least PCI + checksum)
+		return false; // Frame too short (need at least format byte + checksum)
 	}
 
 	// Calculate expected checksum from all bytes except the last one
@@ -56,15 +67,27 @@ export function validateChecksum(frameData: Uint8Array): boolean {
 /**
  * Encode a payload into an ISO 14230 frame
  *
- * Frame structure: [PCI][Payload...][Checksum]
- * PCI = 0x0N where N is payload length (0x01-0x07)
- * Checksum = sum of (PCI + payload) & 0xFF
+ * Frame structure: [Fmt][Tgt][Src][Len][Payload...][Checksum], where the
+ * address bytes are only present with `options.address`, and the length
+ * byte only for payloads over 63 bytes or with `options.lengthByte`.
  *
- * @param payload - The payload bytes (1-7 bytes)
+ * @param payload - The payload bytes (1-255 bytes)
+ * @param options - Address bytes and length byte placement
  * @returns The complete ISO 14230 frame
  * @throws Error if payload length exceeds MAX_PAYLOAD_LENGTH
+ *
+ * @example
+ * encodeFrame(new Uint8Array([0xe5])); // => [0x01, 0xE5, 0xE6]
+ * // SSM read of address 0x000008 from the TCU
+ * encodeFrame(new Uint8Array([0xa8, 0x00, 0x00, 0x00, 0x08]), {
+ *   address: { target: 0x18, source: 0xf0 },
+ *   lengthByte: true,
+ * }); // => [0x80, 0x18, 0xF0, 0x05, 0xA8, 0x00, 0x00, 0x00, 0x08, 0x3D]
  */
-export function encodeFrame(payload: Uint8Array): Uint8Array {
+export function encodeFrame(
+	payload: Uint8Array,
+	options: FrameHeaderOptions = {},
+): Uint8Array {
 	if (payload.length === 0) {
 		throw new Error("K-line payload cannot be empty");
 	}
@@ -75,18 +98,35 @@ export function encodeFrame(payload: Uint8Array): Uint8Array {
 		);
 	}
 
-	// Create frame: [PCI][Payload][Checksum]
-	const frame = new Uint8Array(payload.length + 2);
+	const { address } = options;
+	const lengthByte =
+		options.lengthByte === true || payload.length > MAX_FORMAT_LENGTH;
+	const headerLength = 1 + (address ? 2 : 0) + (lengthByte ? 1 : 0);
 
-	// PCI byte: 0x0N where N = payload length
-	const pci = 0x00 | payload.length;
-	frame[0] = pci;
+	// Create frame: [Fmt][Tgt][Src][Len][Payload][Checksum]
+	const frame = new Uint8Array(headerLength + payload.length + 1);
+
+	let format = lengthByte ? 0 : payload.length;
+	if (address) {
+		format |= address.functional
+			? ADDRESS_MODE_FUNCTIONAL
+			: ADDRESS_MODE_PHYSICAL;
+	}
+	let offset = 0;
+	frame[offset++] = format;
+	if (address) {
+		frame[offset++] = address.target;
+		frame[offset++] = address.source;
+	}
+	if (lengthByte) {
+		frame[offset++] = payload.length;
+	}
 
 	// Copy payload
-	frame.set(payload, 1);
+	frame.set(payload, offset);
 
-	// Calculate checksum: sum of PCI + payload
-	const checksumData = frame.slice(0, -1);
+	// Calculate checksum: sum of header + payload
+	const checksumData = frame.subarray(0, -1);
 	const checksum = calculateChecksum(checksumData);
 	frame[frame.length - 1] = checksum;
 
@@ -96,35 +136,23 @@ export function encodeFrame(payload: Uint8Array): Uint8Array {
 /**
  * Decode an ISO 14230 frame and extract the payload
  *
- * Frame structure: [PCI][Payload...][Checksum]
- * PCI = 0x0N where N is payload length
- *
- * @param frameData - The complete frame data including PCI, payload, and checksum
- * @returns Object with payload bytes and validity flag
+ * @param frameData - The complete frame data including header, payload, and checksum
+ * @returns Object with payload bytes, address (if any) and validity flag
  */
 export function decodeFrame(frameData: Uint8Array): Frame {
-	// Minimum frame: PCI + at least 1 payload byte + checksum = 3 bytes
-	if (frameData.length < 3) {
-		return {
-			data: frameData,
-			payload: new Uint8Array(0),
-			isValid: false,
-		};
-	}
+	const header = parseHeader(frameData, 0);
 
-	// Extract PCI byte
-	const pci = frameData[0];
-	if (pci === undefined) {
+	// Minimum frame: format byte + at least 1 payload byte + checksum
+	if (header === null || header.payloadLength === 0) {
 		return {
 			data: frameData,
 			payload: new Uint8Array(0),
 			isValid: false,
 		};
 	}
-	const payloadLength = pci & 0x0f; // Bits 0-3 = length
 
-	// Validate frame length: PCI + payload + checksum
-	const expectedFrameLength = 1 + payloadLength + 1;
+	// Validate frame length: header + payload + checksum
+	const expectedFrameLength = header.headerLength + header.payloadLength + 1;
 	if (frameData.length < expectedFrameLength) {
 		return {
 			data: frameData,
@@ -134,7 +162,10 @@ export function decodeFrame(frameData: Uint8Array): Frame {
 	}
 
 	// Extract payload
-	const payload = frameData.slice(1, 1 + payloadLength);
+	const payload = frameData.slice(
+		header.headerLength,
+		header.headerLength + header.payloadLength,
+	);
 
 	// Validate checksum
 	const isValid = validateChecksum(frameData.slice(0, expectedFrameLength));
@@ -142,6 +173,7 @@ export function decodeFrame(frameData: Uint8Array): Frame {
 	return {
 		data: frameData.slice(0, expectedFrameLength),
 		payload,
+		...(header.address ? { address: header.address } : {}),
 		isValid,
 	};
 }
@@ -151,24 +183,18 @@ export function decodeFrame(frameData: Uint8Array): Frame {
  * Useful for processing received data that may contain multiple frames or partial frames
  *
  * @param buffer - Buffer that may contain one or more frames
- * @returns Array of parsed frames (only complete, valid frames are returned)
+ * @returns Array of parsed frames (only complete frames are returned)
  */
 export function parseFrames(buffer: Uint8Array): Frame[] {
 	const frames: Frame[] = [];
 	let offset = 0;
 
 	while (offset < buffer.length) {
-		// Need at least PCI byte to determine frame length
-		if (offset >= buffer.length) {
-			break;
-		}
-
-		const pci = buffer[offset];
-		if (pci === undefined) {
-			break;
+		const header = parseHeader(buffer, offset);
+		if (header === null) {
+			break; // Incomplete header, stop parsing
 		}
-		const payloadLength = pci & 0x0f;
-		const expectedFrameLength = 1 + payloadLength + 1; // PCI + payload + checksum
+		const expectedFrameLength = header.headerLength + header.payloadLength + 1;
 
 		// Check if we have a complete frame
 		if (offset + expectedFrameLength > buffer.length) {
@@ -187,14 +213,38 @@ export function parseFrames(buffer: Uint8Array): Frame[] {
 }
 
 /**
- * Get the total frame length (including PCI and checksum) from a PCI byte
+ * Get the total frame length (including header and checksum) from its
+ * format byte
  *
- * @param pci - The PCI byte (0x0N where N = payload length)
+ * @param format - The format byte
+ * @param lengthByte - The separate length byte, used when the format byte's
+ *   length bits are 0
  * @returns Total frame length in bytes
  */
-export function getFrameLength(pci: number): number {
-	const payloadLength = pci & 0x0f;
-	return 1 + payloadLength + 1; // PCI + payload + checksum
+export function getFrameLength(format: number, lengthByte = 0): number {
+	const formatLength = format & MAX_FORMAT_LENGTH;
+	const addressLength = (format & ADDRESS_BYTES_FLAG) === 0 ? 0 : 2;
+	const headerLength = 1 + addressLength + (formatLength === 0 ? 1 : 0);
+	const payloadLength = formatLength === 0 ? lengthByte : formatLength;
+	return headerLength + payloadLength + 1; // header + payload + checksum
+}
+
+/**
+ * Whether `data` is exactly one complete ISO 14230 frame with address bytes
+ * and a valid checksum, such as an SSM packet
+ *
+ * @param data - Bytes to check
+ * @returns true if `data` can be sent as-is
+ */
+export function isAddressedFrame(data: Uint8Array): boolean {
+	const header = parseHeader(data, 0);
+	return (
+		header !== null &&
+		header.address !== undefined &&
+		header.payloadLength > 0 &&
+		data.length === header.headerLength + header.payloadLength + 1 &&
+		validateChecksum(data)
+	);
 }
 
 /**
@@ -205,19 +255,67 @@ export function getFrameLength(pci: number): number {
  * @returns Payload bytes, or empty array if frame is too short
  */
 export function extractPayload(frameData: Uint8Array): Uint8Array {
-	if (frameData.length < 3) {
+	const header = parseHeader(frameData, 0);
+	if (header === null || header.payloadLength === 0) {
 		return new Uint8Array(0);
 	}
 
-	const pci = frameData[0];
-	if (pci === undefined) {
+	const end = header.headerLength + header.payloadLength;
+	if (frameData.length < end + 1) {
 		return new Uint8Array(0);
 	}
-	const payloadLength = pci & 0x0f;
 
-	if (frameData.length < 1 + payloadLength + 1) {
-		return new Uint8Array(0);
+	return frameData.slice(header.headerLength, end);
+}
+
+/**
+ * Read the header at `offset`
+ *
+ * @returns Header and payload lengths plus address bytes, or null if the
+ *   buffer ends inside the header
+ */
+function parseHeader(
+	buffer: Uint8Array,
+	offset: number,
+): {
+	headerLength: number;
+	payloadLength: number;
+	address?: FrameAddress;
+} | null {
+	const format = buffer[offset];
+	if (format === undefined) {
+		return null;
+	}
+
+	let headerLength = 1;
+	let address: FrameAddress | undefined;
+	if ((format & ADDRESS_BYTES_FLAG) !== 0) {
+		const target = buffer[offset + 1];
+		const source = buffer[offset + 2];
+		if (target === undefined || source === undefined) {
+			return null;
+		}
+		address = {
+			target,
+			source,
+			...((format & ADDRESS_MODE_MASK) === ADDRESS_MODE_FUNCTIONAL
+				? { functional: true }
+				: {}),
+		};
+		headerLength += 2;
+	}
+
+	let payloadLength = format & MAX_FORMAT_LENGTH;
+	if (payloadLength === 0) {
+		const lengthByte = buffer[offset + headerLength];
+		if (lengthByte === undefined) {
+			return null;
+		}
+		payloadLength = lengthByte;
+		headerLength += 1;
 	}
 
-	return frameData.slice(1, 1 + payloadLength);
+	return address
+		? { headerLength, payloadLength, address }
+		: { headerLength, payloadLength };
 }
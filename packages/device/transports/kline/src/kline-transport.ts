@@ -9,14 +9,22 @@ import type {
 	DeviceTransport,
 } from "@ecu-explorer/device";
 import { FlowControlManager } from "./flow-control.js";
-import { decodeFrame, encodeFrame } from "./iso14230-framing.js";
+import {
+	decodeFrame,
+	encodeFrame,
+	getFrameLength,
+	isAddressedFrame,
+} from "./iso14230-framing.js";
 import type { FlowControlConfig, KLineHealth } from "./types.js";
 import { FlowControlState } from "./types.js";
 
+// Format byte + 2 address bytes + length byte + 255 payload bytes + checksum
+const MAX_FRAME_LENGTH = 260;
+
 /**
  * Mock serial port for testing (in real implementation, use serial API or OpenPort J2534)
  */
-interface MockSerialPort {
+export interface MockSerialPort {
 	write(data: Uint8Array): Promise<void>;
 	read(maxLength: number): Promise<Uint8Array>;
 	close(): Promise<void>;
@@ -40,7 +48,8 @@ export class KLineConnection implements DeviceConnection {
 
 	private port: MockSerialPort | null = null;
 	private flowControl: FlowControlManager;
-	private receiveQueue: Uint8Array[] = [];
+	/** Received bytes not yet consumed as a frame */
+	private rxBuffer = new Uint8Array(0);
 	private streamActive = false;
 	private streamAbortController: AbortController | null = null;
 
@@ -67,20 +76,30 @@ export class KLineConnection implements DeviceConnection {
 	 * Send a frame with ISO 14230 framing and flow control
 	 * Handles CTS handshake, retries on timeout/checksum error
 	 *
-	 * @param data - Payload to send (1-7 bytes)
+	 * A complete frame with address bytes and a valid checksum (e.g. an SSM
+	 * packet) is sent as-is, without the CTS handshake, and the response
+	 * frame is returned whole. Any other data is a payload, framed without
+	 * address bytes.
+	 *
+	 * @param data - Payload (1-255 bytes) or complete addressed frame
 	 * @param timeoutMs - Override timeout in milliseconds
-	 * @returns Response payload from ECU
+	 * @returns Response payload from ECU, or the response frame for an
+	 *   addressed request
 	 */
 	async sendFrame(data: Uint8Array, timeoutMs?: number): Promise<Uint8Array> {
 		if (!this.port || !this.port.isOpen()) {
 			throw new Error("K-line port not open");
 		}
 
-		if (data.length === 0 || data.length > 7) {
-			throw new Error("K-line payload must be 1-7 bytes");
+		const effectiveTimeout = timeoutMs ?? 500;
+		if (isAddressedFrame(data)) {
+			return this.sendAddressedFrame(data, effectiveTimeout);
+		}
+
+		if (data.length === 0 || data.length > 255) {
+			throw new Error("K-line payload must be 1-255 bytes");
 		}
 
-		const effectiveTimeout = timeoutMs ?? 500;
 		const maxRetries = this.flowControl.getMaxRetries();
 
 		while (this.flowControl.getRetryCount() < maxRetries) {
@@ -108,7 +127,10 @@ export class KLineConnection implements DeviceConnection {
 				}
 
 				// Now read the response frame
-				const responseData = await this.readWithTimeout(64, effectiveTimeout);
+				const responseData = await this.readWithTimeout(
+					MAX_FRAME_LENGTH,
+					effectiveTimeout,
+				);
 				if (responseData.length === 0) {
 					// Response timeout
 					this.health.timeoutErrors++;
@@ -154,7 +176,10 @@ export class KLineConnection implements DeviceConnection {
 
 	/**
 	 * Start streaming frames asynchronously
-	 * Not fully implemented for Phase 1 - placeholder for Phase 2
+	 *
+	 * Reads the port until {@link stopStream} and reports each received
+	 * frame with a valid checksum: addressed frames whole (as
+	 * {@link sendFrame} returns them), others as their payload.
 	 *
 	 * @param onFrame - Callback for each received frame
 	 */
@@ -166,15 +191,23 @@ export class KLineConnection implements DeviceConnection {
 		const poll = async (): Promise<void> => {
 			while (this.streamActive && !signal.aborted) {
 				try {
-					if (this.receiveQueue.length > 0) {
-						const frame = this.receiveQueue.shift();
-						if (frame) {
-							onFrame(frame);
-						}
+					const frame = await this.readFrame(
+						this.flowControl.getResponseTimeoutMs(),
+					);
+					if (signal.aborted) break;
+					if (frame === null) {
+						// Sleep to avoid busy-waiting
+						await new Promise((resolve) => setTimeout(resolve, 10));
+						continue;
 					}
 
-					// Sleep to avoid busy-waiting
-					await new Promise((resolve) => setTimeout(resolve, 10));
+					const decoded = decodeFrame(frame);
+					if (!decoded.isValid) {
+						this.health.checksumErrors++;
+						continue;
+					}
+					this.health.framesReceived++;
+					onFrame(decoded.address ? decoded.data : decoded.payload);
 				} catch {
 					this.streamActive = false;
 				}
@@ -225,6 +258,105 @@ export class KLineConnection implements DeviceConnection {
 		};
 	}
 
+	/**
+	 * Send a complete addressed frame and wait for the addressed frame that
+	 * answers it. K-line is half-duplex, so an echo of the request is
+	 * skipped.
+	 *
+	 * @param frame - Complete frame to send as-is
+	 * @param timeoutMs - Response timeout per attempt
+	 * @returns The response frame, including header and checksum
+	 */
+	private async sendAddressedFrame(
+		frame: Uint8Array,
+		timeoutMs: number,
+	): Promise<Uint8Array> {
+		const maxRetries = this.flowControl.getMaxRetries();
+		let failure = "Response timeout";
+		for (let attempt = 0; attempt < maxRetries; attempt++) {
+			if (attempt > 0) {
+				this.health.retries++;
+			}
+			// Stale bytes from an earlier exchange would misalign the response
+			this.rxBuffer = new Uint8Array(0);
+			await this.port?.write(frame);
+			this.health.framesSent++;
+
+			const deadline = Date.now() + timeoutMs;
+			let response = await this.readFrame(timeoutMs);
+			while (response !== null && sameBytes(response, frame)) {
+				response = await this.readFrame(Math.max(0, deadline - Date.now()));
+			}
+			if (response === null) {
+				this.health.timeoutErrors++;
+				failure = "Response timeout";
+				continue;
+			}
+			if (!decodeFrame(response).isValid) {
+				this.health.checksumErrors++;
+				failure = "Invalid checksum";
+				continue;
+			}
+
+			this.health.framesReceived++;
+			return response;
+		}
+
+		throw new Error(`${failure} - max retries exceeded`);
+	}
+
+	/**
+	 * Read until one complete frame is buffered
+	 *
+	 * @param timeoutMs - Time to wait for the rest of the frame
+	 * @returns The frame bytes (not validated), or null on timeout
+	 */
+	private async readFrame(timeoutMs: number): Promise<Uint8Array | null> {
+		const deadline = Date.now() + timeoutMs;
+		for (;;) {
+			const frame = this.takeBufferedFrame();
+			if (frame !== null) {
+				return frame;
+			}
+			const chunk = await this.readWithTimeout(
+				MAX_FRAME_LENGTH,
+				Math.max(0, deadline - Date.now()),
+			);
+			if (chunk.length === 0) {
+				return null;
+			}
+			const buffered = new Uint8Array(this.rxBuffer.length + chunk.length);
+			buffered.set(this.rxBuffer);
+			buffered.set(chunk, this.rxBuffer.length);
+			this.rxBuffer = buffered;
+		}
+	}
+
+	/** Remove and return the first frame in the receive buffer, if complete */
+	private takeBufferedFrame(): Uint8Array | null {
+		const format = this.rxBuffer[0];
+		if (format === undefined) {
+			return null;
+		}
+		let lengthByte = 0;
+		if ((format & 0x3f) === 0) {
+			const lengthByteIndex = (format & 0x80) === 0 ? 1 : 3;
+			const value = this.rxBuffer[lengthByteIndex];
+			if (value === undefined) {
+				return null;
+			}
+			lengthByte = value;
+		}
+
+		const length = getFrameLength(format, lengthByte);
+		if (this.rxBuffer.length < length) {
+			return null;
+		}
+		const frame = this.rxBuffer.slice(0, length);
+		this.rxBuffer = this.rxBuffer.slice(length);
+		return frame;
+	}
+
 	/**
 	 * Read from port with timeout
 	 *
@@ -259,6 +391,18 @@ export class KLineConnection implements DeviceConnection {
 	}
 }
 
+function sameBytes(a: Uint8Array, b: Uint8Array): boolean {
+	if (a.length !== b.length) {
+		return false;
+	}
+	for (let i = 0; i < a.length; i++) {
+		if (a[i] !== b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
 /**
  * K-line transport implementing DeviceTransport interface
  * Provides device enumeration and connection management for ISO 14230 K-line
@@ -14,12 +14,35 @@ export enum FlowControlState {
 	ERROR = "ERROR",
 }
 
+/** Target and source address bytes of an ISO 14230 header */
+export interface FrameAddress {
+	/** Target address (e.g. 0x18 for a Subaru TCU) */
+	target: number;
+	/** Source address (e.g. 0xF0 for a tester) */
+	source: number;
+	/** Functional rather than physical addressing (default: false) */
+	functional?: boolean;
+}
+
+/** Header options for `encodeFrame()` */
+export interface FrameHeaderOptions {
+	/** Address bytes; omit for a header without address information */
+	address?: FrameAddress;
+	/**
+	 * Carry the length in a separate byte even when it fits the format byte.
+	 * SSM packets always do. Payloads over 63 bytes always use a length byte.
+	 */
+	lengthByte?: boolean;
+}
+
 /** Represents a frame with payload and checksum information */
 export interface Frame {
-	/** The raw frame data including PCI, payload, and checksum */
+	/** The raw frame data including header, payload, and checksum */
 	data: Uint8Array;
-	/** The payload portion (without PCI and checksum) */
+	/** The payload portion (without header and checksum) */
 	payload: Uint8Array;
+	/** Address bytes, when the header carries them */
+	address?: FrameAddress;
 	/** Whether the frame has a valid checksum */
 	isValid: boolean;
 }
@@ -10,6 +10,7 @@ import {
 	encodeFrame,
 	extractPayload,
 	getFrameLength,
+	isAddressedFrame,
 	parseFrames,
 	validateChecksum,
 } from "../src/iso14230-framing.js";
@@ -111,7 +112,7 @@ describe("encodeFrame", () => {
 		);
 	});
 
-	it("encodes 7-byte payload (maximum)", () => {
+	it("encodes 7-byte payload", () => {
 		const payload = new Uint8Array([0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07]);
 		const frame = encodeFrame(payload);
 
@@ -130,11 +131,45 @@ describe("encodeFrame", () => {
 		);
 	});
 
-	it("throws on oversized payload (>7 bytes)", () => {
-		const payload = new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8]);
+	it("throws on oversized payload (>255 bytes)", () => {
+		const payload = new Uint8Array(256);
 		expect(() => encodeFrame(payload)).toThrow(/exceeds maximum length/);
 	});
 
+	it("moves payloads over 63 bytes into a length byte", () => {
+		const payload = new Uint8Array(64).fill(0x01);
+		const frame = encodeFrame(payload);
+
+		// Format 0x00, length byte 0x40, payload, checksum
+		expect(frame.length).toBe(67);
+		expect(frame[0]).toBe(0x00);
+		expect(frame[1]).toBe(0x40);
+		expect(validateChecksum(frame)).toBe(true);
+	});
+
+	it("encodes an SSM A8 request as a physically addressed frame", () => {
+		const payload = new Uint8Array([0xa8, 0x00, 0x00, 0x00, 0x08]);
+		const frame = encodeFrame(payload, {
+			address: { target: 0x18, source: 0xf0 },
+			lengthByte: true,
+		});
+
+		expect(frame).toEqual(
+			new Uint8Array([
+				0x80, 0x18, 0xf0, 0x05, 0xa8, 0x00, 0x00, 0x00, 0x08, 0x3d,
+			]),
+		);
+	});
+
+	it("encodes a functionally addressed frame without a length byte", () => {
+		const frame = encodeFrame(new Uint8Array([0x81]), {
+			address: { target: 0x33, source: 0xf1, functional: true },
+		});
+
+		// Checksum = (0xC1 + 0x33 + 0xF1 + 0x81) & 0xFF = 0x66
+		expect(frame).toEqual(new Uint8Array([0xc1, 0x33, 0xf1, 0x81, 0x66]));
+	});
+
 	it("encodes E5 read command", () => {
 		const payload = new Uint8Array([0xe5]); // Read word
 		const frame = encodeFrame(payload);
@@ -366,9 +401,9 @@ describe("getFrameLength", () => {
 		expect(getFrameLength(0x07)).toBe(9);
 	});
 
-	it("returns correct length for PCI 0x00", () => {
-		// PCI 0x00 = 0 payload + PCI + checksum = 2 bytes total
-		expect(getFrameLength(0x00)).toBe(2);
+	it("reads the length byte when PCI length bits are 0", () => {
+		// PCI 0x00 + length byte + 200 payload + checksum
+		expect(getFrameLength(0x00, 200)).toBe(203);
 	});
 
 	it("returns correct length for maximum PCI 0x0F", () => {
@@ -376,10 +411,11 @@ describe("getFrameLength", () => {
 		expect(getFrameLength(0x0f)).toBe(17);
 	});
 
-	it("ignores bits above 0x0F in PCI", () => {
-		// PCI with high bits set: uses lower 4 bits only
-		expect(getFrameLength(0xf1)).toBe(3); // Same as 0x01
-		expect(getFrameLength(0x83)).toBe(5); // Same as 0x03
+	it("counts address bytes for physical and functional modes", () => {
+		expect(getFrameLength(0xc1)).toBe(5); // Fmt + 2 address + 1 + checksum
+		expect(getFrameLength(0x83)).toBe(7);
+		// SSM: Fmt + 2 address + length byte + 6 + checksum
+		expect(getFrameLength(0x80, 6)).toBe(11);
 	});
 });
 
@@ -481,6 +517,18 @@ describe("Frame round-trip (encode/decode)", () => {
 		expect(decoded.payload).toEqual(original);
 	});
 
+	it("round-trip with address bytes and a 255-byte payload", () => {
+		const original = new Uint8Array(255).map((_, i) => i);
+		const encoded = encodeFrame(original, {
+			address: { target: 0x10, source: 0xf0 },
+		});
+		const decoded = decodeFrame(encoded);
+
+		expect(decoded.isValid).toBe(true);
+		expect(decoded.payload).toEqual(original);
+		expect(decoded.address).toEqual({ target: 0x10, source: 0xf0 });
+	});
+
 	it("round-trip multiple frames", () => {
 		const payloads = [
 			new Uint8Array([0x01]),
@@ -496,3 +544,30 @@ describe("Frame round-trip (encode/decode)", () => {
 		}
 	});
 });
+
+describe("isAddressedFrame", () => {
+	const ssmRequest = new Uint8Array([
+		0x80, 0x18, 0xf0, 0x05, 0xa8, 0x00, 0x00, 0x00, 0x08, 0x3d,
+	]);
+
+	it("accepts a complete SSM packet", () => {
+		expect(isAddressedFrame(ssmRequest)).toBe(true);
+	});
+
+	it("rejects a packet with a bad checksum", () => {
+		const corrupt = ssmRequest.slice();
+		corrupt[9] = 0x3e;
+		expect(isAddressedFrame(corrupt)).toBe(false);
+	});
+
+	it("rejects truncated or padded packets", () => {
+		expect(isAddressedFrame(ssmRequest.subarray(0, 9))).toBe(false);
+		expect(isAddressedFrame(new Uint8Array([...ssmRequest, 0x00]))).toBe(
+			false,
+		);
+	});
+
+	it("rejects frames without address bytes", () => {
+		expect(isAddressedFrame(new Uint8Array([0x01, 0x3e, 0x3f]))).toBe(false);
+	});
+});
@@ -5,9 +5,11 @@
 
 import type { DeviceInfo } from "@ecu-explorer/device";
 import { beforeEach, describe, expect, it, vi } from "vitest";
+import { encodeFrame } from "../src/iso14230-framing.js";
 import {
-	type KLineConnection,
+	KLineConnection,
 	KLineTransport,
+	type MockSerialPort,
 } from "../src/kline-transport.js";
 
 describe("KLineTransport", () => {
@@ -142,14 +144,14 @@ describe("KLineConnection", () => {
 
 	it("rejects empty payload", async () => {
 		await expect(connection.sendFrame(new Uint8Array([]))).rejects.toThrow(
-			"payload must be 1-7 bytes",
+			"payload must be 1-255 bytes",
 		);
 	});
 
 	it("rejects oversized payload", async () => {
-		const oversized = new Uint8Array(8);
+		const oversized = new Uint8Array(256);
 		await expect(connection.sendFrame(oversized)).rejects.toThrow(
-			"payload must be 1-7 bytes",
+			"payload must be 1-255 bytes",
 		);
 	});
 
@@ -215,6 +217,114 @@ describe("KLineConnection", () => {
 	});
 });
 
+describe("KLineConnection addressed frames", () => {
+	// SSM A8 read of 0x000008 from the TCU, and its E8 answer (0x42)
+	const request = new Uint8Array([
+		0x80, 0x18, 0xf0, 0x05, 0xa8, 0x00, 0x00, 0x00, 0x08, 0x3d,
+	]);
+	const response = new Uint8Array([0x80, 0xf0, 0x18, 0x02, 0xe8, 0x42, 0xb4]);
+
+	/** Port that answers each write with the given chunks, one per read */
+	function makeScriptedPort(
+		answer: (written: Uint8Array) => Uint8Array[],
+	): MockSerialPort & { written: Uint8Array[] } {
+		const pending: Uint8Array[] = [];
+		const written: Uint8Array[] = [];
+		return {
+			written,
+			async write(data) {
+				written.push(data.slice());
+				pending.push(...answer(data));
+			},
+			async read() {
+				return pending.shift() ?? new Uint8Array(0);
+			},
+			async close() {},
+			isOpen: () => true,
+		};
+	}
+
+	const deviceInfo: DeviceInfo = {
+		id: "kline:ssm",
+		name: "SSM test",
+		transportName: "k-line",
+		connected: true,
+	};
+
+	it("sends an SSM packet as-is and returns the whole response", async () => {
+		const port = makeScriptedPort(() => [response]);
+		const connection = new KLineConnection(deviceInfo, port);
+
+		const result = await connection.sendFrame(request);
+
+		expect(port.written).toEqual([request]);
+		expect(result).toEqual(response);
+		expect(connection.getHealth().framesReceived).toBe(1);
+	});
+
+	it("skips the request echo and reassembles a split response", async () => {
+		const port = makeScriptedPort((data) => [
+			data.slice(0, 6),
+			new Uint8Array([...data.subarray(6), ...response.subarray(0, 3)]),
+			response.slice(3),
+		]);
+		const connection = new KLineConnection(deviceInfo, port);
+
+		expect(await connection.sendFrame(request)).toEqual(response);
+	});
+
+	it("carries packets longer than 63 bytes", async () => {
+		// 84 addresses: the largest A8 request
+		const payload = new Uint8Array(2 + 84 * 3);
+		payload[0] = 0xa8;
+		const longRequest = encodeFrame(payload, {
+			address: { target: 0x18, source: 0xf0 },
+			lengthByte: true,
+		});
+		const longResponse = encodeFrame(new Uint8Array(85).fill(0x01, 1), {
+			address: { target: 0xf0, source: 0x18 },
+			lengthByte: true,
+		});
+		const port = makeScriptedPort(() => [longResponse]);
+		const connection = new KLineConnection(deviceInfo, port);
+
+		expect(longRequest.length).toBe(259);
+		expect(await connection.sendFrame(longRequest)).toEqual(longResponse);
+		expect(port.written[0]).toEqual(longRequest);
+	});
+
+	it("retries when the response checksum is wrong", async () => {
+		let attempts = 0;
+		const port = makeScriptedPort(() => {
+			attempts++;
+			if (attempts > 1) return [response];
+			const corrupt = response.slice();
+			corrupt[5] = 0x43;
+			return [corrupt];
+		});
+		const connection = new KLineConnection(deviceInfo, port);
+
+		expect(await connection.sendFrame(request)).toEqual(response);
+		expect(port.written).toHaveLength(2);
+		expect(connection.getHealth().checksumErrors).toBe(1);
+	});
+
+	it("streams each received packet whole", async () => {
+		const port = makeScriptedPort(() => []);
+		// A fast-poll TCU keeps answering without further requests
+		const chunks = [response, response.subarray(0, 2), response.subarray(2)];
+		port.read = async () => chunks.shift() ?? new Uint8Array(0);
+		const connection = new KLineConnection(deviceInfo, port);
+		const frames: Uint8Array[] = [];
+
+		connection.startStream((frame) => frames.push(frame.slice()));
+		await new Promise((resolve) => setTimeout(resolve, 50));
+		connection.stopStream();
+
+		expect(frames).toEqual([response, response]);
+	});
+});
+
 describe("K-line transport full flow", () => {
 	it("can enumerate devices and connect", async () => {
 		const transport = new KLineTransport();
@@ -0,0 +1,171 @@
+/**
+ * Routes reassembled receive messages to the requests waiting for them.
+ *
+ * With a single always-on USB reader, responses, unsolicited frames and
+ * streamed data all arrive through one path. Each outstanding request
+ * registers the CAN ID its response will come from; received messages are
+ * matched against that table, first-come first-served per CAN ID. Messages
+ * nobody is waiting for go to the stream listener, if one is attached.
+ *
+ * @module openport2/frame-dispatcher
+ */
+
+/**
+ * A request waiting for its response. Returned by
+ * {@link FrameDispatcher.expect}; await {@link PendingFrame.promise}.
+ */
+export interface PendingFrame {
+	readonly key: number;
+	readonly promise: Promise<Uint8Array>;
+}
+
+interface PendingEntry extends PendingFrame {
+	resolve: (frame: Uint8Array) => void;
+	reject: (error: unknown) => void;
+	timer: ReturnType<typeof setTimeout> | null;
+	sequence: number;
+}
+
+export class FrameDispatcher {
+	private readonly pending = new Map<number, PendingEntry[]>();
+	private pendingCount = 0;
+	private nextSequence = 0;
+	private listener: ((frame: Uint8Array) => void) | null = null;
+
+	/** True while a request is outstanding or a stream listener is attached */
+	get hasDemand(): boolean {
+		return this.pendingCount > 0 || this.listener != null;
+	}
+
+	/**
+	 * Register interest in the next message from `key` (a CAN ID).
+	 *
+	 * Register before sending the request so a fast response cannot arrive
+	 * ahead of its entry in the table.
+	 *
+	 * @param key - CAN ID the response is expected from
+	 * @param timeoutMs - Reject after this long without a response (0: never)
+	 * @param timeoutMessage - Error message used on timeout
+	 */
+	expect(
+		key: number,
+		timeoutMs: number,
+		timeoutMessage: string,
+	): PendingFrame {
+		let resolve!: (frame: Uint8Array) => void;
+		let reject!: (error: unknown) => void;
+		const promise = new Promise<Uint8Array>((res, rej) => {
+			resolve = res;
+			reject = rej;
+		});
+		const entry: PendingEntry = {
+			key,
+			promise,
+			resolve,
+			reject,
+			timer: null,
+			sequence: this.nextSequence++,
+		};
+		if (timeoutMs > 0) {
+			entry.timer = setTimeout(() => {
+				this.remove(entry);
+				reject(new Error(timeoutMessage));
+			}, timeoutMs);
+		}
+
+		const queue = this.pending.get(key);
+		if (queue) {
+			queue.push(entry);
+		} else {
+			this.pending.set(key, [entry]);
+		}
+		this.pendingCount++;
+		return entry;
+	}
+
+	/** Withdraw a request without settling it, e.g. when its write failed. */
+	cancel(pending: PendingFrame): void {
+		const entry = pending as PendingEntry;
+		if (this.remove(entry) && entry.timer != null) {
+			clearTimeout(entry.timer);
+		}
+	}
+
+	/**
+	 * Deliver a received message.
+	 *
+	 * Messages from a CAN ID with an outstanding request complete the oldest
+	 * such request. Anything else goes to the stream listener, or, with no
+	 * listener attached, to the oldest outstanding request (messages the
+	 * adapter delivers without a CAN ID cannot be routed any other way).
+	 *
+	 * @param key - CAN ID the message came from, or null if unknown
+	 * @param frame - Message bytes; handed to the receiver as-is, so pass a
+	 *   copy if the buffer is reused
+	 * @returns false if nobody was waiting and the message was dropped
+	 */
+	dispatch(key: number | null, frame: Uint8Array): boolean {
+		let entry = key == null ? undefined : this.pending.get(key)?.[0];
+		if (entry == null && this.listener != null) {
+			this.listener(frame);
+			return true;
+		}
+		entry ??= this.oldest();
+		if (entry == null) {
+			return false;
+		}
+
+		this.remove(entry);
+		if (entry.timer != null) {
+			clearTimeout(entry.timer);
+		}
+		entry.resolve(frame);
+		return true;
+	}
+
+	/** Attach (or with null, detach) the listener for unclaimed messages. */
+	setListener(listener: ((frame: Uint8Array) => void) | null): void {
+		this.listener = listener;
+	}
+
+	/** Reject every outstanding request, e.g. when the link fails. */
+	rejectAll(error: unknown): void {
+		const entries = [...this.pending.values()].flat();
+		this.pending.clear();
+		this.pendingCount = 0;
+		for (const entry of entries) {
+			if (entry.timer != null) {
+				clearTimeout(entry.timer);
+			}
+			entry.reject(error);
+		}
+	}
+
+	private oldest(): PendingEntry | undefined {
+		let oldest: PendingEntry | undefined;
+		for (const queue of this.pending.values()) {
+			const head = queue[0];
+			if (
+				head != null &&
+				(oldest == null || head.sequence < oldest.sequence)
+			) {
+				oldest = head;
+			}
+		}
+		return oldest;
+	}
+
+	private remove(entry: PendingEntry): boolean {
+		const queue = this.pending.get(entry.key);
+		const index = queue?.indexOf(entry) ?? -1;
+		if (queue == null || index < 0) {
+			return false;
+		}
+		queue.splice(index, 1);
+		if (queue.length === 0) {
+			this.pending.delete(entry.key);
+		}
+		this.pendingCount--;
+		return true;
+	}
+}
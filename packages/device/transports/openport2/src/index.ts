@@ -7,6 +7,9 @@ import {
 	type BrowserSerialLike,
 	createBrowserSerialRuntime,
 } from "@ecu-explorer/device/browser-serial-runtime";
+import { FrameDispatcher } from "./frame-dispatcher.js";
+import { OpenPort2Framer } from "./protocol-framer.js";
+import { WriteCoalescer } from "./write-coalescer.js";
 
 // USBDevice and USBDeviceRequestOptions are available globally from @types/w3c-web-usb
 // HID types are available via DOM lib.
@@ -24,6 +27,11 @@ const DEFAULT_FRAME_TIMEOUT_MS = 500;
 const ADAPTER_DRAIN_TIMEOUT_MS = 25;
 const ADAPTER_DRAIN_MAX_READS = 8;
 const ADAPTER_COMMAND_TIMEOUT_MS = 2000;
+// IN transfers kept queued by the receive loop, so the adapter always has
+// somewhere to put data while the previous transfer is being parsed
+const RX_TRANSFER_QUEUE_DEPTH = 4;
+const RX_TRANSFER_LENGTH = 512;
+const RX_IDLE_BACKOFF_MS = 1;
 const VBATT_PIN = 16;
 const ISO15765_PROTOCOL_ID = 6;
 const ISO15765_CHANNEL_CODE = 0x36;
@@ -33,9 +41,20 @@ const ISO15765_PASS_FILTER = 1;
 const CAN_ID_MASK_11BIT = 0x7ff;
 const DEFAULT_TESTER_CAN_ID = 0x7e0;
 const DEFAULT_ECU_CAN_ID = 0x7e8;
-const PACKET_NORMAL = 0x00;
-const PACKET_RX_END = 0x40;
-const PACKET_NORMAL_START = 0x80;
+// Dispatcher key no message carries: receiveFrame() takes whatever arrives
+// unclaimed
+const ANY_CAN_ID = -1;
+
+/** An adapter command waiting for its text reply. */
+interface ReplyWaiter {
+	/** Reply lines received so far, each CRLF-terminated */
+	response: string;
+	isComplete: (response: string) => boolean;
+	/** Set while draining: transfers left before the drain is over */
+	drainReads: number | null;
+	resolve: (response: string) => void;
+	reject: (error: unknown) => void;
+}
 
 interface EndpointDescriptor {
 	interfaceNumber: number;
@@ -310,6 +329,28 @@ function decodeCanIdHeader(data: Uint8Array): number | null {
 	);
 }
 
+/**
+ * CAN ID the response to a request sent to `requestCanId` comes from
+ * (ISO 15765-4: physical response ID = request ID + 8).
+ */
+function responseCanId(requestCanId: number | null): number {
+	if (
+		requestCanId != null &&
+		requestCanId >= DEFAULT_TESTER_CAN_ID &&
+		requestCanId <= DEFAULT_TESTER_CAN_ID + 7
+	) {
+		return requestCanId + 8;
+	}
+	return DEFAULT_ECU_CAN_ID;
+}
+
+/** CAN ID header of a received message, or null if it has none. */
+function receivedCanId(data: Uint8Array): number | null {
+	const canId = decodeCanIdHeader(data);
+	// Anything above 29 bits is payload, not a CAN ID
+	return canId != null && canId >>> 29 === 0 ? canId : null;
+}
+
 function hasKnownCanHeader(data: Uint8Array): boolean {
 	const canId = decodeCanIdHeader(data);
 	return canId === DEFAULT_TESTER_CAN_ID || canId === DEFAULT_ECU_CAN_ID;
@@ -326,97 +367,12 @@ function wrapIso15765Payload(data: Uint8Array): Uint8Array {
 	return wrapped;
 }
 
+/**
+ * Strip the CAN ID header from a received message. Always copies: `data` is
+ * a view of the framer's reassembly buffer, which the next message reuses.
+ */
 function unwrapIso15765Payload(data: Uint8Array): Uint8Array {
-	if (!hasKnownCanHeader(data)) {
-		return data;
-	}
-	return data.slice(4);
-}
-
-function appendBytes(left: Uint8Array, right: Uint8Array): Uint8Array {
-	const combined = new Uint8Array(left.length + right.length);
-	combined.set(left, 0);
-	combined.set(right, left.length);
-	return combined;
-}
-
-function copyBytes(data: Uint8Array): Uint8Array<ArrayBuffer> {
-	const copy = new Uint8Array(data.length);
-	copy.set(data, 0);
-	return copy;
-}
-
-function consumeProtocolBytes(
-	buffer: Uint8Array,
-	payload: Uint8Array,
-): {
-	buffer: Uint8Array;
-	payload: Uint8Array;
-	message: Uint8Array | null;
-} {
-	let offset = 0;
-	let accumulatedPayload = payload;
-
-	while (offset + 5 <= buffer.length) {
-		if (buffer[offset] !== 0x61 || buffer[offset + 1] !== 0x72) {
-			offset += 1;
-			continue;
-		}
-
-		const channelCode = buffer[offset + 2];
-		const packetLength = buffer[offset + 3] ?? 0;
-		const packetType = buffer[offset + 4] ?? 0;
-		const packetTotalLength = packetLength + 4;
-		if (packetTotalLength <= 0) {
-			offset += 1;
-			continue;
-		}
-		if (offset + packetTotalLength > buffer.length) {
-			break;
-		}
-
-		if (channelCode === 0x6f) {
-			offset += packetTotalLength;
-			continue;
-		}
-
-		if (channelCode !== ISO15765_CHANNEL_CODE) {
-			offset += packetTotalLength;
-			continue;
-		}
-
-		const packetPayloadLength = Math.max(0, packetLength - 5);
-		const payloadStart = offset + 9;
-		const payloadEnd = Math.min(
-			payloadStart + packetPayloadLength,
-			offset + packetTotalLength,
-		);
-		const packetPayload = buffer.slice(payloadStart, payloadEnd);
-
-		if (
-			packetType === PACKET_NORMAL_START ||
-			packetType === PACKET_NORMAL ||
-			packetType === PACKET_RX_END
-		) {
-			accumulatedPayload = appendBytes(accumulatedPayload, packetPayload);
-		}
-
-		offset += packetTotalLength;
-
-		if (packetType === PACKET_RX_END) {
-			return {
-				buffer: copyBytes(buffer.slice(offset)),
-				payload: new Uint8Array(0),
-				message: accumulatedPayload,
-			};
-		}
-	}
-
-	return {
-		buffer: copyBytes(buffer.slice(offset)),
-		payload: accumulatedPayload,
-		message: null,
-	};
+	return data.slice(hasKnownCanHeader(data) ? 4 : 0);
 }
 
 /**
@@ -431,9 +387,20 @@ export class OpenPort2Connection implements DeviceConnection {
 
 	private readonly device: USBDevice;
 	private channelId: number | null = null;
-	private pendingProtocolBytes: Uint8Array = new Uint8Array(0);
-	private streamActive = false;
-	private streamAbortController: AbortController | null = null;
+	private readonly framer = new OpenPort2Framer([ISO15765_CHANNEL_CODE], {
+		collectReplies: true,
+	});
+	private readonly dispatcher = new FrameDispatcher();
+	// Submitted IN transfers, oldest first. Only the receive loop takes from
+	// it; transfers still queued when it stops are picked up when it restarts
+	private readonly rxTransfers: Promise<Uint8Array>[] = [];
+	private receiveLoopActive = false;
+	private replyWaiter: ReplyWaiter | null = null;
+	// Tail of the adapter command chain; commands run one at a time
+	private commandQueue: Promise<unknown> = Promise.resolve();
+	private readonly writer = new WriteCoalescer((data) =>
+		this.device.transferOut(this.endpointOut, data),
+	);
 
 	constructor(
 		device: USBDevice,
@@ -448,7 +415,11 @@ export class OpenPort2Connection implements DeviceConnection {
 	}
 
 	/**
-	 * Write raw bytes to the device via bulk OUT endpoint, then read a response.
+	 * Write raw bytes to the device via bulk OUT endpoint, then wait for the
+	 * response.
+	 *
+	 * The response is picked out of the receive stream by the CAN ID it comes
+	 * from, so requests can overlap with each other and with startStream().
 	 *
 	 * @param data      - Raw bytes to send
 	 * @param timeoutMs - Read timeout in milliseconds
@@ -456,81 +427,226 @@ export class OpenPort2Connection implements DeviceConnection {
 	async sendFrame(data: Uint8Array, timeoutMs?: number): Promise<Uint8Array> {
 		const effectiveTimeout = timeoutMs ?? DEFAULT_FRAME_TIMEOUT_MS;
 		const channelId = this.channelId ?? ISO15765_PROTOCOL_ID;
-		await this.writeMessage(channelId, wrapIso15765Payload(data), 0);
-		const response = await this.readProtocolMessage(effectiveTimeout);
-		return unwrapIso15765Payload(response);
+		const message = wrapIso15765Payload(data);
+		const pending = this.dispatcher.expect(
+			responseCanId(decodeCanIdHeader(message)),
+			effectiveTimeout,
+			`OpenPort 2.0 read timed out after ${effectiveTimeout}ms`,
+		);
+		this.ensureReceiveLoop();
+		try {
+			await this.writeMessage(channelId, message, 0);
+		} catch (error) {
+			this.dispatcher.cancel(pending);
+			throw error;
+		}
+		return pending.promise;
 	}
 
-	/**
-	 * Read a single USB packet from the device.
-	 */
-	private async readUsbPacket(
-		timeoutMs: number,
-		maxLength = 64,
-	): Promise<Uint8Array> {
-		const result = await withTimeout(
-			this.device.transferIn(this.endpointIn, maxLength),
-			timeoutMs,
-			`OpenPort 2.0 read timed out after ${timeoutMs}ms`,
-		);
+	private async submitTransfer(maxLength: number): Promise<Uint8Array> {
+		const result = await this.device.transferIn(this.endpointIn, maxLength);
 		if (result.data == null) {
 			return new Uint8Array(0);
 		}
-		return new Uint8Array(result.data.buffer);
+		// View the transfer buffer directly; the framer copies what it keeps
+		return new Uint8Array(
+			result.data.buffer,
+			result.data.byteOffset,
+			result.data.byteLength,
+		);
+	}
+
+	/** Start the receive loop unless it is already running. */
+	private ensureReceiveLoop(): void {
+		if (this.receiveLoopActive) {
+			return;
+		}
+		this.receiveLoopActive = true;
+		void this.receiveLoop();
+	}
+
+	/** True while a request, stream or adapter command needs the IN endpoint */
+	private get hasReceiveDemand(): boolean {
+		return this.dispatcher.hasDemand || this.replyWaiter != null;
 	}
 
 	/**
-	 * Read a single frame from the device via bulk IN endpoint.
+	 * The only reader of the IN endpoint.
 	 *
-	 * @param maxLength - Maximum number of bytes to read
+	 * Keeps {@link RX_TRANSFER_QUEUE_DEPTH} transfers queued so there is no
+	 * gap between one transfer completing and the next being submitted, and
+	 * demultiplexes what arrives: reassembled protocol messages go to the
+	 * dispatcher, adapter command replies to the waiting command. Transfers
+	 * still queued when demand stops are kept for the next run.
+	 */
+	private async receiveLoop(): Promise<void> {
+		// Cleared in the same turn the loop decides to stop, so a caller
+		// adding demand right after always gets a running loop
+		try {
+			while (this.hasReceiveDemand) {
+				while (this.rxTransfers.length < RX_TRANSFER_QUEUE_DEPTH) {
+					const transfer = this.submitTransfer(RX_TRANSFER_LENGTH);
+					// Failures surface when the transfer reaches the head of the queue
+					transfer.catch(() => {});
+					this.rxTransfers.push(transfer);
+				}
+
+				let chunk: Uint8Array;
+				try {
+					chunk = await (this.rxTransfers[0] as Promise<Uint8Array>);
+				} catch (error) {
+					// The endpoint is gone; fail everything waiting on it
+					this.rxTransfers.length = 0;
+					this.dispatcher.setListener(null);
+					this.dispatcher.rejectAll(error);
+					this.replyWaiter?.reject(error);
+					return;
+				}
+				this.rxTransfers.shift();
+				this.countDrainRead(chunk);
+
+				if (chunk.length === 0) {
+					await new Promise((resolve) =>
+						setTimeout(resolve, RX_IDLE_BACKOFF_MS),
+					);
+					continue;
+				}
+				this.framer.push(chunk);
+				for (
+					let message = this.framer.next();
+					message != null;
+					message = this.framer.next()
+				) {
+					this.dispatcher.dispatch(
+						receivedCanId(message.data),
+						unwrapIso15765Payload(message.data),
+					);
+				}
+				for (
+					let reply = this.framer.takeReply();
+					reply != null;
+					reply = this.framer.takeReply()
+				) {
+					this.deliverReply(reply);
+				}
+			}
+		} finally {
+			this.receiveLoopActive = false;
+		}
+	}
+
+	/** End a drain at the first empty transfer or once its reads are used up. */
+	private countDrainRead(chunk: Uint8Array): void {
+		const waiter = this.replyWaiter;
+		if (waiter?.drainReads == null) {
+			return;
+		}
+		waiter.drainReads -= 1;
+		if (chunk.length === 0 || waiter.drainReads <= 0) {
+			this.replyWaiter = null;
+			waiter.resolve(waiter.response);
+		}
+	}
+
+	/** Hand an adapter reply to the waiting command; drop it if there is none. */
+	private deliverReply(reply: string): void {
+		const waiter = this.replyWaiter;
+		if (waiter == null) {
+			return;
+		}
+		waiter.response += `${reply}\r\n`;
+		if (waiter.isComplete(waiter.response)) {
+			this.replyWaiter = null;
+			waiter.resolve(waiter.response);
+		}
+	}
+
+	/**
+	 * Write an adapter command and wait for its reply.
+	 *
+	 * The reply is read by the receive loop like everything else on the IN
+	 * endpoint, so a command exchange cannot consume protocol messages, nor
+	 * can a reply reach the frame decoder.
+	 *
+	 * @param write - Writes the command
+	 * @param isComplete - Whether the reply lines so far finish the exchange
+	 * @param timeoutMs - Reject after this long without a complete reply
+	 * @param timeoutMessage - Error message used on timeout
+	 * @param drainReads - Instead of waiting for a reply, finish at the first
+	 *   empty transfer or after this many transfers
+	 * @returns The reply lines, each CRLF-terminated
+	 */
+	private exchangeCommand(
+		write: () => Promise<void>,
+		isComplete: (response: string) => boolean,
+		timeoutMs: number,
+		timeoutMessage: string,
+		drainReads: number | null = null,
+	): Promise<string> {
+		const run = async (): Promise<string> => {
+			const reply = new Promise<string>((resolve, reject) => {
+				this.replyWaiter = {
+					response: "",
+					isComplete,
+					drainReads,
+					resolve,
+					reject,
+				};
+			});
+			this.ensureReceiveLoop();
+			try {
+				await write();
+				return await withTimeout(reply, timeoutMs, timeoutMessage);
+			} finally {
+				this.replyWaiter = null;
+			}
+		};
+		const result = this.commandQueue.then(run, run);
+		this.commandQueue = result.catch(() => {});
+		return result;
+	}
+
+	/**
+	 * Wait for the next received message no sendFrame() call is waiting for.
+	 *
+	 * @param maxLength - Maximum number of bytes to return
 	 */
 	async receiveFrame(maxLength: number): Promise<Uint8Array> {
-		return this.readUsbPacket(DEFAULT_FRAME_TIMEOUT_MS, maxLength);
+		const pending = this.dispatcher.expect(
+			ANY_CAN_ID,
+			DEFAULT_FRAME_TIMEOUT_MS,
+			`OpenPort 2.0 read timed out after ${DEFAULT_FRAME_TIMEOUT_MS}ms`,
+		);
+		this.ensureReceiveLoop();
+		const frame = await pending.promise;
+		return frame.length > maxLength ? frame.slice(0, maxLength) : frame;
 	}
 
 	/**
 	 * Start receiving frames asynchronously until stopStream() is called.
 	 *
+	 * Frames are reassembled ISO 15765 messages that no sendFrame() call is
+	 * waiting for, delivered by the same receive loop that serves requests.
+	 *
 	 * @param onFrame - Callback invoked for each received frame
 	 */
 	startStream(onFrame: (frame: Uint8Array) => void): void {
-		this.streamActive = true;
-		this.streamAbortController = new AbortController();
-		const signal = this.streamAbortController.signal;
-
-		const poll = async (): Promise<void> => {
-			while (this.streamActive && !signal.aborted) {
-				try {
-					const frame = await this.receiveFrame(512);
-					if (frame.length > 0) {
-						onFrame(frame);
-					}
-				} catch {
-					// Stop streaming on error
-					this.streamActive = false;
-				}
-			}
-		};
-
-		void poll();
+		this.dispatcher.setListener(onFrame);
+		this.ensureReceiveLoop();
 	}
 
 	/** Stop the active stream started by startStream(). */
 	stopStream(): void {
-		this.streamActive = false;
-		this.streamAbortController?.abort();
-		this.streamAbortController = null;
+		this.dispatcher.setListener(null);
 	}
 
 	/**
-	 * Send an AT command string encoded as UTF-8.
+	 * Send an ASCII AT command. Commands issued together share a transfer.
 	 *
 	 * @param cmd - AT command string (e.g. "ati\r\n")
 	 */
 	async sendAtCommand(cmd: string): Promise<void> {
-		const encoder = new TextEncoder();
-		const data = encoder.encode(cmd);
-		await this.device.transferOut(this.endpointOut, data);
+		await this.writer.writeText(cmd);
 	}
 
 	/**
@@ -542,28 +658,10 @@ export class OpenPort2Connection implements DeviceConnection {
 		expect: string | null,
 		timeoutMs = ADAPTER_COMMAND_TIMEOUT_MS,
 	): Promise<string> {
-		await this.sendAtCommand(cmd);
-
-		const decoder = new TextDecoder();
-		let response = "";
-		const deadline = Date.now() + timeoutMs;
-		while (Date.now() < deadline) {
-			const remaining = Math.max(1, deadline - Date.now());
-			const chunk = await this.readUsbPacket(remaining);
-			if (chunk.length === 0) {
-				continue;
-			}
-			response += decoder.decode(chunk);
-			if (expect != null) {
-				if (response.includes(expect)) {
-					return response;
-				}
-			} else if (response.includes("aro\r\n")) {
-				return response;
-			}
-		}
-
-		throw new Error(
+		return this.exchangeCommand(
+			() => this.sendAtCommand(cmd),
+			(response) => response.includes(expect ?? "aro\r\n"),
+			timeoutMs,
 			expect != null
 				? `OpenPort 2.0 did not return expected response: ${expect}`
 				: "OpenPort 2.0 command acknowledgement timed out",
@@ -572,22 +670,18 @@ export class OpenPort2Connection implements DeviceConnection {
 
 	/**
 	 * Drain any pending adapter console output emitted during AT initialization.
+	 *
+	 * Runs the receive loop with nothing waiting until the input goes quiet,
+	 * so stale replies and messages are read and dropped.
 	 */
 	private async drainPendingInput(): Promise<void> {
-		for (let i = 0; i < ADAPTER_DRAIN_MAX_READS; i += 1) {
-			try {
-				const result = await withTimeout(
-					this.device.transferIn(this.endpointIn, 64),
-					ADAPTER_DRAIN_TIMEOUT_MS,
-					"adapter drain timeout",
-				);
-				if (result.data == null || result.data.byteLength === 0) {
-					return;
-				}
-			} catch {
-				return;
-			}
-		}
+		await this.exchangeCommand(
+			async () => {},
+			() => false,
+			ADAPTER_DRAIN_TIMEOUT_MS,
+			"OpenPort 2.0 input drained",
+			ADAPTER_DRAIN_MAX_READS,
+		).catch(() => {});
 	}
 
 	private async readBatteryVoltage(): Promise<number | null> {
@@ -666,39 +760,18 @@ export class OpenPort2Connection implements DeviceConnection {
 		pattern: Uint8Array,
 		flowControl: Uint8Array,
 	): Promise<void> {
-		const encoder = new TextEncoder();
-		const header = encoder.encode(
-			`atf${channelId} ${filterType} 0 ${mask.length}\r\n`,
+		await this.exchangeCommand(
+			() =>
+				this.writer.writeFrame(
+					`atf${channelId} ${filterType} 0 ${mask.length}\r\n`,
+					mask,
+					pattern,
+					flowControl,
+				),
+			(response) => response.includes("arf"),
+			ADAPTER_COMMAND_TIMEOUT_MS,
+			"OpenPort 2.0 filter configuration timed out",
 		);
-		const combined = new Uint8Array(
-			header.length + mask.length + pattern.length + flowControl.length,
-		);
-		let offset = 0;
-		combined.set(header, offset);
-		offset += header.length;
-		combined.set(mask, offset);
-		offset += mask.length;
-		combined.set(pattern, offset);
-		offset += pattern.length;
-		combined.set(flowControl, offset);
-
-		await this.device.transferOut(this.endpointOut, combined);
-
-		const decoder = new TextDecoder();
-		let response = "";
-		const deadline = Date.now() + ADAPTER_COMMAND_TIMEOUT_MS;
-		while (Date.now() < deadline) {
-			const remaining = Math.max(1, deadline - Date.now());
-			const chunk = await this.readUsbPacket(remaining);
-			if (chunk.length === 0) {
-				continue;
-			}
-			response += decoder.decode(chunk);
-			if (response.includes("arf")) {
-				return;
-			}
-		}
-		throw new Error("OpenPort 2.0 filter configuration timed out");
 	}
 
 	/**
@@ -715,48 +788,12 @@ export class OpenPort2Connection implements DeviceConnection {
 		data: Uint8Array,
 		flags: number,
 	): Promise<void> {
-		const encoder = new TextEncoder();
-		const header = encoder.encode(
+		// Encoded straight into the shared transfer buffer, batched with any
+		// other messages written in the same turn
+		await this.writer.writeFrame(
 			`att${channelId} ${data.length} ${flags}\r\n`,
+			data,
 		);
-		// Combine header and data into a single plain ArrayBuffer-backed Uint8Array
-		const combined = new Uint8Array(header.length + data.length);
-		combined.set(header, 0);
-		combined.set(data, header.length);
-		await this.device.transferOut(this.endpointOut, combined);
-	}
-
-	/**
-	 * Read and decode protocol messages wrapped in the adapter's `AR...` format.
-	 * This is a minimal ISO15765 parser based on the reference J2534 source.
-	 */
-	private async readProtocolMessage(timeoutMs: number): Promise<Uint8Array> {
-		const startedAt = Date.now();
-		let payload: Uint8Array = new Uint8Array(0);
-		let buffered: Uint8Array = this.pendingProtocolBytes;
-		this.pendingProtocolBytes = new Uint8Array(0);
-
-		while (Date.now() - startedAt < timeoutMs) {
-			if (buffered.length > 0) {
-				const parsed = consumeProtocolBytes(buffered, payload);
-				buffered = parsed.buffer;
-				payload = parsed.payload;
-				if (parsed.message != null) {
-					this.pendingProtocolBytes = buffered;
-					return parsed.message;
-				}
-			}
-
-			const remaining = Math.max(1, timeoutMs - (Date.now() - startedAt));
-			const chunk = await this.readUsbPacket(remaining);
-			if (chunk.length === 0) {
-				continue;
-			}
-			buffered = appendBytes(buffered, chunk);
-		}
-
-		this.pendingProtocolBytes = buffered;
-		throw new Error(`OpenPort 2.0 read timed out after ${timeoutMs}ms`);
 	}
 
 	/**
@@ -764,6 +801,7 @@ export class OpenPort2Connection implements DeviceConnection {
 	 */
 	async disconnect(): Promise<void> {
 		this.stopStream();
+		this.dispatcher.rejectAll(new Error("Device connection closed"));
 		if (this.channelId != null) {
 			try {
 				await this.sendExpect(`atc${this.channelId}\r\n`, null);
@@ -934,7 +972,8 @@ class OpenPort2SerialConnection implements DeviceConnection {
 	readonly deviceInfo: DeviceInfo;
 	private readonly port: SerialPortLike;
 	private channelId: number | null = null;
-	private pendingProtocolBytes: Uint8Array = new Uint8Array(0);
+	private readonly framer = new OpenPort2Framer([ISO15765_CHANNEL_CODE]);
+	private readonly writer = new WriteCoalescer((data) => this.port.write(data));
 	private streamActive = false;
 	private streamAbortController: AbortController | null = null;
 
@@ -983,8 +1022,7 @@ class OpenPort2SerialConnection implements DeviceConnection {
 	}
 
 	async sendAtCommand(cmd: string): Promise<void> {
-		const encoder = new TextEncoder();
-		await this.port.write(encoder.encode(cmd));
+		await this.writer.writeText(cmd);
 	}
 
 	private async sendExpect(
@@ -1092,23 +1130,12 @@ class OpenPort2SerialConnection implements DeviceConnection {
 		pattern: Uint8Array,
 		flowControl: Uint8Array,
 	): Promise<void> {
-		const encoder = new TextEncoder();
-		const header = encoder.encode(
+		await this.writer.writeFrame(
 			`atf${channelId} ${filterType} 0 ${mask.length}\r\n`,
+			mask,
+			pattern,
+			flowControl,
 		);
-		const combined = new Uint8Array(
-			header.length + mask.length + pattern.length + flowControl.length,
-		);
-		let offset = 0;
-		combined.set(header, offset);
-		offset += header.length;
-		combined.set(mask, offset);
-		offset += mask.length;
-		combined.set(pattern, offset);
-		offset += pattern.length;
-		combined.set(flowControl, offset);
-
-		await this.port.write(combined);
 
 		const decoder = new TextDecoder();
 		let response = "";
@@ -1132,31 +1159,19 @@ class OpenPort2SerialConnection implements DeviceConnection {
 		data: Uint8Array,
 		flags: number,
 	): Promise<void> {
-		const encoder = new TextEncoder();
-		const header = encoder.encode(
+		await this.writer.writeFrame(
 			`att${channelId} ${data.length} ${flags}\r\n`,
+			data,
 		);
-		const combined = new Uint8Array(header.length + data.length);
-		combined.set(header, 0);
-		combined.set(data, header.length);
-		await this.port.write(combined);
 	}
 
 	private async readProtocolMessage(timeoutMs: number): Promise<Uint8Array> {
 		const startedAt = Date.now();
-		let payload: Uint8Array = new Uint8Array(0);
-		let buffered: Uint8Array = this.pendingProtocolBytes;
-		this.pendingProtocolBytes = new Uint8Array(0);
 
 		while (Date.now() - startedAt < timeoutMs) {
-			if (buffered.length > 0) {
-				const parsed = consumeProtocolBytes(buffered, payload);
-				buffered = parsed.buffer;
-				payload = parsed.payload;
-				if (parsed.message != null) {
-					this.pendingProtocolBytes = buffered;
-					return parsed.message;
-				}
+			const message = this.framer.next();
+			if (message != null) {
+				return message.data;
 			}
 
 			const remaining = Math.max(1, timeoutMs - (Date.now() - startedAt));
@@ -1164,10 +1179,11 @@ class OpenPort2SerialConnection implements DeviceConnection {
 			if (chunk.length === 0) {
 				continue;
 			}
-			buffered = appendBytes(buffered, chunk);
+			this.framer.push(chunk);
 		}
 
-		this.pendingProtocolBytes = buffered;
+		// Unparsed bytes stay buffered; a half-received message is dropped
+		this.framer.discardPartialMessages();
 		throw new Error(`OpenPort 2.0 read timed out after ${timeoutMs}ms`);
 	}
 
@@ -0,0 +1,315 @@
+/**
+ * Zero-copy framer for the OpenPort 2.0 `ar` receive stream.
+ *
+ * The adapter wraps every received protocol message in one or more packets:
+ *
+ * ```
+ * 'a' 'r' <channel> <len> <type> <4 bytes> <payload: len - 5 bytes>
+ * ```
+ *
+ * where `<len>` counts every byte after itself. A message is the
+ * concatenation of the payloads of its `NORMAL_START`/`NORMAL` packets up to
+ * and including the `RX_END` packet.
+ *
+ * Adapter command replies share the stream as CRLF-terminated text lines
+ * (`aro`, `ari main code version ...`, `arr 16 12345`, `arf6 0 0`): `ar`
+ * followed by a letter where a packet has its channel digit. They are
+ * consumed whole, so a reply is never mistaken for a packet header, and
+ * queued for {@link OpenPort2Framer.takeReply} when requested.
+ *
+ * Bytes read from USB or serial are pushed into a power-of-two ring buffer
+ * and packet headers are parsed in place. Payload bytes are copied exactly
+ * once, from the ring into a preallocated reassembly buffer for their
+ * channel, and complete messages are returned as views of that buffer.
+ *
+ * @module openport2/protocol-framer
+ */
+
+// Ref: https://github.com/NikolaKozina/j2534/blob/master/j2534/j2534.c
+/** Continuation of a multi-packet message */
+export const PACKET_NORMAL = 0x00;
+/** Last packet of a received message */
+export const PACKET_RX_END = 0x40;
+/** First packet of a multi-packet message */
+export const PACKET_NORMAL_START = 0x80;
+
+// 'a' 'r' channel length type + 4 reserved bytes
+const PACKET_HEADER_LENGTH = 9;
+// Bytes needed to decide a packet's total length
+const PACKET_PREFIX_LENGTH = 5;
+const ASCII_A = 0x61;
+const ASCII_R = 0x72;
+const ASCII_LOWER_Z = 0x7a;
+const ASCII_CR = 0x0d;
+const ASCII_LF = 0x0a;
+// Longest command reply line; anything longer is not a reply
+const MAX_REPLY_LENGTH = 256;
+
+// Largest J2534 message (PASSTHRU_MSG.Data)
+const DEFAULT_MAX_MESSAGE_LENGTH = 4128;
+const DEFAULT_RING_CAPACITY = 8192;
+
+/**
+ * A complete message returned by {@link OpenPort2Framer.next}.
+ */
+export interface FramedMessage {
+	/** Adapter channel code, e.g. 0x36 (`'6'`) for ISO 15765 */
+	readonly channelCode: number;
+	/**
+	 * Message bytes. This is a view of the channel's reassembly buffer and is
+	 * overwritten by the next message on the same channel; copy it to keep it.
+	 */
+	readonly data: Uint8Array;
+}
+
+interface ChannelReassembly {
+	buffer: Uint8Array;
+	length: number;
+}
+
+/**
+ * Incremental `ar` packet framer.
+ *
+ * @example
+ * const framer = new OpenPort2Framer([0x36]);
+ * framer.push(usbChunk);
+ * for (let msg = framer.next(); msg; msg = framer.next()) {
+ *   handle(msg.data.slice()); // copy if retained
+ * }
+ */
+export class OpenPort2Framer {
+	private ring: Uint8Array;
+	private mask: number;
+	private head = 0;
+	private size = 0;
+	private readonly channels = new Map<number, ChannelReassembly>();
+	private readonly replies: string[] | null;
+	private readonly decoder = new TextDecoder();
+
+	/**
+	 * @param channelCodes - Channels whose messages are reassembled; packets
+	 *   on any other channel are skipped
+	 * @param options.ringCapacity - Initial ring size in bytes (rounded up to
+	 *   a power of two; grows if a push would overflow it)
+	 * @param options.maxMessageLength - Reassembly buffer size per channel
+	 * @param options.collectReplies - Queue adapter command replies for
+	 *   {@link takeReply} instead of dropping them
+	 */
+	constructor(
+		channelCodes: readonly number[],
+		options: {
+			ringCapacity?: number;
+			maxMessageLength?: number;
+			collectReplies?: boolean;
+		} = {},
+	) {
+		const capacity = nextPowerOfTwo(
+			options.ringCapacity ?? DEFAULT_RING_CAPACITY,
+		);
+		this.ring = new Uint8Array(capacity);
+		this.mask = capacity - 1;
+		this.replies = options.collectReplies ? [] : null;
+		const maxMessageLength =
+			options.maxMessageLength ?? DEFAULT_MAX_MESSAGE_LENGTH;
+		for (const code of channelCodes) {
+			this.channels.set(code, {
+				buffer: new Uint8Array(maxMessageLength),
+				length: 0,
+			});
+		}
+	}
+
+	/** Bytes received but not yet consumed by {@link next} */
+	get bufferedBytes(): number {
+		return this.size;
+	}
+
+	/**
+	 * Append received bytes. The chunk is copied into the ring, so the caller
+	 * may reuse it immediately.
+	 */
+	push(chunk: Uint8Array): void {
+		if (this.size + chunk.length > this.ring.length) {
+			this.grow(this.size + chunk.length);
+		}
+		const tail = (this.head + this.size) & this.mask;
+		const first = Math.min(chunk.length, this.ring.length - tail);
+		this.ring.set(chunk.subarray(0, first), tail);
+		if (first < chunk.length) {
+			this.ring.set(chunk.subarray(first), 0);
+		}
+		this.size += chunk.length;
+	}
+
+	/**
+	 * Consume buffered packets until a message completes.
+	 *
+	 * @returns The next complete message, or null if more bytes are needed
+	 */
+	next(): FramedMessage | null {
+		while (this.size >= PACKET_PREFIX_LENGTH) {
+			if (this.byteAt(0) !== ASCII_A || this.byteAt(1) !== ASCII_R) {
+				this.skip(1);
+				continue;
+			}
+
+			const channelCode = this.byteAt(2);
+			if (isReplyPrefix(channelCode, this.byteAt(3))) {
+				const replyLength = this.replyLength();
+				if (replyLength === 0) {
+					return null;
+				}
+				if (replyLength < 0) {
+					// Too long for a reply: not one after all
+					this.skip(1);
+					continue;
+				}
+				this.takeReplyLine(replyLength);
+				continue;
+			}
+
+			const packetLength = this.byteAt(3);
+			const packetType = this.byteAt(4);
+			const packetTotalLength = packetLength + 4;
+			if (packetTotalLength > this.size) {
+				return null;
+			}
+
+			const channel = this.channels.get(channelCode);
+			if (
+				channel &&
+				(packetType === PACKET_NORMAL_START ||
+					packetType === PACKET_NORMAL ||
+					packetType === PACKET_RX_END)
+			) {
+				this.appendPayload(
+					channel,
+					Math.max(0, packetLength - (PACKET_HEADER_LENGTH - 4)),
+				);
+			}
+			this.skip(packetTotalLength);
+
+			if (channel && packetType === PACKET_RX_END) {
+				const length = channel.length;
+				channel.length = 0;
+				return { channelCode, data: channel.buffer.subarray(0, length) };
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Oldest queued command reply, without its CRLF, or null if there is
+	 * none. Only filled when constructed with `collectReplies`.
+	 */
+	takeReply(): string | null {
+		return this.replies?.shift() ?? null;
+	}
+
+	/** Drop partially reassembled messages, e.g. after a read timeout. */
+	discardPartialMessages(): void {
+		for (const channel of this.channels.values()) {
+			channel.length = 0;
+		}
+	}
+
+	/** Drop all buffered bytes and partial messages. */
+	reset(): void {
+		this.head = 0;
+		this.size = 0;
+		this.discardPartialMessages();
+	}
+
+	/**
+	 * Length of the reply line at the ring head including its LF, 0 if the
+	 * line is not complete yet, or -1 if it is too long to be a reply.
+	 */
+	private replyLength(): number {
+		const limit = Math.min(this.size, MAX_REPLY_LENGTH);
+		for (let i = 3; i < limit; i++) {
+			if (this.byteAt(i) === ASCII_LF) {
+				return i + 1;
+			}
+		}
+		return this.size < MAX_REPLY_LENGTH ? 0 : -1;
+	}
+
+	/** Consume the reply line at the ring head, queueing it if collected. */
+	private takeReplyLine(length: number): void {
+		if (this.replies != null) {
+			const line = new Uint8Array(length);
+			for (let i = 0; i < length; i++) {
+				line[i] = this.byteAt(i);
+			}
+			this.replies.push(this.decoder.decode(line).trimEnd());
+		}
+		this.skip(length);
+	}
+
+	private byteAt(index: number): number {
+		return this.ring[(this.head + index) & this.mask] as number;
+	}
+
+	private skip(count: number): void {
+		this.head = (this.head + count) & this.mask;
+		this.size -= count;
+	}
+
+	/** Copy the payload of the packet at the ring head into `channel`. */
+	private appendPayload(channel: ChannelReassembly, length: number): void {
+		if (length === 0) return;
+		if (channel.length + length > channel.buffer.length) {
+			// Longer than any J2534 message; grow rather than truncate
+			const grown = new Uint8Array(
+				nextPowerOfTwo(channel.length + length),
+			);
+			grown.set(channel.buffer.subarray(0, channel.length));
+			channel.buffer = grown;
+		}
+
+		const start = (this.head + PACKET_HEADER_LENGTH) & this.mask;
+		const first = Math.min(length, this.ring.length - start);
+		channel.buffer.set(
+			this.ring.subarray(start, start + first),
+			channel.length,
+		);
+		if (first < length) {
+			channel.buffer.set(
+				this.ring.subarray(0, length - first),
+				channel.length + first,
+			);
+		}
+		channel.length += length;
+	}
+
+	private grow(required: number): void {
+		const ring = new Uint8Array(nextPowerOfTwo(required));
+		const first = Math.min(this.size, this.ring.length - this.head);
+		ring.set(this.ring.subarray(this.head, this.head + first));
+		ring.set(this.ring.subarray(0, this.size - first), first);
+		this.ring = ring;
+		this.mask = ring.length - 1;
+		this.head = 0;
+	}
+}
+
+/**
+ * Whether `ar` followed by these two bytes starts a text reply rather than a
+ * packet: replies carry a letter where packets have their channel digit, and
+ * continue with printable text or the CR of a bare `aro`.
+ */
+function isReplyPrefix(third: number, fourth: number): boolean {
+	return (
+		third >= ASCII_A &&
+		third <= ASCII_LOWER_Z &&
+		(fourth === ASCII_CR || (fourth >= 0x20 && fourth < 0x7f))
+	);
+}
+
+function nextPowerOfTwo(value: number): number {
+	let result = 1;
+	while (result < value) {
+		result *= 2;
+	}
+	return result;
+}
@@ -0,0 +1,180 @@
+/**
+ * Outbound command batching for the OpenPort 2.0.
+ *
+ * The adapter parses its OUT endpoint as a byte stream, so several `at`
+ * commands and `att` messages can travel in one bulk transfer. Commands
+ * queued in the same turn of the event loop (or within `flushDelayMs`) are
+ * encoded straight into a pooled transfer buffer and written together; a
+ * batch is flushed early when the next command would not fit.
+ *
+ * Command text is ASCII and encoded byte by byte, so no `TextEncoder` or
+ * intermediate arrays are created per command.
+ *
+ * @module openport2/write-coalescer
+ */
+
+// Bulk OUT transfers are split into 64-byte USB packets by the host; 4 KiB
+// holds a batch of commands or one near-maximum ISO-TP message
+const DEFAULT_MAX_TRANSFER_LENGTH = 4096;
+// Buffers kept for reuse once their transfer completes
+const MAX_POOLED_BUFFERS = 4;
+
+export interface WriteCoalescerOptions {
+	/** Largest batched transfer in bytes (default 4096) */
+	maxTransferLength?: number;
+	/**
+	 * How long to hold a batch open for more commands (default 0: flush at
+	 * the end of the current microtask turn)
+	 */
+	flushDelayMs?: number;
+}
+
+interface Batch {
+	buffer: Uint8Array<ArrayBuffer>;
+	length: number;
+	promise: Promise<void>;
+	resolve: () => void;
+	reject: (error: unknown) => void;
+}
+
+export class WriteCoalescer {
+	private readonly maxTransferLength: number;
+	private readonly flushDelayMs: number;
+	private readonly pool: Uint8Array<ArrayBuffer>[] = [];
+	private batch: Batch | null = null;
+	private flushScheduled = false;
+	private flushTimer: ReturnType<typeof setTimeout> | null = null;
+
+	/**
+	 * @param write - Performs one transfer; must not retain the buffer after
+	 *   its promise settles
+	 */
+	constructor(
+		private readonly write: (
+			data: Uint8Array<ArrayBuffer>,
+		) => Promise<unknown>,
+		options: WriteCoalescerOptions = {},
+	) {
+		this.maxTransferLength =
+			options.maxTransferLength ?? DEFAULT_MAX_TRANSFER_LENGTH;
+		this.flushDelayMs = options.flushDelayMs ?? 0;
+	}
+
+	/**
+	 * Queue an ASCII command, e.g. `ati\r\n`.
+	 *
+	 * @returns Resolves once the transfer carrying the command completes
+	 */
+	writeText(text: string): Promise<void> {
+		return this.writeFrame(text);
+	}
+
+	/**
+	 * Queue an ASCII header followed by binary data, e.g. an `att` message.
+	 *
+	 * @returns Resolves once the transfer carrying the message completes
+	 */
+	writeFrame(header: string, ...parts: readonly Uint8Array[]): Promise<void> {
+		let length = header.length;
+		for (const part of parts) {
+			length += part.length;
+		}
+		const batch = this.reserve(length);
+		let offset = batch.length;
+		for (let i = 0; i < header.length; i++) {
+			batch.buffer[offset++] = header.charCodeAt(i);
+		}
+		for (const part of parts) {
+			batch.buffer.set(part, offset);
+			offset += part.length;
+		}
+		batch.length = offset;
+
+		if (batch.length >= this.maxTransferLength) {
+			this.flush();
+		} else {
+			this.scheduleFlush();
+		}
+		return batch.promise;
+	}
+
+	/** Write the open batch now. */
+	flush(): void {
+		if (this.flushTimer != null) {
+			clearTimeout(this.flushTimer);
+			this.flushTimer = null;
+		}
+		const batch = this.batch;
+		this.batch = null;
+		if (batch == null || batch.length === 0) {
+			return;
+		}
+
+		this.write(batch.buffer.subarray(0, batch.length)).then(
+			() => {
+				this.release(batch.buffer);
+				batch.resolve();
+			},
+			(error: unknown) => {
+				this.release(batch.buffer);
+				batch.reject(error);
+			},
+		);
+	}
+
+	/** Return the open batch, flushing it first if `length` bytes won't fit. */
+	private reserve(length: number): Batch {
+		if (
+			this.batch != null &&
+			this.batch.length + length > this.batch.buffer.length
+		) {
+			this.flush();
+		}
+		if (this.batch == null) {
+			this.batch = this.createBatch(length);
+		}
+		return this.batch;
+	}
+
+	private createBatch(minLength: number): Batch {
+		// Oversized commands get a one-off buffer of their own
+		const buffer =
+			minLength > this.maxTransferLength
+				? new Uint8Array(minLength)
+				: (this.pool.pop() ?? new Uint8Array(this.maxTransferLength));
+		let resolve!: () => void;
+		let reject!: (error: unknown) => void;
+		const promise = new Promise<void>((res, rej) => {
+			resolve = res;
+			reject = rej;
+		});
+		return { buffer, length: 0, promise, resolve, reject };
+	}
+
+	private release(buffer: Uint8Array<ArrayBuffer>): void {
+		if (
+			buffer.length === this.maxTransferLength &&
+			this.pool.length < MAX_POOLED_BUFFERS
+		) {
+			this.pool.push(buffer);
+		}
+	}
+
+	private scheduleFlush(): void {
+		if (this.flushDelayMs > 0) {
+			this.flushTimer ??= setTimeout(() => {
+				this.flushTimer = null;
+				this.flush();
+			}, this.flushDelayMs);
+			return;
+		}
+		if (this.flushScheduled) {
+			return;
+		}
+		this.flushScheduled = true;
+		queueMicrotask(() => {
+			this.flushScheduled = false;
+			this.flush();
+		});
+	}
+}
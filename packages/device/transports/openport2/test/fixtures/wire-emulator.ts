@@ -0,0 +1,160 @@
+/**
+ * OpenPort 2.0 wire emulator for transport tests.
+ *
+ * Produces the adapter's `ar` receive stream for queued messages and hands
+ * it out in USB-sized transfers, so the framer and connections can be
+ * driven with realistic packet splits and at CAN line rate.
+ */
+
+const ISO15765_CHANNEL_CODE = 0x36;
+const PACKET_NORMAL = 0x00;
+const PACKET_RX_END = 0x40;
+const PACKET_NORMAL_START = 0x80;
+// The packet length byte covers type + 4 reserved bytes + payload
+const MAX_PACKET_PAYLOAD = 0xff - 5;
+// Bits on the wire for a standard-ID CAN frame with 8 data bytes,
+// ignoring bit stuffing
+const CAN_FRAME_BITS = 111;
+
+export interface WireEmulatorOptions {
+	/** Adapter channel code (default 0x36, ISO 15765) */
+	channelCode?: number;
+	/** Largest payload per `ar` packet (default 250) */
+	maxPacketPayload?: number;
+	/** Bytes per USB IN transfer (default 64, full-speed bulk) */
+	usbPacketSize?: number;
+}
+
+/** Build a single `ar` packet. */
+export function encodeAdapterPacket(
+	channelCode: number,
+	packetType: number,
+	payload: Uint8Array,
+): Uint8Array {
+	const packet = new Uint8Array(9 + payload.length);
+	packet[0] = 0x61; // 'a'
+	packet[1] = 0x72; // 'r'
+	packet[2] = channelCode;
+	packet[3] = payload.length + 5;
+	packet[4] = packetType;
+	packet.set(payload, 9);
+	return packet;
+}
+
+/**
+ * Number of ISO-TP messages of `messageLength` bytes a CAN bus carries per
+ * second (single frames carry 7 bytes, first frames 6, consecutive 7).
+ */
+export function canMessagesPerSecond(
+	messageLength: number,
+	bitrate = 500000,
+): number {
+	const frames =
+		messageLength <= 7 ? 1 : 1 + Math.ceil((messageLength - 6) / 7);
+	return Math.floor(bitrate / CAN_FRAME_BITS / frames);
+}
+
+export class OpenPort2WireEmulator {
+	private readonly channelCode: number;
+	private readonly maxPacketPayload: number;
+	private readonly usbPacketSize: number;
+	private readonly chunks: Uint8Array[] = [];
+	private chunkOffset = 0;
+	private pending = 0;
+
+	constructor(options: WireEmulatorOptions = {}) {
+		this.channelCode = options.channelCode ?? ISO15765_CHANNEL_CODE;
+		this.maxPacketPayload = options.maxPacketPayload ?? MAX_PACKET_PAYLOAD;
+		this.usbPacketSize = options.usbPacketSize ?? 64;
+	}
+
+	/** Encode a message as START/NORMAL/RX_END packets. */
+	encodeMessage(message: Uint8Array): Uint8Array {
+		const packets: Uint8Array[] = [];
+		let offset = 0;
+		do {
+			const end = Math.min(offset + this.maxPacketPayload, message.length);
+			const type =
+				end === message.length
+					? PACKET_RX_END
+					: offset === 0
+						? PACKET_NORMAL_START
+						: PACKET_NORMAL;
+			packets.push(
+				encodeAdapterPacket(
+					this.channelCode,
+					type,
+					message.subarray(offset, end),
+				),
+			);
+			offset = end;
+		} while (offset < message.length);
+		return concat(packets);
+	}
+
+	/** Queue a received message. */
+	queueMessage(message: Uint8Array): void {
+		this.queueRaw(this.encodeMessage(message));
+	}
+
+	/** Queue raw adapter bytes, e.g. `aro\r\n` or a control packet. */
+	queueRaw(bytes: Uint8Array): void {
+		if (bytes.length === 0) return;
+		this.chunks.push(bytes);
+		this.pending += bytes.length;
+	}
+
+	/** Bytes queued but not yet read */
+	get pendingBytes(): number {
+		return this.pending;
+	}
+
+	/**
+	 * Next USB IN transfer: up to `maxLength` (and the USB packet size) bytes
+	 * of the queued stream, regardless of packet boundaries.
+	 */
+	readTransfer(maxLength = this.usbPacketSize): Uint8Array {
+		const limit = Math.min(maxLength, this.usbPacketSize);
+		const out = new Uint8Array(Math.min(limit, this.pending));
+		this.pending -= out.length;
+		let filled = 0;
+		while (filled < out.length) {
+			const chunk = this.chunks[0] as Uint8Array;
+			const take = Math.min(
+				out.length - filled,
+				chunk.length - this.chunkOffset,
+			);
+			out.set(
+				chunk.subarray(this.chunkOffset, this.chunkOffset + take),
+				filled,
+			);
+			filled += take;
+			this.chunkOffset += take;
+			if (this.chunkOffset === chunk.length) {
+				this.chunks.shift();
+				this.chunkOffset = 0;
+			}
+		}
+		return out;
+	}
+
+	/** `USBDevice.transferIn` backed by the queued stream. */
+	transferIn = async (
+		_endpoint: number,
+		length: number,
+	): Promise<{ data: DataView }> => {
+		const bytes = this.readTransfer(length);
+		return { data: new DataView(bytes.buffer, 0, bytes.length) };
+	};
+}
+
+function concat(parts: readonly Uint8Array[]): Uint8Array {
+	const total = parts.reduce((sum, part) => sum + part.length, 0);
+	const out = new Uint8Array(total);
+	let offset = 0;
+	for (const part of parts) {
+		out.set(part, offset);
+		offset += part.length;
+	}
+	return out;
+}
@@ -0,0 +1,93 @@
+import { afterEach, describe, expect, it, vi } from "vitest";
+import { FrameDispatcher } from "../src/frame-dispatcher.js";
+
+const ECU = 0x7e8;
+const TCU = 0x7e9;
+
+describe("FrameDispatcher", () => {
+	afterEach(() => {
+		vi.useRealTimers();
+	});
+
+	it("completes the request waiting on the message's CAN ID", async () => {
+		const dispatcher = new FrameDispatcher();
+		const ecu = dispatcher.expect(ECU, 0, "timeout");
+		const tcu = dispatcher.expect(TCU, 0, "timeout");
+
+		expect(dispatcher.dispatch(TCU, Uint8Array.of(2))).toBe(true);
+		expect(dispatcher.dispatch(ECU, Uint8Array.of(1))).toBe(true);
+
+		await expect(tcu.promise).resolves.toEqual(Uint8Array.of(2));
+		await expect(ecu.promise).resolves.toEqual(Uint8Array.of(1));
+		expect(dispatcher.hasDemand).toBe(false);
+	});
+
+	it("completes requests on the same CAN ID in order", async () => {
+		const dispatcher = new FrameDispatcher();
+		const first = dispatcher.expect(ECU, 0, "timeout");
+		const second = dispatcher.expect(ECU, 0, "timeout");
+
+		dispatcher.dispatch(ECU, Uint8Array.of(1));
+		dispatcher.dispatch(ECU, Uint8Array.of(2));
+
+		await expect(first.promise).resolves.toEqual(Uint8Array.of(1));
+		await expect(second.promise).resolves.toEqual(Uint8Array.of(2));
+	});
+
+	it("sends unclaimed messages to the stream listener", async () => {
+		const dispatcher = new FrameDispatcher();
+		const onFrame = vi.fn();
+		dispatcher.setListener(onFrame);
+		const request = dispatcher.expect(ECU, 0, "timeout");
+
+		dispatcher.dispatch(TCU, Uint8Array.of(9));
+		dispatcher.dispatch(null, Uint8Array.of(8));
+		dispatcher.dispatch(ECU, Uint8Array.of(1));
+
+		expect(onFrame.mock.calls).toEqual([
+			[Uint8Array.of(9)],
+			[Uint8Array.of(8)],
+		]);
+		await expect(request.promise).resolves.toEqual(Uint8Array.of(1));
+		expect(dispatcher.hasDemand).toBe(true);
+	});
+
+	it("gives unroutable messages to the oldest request without a listener", async () => {
+		const dispatcher = new FrameDispatcher();
+		const first = dispatcher.expect(TCU, 0, "timeout");
+		const second = dispatcher.expect(ECU, 0, "timeout");
+
+		dispatcher.dispatch(null, Uint8Array.of(1));
+
+		await expect(first.promise).resolves.toEqual(Uint8Array.of(1));
+		expect(dispatcher.dispatch(0x123, Uint8Array.of(2))).toBe(true);
+		await expect(second.promise).resolves.toEqual(Uint8Array.of(2));
+		expect(dispatcher.dispatch(ECU, Uint8Array.of(3))).toBe(false);
+	});
+
+	it("rejects a request that times out and drops its late response", async () => {
+		vi.useFakeTimers();
+		const dispatcher = new FrameDispatcher();
+		const request = dispatcher.expect(ECU, 50, "read timed out");
+		const settled = expect(request.promise).rejects.toThrow(
+			"read timed out",
+		);
+
+		await vi.advanceTimersByTimeAsync(50);
+		await settled;
+		expect(dispatcher.hasDemand).toBe(false);
+		expect(dispatcher.dispatch(ECU, Uint8Array.of(1))).toBe(false);
+	});
+
+	it("withdraws cancelled requests and rejects the rest on rejectAll()", async () => {
+		const dispatcher = new FrameDispatcher();
+		const cancelled = dispatcher.expect(ECU, 1000, "timeout");
+		const pending = dispatcher.expect(TCU, 1000, "timeout");
+
+		dispatcher.cancel(cancelled);
+		dispatcher.rejectAll(new Error("closed"));
+
+		await expect(pending.promise).rejects.toThrow("closed");
+		expect(dispatcher.hasDemand).toBe(false);
+	});
+});
@@ -0,0 +1,157 @@
+import { describe, expect, it } from "vitest";
+import { OpenPort2Framer } from "../src/protocol-framer.js";
+import {
+	canMessagesPerSecond,
+	encodeAdapterPacket,
+	OpenPort2WireEmulator,
+} from "./fixtures/wire-emulator.js";
+
+const ISO15765 = 0x36;
+
+function message(length: number, seed: number): Uint8Array {
+	return Uint8Array.from({ length }, (_, i) => (i * 31 + seed) & 0xff);
+}
+
+/** Copy every message the framer can currently produce. */
+function drain(framer: OpenPort2Framer): Uint8Array[] {
+	const out: Uint8Array[] = [];
+	for (let msg = framer.next(); msg; msg = framer.next()) {
+		out.push(msg.data.slice());
+	}
+	return out;
+}
+
+describe("OpenPort2Framer", () => {
+	it("returns a single-packet message", () => {
+		const framer = new OpenPort2Framer([ISO15765]);
+		framer.push(encodeAdapterPacket(ISO15765, 0x40, message(12, 1)));
+
+		const msg = framer.next();
+		expect(msg?.channelCode).toBe(ISO15765);
+		expect(msg?.data).toEqual(message(12, 1));
+		expect(framer.next()).toBeNull();
+		expect(framer.bufferedBytes).toBe(0);
+	});
+
+	it("reassembles multi-packet messages into one reused buffer", () => {
+		const emulator = new OpenPort2WireEmulator({ maxPacketPayload: 50 });
+		const framer = new OpenPort2Framer([ISO15765]);
+		framer.push(emulator.encodeMessage(message(133, 2)));
+		framer.push(emulator.encodeMessage(message(40, 3)));
+
+		const first = framer.next();
+		expect(first?.data).toEqual(message(133, 2));
+		const firstBuffer = first?.data.buffer;
+
+		const second = framer.next();
+		expect(second?.data).toEqual(message(40, 3));
+		// Views share the channel's reassembly buffer; nothing was allocated
+		expect(second?.data.buffer).toBe(firstBuffer);
+	});
+
+	it("handles packets split at every byte boundary", () => {
+		const emulator = new OpenPort2WireEmulator({ maxPacketPayload: 20 });
+		const stream = emulator.encodeMessage(message(70, 4));
+
+		for (let split = 1; split < stream.length; split++) {
+			const framer = new OpenPort2Framer([ISO15765]);
+			framer.push(stream.subarray(0, split));
+			expect(framer.next()).toBeNull();
+			framer.push(stream.subarray(split));
+			expect(drain(framer)).toEqual([message(70, 4)]);
+		}
+	});
+
+	it("skips control packets, other channels and stray bytes", () => {
+		const framer = new OpenPort2Framer([ISO15765]);
+		framer.push(Uint8Array.of(0x00, 0x13, 0x61));
+		framer.push(encodeAdapterPacket(0x35, 0x40, message(8, 5)));
+		framer.push(encodeAdapterPacket(0x6f, 0x00, Uint8Array.of(0x01)));
+		framer.push(encodeAdapterPacket(ISO15765, 0x40, message(5, 6)));
+
+		expect(drain(framer)).toEqual([message(5, 6)]);
+	});
+
+	it("separates command replies from packets", () => {
+		const encoder = new TextEncoder();
+		const framer = new OpenPort2Framer([ISO15765], { collectReplies: true });
+		framer.push(encoder.encode("aro\r\n"));
+		framer.push(encodeAdapterPacket(ISO15765, 0x40, message(5, 7)));
+		framer.push(encoder.encode("arr 16 1"));
+		expect(drain(framer)).toEqual([message(5, 7)]);
+		framer.push(encoder.encode("2234\r\n"));
+		framer.push(encodeAdapterPacket(ISO15765, 0x40, message(5, 8)));
+		framer.push(encoder.encode("arf6 0 0\r\n"));
+
+		expect(drain(framer)).toEqual([message(5, 8)]);
+		expect(framer.takeReply()).toBe("aro");
+		expect(framer.takeReply()).toBe("arr 16 12234");
+		expect(framer.takeReply()).toBe("arf6 0 0");
+		expect(framer.takeReply()).toBeNull();
+		expect(framer.bufferedBytes).toBe(0);
+	});
+
+	it("keeps messages intact across ring wrap-around and growth", () => {
+		const emulator = new OpenPort2WireEmulator({ maxPacketPayload: 11 });
+		const framer = new OpenPort2Framer([ISO15765], { ringCapacity: 32 });
+		const received: Uint8Array[] = [];
+		const expected: Uint8Array[] = [];
+
+		for (let i = 0; i < 50; i++) {
+			const msg = message(1 + ((i * 7) % 40), i);
+			expected.push(msg);
+			const stream = emulator.encodeMessage(msg);
+			// Uneven pushes move the ring head through every offset
+			for (let at = 0; at < stream.length; at += 13) {
+				framer.push(stream.subarray(at, at + 13));
+				received.push(...drain(framer));
+			}
+		}
+
+		expect(received).toEqual(expected);
+	});
+
+	it("drops a partial message on discardPartialMessages()", () => {
+		const emulator = new OpenPort2WireEmulator({ maxPacketPayload: 10 });
+		const framer = new OpenPort2Framer([ISO15765]);
+		const stream = emulator.encodeMessage(message(25, 7));
+		// START and first NORMAL packets only
+		framer.push(stream.subarray(0, 38));
+		expect(framer.next()).toBeNull();
+
+		framer.discardPartialMessages();
+		framer.push(emulator.encodeMessage(message(3, 8)));
+		expect(drain(framer)).toEqual([message(3, 8)]);
+	});
+
+	it("keeps up with one second of 500 kbps CAN traffic", () => {
+		// 0x63 + 128 bytes behind the CAN ID, as for ROM block reads
+		const length = 4 + 1 + 128;
+		const count = canMessagesPerSecond(length);
+		const emulator = new OpenPort2WireEmulator();
+		for (let i = 0; i < count; i++) {
+			emulator.queueMessage(message(length, i));
+		}
+
+		const framer = new OpenPort2Framer([ISO15765]);
+		const startedAt = performance.now();
+		let received = 0;
+		let buffer: ArrayBufferLike | null = null;
+		while (emulator.pendingBytes > 0) {
+			framer.push(emulator.readTransfer());
+			for (let msg = framer.next(); msg; msg = framer.next()) {
+				expect(msg.data.length).toBe(length);
+				expect(msg.data[0]).toBe(received & 0xff);
+				buffer ??= msg.data.buffer;
+				expect(msg.data.buffer).toBe(buffer);
+				received++;
+			}
+		}
+		const elapsedMs = performance.now() - startedAt;
+
+		expect(received).toBe(count);
+		expect(framer.bufferedBytes).toBe(0);
+		// Far below real time even with per-message assertions
+		expect(elapsedMs).toBeLessThan(1000);
+	});
+});
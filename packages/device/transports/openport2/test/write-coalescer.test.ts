@@ -0,0 +1,115 @@
+import { afterEach, describe, expect, it, vi } from "vitest";
+import { WriteCoalescer } from "../src/write-coalescer.js";
+
+function ascii(bytes: Uint8Array): string {
+	return String.fromCharCode(...bytes);
+}
+
+function recordingWriter() {
+	const transfers: Uint8Array[] = [];
+	const buffers: ArrayBufferLike[] = [];
+	const write = vi.fn(async (data: Uint8Array<ArrayBuffer>) => {
+		transfers.push(data.slice());
+		buffers.push(data.buffer);
+	});
+	return { transfers, buffers, write };
+}
+
+describe("WriteCoalescer", () => {
+	afterEach(() => {
+		vi.useRealTimers();
+	});
+
+	it("packs commands issued together into one transfer", async () => {
+		const { transfers, write } = recordingWriter();
+		const coalescer = new WriteCoalescer(write);
+
+		await Promise.all([
+			coalescer.writeText("ata\r\n"),
+			coalescer.writeFrame("att6 2 0\r\n", Uint8Array.of(0x3e, 0x00)),
+			coalescer.writeFrame(
+				"atf6 1 0 1\r\n",
+				Uint8Array.of(1),
+				Uint8Array.of(2),
+			),
+		]);
+
+		expect(write).toHaveBeenCalledTimes(1);
+		expect(ascii(transfers[0] as Uint8Array)).toBe(
+			"ata\r\natt6 2 0\r\n\x3e\x00atf6 1 0 1\r\n\x01\x02",
+		);
+	});
+
+	it("flushes a batch early when the next command would not fit", async () => {
+		const { transfers, write } = recordingWriter();
+		const coalescer = new WriteCoalescer(write, { maxTransferLength: 20 });
+
+		await Promise.all([
+			coalescer.writeText("atr 16\r\n"),
+			coalescer.writeText("atr 17\r\n"),
+			coalescer.writeText("atr 18\r\n"),
+		]);
+
+		expect(transfers.map(ascii)).toEqual([
+			"atr 16\r\natr 17\r\n",
+			"atr 18\r\n",
+		]);
+	});
+
+	it("sends oversized messages in a transfer of their own", async () => {
+		const { transfers, write } = recordingWriter();
+		const coalescer = new WriteCoalescer(write, { maxTransferLength: 16 });
+		const data = new Uint8Array(40).fill(0xaa);
+
+		await Promise.all([
+			coalescer.writeText("ata\r\n"),
+			coalescer.writeFrame("att6 40 0\r\n", data),
+		]);
+
+		expect(transfers).toHaveLength(2);
+		expect(transfers[1]?.length).toBe(11 + 40);
+		expect(transfers[1]?.subarray(11)).toEqual(data);
+	});
+
+	it("reuses transfer buffers once their writes complete", async () => {
+		const { buffers, write } = recordingWriter();
+		const coalescer = new WriteCoalescer(write);
+
+		await coalescer.writeText("ata\r\n");
+		await coalescer.writeText("ati\r\n");
+
+		expect(buffers).toHaveLength(2);
+		expect(buffers[1]).toBe(buffers[0]);
+	});
+
+	it("rejects every command in a failed transfer", async () => {
+		const coalescer = new WriteCoalescer(async () => {
+			throw new Error("transfer failed");
+		});
+
+		const results = await Promise.allSettled([
+			coalescer.writeText("ata\r\n"),
+			coalescer.writeText("ati\r\n"),
+		]);
+
+		expect(results.map((result) => result.status)).toEqual([
+			"rejected",
+			"rejected",
+		]);
+	});
+
+	it("holds a batch open for flushDelayMs", async () => {
+		vi.useFakeTimers();
+		const { transfers, write } = recordingWriter();
+		const coalescer = new WriteCoalescer(write, { flushDelayMs: 2 });
+
+		const first = coalescer.writeText("ata\r\n");
+		await vi.advanceTimersByTimeAsync(1);
+		const second = coalescer.writeText("ati\r\n");
+		expect(write).not.toHaveBeenCalled();
+
+		await vi.advanceTimersByTimeAsync(1);
+		await Promise.all([first, second]);
+		expect(transfers.map(ascii)).toEqual(["ata\r\nati\r\n"]);
+	});
+});
@@ -26,6 +26,7 @@ import {
 	buildOpenDocumentsContextPayload,
 	buildQuerySyntaxResourceText,
 } from "./resources.js";
+import { handleBinLog } from "./tools/bin-log.js";
 import { handleDiffTables } from "./tools/diff-tables.js";
 import type { PatchTableOptions } from "./tools/patch-table.js";
 
@@ -540,6 +541,110 @@ server.tool(
 	},
 );
 
+// ─── Tool: bin_log ────────────────────────────────────────────────────────────
+
+server.tool(
+	"bin_log",
+	"Bin one log channel onto a table's axes (e.g. AFR or knock by RPM and load) and return per-cell count, mean, min, max or stddev grids shaped like read_table output.",
+	{
+		file: z.string().describe("Filename from list_logs"),
+		rom: z
+			.string()
+			.describe("Absolute or workspace-relative path to the ROM binary"),
+		definition: z
+			.string()
+			.optional()
+			.describe("Optional explicit path to an ECU definition XML file"),
+		table: z.string().describe("1D or 2D table whose axes define the cells"),
+		x: z.string().describe("Log channel matched against the table's X axis"),
+		y: z
+			.string()
+			.optional()
+			.describe("Log channel matched against the Y axis (2D tables only)"),
+		value: z.string().describe("Log channel aggregated per cell"),
+		weight: z
+			.string()
+			.optional()
+			.describe("Optional log channel used as a per-sample weight"),
+		where: z
+			.string()
+			.optional()
+			.describe(
+				"Optional row filter expression using fields from read_log(file), e.g. 'Throttle Position > 80'",
+			),
+		start_s: z
+			.number()
+			.nonnegative()
+			.optional()
+			.describe("Optional start time in seconds"),
+		end_s: z
+			.number()
+			.nonnegative()
+			.optional()
+			.describe("Optional end time in seconds"),
+		weighting: z
+			.enum(["nearest", "interpolate"])
+			.optional()
+			.describe(
+				"'nearest' (default) puts each sample in the cell of the nearest breakpoints; 'interpolate' splits it between the surrounding cells",
+			),
+		stats: z
+			.array(z.enum(["count", "mean", "min", "max", "stddev"]))
+			.optional()
+			.describe("Statistics to return (default count and mean)"),
+		min_count: z
+			.number()
+			.int()
+			.positive()
+			.optional()
+			.describe("Leave cells with fewer samples blank (default 1)"),
+	},
+	async ({
+		file,
+		rom,
+		definition,
+		table,
+		x,
+		y,
+		value,
+		weight,
+		where,
+		start_s,
+		end_s,
+		weighting,
+		stats,
+		min_count,
+	}) => {
+		try {
+			const binLogOptions: Parameters<typeof handleBinLog>[0] = {
+				file,
+				rom,
+				table,
+				x,
+				value,
+			};
+			if (definition !== undefined) binLogOptions.definitionPath = definition;
+			if (y !== undefined) binLogOptions.y = y;
+			if (weight !== undefined) binLogOptions.weight = weight;
+			if (where !== undefined) binLogOptions.where = where;
+			if (start_s !== undefined) binLogOptions.startS = start_s;
+			if (end_s !== undefined) binLogOptions.endS = end_s;
+			if (weighting !== undefined) binLogOptions.weighting = weighting;
+			if (stats !== undefined) binLogOptions.stats = stats;
+			if (min_count !== undefined) binLogOptions.minCount = min_count;
+
+			const content = await handleBinLog(binLogOptions, config);
+			return { content: [{ type: "text", text: content }] };
+		} catch (err) {
+			const message = err instanceof Error ? err.message : String(err);
+			return {
+				content: [{ type: "text", text: `Error: ${message}` }],
+				isError: true,
+			};
+		}
+	},
+);
+
 // ─── Start server ─────────────────────────────────────────────────────────────
 
 const transport = new StdioServerTransport();
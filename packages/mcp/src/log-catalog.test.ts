@@ -0,0 +1,147 @@
+import { appendFile, mkdtemp, rm, utimes, writeFile } from "node:fs/promises";
+import * as os from "node:os";
+import * as path from "node:path";
+import { afterEach, beforeEach, describe, expect, it } from "vitest";
+import { LogCatalog } from "./log-catalog.js";
+
+describe("LogCatalog", () => {
+	let tempDir: string;
+
+	beforeEach(async () => {
+		tempDir = await mkdtemp(path.join(os.tmpdir(), "ecu-log-catalog-"));
+	});
+
+	afterEach(async () => {
+		await rm(tempDir, { recursive: true, force: true });
+	});
+
+	it("keeps running metadata while a log is appended to", async () => {
+		const filePath = path.join(tempDir, "session.csv");
+		await writeFile(
+			filePath,
+			["Timestamp (ms),Engine RPM,AFR", "Unit,rpm,afr", "0,2000,14.7", ""].join(
+				"\n",
+			),
+		);
+		const catalog = new LogCatalog();
+
+		const first = await catalog.get(filePath);
+		expect(first.rowCount).toBe(1);
+		expect(first.durationMs).toBeNull();
+		expect(first.channels).toEqual(["Engine RPM", "AFR"]);
+		expect(first.units).toEqual(["rpm", "afr"]);
+
+		await appendFile(filePath, "100,2500,13.1\n200,3000,\n300,");
+		const grown = await catalog.get(filePath);
+		// The unterminated last row counts, but is not committed yet
+		expect(grown.rowCount).toBe(4);
+		expect(grown.durationMs).toBe(300);
+		expect(grown.sampleRateHz).toBe(10);
+		expect(grown.channelRanges).toEqual([
+			{ min: 2000, max: 3000 },
+			{ min: 13.1, max: 14.7 },
+		]);
+
+		await appendFile(filePath, "3500,12.2\n");
+		const done = await catalog.get(filePath);
+		expect(done.rowCount).toBe(4);
+		expect(done.channelRanges).toEqual([
+			{ min: 2000, max: 3500 },
+			{ min: 12.2, max: 14.7 },
+		]);
+		expect(await catalog.get(filePath)).toBe(done);
+	});
+
+	it("parses a rewritten log from the start", async () => {
+		const filePath = path.join(tempDir, "session.csv");
+		await writeFile(
+			filePath,
+			["Time (s),Engine RPM", "Unit,rpm", "0,2000", "1,2500", "2,3000"].join(
+				"\n",
+			),
+		);
+		const catalog = new LogCatalog();
+		expect((await catalog.get(filePath)).rowCount).toBe(3);
+
+		await writeFile(
+			filePath,
+			["Time (s),Engine RPM", "Unit,rpm", "0,900"].join("\n"),
+		);
+		const rewritten = await catalog.get(filePath);
+		expect(rewritten.rowCount).toBe(1);
+		expect(rewritten.timeUnit).toBe("s");
+		expect(rewritten.timeColumnName).toBe("Time (s)");
+		expect(rewritten.channelRanges).toEqual([{ min: 900, max: 900 }]);
+	});
+
+	it("parses a log overwritten in place with a longer one", async () => {
+		const filePath = path.join(tempDir, "session.csv");
+		await writeFile(
+			filePath,
+			["Time (s),Engine RPM", "Unit,rpm", "0,2000", "1,2500", ""].join("\n"),
+		);
+		const catalog = new LogCatalog();
+		expect((await catalog.get(filePath)).rowCount).toBe(2);
+
+		// Truncate and write, keeping the inode, as editors save files
+		await writeFile(
+			filePath,
+			[
+				"Timestamp (ms),Engine RPM,AFR",
+				"Unit,rpm,afr",
+				"0,900,14.7",
+				"100,950,14.6",
+				"200,1000,14.5",
+				"",
+			].join("\n"),
+		);
+		const rewritten = await catalog.get(filePath);
+		expect(rewritten.channels).toEqual(["Engine RPM", "AFR"]);
+		expect(rewritten.rowCount).toBe(3);
+		expect(rewritten.timeUnit).toBe("ms");
+		expect(rewritten.durationMs).toBe(200);
+		expect(rewritten.channelRanges).toEqual([
+			{ min: 900, max: 1000 },
+			{ min: 14.5, max: 14.7 },
+		]);
+	});
+
+	it("parses a log rewritten with the same header from the start", async () => {
+		const filePath = path.join(tempDir, "session.csv");
+		await writeFile(filePath, "Time (s),Engine RPM\nUnit,rpm\n0,2000\n");
+		const catalog = new LogCatalog();
+		expect((await catalog.get(filePath)).rowCount).toBe(1);
+
+		await writeFile(
+			filePath,
+			"Time (s),Engine RPM\nUnit,rpm\n0,7000\n1,800\n2,900\n",
+		);
+		const rewritten = await catalog.get(filePath);
+		expect(rewritten.rowCount).toBe(3);
+		expect(rewritten.channelRanges).toEqual([{ min: 800, max: 7000 }]);
+	});
+
+	it("lists logs newest first and forgets deleted ones", async () => {
+		const older = path.join(tempDir, "older.csv");
+		const newer = path.join(tempDir, "newer.csv");
+		await writeFile(older, "Timestamp (ms),RPM\nUnit,rpm\n0,1000\n");
+		await writeFile(newer, "Timestamp (ms),RPM\nUnit,rpm\n");
+		await writeFile(path.join(tempDir, "notes.txt"), "not a log");
+		const catalog = new LogCatalog();
+
+		await utimes(older, new Date(1_000_000), new Date(1_000_000));
+
+		const files = await catalog.list(tempDir);
+		expect(files.map((file) => file.fileName)).toEqual([
+			"newer.csv",
+			"older.csv",
+		]);
+		expect(files[0]?.rowCount).toBe(0);
+
+		await rm(older);
+		expect(
+			(await catalog.list(tempDir)).map((file) => file.fileName),
+		).toEqual(["newer.csv"]);
+		await expect(catalog.get(older)).rejects.toThrow();
+	});
+});
@@ -0,0 +1,410 @@
+/**
+ * Log catalog for the ECU Explorer MCP server.
+ *
+ * Keeps running metadata (row count, duration, sample rate, per-channel
+ * ranges) for each log file in memory. A file is only stat'ed when its
+ * metadata is requested: an unchanged file is answered from memory, a
+ * growing one has just its appended bytes parsed, and a truncated or
+ * rewritten one is parsed again from the start. A file that grew is only
+ * treated as appended to if its first bytes and the last bytes already
+ * parsed are unchanged, since editors rewrite files in place. Logs the
+ * LoggingManager is still writing therefore cost one `stat`, two small
+ * reads and the new rows per call.
+ */
+
+import type { Stats } from "node:fs";
+import * as fs from "node:fs/promises";
+import * as path from "node:path";
+import {
+	detectTimeColumnIndex,
+	detectTimeUnit,
+	splitCsvLine,
+	toMilliseconds,
+} from "./log-csv.js";
+import type { LogFile } from "./log-reader.js";
+
+/** Bytes read per `read` call while catching up on a file */
+const READ_CHUNK_BYTES = 1 << 20;
+
+/** Bytes kept from the start and from the end of the consumed region */
+const CHECK_BYTES = 4096;
+
+const NEWLINE = 0x0a;
+
+const decoder = new TextDecoder();
+
+/**
+ * Running metadata over the lines of a log.
+ *
+ * Lines follow the LoggingManager layout: header, units row, then data.
+ * Blank lines are ignored.
+ */
+class LogTally {
+	headerFields: string[] | null = null;
+	unitFields: string[] | null = null;
+	timeColumnName: string | null = null;
+	timeUnit: "ms" | "s" | null = null;
+	rowCount = 0;
+	firstTimestamp = Number.NaN;
+	lastTimestamp = Number.NaN;
+	/** Per channel, parallel to the header fields after the first */
+	min: number[] = [];
+	max: number[] = [];
+	private timeIndex = 0;
+
+	addLine(line: string): void {
+		if (line.trim().length === 0) return;
+		const fields = splitCsvLine(line);
+
+		if (this.headerFields === null) {
+			const timeColIdx = detectTimeColumnIndex(fields);
+			this.headerFields = fields;
+			this.timeColumnName =
+				timeColIdx >= 0 ? (fields[timeColIdx] ?? null) : null;
+			// Without a recognizable time header the first column is the timestamp
+			this.timeIndex = Math.max(0, timeColIdx);
+			this.timeUnit = detectTimeUnit(fields[this.timeIndex]);
+			const channelCount = Math.max(0, fields.length - 1);
+			this.min = new Array<number>(channelCount).fill(
+				Number.POSITIVE_INFINITY,
+			);
+			this.max = new Array<number>(channelCount).fill(
+				Number.NEGATIVE_INFINITY,
+			);
+			return;
+		}
+		if (this.unitFields === null) {
+			this.unitFields = fields;
+			return;
+		}
+
+		const timestamp = Number.parseFloat(fields[this.timeIndex] ?? "");
+		if (this.rowCount === 0) this.firstTimestamp = timestamp;
+		this.lastTimestamp = timestamp;
+		this.rowCount++;
+
+		for (let i = 0; i < this.min.length; i++) {
+			const value = Number.parseFloat(fields[i + 1] ?? "");
+			if (!Number.isFinite(value)) continue;
+			if (value < (this.min[i] as number)) this.min[i] = value;
+			if (value > (this.max[i] as number)) this.max[i] = value;
+		}
+	}
+
+	clone(): LogTally {
+		const copy = new LogTally();
+		Object.assign(copy, this);
+		copy.min = this.min.slice();
+		copy.max = this.max.slice();
+		return copy;
+	}
+
+	toLogFile(filePath: string, stat: { size: number; mtime: Date }): LogFile {
+		const base = {
+			filePath,
+			fileName: path.basename(filePath),
+			fileSizeBytes: stat.size,
+			mtime: stat.mtime,
+		};
+		if (this.headerFields === null || this.unitFields === null) {
+			return {
+				...base,
+				channels: [],
+				units: [],
+				rowCount: 0,
+				durationMs: null,
+				sampleRateHz: null,
+				timeUnit: null,
+				headers: [],
+				timeColumnName: null,
+				channelRanges: [],
+			};
+		}
+
+		let durationMs: number | null = null;
+		let sampleRateHz: number | null = null;
+		if (
+			this.rowCount > 1 &&
+			Number.isFinite(this.firstTimestamp) &&
+			Number.isFinite(this.lastTimestamp)
+		) {
+			durationMs = toMilliseconds(
+				this.lastTimestamp - this.firstTimestamp,
+				this.timeUnit,
+			);
+			const durationS = durationMs / 1000;
+			if (durationS > 0) {
+				sampleRateHz = (this.rowCount - 1) / durationS;
+			}
+		}
+
+		return {
+			...base,
+			channels: this.headerFields.slice(1),
+			units: this.unitFields.slice(1),
+			rowCount: this.rowCount,
+			durationMs,
+			sampleRateHz,
+			timeUnit: this.timeUnit,
+			headers: this.headerFields,
+			timeColumnName: this.timeColumnName,
+			channelRanges: this.min.map((min, i) => {
+				const max = this.max[i] as number;
+				return min <= max ? { min, max } : null;
+			}),
+		};
+	}
+}
+
+interface CatalogEntry {
+	ino: number;
+	mtimeMs: number;
+	/** Bytes of the file consumed so far */
+	size: number;
+	/** Complete lines seen so far */
+	tally: LogTally;
+	/** Bytes after the last newline: a row the logger is still writing */
+	pending: Uint8Array;
+	/** First bytes of the file, up to {@link CHECK_BYTES} */
+	head: Uint8Array;
+	/** Last bytes consumed, up to {@link CHECK_BYTES}, ending at `size` */
+	tail: Uint8Array;
+	/** Metadata as of `size`; null until the first read completes */
+	file: LogFile | null;
+}
+
+/**
+ * In-memory catalog of log file metadata, updated incrementally.
+ */
+export class LogCatalog {
+	private readonly entries = new Map<string, CatalogEntry>();
+	private readonly refreshes = new Map<string, Promise<LogFile>>();
+
+	/**
+	 * Get metadata of a log file, parsing only what changed since the last
+	 * call.
+	 *
+	 * @param filePath - Absolute path to the log CSV file
+	 * @returns Log file metadata
+	 */
+	get(filePath: string): Promise<LogFile> {
+		// Serialize refreshes of one file so appended bytes are consumed once
+		const previous = this.refreshes.get(filePath);
+		const refresh = (previous ?? Promise.resolve())
+			.catch(() => undefined)
+			.then(() => this.refresh(filePath));
+		this.refreshes.set(filePath, refresh);
+		const settle = () => {
+			if (this.refreshes.get(filePath) === refresh) {
+				this.refreshes.delete(filePath);
+			}
+		};
+		refresh.then(settle, settle);
+		return refresh;
+	}
+
+	/**
+	 * List the log files in a directory.
+	 *
+	 * Files that can't be read are skipped, and cached entries of files no
+	 * longer in the directory are dropped.
+	 *
+	 * @param logsDir - Directory to scan for CSV log files
+	 * @returns Log file metadata, sorted by mtime descending (newest first)
+	 */
+	async list(logsDir: string): Promise<LogFile[]> {
+		let entries: string[];
+		try {
+			const dirEntries = await fs.readdir(logsDir);
+			entries = dirEntries.filter((e) => e.toLowerCase().endsWith(".csv"));
+		} catch {
+			return [];
+		}
+
+		const listed = new Set<string>();
+		const files: LogFile[] = [];
+		for (const entry of entries) {
+			const filePath = path.join(logsDir, entry);
+			listed.add(filePath);
+			try {
+				files.push(await this.get(filePath));
+			} catch {
+				// Skip files that can't be read
+			}
+		}
+
+		const dir = path.join(logsDir, ".");
+		for (const filePath of this.entries.keys()) {
+			if (path.dirname(filePath) === dir && !listed.has(filePath)) {
+				this.entries.delete(filePath);
+			}
+		}
+
+		// Sort by mtime descending (newest first)
+		files.sort((a, b) => b.mtime.getTime() - a.mtime.getTime());
+		return files;
+	}
+
+	private async refresh(filePath: string): Promise<LogFile> {
+		let stat: Stats;
+		try {
+			stat = await fs.stat(filePath);
+		} catch (error) {
+			this.entries.delete(filePath);
+			throw error;
+		}
+
+		const cached = this.entries.get(filePath);
+		if (
+			cached?.file &&
+			cached.ino === stat.ino &&
+			cached.size === stat.size &&
+			cached.mtimeMs === stat.mtimeMs
+		) {
+			return cached.file;
+		}
+
+		// Logs only ever grow; anything else means the file was rewritten
+		const appended =
+			cached !== undefined &&
+			cached.ino === stat.ino &&
+			stat.size > cached.size &&
+			(await this.isConsumedUnchanged(filePath, cached));
+		const entry: CatalogEntry =
+			appended && cached
+				? cached
+				: {
+						ino: stat.ino,
+						mtimeMs: stat.mtimeMs,
+						size: 0,
+						tally: new LogTally(),
+						pending: new Uint8Array(0),
+						head: new Uint8Array(0),
+						tail: new Uint8Array(0),
+						file: null,
+					};
+		this.entries.delete(filePath);
+
+		await this.readAppended(filePath, entry, stat.size);
+
+		let tally = entry.tally;
+		if (entry.pending.length > 0) {
+			// Count the unterminated last row without committing it
+			tally = tally.clone();
+			tally.addLine(decoder.decode(entry.pending));
+		}
+		entry.ino = stat.ino;
+		entry.mtimeMs = stat.mtimeMs;
+		const file = tally.toLogFile(filePath, {
+			size: entry.size,
+			mtime: stat.mtime,
+		});
+		entry.file = file;
+		this.entries.set(filePath, entry);
+		return file;
+	}
+
+	/**
+	 * Whether the bytes `entry` was built from are still at the start of the
+	 * file, judged by its first and last consumed bytes.
+	 */
+	private async isConsumedUnchanged(
+		filePath: string,
+		entry: CatalogEntry,
+	): Promise<boolean> {
+		const handle = await fs.open(filePath, "r");
+		try {
+			const head = await readAt(handle, entry.head.length, 0);
+			const tail = await readAt(
+				handle,
+				entry.tail.length,
+				entry.size - entry.tail.length,
+			);
+			return sameBytes(head, entry.head) && sameBytes(tail, entry.tail);
+		} finally {
+			await handle.close();
+		}
+	}
+
+	/**
+	 * Feed the complete lines between `entry.size` and `size` to the tally.
+	 */
+	private async readAppended(
+		filePath: string,
+		entry: CatalogEntry,
+		size: number,
+	): Promise<void> {
+		const handle = await fs.open(filePath, "r");
+		try {
+			let position = entry.size;
+			while (position < size) {
+				const carried = entry.pending.length;
+				const length = Math.min(READ_CHUNK_BYTES, size - position);
+				const chunk = new Uint8Array(carried + length);
+				chunk.set(entry.pending);
+				const { bytesRead } = await handle.read(
+					chunk,
+					carried,
+					length,
+					position,
+				);
+				if (bytesRead === 0) break;
+				position += bytesRead;
+
+				const filled = chunk.subarray(0, carried + bytesRead);
+				const read = filled.subarray(carried);
+				if (entry.head.length < CHECK_BYTES) {
+					const missing = CHECK_BYTES - entry.head.length;
+					entry.head = concat(entry.head, read.subarray(0, missing));
+				}
+				entry.tail =
+					read.length >= CHECK_BYTES
+						? read.slice(-CHECK_BYTES)
+						: concat(entry.tail, read).slice(-CHECK_BYTES);
+
+				const end = filled.lastIndexOf(NEWLINE);
+				if (end >= 0) {
+					const text = decoder.decode(filled.subarray(0, end));
+					for (const line of text.split("\n")) {
+						entry.tally.addLine(line);
+					}
+				}
+				entry.pending = filled.slice(end + 1);
+			}
+			entry.size = position;
+		} finally {
+			await handle.close();
+		}
+	}
+}
+
+async function readAt(
+	handle: fs.FileHandle,
+	length: number,
+	position: number,
+): Promise<Uint8Array> {
+	const buffer = new Uint8Array(length);
+	let filled = 0;
+	while (filled < length) {
+		const { bytesRead } = await handle.read(
+			buffer,
+			filled,
+			length - filled,
+			position + filled,
+		);
+		if (bytesRead === 0) break;
+		filled += bytesRead;
+	}
+	return buffer.subarray(0, filled);
+}
+
+function concat(a: Uint8Array, b: Uint8Array): Uint8Array {
+	const joined = new Uint8Array(a.length + b.length);
+	joined.set(a);
+	joined.set(b, a.length);
+	return joined;
+}
+
+function sameBytes(a: Uint8Array, b: Uint8Array): boolean {
+	return a.length === b.length && a.every((byte, i) => byte === b[i]);
+}
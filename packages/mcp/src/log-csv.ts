@@ -0,0 +1,101 @@
+/**
+ * CSV line and time-column helpers for log files.
+ *
+ * Shared by the log reader, which parses whole files, and the log catalog,
+ * which parses appended lines as a log grows.
+ */
+
+/**
+ * Parse a CSV line, handling quoted fields.
+ *
+ * @param line - CSV line to parse
+ * @returns Array of field values
+ */
+export function parseCsvLine(line: string): string[] {
+	const fields: string[] = [];
+	let current = "";
+	let inQuotes = false;
+
+	for (let i = 0; i < line.length; i++) {
+		const ch = line[i];
+		if (ch === '"') {
+			inQuotes = !inQuotes;
+		} else if (ch === "," && !inQuotes) {
+			fields.push(current);
+			current = "";
+		} else {
+			current += ch;
+		}
+	}
+	fields.push(current);
+	return fields;
+}
+
+/**
+ * Split a CSV line into fields.
+ *
+ * Logger output is never quoted; only falls back to the quote-aware
+ * {@link parseCsvLine} when needed.
+ */
+export function splitCsvLine(line: string): string[] {
+	return line.includes('"') ? parseCsvLine(line) : line.split(",");
+}
+
+/**
+ * Detect the time column index from header fields.
+ * Returns the index of the first column that looks like a time column,
+ * or -1 if none found.
+ */
+export function detectTimeColumnIndex(headerFields: string[]): number {
+	for (let i = 0; i < headerFields.length; i++) {
+		const h = (headerFields[i] ?? "").toLowerCase();
+		if (
+			h.includes("time") ||
+			h.includes("timestamp") ||
+			h === "t" ||
+			h === "t (s)" ||
+			h === "time (s)"
+		) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+export function detectTimeUnit(
+	headerName: string | undefined,
+): "ms" | "s" | null {
+	if (!headerName) return null;
+	const normalized = headerName.toLowerCase();
+
+	if (
+		normalized.includes("(ms)") ||
+		normalized.includes("milliseconds") ||
+		normalized.includes("timestamp_ms")
+	) {
+		return "ms";
+	}
+
+	if (
+		normalized.includes("(s)") ||
+		normalized.includes("seconds") ||
+		normalized.includes("timestamp_s")
+	) {
+		return "s";
+	}
+
+	return null;
+}
+
+export function toSeconds(value: number, unit: "ms" | "s" | null): number {
+	if (unit === "ms") return value / 1000;
+	return value;
+}
+
+export function toMilliseconds(
+	value: number,
+	unit: "ms" | "s" | null,
+): number {
+	if (unit === "s") return value * 1000;
+	return value;
+}
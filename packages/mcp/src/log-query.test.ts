@@ -0,0 +1,79 @@
+import { describe, expect, it } from "vitest";
+import { compileLogPredicate, runLogQuery } from "./log-query.js";
+
+const columns = new Map<string, Float64Array>([
+	["rpm", Float64Array.from([1000, 2500, 4000, 5500, Number.NaN])],
+	["load", Float64Array.from([0.5, 1.2, 1.8, 2.1, 1.5])],
+	["knock", Float64Array.from([0, 0, 2, 0, 1])],
+]);
+
+function matching(expression: string): number[] {
+	const predicate = compileLogPredicate(expression, columns);
+	return [0, 1, 2, 3, 4].filter((row) => predicate(row));
+}
+
+describe("compileLogPredicate", () => {
+	it("evaluates comparisons and boolean operators", () => {
+		expect(matching("rpm > 2000 and load < 2")).toEqual([1, 2]);
+		expect(matching("knock > 0 or load == 0.5")).toEqual([0, 2, 4]);
+		expect(matching("not (knock > 0)")).toEqual([0, 1, 3]);
+		expect(matching("rpm != 2500 and knock == 0")).toEqual([0, 3]);
+	});
+
+	it("evaluates arithmetic with filtrex precedence", () => {
+		expect(matching("rpm * load / 1000 >= 7.5")).toEqual([3]);
+		expect(matching("2 ^ 3 ^ 2 == 512 and -knock < 0")).toEqual([2, 4]);
+		expect(matching("abs(load - 2) < 0.3 or max(rpm, 3000) == rpm")).toEqual([
+			2, 3,
+		]);
+	});
+
+	it("never matches rows missing a referenced value", () => {
+		expect(matching("rpm > 0 or knock > 0")).toEqual([0, 1, 2, 3]);
+		expect(matching("not (rpm > 0)")).toEqual([]);
+	});
+});
+
+describe("runLogQuery", () => {
+	const timeMs = Float64Array.from([0, 100, 200, 300, 400]);
+
+	it("limits the scan to the time range", () => {
+		const seen: number[] = [];
+		const { rows } = runLogQuery(5, {
+			timeMs,
+			startMs: 100,
+			endMs: 300,
+			where: (row) => {
+				seen.push(row);
+				return row !== 2;
+			},
+		});
+		expect(Array.from(rows)).toEqual([1, 3]);
+		expect(seen).toEqual([1, 2, 3]);
+	});
+
+	it("filters unsorted timestamps row by row", () => {
+		const { rows } = runLogQuery(5, {
+			timeMs: Float64Array.from([300, 100, Number.NaN, 400, 0]),
+			startMs: 50,
+			endMs: 350,
+		});
+		expect(Array.from(rows)).toEqual([0, 1, 2]);
+	});
+
+	it("applies step_ms to matching rows and aggregates the selection", () => {
+		const { rows, stats } = runLogQuery(5, {
+			timeMs,
+			stepMs: 150,
+			where: (row) => row !== 1,
+			statsColumns: [
+				columns.get("rpm") as Float64Array,
+				new Float64Array(5).fill(Number.NaN),
+			],
+		});
+		expect(Array.from(rows)).toEqual([0, 2, 4]);
+		expect(stats[0]).toEqual({ count: 2, min: 1000, max: 4000, mean: 2500 });
+		expect(stats[1]?.count).toBe(0);
+		expect(stats[1]?.mean).toBeNaN();
+	});
+});
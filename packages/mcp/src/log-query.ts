@@ -0,0 +1,510 @@
+/**
+ * Columnar query engine for read_log.
+ *
+ * A log is held as one `Float64Array` per column (see
+ * `parseLogFileColumns`). A `where` expression is compiled once into a row
+ * predicate that reads those arrays directly, and {@link runLogQuery} scans
+ * the rows in a single pass: time range, predicate, step thinning and
+ * per-channel aggregates, producing a selection vector of row indices.
+ * Nothing is allocated per row.
+ */
+
+import { compileExpression } from "filtrex";
+import {
+	buildFieldAliasMap,
+	buildUnknownFieldError,
+	detectUnknownFieldFragments,
+	extractReferencedFields,
+	normalizeExpression,
+	rewriteExpressionWithAliases,
+} from "./query-utils.js";
+
+/**
+ * Test whether a row (by index) matches.
+ */
+export type RowPredicate = (row: number) => boolean;
+
+export interface LogQueryOptions {
+	/** Row filter from {@link compileLogPredicate} */
+	where?: RowPredicate;
+	/** Row timestamps in milliseconds; required for the range and step options */
+	timeMs?: Float64Array | null;
+	/** Start of the time range in milliseconds (inclusive) */
+	startMs?: number;
+	/** End of the time range in milliseconds (inclusive) */
+	endMs?: number;
+	/** Minimum spacing between returned rows, applied after `where` */
+	stepMs?: number;
+	/** Columns to aggregate over the selected rows */
+	statsColumns?: readonly Float64Array[];
+}
+
+export interface ColumnStats {
+	/** Number of selected rows with a value in this column */
+	count: number;
+	/** NaN when `count` is 0 */
+	min: number;
+	/** NaN when `count` is 0 */
+	max: number;
+	/** NaN when `count` is 0 */
+	mean: number;
+}
+
+export interface LogQueryResult {
+	/** Indices of the selected rows, ascending */
+	rows: Uint32Array;
+	/** Aggregates, parallel to `statsColumns` */
+	stats: ColumnStats[];
+}
+
+/**
+ * Select rows from a columnar log.
+ *
+ * Rows outside `[startMs, endMs]` are skipped first; when the time column
+ * is sorted the range is found by binary search, so `where` only runs on
+ * rows inside it. Rows without a timestamp pass the range but are dropped
+ * by `stepMs`.
+ *
+ * @param rowCount - Number of rows in the log
+ * @param options - Selection and aggregation options
+ * @returns Selected rows and their aggregates
+ */
+export function runLogQuery(
+	rowCount: number,
+	options: LogQueryOptions = {},
+): LogQueryResult {
+	const { where, timeMs = null, stepMs, statsColumns = [] } = options;
+	const start = options.startMs ?? Number.NEGATIVE_INFINITY;
+	const end = options.endMs ?? Number.POSITIVE_INFINITY;
+
+	let lo = 0;
+	let hi = rowCount;
+	if (
+		timeMs !== null &&
+		(options.startMs !== undefined || options.endMs !== undefined) &&
+		isSorted(timeMs, rowCount)
+	) {
+		lo = lowerBound(timeMs, rowCount, start);
+		hi = Math.max(lo, upperBound(timeMs, rowCount, end));
+	}
+
+	const statCount = statsColumns.length;
+	const min = new Float64Array(statCount).fill(Number.POSITIVE_INFINITY);
+	const max = new Float64Array(statCount).fill(Number.NEGATIVE_INFINITY);
+	const sum = new Float64Array(statCount);
+	const counts = new Uint32Array(statCount);
+
+	const selected = new Uint32Array(hi - lo);
+	let count = 0;
+	let lastTime = Number.NEGATIVE_INFINITY;
+	for (let row = lo; row < hi; row++) {
+		if (timeMs !== null) {
+			const t = timeMs[row] as number;
+			if (t < start || t > end) continue;
+		}
+		if (where !== undefined && !where(row)) continue;
+		if (stepMs !== undefined) {
+			const t = timeMs !== null ? (timeMs[row] as number) : Number.NaN;
+			// NaN (no timestamp) fails the comparison and is dropped
+			if (!(t - lastTime >= stepMs)) continue;
+			lastTime = t;
+		}
+
+		selected[count++] = row;
+		for (let j = 0; j < statCount; j++) {
+			const value = (statsColumns[j] as Float64Array)[row] as number;
+			if (value !== value) continue;
+			if (value < (min[j] as number)) min[j] = value;
+			if (value > (max[j] as number)) max[j] = value;
+			sum[j] = (sum[j] as number) + value;
+			counts[j] = (counts[j] as number) + 1;
+		}
+	}
+
+	const stats: ColumnStats[] = [];
+	for (let j = 0; j < statCount; j++) {
+		const n = counts[j] as number;
+		stats.push(
+			n > 0
+				? {
+						count: n,
+						min: min[j] as number,
+						max: max[j] as number,
+						mean: (sum[j] as number) / n,
+					}
+				: { count: 0, min: Number.NaN, max: Number.NaN, mean: Number.NaN },
+		);
+	}
+
+	return { rows: selected.subarray(0, count), stats };
+}
+
+/**
+ * Compile a user `where` expression over the columns of a parsed log.
+ *
+ * Field names are validated against the headers and rewritten to aliases
+ * before {@link compileLogPredicate}; when a header repeats, its last
+ * column is used.
+ *
+ * @param where - Expression as written by the caller
+ * @param headers - Log headers, parallel to `columns`
+ * @param columns - Log columns
+ * @returns Row predicate and the fields it references
+ * @throws Error naming unknown fields or describing an invalid expression
+ */
+export function compileLogWhere(
+	where: string,
+	headers: readonly string[],
+	columns: readonly Float64Array[],
+): { predicate: RowPredicate; referencedFields: string[] } {
+	const fields = [...headers];
+	const referencedFields = extractReferencedFields(where, fields);
+	const unknownFragments = detectUnknownFieldFragments(where, fields);
+	if (unknownFragments.length > 0) {
+		throw buildUnknownFieldError("field", unknownFragments, fields);
+	}
+
+	const { fieldToAlias } = buildFieldAliasMap(fields, "__log_");
+	const rewritten = rewriteExpressionWithAliases(
+		normalizeExpression(where),
+		fieldToAlias,
+	);
+	const columnsByAlias = new Map<string, Float64Array>();
+	fields.forEach((header, i) => {
+		const alias = fieldToAlias.get(header);
+		const column = columns[i];
+		if (alias !== undefined && column) columnsByAlias.set(alias, column);
+	});
+
+	try {
+		return {
+			predicate: compileLogPredicate(rewritten, columnsByAlias),
+			referencedFields,
+		};
+	} catch (err) {
+		throw new Error(
+			`Invalid where expression: ${err instanceof Error ? err.message : String(err)}. Available fields: ${fields.join(", ")}`,
+		);
+	}
+}
+
+/**
+ * Compile a `where` expression into a row predicate over columns.
+ *
+ * The expression uses filtrex syntax with fields already rewritten to
+ * identifiers (see `rewriteExpressionWithAliases`). Arithmetic,
+ * comparisons, `and`/`or`/`not` and the common math functions are
+ * translated to a JavaScript function that indexes the column arrays
+ * directly. Anything else falls back to filtrex, evaluated against one
+ * reused row object. Either way, a row with no value in a referenced
+ * column never matches.
+ *
+ * @param expression - Rewritten expression
+ * @param columns - Columns by identifier
+ * @returns Row predicate
+ * @throws Error from filtrex if the expression is invalid
+ */
+export function compileLogPredicate(
+	expression: string,
+	columns: ReadonlyMap<string, Float64Array>,
+): RowPredicate {
+	let compiled: CompiledExpression | null = null;
+	try {
+		compiled = new ExpressionCompiler(expression, columns).compile();
+	} catch (error) {
+		if (!(error instanceof UnsupportedExpressionError)) throw error;
+	}
+	if (compiled) {
+		const { source, referenced } = compiled;
+		const params = referenced.map((_, i) => `c${i}`);
+		const guards = params
+			.map((param, i) => `const v${i} = ${param}[r];`)
+			.concat(params.map((_, i) => `if (v${i} !== v${i}) return false;`))
+			.join(" ");
+		// Built only from validated tokens: numbers, column reads, operators
+		// and Math functions
+		const factory = new Function(
+			...params,
+			`"use strict"; return (r) => { ${guards} return !!(${source}); };`,
+		) as (...args: Float64Array[]) => RowPredicate;
+		return factory(...referenced);
+	}
+	return compileFiltrexPredicate(expression, columns);
+}
+
+function compileFiltrexPredicate(
+	expression: string,
+	columns: ReadonlyMap<string, Float64Array>,
+): RowPredicate {
+	const filter = compileExpression(expression) as (
+		obj: Record<string, number>,
+	) => unknown;
+	const names = [
+		...new Set(expression.match(/[A-Za-z_$][\w$]*/g) ?? []),
+	].filter((name) => columns.has(name));
+	const referenced = names.map((name) => columns.get(name) as Float64Array);
+	const row: Record<string, number> = {};
+	return (r) => {
+		for (let i = 0; i < referenced.length; i++) {
+			const value = (referenced[i] as Float64Array)[r] as number;
+			if (value !== value) return false;
+			row[names[i] as string] = value;
+		}
+		try {
+			const result = filter(row);
+			return !(result instanceof Error) && Boolean(result);
+		} catch {
+			return false;
+		}
+	};
+}
+
+function isSorted(values: Float64Array, length: number): boolean {
+	for (let i = 1; i < length; i++) {
+		// Also false for NaN, which the range must keep
+		if (!((values[i] as number) >= (values[i - 1] as number))) return false;
+	}
+	return length === 0 || !Number.isNaN(values[0]);
+}
+
+/** First index whose value is ≥ `target` */
+function lowerBound(values: Float64Array, length: number, target: number) {
+	let lo = 0;
+	let hi = length;
+	while (lo < hi) {
+		const mid = (lo + hi) >>> 1;
+		if ((values[mid] as number) < target) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+/** First index whose value is > `target` */
+function upperBound(values: Float64Array, length: number, target: number) {
+	let lo = 0;
+	let hi = length;
+	while (lo < hi) {
+		const mid = (lo + hi) >>> 1;
+		if ((values[mid] as number) <= target) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+// ─── Expression translation ──────────────────────────────────────────────────
+
+class UnsupportedExpressionError extends Error {}
+
+interface CompiledExpression {
+	/** JavaScript expression reading `v<i>` for each referenced column */
+	source: string;
+	referenced: Float64Array[];
+}
+
+type Token =
+	| { kind: "number"; text: string }
+	| { kind: "name"; text: string }
+	| { kind: "op"; text: string };
+
+const MATH_FUNCTIONS: Readonly<Record<string, string>> = {
+	abs: "Math.abs",
+	ceil: "Math.ceil",
+	floor: "Math.floor",
+	log: "Math.log",
+	log2: "Math.log2",
+	log10: "Math.log10",
+	max: "Math.max",
+	min: "Math.min",
+	round: "Math.round",
+	sqrt: "Math.sqrt",
+};
+
+const COMPARISONS = new Set(["<", "<=", ">", ">="]);
+const EQUALITY: Readonly<Record<string, string>> = { "==": "===", "!=": "!==" };
+
+const TOKEN_PATTERN =
+	/\s*(?:(\d+(?:\.\d+)?(?:[eE][+-]?\d+)?)|([A-Za-z_$][\w$]*)|(<=|>=|==|!=|[-+*/^(),<>]))/y;
+
+/**
+ * Recursive-descent translator for the filtrex subset the engine runs
+ * natively. Precedence follows filtrex, lowest first: `or`, `and`,
+ * equality, comparison, `+ -`, `* /`, `not`, `^`, unary minus. Anything
+ * outside the subset (strings, `in`, `mod`, ternaries, chained
+ * comparisons, unknown names) raises {@link UnsupportedExpressionError}.
+ */
+class ExpressionCompiler {
+	private readonly tokens: Token[] = [];
+	private pos = 0;
+	private readonly referenced: Float64Array[] = [];
+	private readonly slots = new Map<string, number>();
+
+	constructor(
+		expression: string,
+		private readonly columns: ReadonlyMap<string, Float64Array>,
+	) {
+		let index = 0;
+		while (index < expression.length) {
+			if (expression.slice(index).trim() === "") break;
+			TOKEN_PATTERN.lastIndex = index;
+			const match = TOKEN_PATTERN.exec(expression);
+			if (!match) throw new UnsupportedExpressionError();
+			if (match[1] !== undefined) {
+				this.tokens.push({ kind: "number", text: match[1] });
+			} else if (match[2] !== undefined) {
+				this.tokens.push({ kind: "name", text: match[2] });
+			} else {
+				this.tokens.push({ kind: "op", text: match[3] as string });
+			}
+			index = TOKEN_PATTERN.lastIndex;
+		}
+	}
+
+	compile(): CompiledExpression {
+		const source = this.or();
+		if (this.pos !== this.tokens.length) {
+			throw new UnsupportedExpressionError();
+		}
+		return { source, referenced: this.referenced };
+	}
+
+	private peek(): Token | undefined {
+		return this.tokens[this.pos];
+	}
+
+	private accept(kind: Token["kind"], text: string): boolean {
+		const token = this.peek();
+		if (token?.kind === kind && token.text === text) {
+			this.pos++;
+			return true;
+		}
+		return false;
+	}
+
+	private expect(text: string): void {
+		if (!this.accept("op", text)) throw new UnsupportedExpressionError();
+	}
+
+	private or(): string {
+		let left = this.and();
+		while (this.accept("name", "or")) {
+			left = `(!!(${left}) || !!(${this.and()}))`;
+		}
+		return left;
+	}
+
+	private and(): string {
+		let left = this.equality();
+		while (this.accept("name", "and")) {
+			left = `(!!(${left}) && !!(${this.equality()}))`;
+		}
+		return left;
+	}
+
+	private equality(): string {
+		let left = this.comparison();
+		for (;;) {
+			const token = this.peek();
+			const op = token?.kind === "op" ? EQUALITY[token.text] : undefined;
+			if (op === undefined) return left;
+			this.pos++;
+			left = `(${left} ${op} ${this.comparison()})`;
+		}
+	}
+
+	private comparison(): string {
+		const left = this.additive();
+		const token = this.peek();
+		if (token?.kind !== "op" || !COMPARISONS.has(token.text)) return left;
+		this.pos++;
+		const right = this.additive();
+		const next = this.peek();
+		if (next?.kind === "op" && COMPARISONS.has(next.text)) {
+			// Chained comparisons have filtrex-specific semantics
+			throw new UnsupportedExpressionError();
+		}
+		return `(${left} ${token.text} ${right})`;
+	}
+
+	private additive(): string {
+		let left = this.multiplicative();
+		for (;;) {
+			const token = this.peek();
+			if (token?.kind !== "op" || (token.text !== "+" && token.text !== "-")) {
+				return left;
+			}
+			this.pos++;
+			left = `(${left} ${token.text} ${this.multiplicative()})`;
+		}
+	}
+
+	private multiplicative(): string {
+		let left = this.not();
+		for (;;) {
+			const token = this.peek();
+			if (token?.kind !== "op" || (token.text !== "*" && token.text !== "/")) {
+				return left;
+			}
+			this.pos++;
+			left = `(${left} ${token.text} ${this.not()})`;
+		}
+	}
+
+	private not(): string {
+		if (this.accept("name", "not")) {
+			return `(!(${this.not()}))`;
+		}
+		return this.power();
+	}
+
+	private power(): string {
+		const base = this.unary();
+		if (this.accept("op", "^")) {
+			// Right-associative
+			return `Math.pow(${base}, ${this.power()})`;
+		}
+		return base;
+	}
+
+	private unary(): string {
+		if (this.accept("op", "-")) {
+			return `(-${this.unary()})`;
+		}
+		return this.primary();
+	}
+
+	private primary(): string {
+		const token = this.peek();
+		if (!token) throw new UnsupportedExpressionError();
+		this.pos++;
+
+		if (token.kind === "number") {
+			return `${Number(token.text)}`;
+		}
+		if (token.kind === "op") {
+			if (token.text !== "(") throw new UnsupportedExpressionError();
+			const inner = this.or();
+			this.expect(")");
+			return `(${inner})`;
+		}
+
+		const fn = MATH_FUNCTIONS[token.text];
+		if (fn !== undefined && this.accept("op", "(")) {
+			const args = [this.or()];
+			while (this.accept("op", ",")) {
+				args.push(this.or());
+			}
+			this.expect(")");
+			return `${fn}(${args.join(", ")})`;
+		}
+
+		const column = this.columns.get(token.text);
+		if (!column) throw new UnsupportedExpressionError();
+		let slot = this.slots.get(token.text);
+		if (slot === undefined) {
+			slot = this.referenced.length;
+			this.slots.set(token.text, slot);
+			this.referenced.push(column);
+		}
+		return `v${slot}`;
+	}
+}
@@ -2,7 +2,11 @@ import { mkdtemp, rm, writeFile } from "node:fs/promises";
 import * as os from "node:os";
 import * as path from "node:path";
 import { describe, expect, it } from "vitest";
-import { parseLogFileRows, readLogFileMeta } from "./log-reader.js";
+import {
+	parseLogFileColumns,
+	parseLogFileRows,
+	readLogFileMeta,
+} from "./log-reader.js";
 
 describe("log-reader time units", () => {
 	it("treats Timestamp (ms) columns as milliseconds without magnitude heuristics", async () => {
@@ -33,4 +37,35 @@ describe("log-reader time units", () => {
 
 		await rm(tempDir, { recursive: true, force: true });
 	});
+
+	it("parses columns with empty cells as NaN", async () => {
+		const tempDir = await mkdtemp(path.join(os.tmpdir(), "ecu-log-reader-"));
+		const filePath = path.join(tempDir, "session.csv");
+
+		await writeFile(
+			filePath,
+			[
+				"Time (s),Engine RPM,Note",
+				"Unit,rpm,",
+				"0.1,2000,",
+				'0.2,,"a, b"',
+				"0.3,3000,",
+				"",
+			].join("\n"),
+		);
+
+		const parsed = await parseLogFileColumns(filePath);
+
+		expect(parsed.timeUnit).toBe("s");
+		expect(parsed.rowCount).toBe(3);
+		expect(Array.from(parsed.columns[0] ?? [])).toEqual([0.1, 0.2, 0.3]);
+		expect(Array.from(parsed.columns[1] ?? [])).toEqual([
+			2000,
+			Number.NaN,
+			3000,
+		]);
+		expect(parsed.sampleRateHz).toBe(10);
+
+		await rm(tempDir, { recursive: true, force: true });
+	});
 });
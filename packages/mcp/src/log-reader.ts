@@ -10,6 +10,15 @@
 
 import * as fs from "node:fs/promises";
 import * as path from "node:path";
+import { LogCatalog } from "./log-catalog.js";
+import {
+	detectTimeColumnIndex,
+	detectTimeUnit,
+	parseCsvLine,
+	splitCsvLine,
+	toMilliseconds,
+	toSeconds,
+} from "./log-csv.js";
 
 export interface LogFile {
 	/** Absolute path to the log file */
@@ -32,6 +41,17 @@ export interface LogFile {
 	sampleRateHz: number | null;
 	/** Time column unit when detected */
 	timeUnit: "ms" | "s" | null;
+	/** All header fields, including the timestamp column */
+	headers: string[];
+	/** Detected time column; null if no header looks like time */
+	timeColumnName: string | null;
+	/** Value range of each channel, parallel to `channels`; null until a numeric value is logged */
+	channelRanges: Array<LogChannelRange | null>;
+}
+
+export interface LogChannelRange {
+	min: number;
+	max: number;
 }
 
 export interface LogMetadata {
@@ -65,86 +85,6 @@ export interface LogData {
 	units: string[];
 }
 
-/**
- * Parse a CSV line, handling quoted fields.
- *
- * @param line - CSV line to parse
- * @returns Array of field values
- */
-function parseCsvLine(line: string): string[] {
-	const fields: string[] = [];
-	let current = "";
-	let inQuotes = false;
-
-	for (let i = 0; i < line.length; i++) {
-		const ch = line[i];
-		if (ch === '"') {
-			inQuotes = !inQuotes;
-		} else if (ch === "," && !inQuotes) {
-			fields.push(current);
-			current = "";
-		} else {
-			current += ch;
-		}
-	}
-	fields.push(current);
-	return fields;
-}
-
-/**
- * Detect the time column index from header fields.
- * Returns the index of the first column that looks like a time column,
- * or -1 if none found.
- */
-function detectTimeColumnIndex(headerFields: string[]): number {
-	for (let i = 0; i < headerFields.length; i++) {
-		const h = (headerFields[i] ?? "").toLowerCase();
-		if (
-			h.includes("time") ||
-			h.includes("timestamp") ||
-			h === "t" ||
-			h === "t (s)" ||
-			h === "time (s)"
-		) {
-			return i;
-		}
-	}
-	return -1;
-}
-
-function detectTimeUnit(headerName: string | undefined): "ms" | "s" | null {
-	if (!headerName) return null;
-	const normalized = headerName.toLowerCase();
-
-	if (
-		normalized.includes("(ms)") ||
-		normalized.includes("milliseconds") ||
-		normalized.includes("timestamp_ms")
-	) {
-		return "ms";
-	}
-
-	if (
-		normalized.includes("(s)") ||
-		normalized.includes("seconds") ||
-		normalized.includes("timestamp_s")
-	) {
-		return "s";
-	}
-
-	return null;
-}
-
-function toSeconds(value: number, unit: "ms" | "s" | null): number {
-	if (unit === "ms") return value / 1000;
-	return value;
-}
-
-function toMilliseconds(value: number, unit: "ms" | "s" | null): number {
-	if (unit === "s") return value * 1000;
-	return value;
-}
-
 /**
  * Get log metadata from a file without loading all rows.
  * Reads only the header, units, first data row, and last data row.
@@ -212,79 +152,64 @@ export async function getLogMetadata(filePath: string): Promise<LogMetadata> {
 	return { channels, rowCount, durationS, sampleRateHz, timeUnit };
 }
 
+/**
+ * Shared catalog behind {@link readLogFileMeta} and {@link listLogFiles}, so
+ * metadata of a log stays cached across tool calls.
+ */
+const logCatalog = new LogCatalog();
+
 /**
  * Read metadata from a log file without loading all rows.
  *
+ * Served from the log catalog: an unchanged file is not read again and a
+ * growing one only has its appended bytes parsed.
+ *
  * @param filePath - Absolute path to the log CSV file
  * @returns Log file metadata
  */
 export async function readLogFileMeta(filePath: string): Promise<LogFile> {
-	const stat = await fs.stat(filePath);
-	const fileName = path.basename(filePath);
-
-	// Read the file content
-	const content = await fs.readFile(filePath, "utf8");
-	const lines = content.split("\n").filter((l) => l.trim().length > 0);
-
-	if (lines.length < 2) {
-		return {
-			filePath,
-			fileName,
-			fileSizeBytes: stat.size,
-			mtime: stat.mtime,
-			channels: [],
-			units: [],
-			rowCount: 0,
-			durationMs: null,
-			sampleRateHz: null,
-			timeUnit: null,
-		};
-	}
-
-	// Parse header row
-	const headerFields = parseCsvLine(lines[0] ?? "");
-	// First column is "Timestamp (ms)", rest are channel names
-	const channels = headerFields.slice(1);
-
-	// Parse units row
-	const unitFields = parseCsvLine(lines[1] ?? "");
-	// First column is "Unit", rest are units
-	const units = unitFields.slice(1);
-
-	// Count data rows and get duration
-	const dataLines = lines.slice(2);
-	const rowCount = dataLines.length;
-
-	let durationMs: number | null = null;
-	let sampleRateHz: number | null = null;
-
-	const timeUnit = detectTimeUnit(headerFields[0]);
+	return logCatalog.get(filePath);
+}
 
-	if (dataLines.length > 1) {
-		const firstRow = parseCsvLine(dataLines[0] ?? "");
-		const lastRow = parseCsvLine(dataLines[dataLines.length - 1] ?? "");
-		const firstTs = Number.parseFloat(firstRow[0] ?? "0");
-		const lastTs = Number.parseFloat(lastRow[0] ?? "0");
-		if (Number.isFinite(firstTs) && Number.isFinite(lastTs)) {
-			durationMs = toMilliseconds(lastTs - firstTs, timeUnit);
-			const durationS = durationMs / 1000;
-			if (durationS > 0 && rowCount > 1) {
-				sampleRateHz = (rowCount - 1) / durationS;
-			}
-		}
-	}
+/**
+ * Resolve a requested log file against the logs directory.
+ *
+ * Bare file names are looked up in `logsDir`; paths are resolved from the
+ * working directory and may point outside it.
+ *
+ * @param logsDir - Configured logs directory
+ * @param requestedFile - File name from list_logs, or a path
+ * @returns Absolute path and whether it lies outside `logsDir`
+ */
+export function resolveLogFilePath(
+	logsDir: string,
+	requestedFile: string,
+): {
+	logPath: string;
+	outsideLogsDir: boolean;
+} {
+	const candidatePath = path.isAbsolute(requestedFile)
+		? requestedFile
+		: requestedFile.includes(path.sep) ||
+				requestedFile.startsWith(`.${path.sep}`) ||
+				requestedFile === "." ||
+				requestedFile === ".."
+			? path.resolve(process.cwd(), requestedFile)
+			: path.resolve(logsDir, requestedFile);
+
+	const normalizedBase = path.resolve(logsDir);
+	const normalizedCandidate = path.resolve(candidatePath);
+	const rel = path.relative(normalizedBase, normalizedCandidate);
+	const outsideLogsDir = !(
+		rel === "" ||
+		(!rel.startsWith("..") &&
+			!path.isAbsolute(rel) &&
+			!rel.startsWith(`..${path.sep}`))
+	);
 
 	return {
-		filePath,
-		fileName,
-		fileSizeBytes: stat.size,
-		mtime: stat.mtime,
-		channels,
-		units,
-		rowCount,
-		durationMs,
-		sampleRateHz,
-		timeUnit,
+		logPath: normalizedCandidate,
+		outsideLogsDir,
 	};
 }
 
@@ -295,28 +220,7 @@ export async function readLogFileMeta(filePath: string): Promise<LogFile> {
  * @returns Array of log file metadata, sorted by mtime descending (newest first)
  */
 export async function listLogFiles(logsDir: string): Promise<LogFile[]> {
-	let entries: string[];
-	try {
-		const dirEntries = await fs.readdir(logsDir);
-		entries = dirEntries.filter((e) => e.toLowerCase().endsWith(".csv"));
-	} catch {
-		return [];
-	}
-
-	const files: LogFile[] = [];
-	for (const entry of entries) {
-		const filePath = path.join(logsDir, entry);
-		try {
-			const meta = await readLogFileMeta(filePath);
-			files.push(meta);
-		} catch {
-			// Skip files that can't be read
-		}
-	}
-
-	// Sort by mtime descending (newest first)
-	files.sort((a, b) => b.mtime.getTime() - a.mtime.getTime());
-	return files;
+	return logCatalog.list(logsDir);
 }
 
 /**
@@ -527,3 +431,123 @@ export async function parseLogFileRows(filePath: string): Promise<{
 		sampleRateHz,
 	};
 }
+
+/**
+ * A log held as one typed array per column.
+ */
+export interface LogColumns {
+	/** Column names, including the time column */
+	headers: string[];
+	timeColumnName: string | null;
+	timeUnit: "ms" | "s" | null;
+	rowCount: number;
+	/** Values per column, parallel to `headers`; NaN where a cell is empty or not numeric */
+	columns: Float64Array[];
+	sampleRateHz: number | null;
+}
+
+/**
+ * Parse a CSV log file into columnar typed arrays.
+ *
+ * Same header, units-row and time-column detection as
+ * {@link parseLogFileRows}, but each value lands in a `Float64Array` per
+ * column instead of a per-row object, which is what read_log queries scan.
+ *
+ * @param filePath - Absolute path to the log CSV file
+ * @returns Columns of the log
+ */
+export async function parseLogFileColumns(
+	filePath: string,
+): Promise<LogColumns> {
+	const content = await fs.readFile(filePath, "utf8");
+	const lines = content.split("\n").filter((l) => l.trim().length > 0);
+
+	if (lines.length < 1) {
+		return {
+			headers: [],
+			timeColumnName: null,
+			timeUnit: null,
+			rowCount: 0,
+			columns: [],
+			sampleRateHz: null,
+		};
+	}
+
+	const headerFields = parseCsvLine(lines[0] ?? "");
+
+	// Check if there's a units row
+	let dataStartLine = 1;
+	if (lines.length >= 2) {
+		const secondFields = parseCsvLine(lines[1] ?? "");
+		const firstVal = Number.parseFloat(secondFields[0] ?? "");
+		if (!Number.isFinite(firstVal)) {
+			dataStartLine = 2;
+		}
+	}
+
+	const timeColIdx = detectTimeColumnIndex(headerFields);
+	const timeColumnName =
+		timeColIdx >= 0 ? (headerFields[timeColIdx] ?? null) : null;
+	const timeUnit =
+		timeColIdx >= 0 ? detectTimeUnit(headerFields[timeColIdx]) : null;
+
+	const rowCount = Math.max(0, lines.length - dataStartLine);
+	const columns = headerFields.map(() => new Float64Array(rowCount));
+	for (let row = 0; row < rowCount; row++) {
+		const line = lines[dataStartLine + row] as string;
+		const fields = splitCsvLine(line);
+		for (let col = 0; col < columns.length; col++) {
+			const val = Number.parseFloat(fields[col] ?? "");
+			(columns[col] as Float64Array)[row] = Number.isFinite(val)
+				? val
+				: Number.NaN;
+		}
+	}
+
+	let sampleRateHz: number | null = null;
+	const timeColumn = columns[timeColIdx];
+	if (timeColumn && rowCount > 1) {
+		const durationS =
+			toSeconds(timeColumn[rowCount - 1] as number, timeUnit) -
+			toSeconds(timeColumn[0] as number, timeUnit);
+		if (durationS > 0) {
+			sampleRateHz = (rowCount - 1) / durationS;
+		}
+	}
+
+	return {
+		headers: headerFields,
+		timeColumnName,
+		timeUnit,
+		rowCount,
+		columns,
+		sampleRateHz,
+	};
+}
+
+/**
+ * Find a column of a parsed log by header.
+ *
+ * @param log - Parsed log
+ * @param name - Header name; the last column wins when it repeats
+ * @returns The column, or null if there is none
+ */
+export function getLogColumn(
+	log: LogColumns,
+	name: string,
+): Float64Array | null {
+	return log.columns[log.headers.lastIndexOf(name)] ?? null;
+}
+
+/**
+ * Row timestamps of a parsed log in milliseconds.
+ *
+ * @param log - Parsed log
+ * @returns Timestamps, or null if the log has no time column
+ */
+export function getLogTimeMs(log: LogColumns): Float64Array | null {
+	if (log.timeColumnName === null) return null;
+	const column = getLogColumn(log, log.timeColumnName);
+	if (column === null) return null;
+	return log.timeUnit === "s" ? column.map((t) => t * 1000) : column;
+}
@@ -105,8 +105,9 @@ export function buildLogAnalysisResourceText(): string {
 		"",
 		"Use MCP tools for:",
 		"- discovering logs",
-		"- checking schema and units",
+		"- checking schema, units and per-channel ranges",
 		"- simple structured slices with `read_log`",
+		"- binning a channel onto a table's axes with `bin_log` (e.g. AFR by RPM and load)",
 		"",
 		"Use shell-native tooling for:",
 		"- multi-row temporal patterns",
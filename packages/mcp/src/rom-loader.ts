@@ -11,7 +11,16 @@ import * as path from "node:path";
 import { pathToFileURL } from "node:url";
 import type { ROMDefinition } from "@ecu-explorer/core";
 import { scoreRomDefinition } from "@ecu-explorer/core";
-import { EcuFlashProvider } from "@ecu-explorer/definitions-ecuflash";
+import {
+	EcuFlashProvider,
+	RomIdIndex,
+} from "@ecu-explorer/definitions-ecuflash";
+
+/**
+ * Definition headers shared across loads, so repeated tool calls only
+ * rescan definition files that changed
+ */
+const romIdIndex = new RomIdIndex();
 
 export interface LoadRomOptions {
 	definitionPath?: string;
@@ -60,7 +69,7 @@ export async function loadRom(
 	const romBytes = new Uint8Array(buffer);
 
 	// Resolve definition
-	const provider = new EcuFlashProvider(definitionsPaths);
+	const provider = new EcuFlashProvider(definitionsPaths, { romIdIndex });
 	const romUri = pathToFileURL(absolutePath).toString();
 
 	let bestDefinition: ROMDefinition;
@@ -90,10 +99,15 @@ export async function loadRom(
 		let bestScore = 0;
 		let matchedDefinition: ROMDefinition | null = null;
 
-		for (const uri of definitionUris) {
+		// Headers are scanned concurrently through the index's I/O pool
+		const stubs = await Promise.all(
+			definitionUris.map((uri) => provider.peek(uri).catch(() => null)),
+		);
+
+		for (const [i, uri] of definitionUris.entries()) {
 			try {
-				const stub = await provider.peek(uri);
-				if (stub.fingerprints.length === 0) continue;
+				const stub = stubs[i];
+				if (!stub || stub.fingerprints.length === 0) continue;
 
 				const score = scoreRomDefinition(romBytes, stub);
 				if (score > bestScore) {
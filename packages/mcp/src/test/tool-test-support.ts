@@ -39,23 +39,29 @@ export function createLogFileMeta(
 		durationMs: number;
 		sampleRateHz: number;
 		timeUnit: "ms" | "s";
+		headers: string[];
+		channelRanges: Array<{ min: number; max: number } | null>;
 	}> = {},
 ) {
+	const channels = overrides.channels ?? ["Engine RPM"];
 	return {
 		filePath: overrides.filePath ?? "/tmp/logs/session.csv",
 		fileName: overrides.fileName ?? "session.csv",
 		fileSizeBytes: overrides.fileSizeBytes ?? 1,
 		mtime: overrides.mtime ?? new Date("2026-03-10T00:00:00.000Z"),
-		channels: overrides.channels ?? ["Engine RPM"],
+		channels,
 		units: overrides.units ?? ["rpm"],
 		rowCount: overrides.rowCount ?? 1,
 		durationMs: overrides.durationMs ?? 0,
 		sampleRateHz: overrides.sampleRateHz ?? 10,
 		timeUnit: overrides.timeUnit ?? "ms",
+		headers: overrides.headers ?? ["Timestamp (ms)", ...channels],
+		timeColumnName: "Timestamp (ms)",
+		channelRanges: overrides.channelRanges ?? channels.map(() => null),
 	};
 }
 
-export function createParsedLogRows(
+export function createParsedLogColumns(
 	overrides: Partial<{
 		headers: string[];
 		timeColumnName: string | null;
@@ -64,11 +70,16 @@ export function createParsedLogRows(
 		rows: Array<Record<string, number>>;
 	}> = {},
 ) {
+	const headers = overrides.headers ?? ["Timestamp (ms)", "Engine RPM"];
+	const rows = overrides.rows ?? [];
 	return {
-		headers: overrides.headers ?? ["Timestamp (ms)", "Engine RPM"],
+		headers,
 		timeColumnName: overrides.timeColumnName ?? "Timestamp (ms)",
 		timeUnit: overrides.timeUnit ?? "ms",
 		sampleRateHz: overrides.sampleRateHz ?? 10,
-		rows: overrides.rows ?? [],
+		rowCount: rows.length,
+		columns: headers.map((header) =>
+			Float64Array.from(rows, (row) => row[header] ?? Number.NaN),
+		),
 	};
 }
@@ -0,0 +1,148 @@
+import { mkdtemp, rm, writeFile } from "node:fs/promises";
+import * as os from "node:os";
+import * as path from "node:path";
+import type {
+	ROMDefinition,
+	Table1DDefinition,
+	Table2DDefinition,
+} from "@ecu-explorer/core";
+import { afterEach, beforeEach, describe, expect, it, vi } from "vitest";
+import {
+	createMcpConfig,
+	createRomLoaderResult,
+} from "../test/tool-test-support.js";
+import { handleBinLog } from "./bin-log.js";
+
+let definition: ROMDefinition;
+
+vi.mock("../rom-loader.js", () => ({
+	loadRom: vi.fn(async () => createRomLoaderResult(definition)),
+}));
+
+const fuelTable = {
+	id: "fuel",
+	name: "High Octane Fuel",
+	kind: "table2d",
+	rows: 2,
+	cols: 3,
+	category: "Fuel",
+	x: { id: "x", kind: "static", name: "RPM", values: [2000, 3000, 4000] },
+	y: { id: "y", kind: "static", name: "Load", values: [1, 2] },
+	z: { id: "z", name: "values", address: 0, dtype: "u8" },
+} satisfies Table2DDefinition;
+
+const boostTable = {
+	id: "boost",
+	name: "Boost Target",
+	kind: "table1d",
+	rows: 2,
+	category: "Boost",
+	x: { id: "x", kind: "static", name: "RPM", values: [2000, 4000] },
+	z: { id: "z", name: "values", address: 0, dtype: "u8" },
+} satisfies Table1DDefinition;
+
+describe("handleBinLog", () => {
+	let tempDir: string;
+
+	beforeEach(async () => {
+		definition = {
+			uri: "file:///tmp/sample.xml",
+			name: "Sample Definition",
+			fingerprints: [],
+			platform: {},
+			tables: [fuelTable, boostTable],
+		};
+		tempDir = await mkdtemp(path.join(os.tmpdir(), "ecu-mcp-bin-log-"));
+		await writeFile(
+			path.join(tempDir, "pull.csv"),
+			[
+				"Timestamp (ms),Engine RPM,Load,AFR,Knock Sum",
+				"Unit,rpm,g/rev,afr,count",
+				"0,2100,1.1,14.7,0",
+				"100,2900,1.9,12.0,0",
+				"200,3100,2.1,11.0,1",
+				"300,3900,1.0,12.5,0",
+				"400,3950,1.2,,0",
+			].join("\n"),
+		);
+	});
+
+	afterEach(async () => {
+		await rm(tempDir, { recursive: true, force: true });
+	});
+
+	it("bins a channel onto a 2D table grid per statistic", async () => {
+		const result = await handleBinLog(
+			{
+				file: "pull.csv",
+				rom: "/tmp/sample.hex",
+				table: "high octane fuel",
+				x: "Engine RPM",
+				y: "Load",
+				value: "AFR",
+				stats: ["count", "mean"],
+			},
+			createMcpConfig({ logsDir: tempDir }),
+		);
+
+		expect(result).toContain("table: High Octane Fuel");
+		expect(result).toContain("samples_binned: 4");
+		expect(result).toContain("cells_filled: 3");
+		expect(result).toContain("count of AFR per cell:");
+		expect(result).toContain("| Load\\RPM | 2000 | 3000 | 4000 |");
+		expect(result).toContain("| 1        | 1    | 0    | 1    |");
+		expect(result).toContain("| 2        | 0    | 2    | 0    |");
+		expect(result).toContain("| 2        |      | 11.5 |      |");
+	});
+
+	it("applies where and the time range before binning", async () => {
+		const result = await handleBinLog(
+			{
+				file: "pull.csv",
+				rom: "/tmp/sample.hex",
+				table: "Boost Target",
+				x: "Engine RPM",
+				value: "AFR",
+				where: "Knock Sum == 0",
+				startS: 0.05,
+				stats: ["mean", "max"],
+			},
+			createMcpConfig({ logsDir: tempDir }),
+		);
+
+		expect(result).toContain("rows_matched: 3");
+		expect(result).toContain("samples_binned: 2");
+		expect(result).toContain("| RPM (");
+		expect(result).toContain("| 4000 ");
+		expect(result).toMatch(/\| 4000 +\| 12\.5 +\| 12\.5 +\|/);
+	});
+
+	it("reports missing channels and axes", async () => {
+		const config = createMcpConfig({ logsDir: tempDir });
+		await expect(
+			handleBinLog(
+				{
+					file: "pull.csv",
+					rom: "/tmp/sample.hex",
+					table: "High Octane Fuel",
+					x: "Engine RPM",
+					value: "AFR",
+				},
+				config,
+			),
+		).rejects.toThrow(/provide a y channel/);
+		await expect(
+			handleBinLog(
+				{
+					file: "pull.csv",
+					rom: "/tmp/sample.hex",
+					table: "High Octane Fuel",
+					x: "Engine RPM",
+					y: "MAP",
+					value: "AFR",
+				},
+				config,
+			),
+		).rejects.toThrow(/Unknown channel\(s\): MAP/);
+	});
+});
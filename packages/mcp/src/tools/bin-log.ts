@@ -0,0 +1,270 @@
+/**
+ * bin_log tool handler for the ECU Explorer MCP server.
+ *
+ * Bins one log channel onto the axes of a calibration table, so logged
+ * behaviour (AFR, knock, boost error) can be compared cell by cell with the
+ * map that governs it. Returns YAML frontmatter plus one grid per requested
+ * statistic, laid out like read_table.
+ */
+
+import * as fs from "node:fs/promises";
+import {
+	type BinnedGrid,
+	type BinWeighting,
+	createTableBinner,
+	findClosestTableMatches,
+} from "@ecu-explorer/core";
+import type { McpConfig } from "../config.js";
+import { buildMarkdownTable } from "../formatters/markdown.js";
+import { formatUnit } from "../formatters/unit.js";
+import { toYamlFrontmatter } from "../formatters/yaml-formatter.js";
+import {
+	compileLogWhere,
+	type RowPredicate,
+	runLogQuery,
+} from "../log-query.js";
+import {
+	getLogColumn,
+	getLogTimeMs,
+	parseLogFileColumns,
+	resolveLogFilePath,
+} from "../log-reader.js";
+import { loadRom } from "../rom-loader.js";
+import { findTableByName } from "../table-diff.js";
+
+export type BinLogStat = "count" | "mean" | "min" | "max" | "stddev";
+
+export interface BinLogOptions {
+	file: string;
+	rom: string;
+	table: string;
+	definitionPath?: string;
+	/** Channel binned along the table's X axis */
+	x: string;
+	/** Channel binned along the table's Y axis (2D tables) */
+	y?: string;
+	/** Channel aggregated per cell */
+	value: string;
+	/** Optional per-sample weight channel */
+	weight?: string;
+	where?: string;
+	startS?: number;
+	endS?: number;
+	weighting?: BinWeighting;
+	stats?: BinLogStat[];
+	/** Cells with fewer samples are left blank (default 1) */
+	minCount?: number;
+}
+
+const DEFAULT_STATS: BinLogStat[] = ["count", "mean"];
+
+function formatBinValue(v: number): string {
+	if (!Number.isFinite(v)) return "";
+	const s = v.toFixed(4);
+	return s.replace(/\.?0+$/, "");
+}
+
+function statAt(
+	grid: BinnedGrid,
+	stat: BinLogStat,
+	cell: number,
+	minCount: number,
+): string {
+	const count = grid.count[cell] ?? 0;
+	if (stat === "count") return String(count);
+	if (count === 0 || count < minCount) return "";
+	return formatBinValue(grid[stat][cell] as number);
+}
+
+function requireChannels(
+	requested: Array<string | undefined>,
+	headers: string[],
+): void {
+	const missing = requested.filter(
+		(channel): channel is string =>
+			channel !== undefined && !headers.includes(channel),
+	);
+	if (missing.length > 0) {
+		throw new Error(
+			`Unknown channel(s): ${missing.join(", ")}. Available channels: ${headers.join(", ")}`,
+		);
+	}
+}
+
+/**
+ * Handle the bin_log tool call.
+ */
+export async function handleBinLog(
+	options: BinLogOptions,
+	config: McpConfig,
+): Promise<string> {
+	const { file, where, startS, endS } = options;
+	const stats = options.stats ?? DEFAULT_STATS;
+	const weighting = options.weighting ?? "nearest";
+	const minCount = options.minCount ?? 1;
+	const { logPath, outsideLogsDir } = resolveLogFilePath(config.logsDir, file);
+
+	try {
+		await fs.stat(logPath);
+	} catch {
+		throw new Error(`Log file not found: ${logPath}`);
+	}
+
+	const { definition, romBytes } = await loadRom(
+		options.rom,
+		config.definitionsPaths,
+		options.definitionPath === undefined
+			? {}
+			: { definitionPath: options.definitionPath },
+	);
+	const table = findTableByName(definition.tables, options.table);
+	if (!table) {
+		const suggestions = findClosestTableMatches(
+			options.table,
+			definition.tables,
+			3,
+		);
+		const suggestionText =
+			suggestions.length > 0
+				? `\nDid you mean: ${suggestions.map((t) => t.name).join(", ")}?`
+				: "";
+		throw new Error(
+			`Table "${options.table}" not found in ROM definition "${definition.name}". ` +
+				suggestionText +
+				"\nUse list_tables to see all available tables.",
+		);
+	}
+	if (table.kind === "table3d") {
+		throw new Error("bin_log only supports 1D and 2D tables.");
+	}
+	if (table.kind === "table2d" && options.y === undefined) {
+		throw new Error(
+			`Table "${table.name}" is 2D; provide a y channel for its rows.`,
+		);
+	}
+	if (table.kind === "table1d" && options.y !== undefined) {
+		throw new Error(
+			`Table "${table.name}" is 1D; the y channel is only used with 2D tables.`,
+		);
+	}
+
+	const binner = createTableBinner(table, romBytes, { weighting });
+
+	const parsed = await parseLogFileColumns(logPath);
+	requireChannels(
+		[options.x, options.y, options.value, options.weight],
+		parsed.headers,
+	);
+	const timeMs = getLogTimeMs(parsed);
+	if ((startS !== undefined || endS !== undefined) && timeMs === null) {
+		throw new Error(
+			`Log ${file} does not expose a time column required for range options.`,
+		);
+	}
+
+	let predicate: RowPredicate | undefined;
+	let referencedFields: string[] = [];
+	if (where !== undefined) {
+		({ predicate, referencedFields } = compileLogWhere(
+			where,
+			parsed.headers,
+			parsed.columns,
+		));
+	}
+
+	const { rows } = runLogQuery(parsed.rowCount, {
+		timeMs,
+		...(predicate !== undefined ? { where: predicate } : {}),
+		...(startS !== undefined ? { startMs: startS * 1000 } : {}),
+		...(endS !== undefined ? { endMs: endS * 1000 } : {}),
+	});
+	const column = (name: string) => getLogColumn(parsed, name) as Float64Array;
+	const binned = binner.addColumns(
+		{
+			x: column(options.x),
+			value: column(options.value),
+			...(options.y !== undefined ? { y: column(options.y) } : {}),
+			...(options.weight !== undefined
+				? { weight: column(options.weight) }
+				: {}),
+		},
+		rows,
+	);
+	const grid = binner.result();
+
+	let cellsFilled = 0;
+	for (const count of grid.count) {
+		if (count >= minCount && count > 0) cellsFilled++;
+	}
+
+	const frontmatterData: Record<string, unknown> = {
+		file,
+		resolved_path: logPath,
+		outside_logs_dir: outsideLogsDir,
+		rom: options.rom,
+		table: table.name,
+		kind: table.kind,
+		// 1D tables are listed one breakpoint per row, as in read_table
+		rows: grid.yAxis ? grid.rows : grid.cols,
+		cols: grid.yAxis ? grid.cols : 1,
+		x_channel: options.x,
+		y_channel: options.y ?? null,
+		value_channel: options.value,
+		weight_channel: options.weight ?? null,
+		weighting,
+		where: where ?? null,
+		referenced_fields: referencedFields,
+		rows_matched: rows.length,
+		samples_binned: binned,
+		cells_filled: cellsFilled,
+		stats,
+	};
+	if (table.x) {
+		frontmatterData.x_axis_name = table.x.name;
+		frontmatterData.x_axis_unit = formatUnit(table.x.unit);
+	}
+	if (table.kind === "table2d" && table.y) {
+		frontmatterData.y_axis_name = table.y.name;
+		frontmatterData.y_axis_unit = formatUnit(table.y.unit);
+	}
+	const frontmatter = toYamlFrontmatter(frontmatterData);
+	const warningNote = outsideLogsDir
+		? `Warning: ${logPath} is outside the configured logs directory ${config.logsDir}. Parsing may fail if the log file is not in the expected format.\n\n`
+		: "";
+
+	if (binned === 0) {
+		return `${frontmatter}\n${warningNote}(No samples fell on ${table.name})`;
+	}
+
+	const xHeaders = grid.xAxis.map(formatBinValue);
+
+	// 1D: one row per breakpoint, one column per statistic
+	if (grid.yAxis === undefined) {
+		const axisName = table.x
+			? `${table.x.name} (${formatUnit(table.x.unit)})`
+			: "Index";
+		const markdownRows = xHeaders.map((label, col) => [
+			label,
+			...stats.map((stat) => statAt(grid, stat, col, minCount)),
+		]);
+		return `${frontmatter}\n${warningNote}${buildMarkdownTable([axisName, ...stats], markdownRows)}`;
+	}
+
+	// 2D: one Y\X grid per statistic
+	const yLabels = grid.yAxis.map(formatBinValue);
+	const corner =
+		table.kind === "table2d" && table.y
+			? `${table.y.name}\\${table.x?.name ?? "X"}`
+			: `Y\\${table.x?.name ?? "X"}`;
+	const sections = stats.map((stat) => {
+		const markdownRows = yLabels.map((label, row) => [
+			label,
+			...xHeaders.map((_, col) =>
+				statAt(grid, stat, row * grid.cols + col, minCount),
+			),
+		]);
+		return `${stat} of ${options.value} per cell:\n\n${buildMarkdownTable([corner, ...xHeaders], markdownRows)}`;
+	});
+
+	return `${frontmatter}\n${warningNote}${sections.join("\n\n")}`;
+}
@@ -7,7 +7,7 @@ import * as logReader from "../log-reader.js";
 import {
 	createLogFileMeta,
 	createMcpConfig,
-	createParsedLogRows,
+	createParsedLogColumns,
 } from "../test/tool-test-support.js";
 import { handleReadLog } from "./read-log.js";
 
@@ -19,7 +19,7 @@ vi.mock("../log-reader.js", async () => {
 	return {
 		...actual,
 		readLogFileMeta: vi.fn(),
-		parseLogFileRows: vi.fn(),
+		parseLogFileColumns: vi.fn(),
 	};
 });
 
@@ -52,8 +52,8 @@ describe("handleReadLog", () => {
 				sampleRateHz: 10,
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Engine RPM", "Knock Sum"],
 			}),
 		);
@@ -95,8 +95,8 @@ describe("handleReadLog", () => {
 				sampleRateHz: 20,
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Engine RPM", "Knock Sum"],
 				rows: [
 					{ "Timestamp (ms)": 0, "Engine RPM": 3000, "Knock Sum": 0 },
@@ -138,8 +138,8 @@ describe("handleReadLog", () => {
 				sampleRateHz: 10,
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Engine Temp", "Coolant Temp"],
 				rows: [
 					{ "Timestamp (ms)": 0, "Engine Temp": 120, "Coolant Temp": 95 },
@@ -186,8 +186,8 @@ describe("handleReadLog", () => {
 				units: ["rpm", "count"],
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Engine RPM", "Knock Sum"],
 				rows: [{ "Timestamp (ms)": 0, "Engine RPM": 3000, "Knock Sum": 0 }],
 			}),
@@ -238,8 +238,8 @@ describe("handleReadLog", () => {
 				sampleRateHz: 10,
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Engine RPM", "Knock Sum"],
 				rows: [
 					{ "Timestamp (ms)": 100, "Engine RPM": 2000, "Knock Sum": 1 },
@@ -269,6 +269,8 @@ describe("handleReadLog", () => {
 		expect(result).toContain("| 0.26");
 		expect(result).toContain("| 0.34");
 		expect(result).not.toContain("| 0.50");
+		expect(result).toContain("channel_stats:");
+		expect(result).toContain("mean: 2300");
 	});
 
 	it("supports overlapping field names in where expressions", async () => {
@@ -292,8 +294,8 @@ describe("handleReadLog", () => {
 				sampleRateHz: 10,
 			}),
 		);
-		vi.mocked(logReader.parseLogFileRows).mockResolvedValue(
-			createParsedLogRows({
+		vi.mocked(logReader.parseLogFileColumns).mockResolvedValue(
+			createParsedLogColumns({
 				headers: ["Timestamp (ms)", "Load", "Load Avg"],
 				rows: [
 					{ "Timestamp (ms)": 0, Load: 1.2, "Load Avg": 1.0 },
@@ -6,21 +6,22 @@
  */
 
 import * as fs from "node:fs/promises";
-import * as path from "node:path";
-import { compileExpression } from "filtrex";
 import type { McpConfig } from "../config.js";
 import { buildMarkdownTable } from "../formatters/markdown.js";
 import { toYamlFrontmatter } from "../formatters/yaml-formatter.js";
-import { parseLogFileRows, readLogFileMeta } from "../log-reader.js";
 import {
-	buildAliasedObject,
-	buildFieldAliasMap,
-	buildUnknownFieldError,
-	detectUnknownFieldFragments,
-	extractReferencedFields,
-	normalizeExpression,
-	rewriteExpressionWithAliases,
-} from "../query-utils.js";
+	type ColumnStats,
+	compileLogWhere,
+	type RowPredicate,
+	runLogQuery,
+} from "../log-query.js";
+import {
+	getLogColumn,
+	getLogTimeMs,
+	parseLogFileColumns,
+	readLogFileMeta,
+	resolveLogFilePath,
+} from "../log-reader.js";
 
 export interface ReadLogOptions {
 	file: string;
@@ -31,49 +32,28 @@ export interface ReadLogOptions {
 	stepMs?: number;
 }
 
-function resolveLogFilePath(
-	logsDir: string,
-	requestedFile: string,
-): {
-	logPath: string;
-	outsideLogsDir: boolean;
-} {
-	const candidatePath = path.isAbsolute(requestedFile)
-		? requestedFile
-		: requestedFile.includes(path.sep) ||
-				requestedFile.startsWith(`.${path.sep}`) ||
-				requestedFile === "." ||
-				requestedFile === ".."
-			? path.resolve(process.cwd(), requestedFile)
-			: path.resolve(logsDir, requestedFile);
-
-	const normalizedBase = path.resolve(logsDir);
-	const normalizedCandidate = path.resolve(candidatePath);
-	const rel = path.relative(normalizedBase, normalizedCandidate);
-	const outsideLogsDir = !(
-		rel === "" ||
-		(!rel.startsWith("..") &&
-			!path.isAbsolute(rel) &&
-			!rel.startsWith(`..${path.sep}`))
-	);
-
-	return {
-		logPath: normalizedCandidate,
-		outsideLogsDir,
-	};
-}
-
 function formatLogValue(v: number | undefined): string {
 	if (v === undefined || !Number.isFinite(v)) return "";
 	const s = v.toFixed(4);
 	return s.replace(/\.?0+$/, "");
 }
 
-function normalizeTimeToMs(
-	timestamp: number,
-	timeUnit: "ms" | "s" | null,
-): number {
-	return timeUnit === "s" ? timestamp * 1000 : timestamp;
+function formatChannelStats(
+	channels: string[],
+	stats: ColumnStats[],
+): Record<string, { min: number; max: number; mean: number } | null> {
+	const round = (v: number) => Number(v.toFixed(4));
+	return Object.fromEntries(
+		channels.map((channel, i) => {
+			const s = stats[i];
+			return [
+				channel,
+				s && s.count > 0
+					? { min: round(s.min), max: round(s.max), mean: round(s.mean) }
+					: null,
+			];
+		}),
+	);
 }
 
 function toSeconds(timestampMs: number): number {
@@ -127,16 +107,12 @@ export async function handleReadLog(
 		throw new Error(`Log file not found: ${logPath}`);
 	}
 
-	const meta = await readLogFileMeta(logPath);
-	const parsed = await parseLogFileRows(logPath);
-	const timeColumnName = parsed.timeColumnName;
-	const timeUnit = parsed.timeUnit;
-	const dataChannels = parsed.headers.filter(
-		(header) => header !== timeColumnName,
-	);
-	const selectedChannels = validateRequestedChannels(channels, dataChannels);
-
 	if (isSchemaOnlyRequest(options)) {
+		// Answered from the log catalog, without parsing rows
+		const meta = await readLogFileMeta(logPath);
+		const dataChannels = meta.headers.filter(
+			(header) => header !== meta.timeColumnName,
+		);
 		const frontmatter = toYamlFrontmatter({
 			file,
 			resolved_path: logPath,
@@ -147,24 +123,38 @@ export async function handleReadLog(
 					? Number((meta.durationMs / 1000).toFixed(3))
 					: null,
 			sample_rate_hz: meta.sampleRateHz,
-			time_column: timeColumnName,
-			time_unit: timeUnit,
-			channels: selectedChannels,
+			time_column: meta.timeColumnName,
+			time_unit: meta.timeUnit,
+			channels: dataChannels,
 		});
 
-		if (selectedChannels.length === 0) {
+		if (dataChannels.length === 0) {
 			return `${frontmatter}\n${warningNote ? `${warningNote}\n\n` : ""}(No channels available in ${file})`;
 		}
 
-		const headers = ["Channel", "Unit"];
-		const rows = selectedChannels.map((channel) => {
+		const headers = ["Channel", "Unit", "Min", "Max"];
+		const rows = dataChannels.map((channel) => {
 			const index = meta.channels.indexOf(channel);
-			return [channel, index >= 0 ? (meta.units[index] ?? "") : ""];
+			const range = index >= 0 ? meta.channelRanges[index] : undefined;
+			return [
+				channel,
+				index >= 0 ? (meta.units[index] ?? "") : "",
+				formatLogValue(range?.min),
+				formatLogValue(range?.max),
+			];
 		});
 
 		return `${frontmatter}\n${warningNote ? `${warningNote}\n\n` : ""}${buildMarkdownTable(headers, rows)}`;
 	}
 
+	const parsed = await parseLogFileColumns(logPath);
+	const timeColumnName = parsed.timeColumnName;
+	const timeUnit = parsed.timeUnit;
+	const dataChannels = parsed.headers.filter(
+		(header) => header !== timeColumnName,
+	);
+	const selectedChannels = validateRequestedChannels(channels, dataChannels);
+
 	const startMs = startS !== undefined ? startS * 1000 : undefined;
 	const endMs = endS !== undefined ? endS * 1000 : undefined;
 
@@ -177,79 +167,35 @@ export async function handleReadLog(
 		);
 	}
 
-	const normalizedWhere =
-		where !== undefined ? normalizeExpression(where) : undefined;
-	let filterFn: ((obj: Record<string, number>) => unknown) | undefined;
+	let predicate: RowPredicate | undefined;
 	let referencedFields: string[] = [];
-	const { fieldToAlias } = buildFieldAliasMap(parsed.headers, "__log_");
-
-	if (normalizedWhere !== undefined) {
-		referencedFields = extractReferencedFields(
-			where ?? normalizedWhere,
-			parsed.headers,
-		);
-		const unknownFragments = detectUnknownFieldFragments(
-			where ?? normalizedWhere,
+	if (where !== undefined) {
+		({ predicate, referencedFields } = compileLogWhere(
+			where,
 			parsed.headers,
-		);
-		if (unknownFragments.length > 0) {
-			throw buildUnknownFieldError("field", unknownFragments, parsed.headers);
-		}
-
-		const rewritten = rewriteExpressionWithAliases(
-			normalizedWhere,
-			fieldToAlias,
-		);
-
-		try {
-			filterFn = compileExpression(rewritten);
-		} catch (err) {
-			throw new Error(
-				`Invalid where expression: ${err instanceof Error ? err.message : String(err)}. Available fields: ${parsed.headers.join(", ")}`,
-			);
-		}
+			parsed.columns,
+		));
 	}
 
-	const baseRows = parsed.rows.map((row, index) => ({
-		index,
-		row,
-		timeMs:
-			timeColumnName !== null && row[timeColumnName] !== undefined
-				? normalizeTimeToMs(row[timeColumnName], timeUnit)
-				: undefined,
-	}));
-
-	const matchedRows = baseRows.filter(({ row, timeMs }) => {
-		if (startMs !== undefined && timeMs !== undefined && timeMs < startMs)
-			return false;
-		if (endMs !== undefined && timeMs !== undefined && timeMs > endMs)
-			return false;
-		if (!filterFn) return true;
+	const timeMs = getLogTimeMs(parsed);
+	const channelColumns = selectedChannels.map(
+		(channel) =>
+			getLogColumn(parsed, channel) ?? new Float64Array(parsed.rowCount),
+	);
 
-		const aliasRow = buildAliasedObject(row, fieldToAlias);
-		try {
-			return Boolean(filterFn({ ...row, ...aliasRow }));
-		} catch {
-			return false;
-		}
+	// Range, where, step_ms and per-channel stats in one pass over columns
+	const { rows: selectedRows, stats } = runLogQuery(parsed.rowCount, {
+		timeMs,
+		statsColumns: channelColumns,
+		...(predicate !== undefined ? { where: predicate } : {}),
+		...(startMs !== undefined ? { startMs } : {}),
+		...(endMs !== undefined ? { endMs } : {}),
+		...(stepMs !== undefined ? { stepMs } : {}),
 	});
-
-	let selectedRows = matchedRows;
-
-	if (stepMs !== undefined) {
-		let lastIncludedTime: number | undefined;
-		selectedRows = selectedRows.filter((entry) => {
-			if (entry.timeMs === undefined) return false;
-			if (
-				lastIncludedTime === undefined ||
-				entry.timeMs - lastIncludedTime >= stepMs
-			) {
-				lastIncludedTime = entry.timeMs;
-				return true;
-			}
-			return false;
-		});
-	}
+	const timeAt = (row: number | undefined): number | undefined => {
+		const t = row !== undefined ? timeMs?.[row] : undefined;
+		return t !== undefined && !Number.isNaN(t) ? t : undefined;
+	};
 
 	const frontmatter = toYamlFrontmatter({
 		file,
@@ -259,10 +205,10 @@ export async function handleReadLog(
 		time_range_s:
 			selectedRows.length > 0 && timeColumnName
 				? [
-						Number(toSeconds(selectedRows[0]?.timeMs ?? 0).toFixed(3)),
+						Number(toSeconds(timeAt(selectedRows[0]) ?? 0).toFixed(3)),
 						Number(
 							toSeconds(
-								selectedRows[selectedRows.length - 1]?.timeMs ?? 0,
+								timeAt(selectedRows[selectedRows.length - 1]) ?? 0,
 							).toFixed(3),
 						),
 					]
@@ -272,6 +218,10 @@ export async function handleReadLog(
 		channels: selectedChannels,
 		where: where ?? null,
 		referenced_fields: referencedFields,
+		channel_stats:
+			selectedRows.length > 0
+				? formatChannelStats(selectedChannels, stats)
+				: null,
 	});
 
 	if (selectedRows.length === 0) {
@@ -281,13 +231,14 @@ export async function handleReadLog(
 	const headers = timeColumnName
 		? ["Time (s)", ...selectedChannels]
 		: [...selectedChannels];
-	const markdownRows = selectedRows.map(({ row, timeMs }) => {
+	const markdownRows = Array.from(selectedRows, (row) => {
 		const cells: string[] = [];
 		if (timeColumnName) {
-			cells.push(timeMs !== undefined ? toSeconds(timeMs).toFixed(2) : "");
+			const t = timeAt(row);
+			cells.push(t !== undefined ? toSeconds(t).toFixed(2) : "");
 		}
-		for (const channel of selectedChannels) {
-			cells.push(formatLogValue(row[channel]));
+		for (const column of channelColumns) {
+			cells.push(formatLogValue(column[row]));
 		}
 		return cells;
 	});
@@ -27,6 +27,12 @@ export {
 	shouldDownsample,
 } from "./views/chartUtils.js";
 export type { ThemeColors } from "./views/colorMap.js";
+export type { LogOverlayCell, TableLogOverlay } from "./views/log-overlay.js";
+export {
+	formatLogOverlayTitle,
+	formatLogOverlayValue,
+	getLogOverlayCell,
+} from "./views/log-overlay.js";
 export { ROMView } from "./views/rom.svelte.js";
 export { default as SplitView } from "./views/SplitView.svelte";
 export { default as TableCell } from "./views/TableCell.svelte";
@@ -0,0 +1,86 @@
+/**
+ * Log overlay for the table grid
+ *
+ * Per-cell statistics of a logged channel binned onto the table's axes,
+ * shown on top of the calibration values. Plain arrays, so the overlay can
+ * be posted to a webview as is.
+ */
+
+/**
+ * Binned log statistics for every cell of a table
+ */
+export interface TableLogOverlay {
+	/** Channel the statistics describe, e.g. "AFR" */
+	label: string;
+	rows: number;
+	cols: number;
+	/** Samples per cell, row-major */
+	count: number[];
+	/** Row-major; null where a cell has no samples */
+	mean: Array<number | null>;
+	min: Array<number | null>;
+	max: Array<number | null>;
+	stddev: Array<number | null>;
+}
+
+/**
+ * Statistics of one overlay cell
+ */
+export interface LogOverlayCell {
+	count: number;
+	mean: number;
+	min: number;
+	max: number;
+	stddev: number;
+}
+
+/**
+ * Get the statistics of a cell
+ *
+ * @returns The statistics, or null if the cell is outside the overlay or
+ *   has no samples
+ */
+export function getLogOverlayCell(
+	overlay: TableLogOverlay,
+	row: number,
+	col: number,
+): LogOverlayCell | null {
+	if (row < 0 || col < 0 || row >= overlay.rows || col >= overlay.cols) {
+		return null;
+	}
+	const index = row * overlay.cols + col;
+	const count = overlay.count[index] ?? 0;
+	const mean = overlay.mean[index];
+	if (count === 0 || mean === null || mean === undefined) return null;
+	return {
+		count,
+		mean,
+		min: overlay.min[index] ?? mean,
+		max: overlay.max[index] ?? mean,
+		stddev: overlay.stddev[index] ?? 0,
+	};
+}
+
+function formatStat(value: number): string {
+	return Number.isInteger(value)
+		? value.toString()
+		: Number(value.toFixed(2)).toString();
+}
+
+/**
+ * Format the mean shown inside a cell
+ */
+export function formatLogOverlayValue(cell: LogOverlayCell): string {
+	return formatStat(cell.mean);
+}
+
+/**
+ * Format the tooltip of a cell, e.g. "AFR: mean 12.4 (n=38, min 11.9,
+ * max 13.1, sd 0.31)"
+ */
+export function formatLogOverlayTitle(
+	label: string,
+	cell: LogOverlayCell,
+): string {
+	return `${label}: mean ${formatStat(cell.mean)} (n=${cell.count}, min ${formatStat(cell.min)}, max ${formatStat(cell.max)}, sd ${formatStat(cell.stddev)})`;
+}
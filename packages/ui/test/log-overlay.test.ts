@@ -0,0 +1,45 @@
+import { describe, expect, it } from "vitest";
+import {
+	formatLogOverlayTitle,
+	formatLogOverlayValue,
+	getLogOverlayCell,
+	type TableLogOverlay,
+} from "../src/lib/views/log-overlay.js";
+
+const overlay: TableLogOverlay = {
+	label: "AFR",
+	rows: 2,
+	cols: 2,
+	count: [3, 0, 1, 2],
+	mean: [12.456, null, 14.7, 11],
+	min: [12.1, null, 14.7, 10.5],
+	max: [12.9, null, 14.7, 11.5],
+	stddev: [0.3123, null, 0, 0.5],
+};
+
+describe("log overlay", () => {
+	it("reads the statistics of a cell in row-major order", () => {
+		expect(getLogOverlayCell(overlay, 1, 1)).toEqual({
+			count: 2,
+			mean: 11,
+			min: 10.5,
+			max: 11.5,
+			stddev: 0.5,
+		});
+	});
+
+	it("returns null for empty cells and cells outside the overlay", () => {
+		expect(getLogOverlayCell(overlay, 0, 1)).toBeNull();
+		expect(getLogOverlayCell(overlay, 2, 0)).toBeNull();
+		expect(getLogOverlayCell(overlay, 0, -1)).toBeNull();
+	});
+
+	it("formats the cell value and tooltip", () => {
+		const cell = getLogOverlayCell(overlay, 0, 0);
+		if (!cell) throw new Error("expected overlay cell");
+		expect(formatLogOverlayValue(cell)).toBe("12.46");
+		expect(formatLogOverlayTitle("AFR", cell)).toBe(
+			"AFR: mean 12.46 (n=3, min 12.1, max 12.9, sd 0.31)",
+		);
+	});
+});
@@ -4,6 +4,12 @@ import type {
 	SerialPortSession,
 	SerialRuntime,
 } from "@ecu-explorer/device/hardware-runtime";
+import {
+	DecimalLineParser,
+	type WidebandStreamParser,
+} from "./stream-parser.js";
+
+export * from "./stream-parser.js";
 
 export type WidebandReading =
 	| {
@@ -98,17 +104,44 @@ export function parseAemWidebandLine(
 	};
 }
 
-export class AemSerialWidebandSession implements WidebandSession {
+/**
+ * Serial wire format of a wideband controller
+ */
+export interface SerialWidebandProtocol {
+	readonly id: string;
+	readonly name: string;
+	readonly serialOptions: SerialOpenOptions;
+	/** Create a parser for one session's byte stream */
+	createParser(): WidebandStreamParser;
+}
+
+/** AEM UEGO serial output: one ASCII reading per line at 9600 8N1 */
+export const AEM_SERIAL_PROTOCOL: SerialWidebandProtocol = {
+	id: "aem-serial-wideband",
+	name: "AEM Serial Wideband",
+	serialOptions: {
+		baudRate: 9600,
+		dataBits: 8,
+		stopBits: 1,
+		parity: "none",
+	},
+	createParser: () => new DecimalLineParser(),
+};
+
+/**
+ * Wideband session that streams readings from a serial port, decoding the
+ * bytes with a protocol-specific {@link WidebandStreamParser}
+ */
+export class SerialWidebandSession implements WidebandSession {
 	private streaming = false;
 	private streamTask: Promise<void> | undefined;
-	private readonly decoder = new TextDecoder();
-	private bufferedLine = "";
 
 	constructor(
 		readonly id: string,
 		readonly name: string,
 		private readonly mode: AemWidebandMode,
 		private readonly port: WidebandSerialPortSession,
+		private readonly parser: WidebandStreamParser,
 		private readonly now: () => number = () => Date.now(),
 	) {}
 
@@ -131,14 +164,14 @@ export class AemSerialWidebandSession implements WidebandSession {
 		this.streaming = false;
 		await this.streamTask;
 		this.streamTask = undefined;
-		this.bufferedLine = "";
+		this.parser.reset();
 	}
 
 	async close(): Promise<void> {
 		this.streaming = false;
 		await this.streamTask;
 		this.streamTask = undefined;
-		this.bufferedLine = "";
+		this.parser.reset();
 		await this.port.close();
 	}
 
@@ -146,6 +179,13 @@ export class AemSerialWidebandSession implements WidebandSession {
 		onReading: (reading: WidebandReading) => void,
 		onError?: (error: Error) => void,
 	): Promise<void> {
+		const kind = this.mode;
+		const emit = (value: number) => {
+			if (Number.isFinite(value)) {
+				onReading({ kind, value, timestamp: this.now() });
+			}
+		};
+
 		while (this.streaming) {
 			let chunk: Uint8Array;
 			try {
@@ -167,28 +207,38 @@ export class AemSerialWidebandSession implements WidebandSession {
 				continue;
 			}
 
-			this.bufferedLine += this.decoder.decode(chunk);
-			const lines = this.bufferedLine.split(/\r?\n/);
-			this.bufferedLine = lines.pop() ?? "";
-
-			for (const line of lines) {
-				const reading = parseAemWidebandLine(line, this.mode, this.now());
-				if (reading != null) {
-					onReading(reading);
-				}
-			}
+			this.parser.push(chunk, emit);
 		}
 	}
 }
 
-export class AemSerialWidebandAdapter implements WidebandAdapter {
-	readonly id = "aem-serial-wideband";
-	readonly name = "AEM Serial Wideband";
+export class AemSerialWidebandSession extends SerialWidebandSession {
+	constructor(
+		id: string,
+		name: string,
+		mode: AemWidebandMode,
+		port: WidebandSerialPortSession,
+		now?: () => number,
+	) {
+		super(id, name, mode, port, AEM_SERIAL_PROTOCOL.createParser(), now);
+	}
+}
+
+/**
+ * Opens serial-backed candidates as sessions speaking the given protocol
+ */
+export class SerialWidebandAdapter implements WidebandAdapter {
+	readonly id: string;
+	readonly name: string;
 
 	constructor(
 		private readonly runtime: WidebandSerialRuntime,
 		private readonly mode: AemWidebandMode,
-	) {}
+		private readonly protocol: SerialWidebandProtocol,
+	) {
+		this.id = protocol.id;
+		this.name = protocol.name;
+	}
 
 	canOpen(candidate: WidebandHardwareCandidate): boolean {
 		return (
@@ -206,22 +256,27 @@ export class AemSerialWidebandAdapter implements WidebandAdapter {
 			);
 		}
 
-		const port = await this.runtime.openPort(path, {
-			baudRate: 9600,
-			dataBits: 8,
-			stopBits: 1,
-			parity: "none",
-		});
+		const port = await this.runtime.openPort(
+			path,
+			this.protocol.serialOptions,
+		);
 
-		return new AemSerialWidebandSession(
+		return new SerialWidebandSession(
 			candidate.id,
 			candidate.name,
 			this.mode,
 			port,
+			this.protocol.createParser(),
 		);
 	}
 }
 
+export class AemSerialWidebandAdapter extends SerialWidebandAdapter {
+	constructor(runtime: WidebandSerialRuntime, mode: AemWidebandMode) {
+		super(runtime, mode, AEM_SERIAL_PROTOCOL);
+	}
+}
+
 export function getWidebandSerialPath(
 	candidate: WidebandHardwareCandidate,
 ): string | undefined {
@@ -0,0 +1,273 @@
+/**
+ * Incremental parsers for wideband controller serial output.
+ *
+ * Parsers consume bytes exactly as they come off the port, carry partial
+ * readings across chunk boundaries, and report each complete value without
+ * decoding text or allocating per reading.
+ */
+
+/**
+ * Turns a serial byte stream into numeric readings
+ */
+export interface WidebandStreamParser {
+	/**
+	 * Consume received bytes
+	 *
+	 * @param bytes - Next chunk from the port
+	 * @param onValue - Called once per complete reading, in stream order
+	 */
+	push(bytes: Uint8Array, onValue: (value: number) => void): void;
+	/** Discard any partial reading */
+	reset(): void;
+}
+
+const CR = 0x0d;
+const LF = 0x0a;
+const SPACE = 0x20;
+const TAB = 0x09;
+const PLUS = 0x2b;
+const MINUS = 0x2d;
+const DOT = 0x2e;
+const ZERO = 0x30;
+const NINE = 0x39;
+
+/** Digits beyond this are not accumulated (they are below float precision) */
+const MAX_SIGNIFICANT_DIGITS = 15;
+
+const POW10 = Array.from({ length: 23 }, (_, i) => 10 ** i);
+
+// Line scanner states
+const LINE_START = 0;
+const LINE_SIGN = 1;
+const LINE_INTEGER = 2;
+const LINE_FRACTION = 3;
+/** Number finished; the rest of the line is ignored */
+const LINE_DONE = 4;
+/** Line does not start with a number */
+const LINE_INVALID = 5;
+
+/**
+ * Parser for one decimal reading per line, as sent by AEM UEGO gauges
+ * (e.g. `14.7\r\n`)
+ *
+ * Like `Number.parseFloat`, the reading is the number at the start of the
+ * line (after whitespace) and any text after it is ignored; lines that do
+ * not start with a number, such as a startup banner, are skipped. The value
+ * is accumulated as an integer mantissa and a decimal scale while scanning,
+ * so no line is ever decoded to a string.
+ */
+export class DecimalLineParser implements WidebandStreamParser {
+	private state = LINE_START;
+	private negative = false;
+	private sawDigit = false;
+	private mantissa = 0;
+	/** Digits accumulated in the mantissa, not counting leading zeros */
+	private significant = 0;
+	/** Power of ten the mantissa is divided by (negative to multiply) */
+	private scale = 0;
+
+	push(bytes: Uint8Array, onValue: (value: number) => void): void {
+		for (let i = 0; i < bytes.length; i++) {
+			const byte = bytes[i] as number;
+			if (byte === LF || byte === CR) {
+				this.endLine(onValue);
+				continue;
+			}
+			const isDigit = byte >= ZERO && byte <= NINE;
+			switch (this.state) {
+				case LINE_START:
+					if (byte === SPACE || byte === TAB) break;
+					if (byte === MINUS || byte === PLUS) {
+						this.negative = byte === MINUS;
+						this.state = LINE_SIGN;
+						break;
+					}
+					this.integerByte(byte, isDigit);
+					break;
+				case LINE_SIGN:
+				case LINE_INTEGER:
+					this.integerByte(byte, isDigit);
+					break;
+				case LINE_FRACTION:
+					if (isDigit) {
+						this.fractionDigit(byte - ZERO);
+					} else {
+						this.state = LINE_DONE;
+					}
+					break;
+			}
+		}
+	}
+
+	reset(): void {
+		this.state = LINE_START;
+		this.negative = false;
+		this.sawDigit = false;
+		this.mantissa = 0;
+		this.significant = 0;
+		this.scale = 0;
+	}
+
+	private integerByte(byte: number, isDigit: boolean): void {
+		if (isDigit) {
+			this.state = LINE_INTEGER;
+			this.sawDigit = true;
+			const digit = byte - ZERO;
+			if (this.mantissa === 0 && digit === 0) return;
+			if (this.significant < MAX_SIGNIFICANT_DIGITS) {
+				this.mantissa = this.mantissa * 10 + digit;
+				this.significant++;
+			} else {
+				this.scale--;
+			}
+		} else if (byte === DOT) {
+			this.state = LINE_FRACTION;
+		} else {
+			this.state = this.sawDigit ? LINE_DONE : LINE_INVALID;
+		}
+	}
+
+	private fractionDigit(digit: number): void {
+		this.sawDigit = true;
+		if (this.mantissa === 0 && digit === 0) {
+			this.scale++;
+		} else if (this.significant < MAX_SIGNIFICANT_DIGITS) {
+			this.mantissa = this.mantissa * 10 + digit;
+			this.significant++;
+			this.scale++;
+		}
+	}
+
+	private endLine(onValue: (value: number) => void): void {
+		if (this.sawDigit && this.state !== LINE_INVALID) {
+			const { mantissa, scale } = this;
+			const magnitude =
+				scale >= 0
+					? mantissa / (POW10[scale] ?? 10 ** scale)
+					: mantissa * (POW10[-scale] ?? 10 ** -scale);
+			onValue(this.negative ? -magnitude : magnitude);
+		}
+		this.reset();
+	}
+}
+
+/**
+ * Layout of a fixed-length binary frame carrying one reading
+ */
+export interface BinaryFrameFormat {
+	/** Bytes every frame starts with (at least one) */
+	sync: readonly number[];
+	/** Frame length in bytes, including sync and checksum */
+	length: number;
+	/** Byte offset of the raw reading within the frame */
+	valueOffset: number;
+	/** Encoding of the raw reading */
+	valueType: "u8" | "u16be" | "u16le" | "s16be" | "s16le";
+	/** Reading = raw * scale + offset (default 1) */
+	scale?: number;
+	/** Reading = raw * scale + offset (default 0) */
+	offset?: number;
+	/** Checksum of all preceding bytes, stored in the last byte */
+	checksum?: "sum8" | "xor8";
+}
+
+/**
+ * Parser for fixed-length binary frames located by sync bytes
+ *
+ * Bytes are collected into one preallocated frame buffer. When the buffer
+ * stops matching the sync bytes, or a complete frame fails its checksum,
+ * the first byte is dropped and the rest is rescanned, so the parser locks
+ * back onto the stream after noise or a partial frame.
+ */
+export class BinaryFrameParser implements WidebandStreamParser {
+	private readonly frame: Uint8Array;
+	private readonly view: DataView;
+	private readonly sync: Uint8Array;
+	private readonly scale: number;
+	private readonly offset: number;
+	private fill = 0;
+
+	/**
+	 * @param format - Frame layout
+	 * @throws Error if the layout does not fit in `format.length` bytes
+	 */
+	constructor(private readonly format: BinaryFrameFormat) {
+		const valueSize = format.valueType === "u8" ? 1 : 2;
+		const checksumSize = format.checksum ? 1 : 0;
+		if (
+			format.sync.length === 0 ||
+			format.valueOffset < format.sync.length ||
+			format.valueOffset + valueSize > format.length - checksumSize
+		) {
+			throw new Error(
+				`Invalid binary frame layout: sync ${format.sync.length} bytes, value at ${format.valueOffset}, length ${format.length}`,
+			);
+		}
+		this.frame = new Uint8Array(format.length);
+		this.view = new DataView(this.frame.buffer);
+		this.sync = Uint8Array.from(format.sync);
+		this.scale = format.scale ?? 1;
+		this.offset = format.offset ?? 0;
+	}
+
+	push(bytes: Uint8Array, onValue: (value: number) => void): void {
+		const { frame, sync } = this;
+		for (let i = 0; i < bytes.length; i++) {
+			frame[this.fill++] = bytes[i] as number;
+			for (;;) {
+				const checked = Math.min(this.fill, sync.length);
+				let synced = true;
+				for (let j = 0; j < checked; j++) {
+					if (frame[j] !== sync[j]) {
+						synced = false;
+						break;
+					}
+				}
+				if (synced && this.fill < frame.length) break;
+				if (synced && this.checksumMatches()) {
+					onValue(this.readValue() * this.scale + this.offset);
+					this.fill = 0;
+					break;
+				}
+				// Drop the first byte and look for a frame in the rest
+				frame.copyWithin(0, 1, this.fill);
+				this.fill--;
+				if (this.fill === 0) break;
+			}
+		}
+	}
+
+	reset(): void {
+		this.fill = 0;
+	}
+
+	private checksumMatches(): boolean {
+		const { checksum } = this.format;
+		if (!checksum) return true;
+		const { frame } = this;
+		const last = frame.length - 1;
+		let sum = 0;
+		for (let i = 0; i < last; i++) {
+			const byte = frame[i] as number;
+			sum = checksum === "sum8" ? sum + byte : sum ^ byte;
+		}
+		return (sum & 0xff) === frame[last];
+	}
+
+	private readValue(): number {
+		const { view } = this;
+		const at = this.format.valueOffset;
+		switch (this.format.valueType) {
+			case "u8":
+				return view.getUint8(at);
+			case "u16be":
+				return view.getUint16(at);
+			case "u16le":
+				return view.getUint16(at, true);
+			case "s16be":
+				return view.getInt16(at);
+			case "s16le":
+				return view.getInt16(at, true);
+		}
+	}
+}
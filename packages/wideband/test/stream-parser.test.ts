@@ -0,0 +1,110 @@
+import { describe, expect, it } from "vitest";
+import {
+	BinaryFrameParser,
+	DecimalLineParser,
+	type WidebandStreamParser,
+} from "../src/stream-parser.js";
+
+function feed(
+	parser: WidebandStreamParser,
+	...chunks: Array<string | number[]>
+) {
+	const values: number[] = [];
+	for (const chunk of chunks) {
+		const bytes =
+			typeof chunk === "string"
+				? new TextEncoder().encode(chunk)
+				: Uint8Array.from(chunk);
+		parser.push(bytes, (value) => values.push(value));
+	}
+	return values;
+}
+
+describe("DecimalLineParser", () => {
+	it("parses readings split across chunks", () => {
+		const parser = new DecimalLineParser();
+		expect(feed(parser, "14.", "7\r", "\n15", ".20\n", "0.98\r\n")).toEqual([
+			14.7, 15.2, 0.98,
+		]);
+	});
+
+	it("matches parseFloat for the leading number of each line", () => {
+		const lines = [
+			" 14.7",
+			"-0.5",
+			"+2",
+			"007.010",
+			"14.7 AFR",
+			".5",
+			"12.",
+			"0.000123",
+			"123456.789012345",
+		];
+		const parser = new DecimalLineParser();
+		expect(feed(parser, `${lines.join("\n")}\n`)).toEqual(
+			lines.map((line) => Number.parseFloat(line)),
+		);
+	});
+
+	it("skips lines without a leading number", () => {
+		const parser = new DecimalLineParser();
+		expect(feed(parser, "AEM UEGO\r\n\r\n-\n.\nx1\n14.7\n")).toEqual([14.7]);
+	});
+
+	it("drops a partial line on reset", () => {
+		const parser = new DecimalLineParser();
+		feed(parser, "14.");
+		parser.reset();
+		expect(feed(parser, "7\n")).toEqual([7]);
+	});
+});
+
+describe("BinaryFrameParser", () => {
+	const format = {
+		sync: [0xaa, 0x55],
+		length: 5,
+		valueOffset: 2,
+		valueType: "u16be",
+		scale: 0.001,
+		checksum: "xor8",
+	} as const;
+	const frame = (raw: number) => {
+		const bytes = [0xaa, 0x55, raw >> 8, raw & 0xff];
+		return [...bytes, bytes.reduce((sum, byte) => sum ^ byte, 0)];
+	};
+
+	it("decodes frames split across chunks", () => {
+		const parser = new BinaryFrameParser(format);
+		const bytes = [...frame(1000), ...frame(985)];
+		expect(
+			feed(parser, bytes.slice(0, 3), bytes.slice(3, 7), bytes.slice(7)),
+		).toEqual([1, 0.985]);
+	});
+
+	it("resynchronizes after noise and corrupt frames", () => {
+		const parser = new BinaryFrameParser(format);
+		const corrupt = frame(500);
+		corrupt[4] = (corrupt[4] as number) ^ 0xff;
+		expect(
+			feed(parser, [0x00, 0xaa, 0xaa], frame(1000), corrupt, frame(1470)),
+		).toEqual([1, 1.47]);
+	});
+
+	it("reads signed little-endian values with an offset", () => {
+		const parser = new BinaryFrameParser({
+			sync: [0x7e],
+			length: 3,
+			valueOffset: 1,
+			valueType: "s16le",
+			scale: 0.5,
+			offset: 10,
+		});
+		expect(feed(parser, [0x7e, 0xfe, 0xff, 0x7e, 0x04, 0x00])).toEqual([9, 12]);
+	});
+
+	it("rejects layouts that do not fit the frame", () => {
+		expect(
+			() => new BinaryFrameParser({ ...format, valueOffset: 3 }),
+		).toThrow(/Invalid binary frame layout/);
+	});
+});
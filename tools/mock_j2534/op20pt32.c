@@ -6,6 +6,20 @@
  *   - UDS DiagnosticSessionControl (10 03) → positive response (50 03)
  *   - UDS SecurityAccess requestSeed (27 03) → seed = 0x12 0x34
  *   - UDS SecurityAccess sendKey (27 04 KH KL) → LOG THE KEY and return positive (67 04)
+ *   - OBD-II Mode 01 (01 PID [PID ...]) → single- or multi-PID live data (41 PID A [B] ...)
+ *   - MUT-III RAX RAM reads, both paths:
+ *       ReadMemoryByAddress (23 14 A3 A2 A1 A0 LEN) → 63 + LEN bytes (bulk)
+ *       E0 A3 A2 A1 A0 / E5 / E1 → pointer set, 2-byte read + inc, 1-byte read
+ *     Set J2534_MOCK_NO_BULK_READ=1 to reject 0x23 like ECUs without it.
+ *   - Subaru SSM over K-line (ISO 9141 / ISO 14230 channels):
+ *       80 18 F0 LEN A8 PP A2 A1 A0 ... CS → 80 F0 18 LEN E8 DATA ... CS
+ *     PP = 01 (fast-poll) keeps answering until the next request.
+ *     Set J2534_MOCK_NO_SSM_FAST_POLL=1 to leave fast-poll requests unanswered.
+ *
+ * Timing model: each response becomes readable only after a simulated
+ * bus + ECU delay (see mock_response_delay_ms), and the log prints the
+ * per-request poll rates once a second so live-data schedules can be
+ * checked under load.
  *
  * Magic seed: 0x1234 — fixed so we can predict the expected key
  * The key sent by EcuFlash in response to seed 0x1234 is the write-session key.
@@ -21,11 +35,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdlib.h>
 
 /* J2534 API definitions */
 #define STATUS_NOERROR 0
 #define STATUS_ERR_FAILED 0x1F
 
+#define ISO9141 3
+#define ISO14230 4
 #define ISO15765 6
 #define ISO15765_PS 0x04
 
@@ -44,6 +61,8 @@ typedef struct
 static FILE *logfile = NULL;
 static DWORD g_device_id = 1;
 static DWORD g_channel_id = 1;
+static DWORD g_protocol_id = ISO15765;
+static DWORD g_baud_rate = 500000;
 
 static void log_msg(const char *fmt, ...)
 {
@@ -105,12 +124,309 @@ static void build_can_response(PASSTHRU_MSG *msg, const BYTE *uds_payload, DWORD
 	msg->RxStatus = 0;
 }
 
+/* Mode 01 PID table: PID, data length, fixed sample bytes (A, B) */
+typedef struct
+{
+	BYTE pid;
+	BYTE len;
+	BYTE a;
+	BYTE b;
+} MOCK_OBD_PID;
+
+static const MOCK_OBD_PID mock_obd_pids[] = {
+	{0x04, 1, 0x80, 0x00}, /* Load 50.2% */
+	{0x05, 1, 0x64, 0x00}, /* Coolant 60 °C */
+	{0x0B, 1, 0x65, 0x00}, /* MAP 101 kPa */
+	{0x0C, 2, 0x0F, 0xA0}, /* RPM 1000 */
+	{0x0D, 1, 0x50, 0x00}, /* Speed 80 km/h */
+	{0x0F, 1, 0x46, 0x00}, /* IAT 30 °C */
+	{0x10, 2, 0x01, 0xF4}, /* MAF 5.00 g/s */
+	{0x11, 1, 0x33, 0x00}, /* Throttle 20% */
+};
+
+/* ISO 15765-4 allows at most six PIDs per Mode 01 request */
+#define MOCK_OBD_MAX_PIDS 6
+
+static DWORD g_obd_requests = 0;
+static DWORD g_obd_pids_answered = 0;
+
+static const MOCK_OBD_PID *find_obd_pid(BYTE pid)
+{
+	for (DWORD i = 0; i < sizeof(mock_obd_pids) / sizeof(mock_obd_pids[0]); i++)
+	{
+		if (mock_obd_pids[i].pid == pid)
+			return &mock_obd_pids[i];
+	}
+	return NULL;
+}
+
+/*
+ * Answer a Mode 01 request carrying one to six PIDs.
+ * Unsupported PIDs are omitted from the response, as a real ECU does.
+ * Returns the response length (including the leading length byte),
+ * or 0 if none of the PIDs are supported.
+ */
+static DWORD build_obd_mode01_response(const BYTE *pids, DWORD count, BYTE *resp)
+{
+	DWORD n = 1;
+	resp[n++] = 0x41;
+	for (DWORD i = 0; i < count && i < MOCK_OBD_MAX_PIDS; i++)
+	{
+		const MOCK_OBD_PID *entry = find_obd_pid(pids[i]);
+		if (!entry)
+			continue;
+		resp[n++] = entry->pid;
+		resp[n++] = entry->a;
+		if (entry->len > 1)
+			resp[n++] = entry->b;
+		g_obd_pids_answered++;
+	}
+	if (n == 2)
+		return 0;
+	resp[0] = (BYTE)(n - 1);
+	return n;
+}
+
+/* Emulated ECU RAM window covering the RAX blocks (0x238051A8–0x238051C9) */
+#define MOCK_RAM_BASE 0x23805180UL
+#define MOCK_RAM_SIZE 0x80
+#define MOCK_RAX_A_ADDR 0x238051ACUL
+
+static BYTE g_ram[MOCK_RAM_SIZE];
+static DWORD g_ram_pointer = 0;
+static int g_bulk_read_disabled = 0;
+static DWORD g_bulk_reads = 0;
+static DWORD g_pointer_reads = 0;
+
+static void init_mock_ram(void)
+{
+	for (DWORD i = 0; i < MOCK_RAM_SIZE; i++)
+		g_ram[i] = (BYTE)(0x40 + i);
+	/* RAX_A fuel trims: 0x80 → 0% */
+	memset(g_ram + (MOCK_RAX_A_ADDR - MOCK_RAM_BASE), 0x80, 4);
+}
+
+/* Read one byte of emulated RAM; addresses outside the window read as 0 */
+static BYTE read_mock_ram(DWORD addr)
+{
+	if (addr < MOCK_RAM_BASE || addr - MOCK_RAM_BASE >= MOCK_RAM_SIZE)
+		return 0x00;
+	return g_ram[addr - MOCK_RAM_BASE];
+}
+
+/* ── Timing model ─────────────────────────────────────────────────────────
+ * Response delay = ECU base latency + per-request load + 1 ms per extra
+ * ISO-TP frame (a single frame carries 7 bytes; a first frame 6 and each
+ * consecutive frame 7, with the tester's flow control in between).
+ *   J2534_MOCK_LATENCY_MS  ECU base latency (default 2)
+ *   J2534_MOCK_LOAD_MS     extra processing per request, to simulate load (default 0)
+ */
+static DWORD g_base_latency_ms = 2;
+static DWORD g_load_ms = 0;
+static DWORD g_response_ready_at = 0;
+
+static DWORD env_dword(const char *name, DWORD fallback)
+{
+	const char *value = getenv(name);
+	return value ? (DWORD)strtoul(value, NULL, 10) : fallback;
+}
+
+/* payload_len includes the leading length byte, as built for build_can_response */
+static DWORD mock_response_delay_ms(DWORD payload_len)
+{
+	DWORD data_len = payload_len > 0 ? payload_len - 1 : 0;
+	DWORD frames = data_len <= 7 ? 1 : 1 + (data_len - 6 + 6) / 7;
+	return g_base_latency_ms + g_load_ms + (frames - 1);
+}
+
+/* Per-request poll rate tracking, summarised once per second */
+#define MOCK_RATE_SLOTS 32
+#define MOCK_RATE_WINDOW_MS 1000
+
+typedef struct
+{
+	DWORD key; /* service << 24 | first argument bytes */
+	DWORD count;
+} MOCK_RATE_SLOT;
+
+static MOCK_RATE_SLOT g_rate_slots[MOCK_RATE_SLOTS];
+static DWORD g_rate_slot_count = 0;
+static DWORD g_rate_window_start = 0;
+
+static void report_poll_rates(DWORD now)
+{
+	DWORD elapsed = now - g_rate_window_start;
+	if (g_rate_slot_count == 0)
+		return;
+	log_msg("  [rates over %lu ms]", elapsed);
+	for (DWORD i = 0; i < g_rate_slot_count; i++)
+	{
+		DWORD hz_x10 = g_rate_slots[i].count * 10000 / (elapsed ? elapsed : 1);
+		log_msg(" %02lX:%06lX=%lu.%luHz", g_rate_slots[i].key >> 24,
+				g_rate_slots[i].key & 0xFFFFFF, hz_x10 / 10, hz_x10 % 10);
+	}
+	log_msg("\n");
+}
+
+static void track_poll_rate(const BYTE *uds, DWORD uds_len)
+{
+	DWORD now = GetTickCount();
+	DWORD key = (DWORD)uds[0] << 24;
+	for (DWORD i = 1; i < 4 && i < uds_len; i++)
+		key |= (DWORD)uds[i] << (8 * (3 - i));
+
+	if (g_rate_window_start == 0)
+		g_rate_window_start = now;
+	if (now - g_rate_window_start >= MOCK_RATE_WINDOW_MS)
+	{
+		report_poll_rates(now);
+		g_rate_slot_count = 0;
+		g_rate_window_start = now;
+	}
+
+	for (DWORD i = 0; i < g_rate_slot_count; i++)
+	{
+		if (g_rate_slots[i].key == key)
+		{
+			g_rate_slots[i].count++;
+			return;
+		}
+	}
+	if (g_rate_slot_count < MOCK_RATE_SLOTS)
+	{
+		g_rate_slots[g_rate_slot_count].key = key;
+		g_rate_slots[g_rate_slot_count].count = 1;
+		g_rate_slot_count++;
+	}
+}
+
+/* ── Subaru SSM over K-line ──────────────────────────────────────────────
+ * Packets: 80 DEST SRC LEN DATA... CS, CS = sum of all preceding bytes.
+ * Only A8 (read addresses) is emulated. Every address reads as its low byte
+ * plus the number of A8 responses sent so far, so values move between cycles.
+ * On K-line the whole request and response are clocked out serially, so the
+ * delay is dominated by 10 bit times per byte at the channel baud rate.
+ */
+#define SSM_MAX_PACKET (6 + 84)
+
+static int g_ssm_fast_poll_disabled = 0;
+static int g_ssm_fast_poll = 0;
+static BYTE g_ssm_request[4 + 2 + 84 * 3 + 1];
+static DWORD g_ssm_address_count = 0;
+static DWORD g_ssm_requests = 0;
+static DWORD g_ssm_responses = 0;
+
+static BYTE ssm_checksum(const BYTE *packet, DWORD len)
+{
+	DWORD sum = 0;
+	for (DWORD i = 0; i + 1 < len; i++)
+		sum += packet[i];
+	return (BYTE)sum;
+}
+
+static DWORD kline_delay_ms(DWORD bytes)
+{
+	DWORD baud = g_baud_rate ? g_baud_rate : 4800;
+	return g_base_latency_ms + g_load_ms + (bytes * 10 * 1000 + baud - 1) / baud;
+}
+
+/* Queue the E8 response for the stored A8 request */
+static void queue_ssm_response(DWORD ready_at)
+{
+	PASSTHRU_MSG *msg = (PASSTHRU_MSG *)pending_response;
+	BYTE dest = g_ssm_request[1];
+	DWORD n = g_ssm_address_count;
+	DWORD resp_len = 6 + n;
+
+	memset(msg, 0, sizeof(PASSTHRU_MSG));
+	msg->ProtocolID = g_protocol_id;
+	msg->Data[0] = 0x80;
+	msg->Data[1] = 0xF0;
+	msg->Data[2] = dest;
+	msg->Data[3] = (BYTE)(n + 1);
+	msg->Data[4] = 0xE8;
+	for (DWORD i = 0; i < n; i++)
+	{
+		const BYTE *a = g_ssm_request + 6 + i * 3;
+		msg->Data[5 + i] = (BYTE)(a[2] + g_ssm_responses);
+	}
+	msg->Data[resp_len - 1] = ssm_checksum(msg->Data, resp_len);
+	msg->DataSize = resp_len;
+
+	g_ssm_responses++;
+	g_response_ready_at = ready_at;
+	pending_response_len = sizeof(PASSTHRU_MSG);
+	has_pending = 1;
+}
+
+static void handle_ssm_request(const BYTE *data, DWORD len)
+{
+	/* Any new request ends fast-poll */
+	g_ssm_fast_poll = 0;
+
+	if (len < 6 || data[0] != 0x80 || data[2] != 0xF0 || data[3] + 5UL != len)
+	{
+		log_msg("  → Malformed SSM packet ignored\n");
+		return;
+	}
+	if (data[len - 1] != ssm_checksum(data, len))
+	{
+		log_msg("  → SSM checksum mismatch (got 0x%02X, expected 0x%02X) — no response\n",
+				data[len - 1], ssm_checksum(data, len));
+		return;
+	}
+
+	track_poll_rate(data + 4, data[3]);
+
+	if (data[4] != 0xA8 || (data[3] - 2) % 3 != 0 || data[3] < 5 ||
+		(data[3] - 2UL) / 3 + 6 > SSM_MAX_PACKET)
+	{
+		log_msg("  → Unsupported SSM command 0x%02X — no response\n", data[4]);
+		return;
+	}
+
+	memcpy(g_ssm_request, data, len);
+	g_ssm_address_count = (data[3] - 2UL) / 3;
+	g_ssm_requests++;
+
+	if (data[5] == 0x01)
+	{
+		if (g_ssm_fast_poll_disabled)
+		{
+			log_msg("  → SSM A8 fast-poll ignored (fast-poll disabled)\n");
+			return;
+		}
+		g_ssm_fast_poll = 1;
+	}
+
+	log_msg("  → SSM A8 read %lu addresses%s — %lu requests, %lu responses so far\n",
+			g_ssm_address_count, g_ssm_fast_poll ? " (fast-poll)" : "",
+			g_ssm_requests, g_ssm_responses);
+	queue_ssm_response(GetTickCount() + kline_delay_ms(len + 6 + g_ssm_address_count));
+}
+
+static DWORD read_be32(const BYTE *p)
+{
+	return ((DWORD)p[0] << 24) | ((DWORD)p[1] << 16) | ((DWORD)p[2] << 8) | p[3];
+}
+
 BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
 {
 	if (fdwReason == DLL_PROCESS_ATTACH)
 	{
 		log_msg("=== Mock op20pt32.dll loaded (ecuflash mitsucan security key interceptor) ===\n");
 		log_msg("Magic seed: 0x1234 — watch for key sent in 27 04 response\n");
+		init_mock_ram();
+		g_bulk_read_disabled = getenv("J2534_MOCK_NO_BULK_READ") != NULL;
+		if (g_bulk_read_disabled)
+			log_msg("Bulk RAM reads (0x23) disabled — ECU will answer NRC 0x11\n");
+		g_base_latency_ms = env_dword("J2534_MOCK_LATENCY_MS", g_base_latency_ms);
+		g_load_ms = env_dword("J2534_MOCK_LOAD_MS", g_load_ms);
+		g_ssm_fast_poll_disabled = getenv("J2534_MOCK_NO_SSM_FAST_POLL") != NULL;
+		if (g_ssm_fast_poll_disabled)
+			log_msg("SSM fast-poll disabled — A8 01 requests go unanswered\n");
+		log_msg("Timing model: %lu ms base latency, %lu ms load per request\n",
+				g_base_latency_ms, g_load_ms);
 	}
 	return TRUE;
 }
@@ -137,6 +453,8 @@ __declspec(dllexport) LONG __stdcall PassThruConnect(
 	DWORD BaudRate, DWORD *pChannelID)
 {
 	log_msg("PassThruConnect(proto=%lu, baud=%lu)\n", ProtocolID, BaudRate);
+	g_protocol_id = ProtocolID;
+	g_baud_rate = BaudRate;
 	if (pChannelID)
 		*pChannelID = g_channel_id;
 	return STATUS_NOERROR;
@@ -163,6 +481,13 @@ __declspec(dllexport) LONG __stdcall PassThruWriteMsgs(
 
 	log_bytes("TX (EcuFlash→ECU)", data, len);
 
+	/* K-line channels carry raw SSM packets */
+	if (m->ProtocolID == ISO9141 || m->ProtocolID == ISO14230)
+	{
+		handle_ssm_request(data, len);
+		return STATUS_NOERROR;
+	}
+
 	/* data[0..3] = CAN ID (0x7E0 for tester), data[4..] = UDS payload */
 	/* UDS payload: data[4] = length byte (ISO 15765 SF), data[5..] = UDS */
 	if (len >= 6)
@@ -170,6 +495,8 @@ __declspec(dllexport) LONG __stdcall PassThruWriteMsgs(
 		BYTE uds_svc = data[5]; /* UDS service ID */
 		BYTE uds_sf = data[6];	/* subfunction */
 
+		track_poll_rate(data + 5, data[4]);
+
 		/* DiagnosticSessionControl (0x10) → respond with 50 03 */
 		if (uds_svc == 0x10)
 		{
@@ -222,6 +549,87 @@ __declspec(dllexport) LONG __stdcall PassThruWriteMsgs(
 			pending_response_len = sizeof(PASSTHRU_MSG);
 			has_pending = 1;
 		}
+		/* OBD-II Mode 01 (single or multi-PID) → 41 PID A [B] ... */
+		else if (uds_svc == 0x01)
+		{
+			DWORD pid_count = data[4] > 0 ? (DWORD)data[4] - 1 : 0;
+			if (pid_count > len - 6)
+				pid_count = len - 6;
+			BYTE resp[2 + MOCK_OBD_MAX_PIDS * 3];
+			DWORD resp_len = build_obd_mode01_response(data + 6, pid_count, resp);
+			g_obd_requests++;
+			log_msg("  → OBD-II Mode 01 (%lu PIDs) — %lu requests, %lu PIDs answered so far\n",
+					pid_count, g_obd_requests, g_obd_pids_answered);
+			if (pid_count > MOCK_OBD_MAX_PIDS || resp_len == 0)
+			{
+				/* requestOutOfRange */
+				BYTE nrc[] = {0x03, 0x7F, 0x01, 0x31};
+				build_can_response((PASSTHRU_MSG *)pending_response, nrc, 4);
+			}
+			else
+			{
+				build_can_response((PASSTHRU_MSG *)pending_response, resp, resp_len);
+			}
+			pending_response_len = sizeof(PASSTHRU_MSG);
+			has_pending = 1;
+		}
+		/* ReadMemoryByAddress (23 14 A3 A2 A1 A0 LEN) → 63 + LEN bytes of RAM */
+		else if (uds_svc == 0x23 && uds_sf == 0x14 && len >= 12)
+		{
+			DWORD addr = read_be32(data + 7);
+			DWORD count = data[11];
+			/* The response length byte covers the 0x63 too, so cap the data at
+			   0xFE bytes rather than let count + 1 wrap to 0 */
+			if (count > 0xFE)
+				count = 0xFE;
+			if (g_bulk_read_disabled)
+			{
+				log_msg("  → ReadMemoryByAddress 0x%08lX (%lu bytes) rejected (bulk reads disabled)\n",
+						addr, count);
+				/* serviceNotSupported */
+				BYTE nrc[] = {0x03, 0x7F, 0x23, 0x11};
+				build_can_response((PASSTHRU_MSG *)pending_response, nrc, 4);
+			}
+			else
+			{
+				BYTE resp[2 + 0xFF];
+				resp[0] = (BYTE)(count + 1);
+				resp[1] = 0x63;
+				for (DWORD i = 0; i < count; i++)
+					resp[2 + i] = read_mock_ram(addr + i);
+				g_bulk_reads++;
+				log_msg("  → ReadMemoryByAddress 0x%08lX (%lu bytes) — %lu bulk reads so far\n",
+						addr, count, g_bulk_reads);
+				build_can_response((PASSTHRU_MSG *)pending_response, resp, count + 2);
+			}
+			pending_response_len = sizeof(PASSTHRU_MSG);
+			has_pending = 1;
+		}
+		/* MUT-III set RAM pointer (E0 A3 A2 A1 A0) → 00 */
+		else if (uds_svc == 0xE0 && len >= 10)
+		{
+			g_ram_pointer = read_be32(data + 6);
+			log_msg("  → MUT-III set address 0x%08lX\n", g_ram_pointer);
+			BYTE resp[] = {0x01, 0x00};
+			build_can_response((PASSTHRU_MSG *)pending_response, resp, 2);
+			pending_response_len = sizeof(PASSTHRU_MSG);
+			has_pending = 1;
+		}
+		/* MUT-III read word + increment (E5) / read byte (E1) */
+		else if (uds_svc == 0xE5 || uds_svc == 0xE1)
+		{
+			DWORD count = uds_svc == 0xE5 ? 2 : 1;
+			BYTE resp[3];
+			resp[0] = (BYTE)count;
+			for (DWORD i = 0; i < count; i++)
+				resp[1 + i] = read_mock_ram(g_ram_pointer++);
+			g_pointer_reads++;
+			log_msg("  → MUT-III read %lu byte(s) — %lu pointer reads so far\n",
+					count, g_pointer_reads);
+			build_can_response((PASSTHRU_MSG *)pending_response, resp, count + 1);
+			pending_response_len = sizeof(PASSTHRU_MSG);
+			has_pending = 1;
+		}
 		/* Everything else → generic positive response */
 		else
 		{
@@ -233,6 +641,12 @@ __declspec(dllexport) LONG __stdcall PassThruWriteMsgs(
 		}
 	}
 
+	if (has_pending)
+	{
+		const PASSTHRU_MSG *resp = (const PASSTHRU_MSG *)pending_response;
+		g_response_ready_at = GetTickCount() + mock_response_delay_ms(resp->DataSize - 4);
+	}
+
 	return STATUS_NOERROR;
 }
 
@@ -246,11 +660,27 @@ __declspec(dllexport) LONG __stdcall PassThruReadMsgs(
 
 	if (has_pending && *pNumMsgs > 0)
 	{
+		/* Honour the timing model: wait (up to Timeout) for the response */
+		DWORD now = GetTickCount();
+		if ((LONG)(g_response_ready_at - now) > 0)
+		{
+			DWORD wait = g_response_ready_at - now;
+			if (wait > Timeout)
+			{
+				Sleep(Timeout);
+				*pNumMsgs = 0;
+				return STATUS_NOERROR;
+			}
+			Sleep(wait);
+		}
 		memcpy(&pMsg[0], pending_response, sizeof(PASSTHRU_MSG));
 		PASSTHRU_MSG *m = &pMsg[0];
 		log_bytes("RX (ECU→EcuFlash)", m->Data, m->DataSize);
 		*pNumMsgs = 1;
 		has_pending = 0;
+		/* SSM fast-poll: the ECU sends the next response unprompted */
+		if (g_ssm_fast_poll)
+			queue_ssm_response(GetTickCount() + kline_delay_ms(6 + g_ssm_address_count));
 		return STATUS_NOERROR;
 	}
 